@@ -198,6 +198,14 @@ DAWN_NATIVE_EXPORT std::vector<const char*> GetTogglesUsed(WGPUDevice device);
 // Backdoor to get the number of lazy clears for testing
 DAWN_NATIVE_EXPORT size_t GetLazyClearCountForTesting(WGPUDevice device);
 
+// Backdoor to get the number of command blocks allocated from the system allocator for testing
+DAWN_NATIVE_EXPORT uint64_t GetCommandBlockAllocationCountForTesting(WGPUDevice device);
+
+// Backdoor to limit the number of threads render passes are recorded on, when the backend records
+// them in parallel, for testing
+DAWN_NATIVE_EXPORT void SetMaxRenderPassRecordingChunksForTesting(WGPUDevice device,
+                                                                  uint32_t maxChunks);
+
 // Backdoor to get the number of deprecation warnings for testing
 DAWN_NATIVE_EXPORT size_t GetDeprecationWarningCountForTesting(WGPUDevice device);
 
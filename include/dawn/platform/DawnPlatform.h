@@ -68,6 +68,14 @@ class DAWN_PLATFORM_EXPORT CachingInterface {
     CachingInterface& operator=(const CachingInterface&) = delete;
 };
 
+// Creates a CachingInterface persisting the entries in a single memory mapped pack file at |path|.
+// The least recently used entries are evicted when the file would grow beyond |maxSize| bytes.
+// Returns nullptr if the file can't be opened, is in use by another process, or if the platform
+// doesn't support it.
+DAWN_PLATFORM_EXPORT std::unique_ptr<CachingInterface> CreateFileCachingInterface(
+    const char* path,
+    uint64_t maxSize);
+
 class DAWN_PLATFORM_EXPORT WaitableEvent {
   public:
     WaitableEvent() = default;
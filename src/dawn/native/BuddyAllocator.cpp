@@ -208,6 +208,7 @@ uint64_t BuddyAllocator::Allocate(uint64_t allocationSize, uint64_t alignment) {
     // Remove curr block from free-list (now allocated).
     RemoveFreeBlock(currBlock, currBlockLevel);
     currBlock->mState = BlockState::Allocated;
+    mAllocatedSize += currBlock->mSize;
 
     return currBlock->mOffset;
 }
@@ -238,6 +239,8 @@ void BuddyAllocator::Deallocate(uint64_t offset) {
 
     // Mark curr free so we can merge.
     curr->mState = BlockState::Free;
+    DAWN_ASSERT(mAllocatedSize >= curr->mSize);
+    mAllocatedSize -= curr->mSize;
 
     // Merge the buddies (LevelN-to-Level0).
     while (currBlockLevel > 0 && curr->pBuddy->mState == BlockState::Free) {
@@ -262,6 +265,10 @@ void BuddyAllocator::Deallocate(uint64_t offset) {
     InsertFreeBlock(curr, currBlockLevel);
 }
 
+uint64_t BuddyAllocator::GetAllocatedSize() const {
+    return mAllocatedSize;
+}
+
 // Helper which deletes a block in the tree recursively (post-order).
 void BuddyAllocator::DeleteBlock(BuddyBlock* block) {
     DAWN_ASSERT(block != nullptr);
@@ -57,6 +57,10 @@ class BuddyAllocator {
     uint64_t Allocate(uint64_t allocationSize, uint64_t alignment = 1);
     void Deallocate(uint64_t offset);
 
+    // Returns the sum of the sizes of the allocated blocks, including the padding added by
+    // rounding allocations up to a power-of-two.
+    uint64_t GetAllocatedSize() const;
+
     // For testing purposes only.
     uint64_t ComputeTotalNumOfFreeBlocksForTesting() const;
 
@@ -125,6 +129,7 @@ class BuddyAllocator {
     raw_ptr<BuddyBlock, DanglingUntriaged> mRoot = nullptr;  // Used to deallocate non-free blocks.
 
     uint64_t mMaxBlockSize = 0;
+    uint64_t mAllocatedSize = 0;
 
     // List of linked-lists of free blocks where the index is a level that
     // corresponds to a power-of-two sized block.
@@ -87,6 +87,7 @@ ResultOrError<ResourceMemoryAllocation> BuddyMemoryAllocator::Allocate(uint64_t
         std::unique_ptr<ResourceHeapBase> memory;
         DAWN_TRY_ASSIGN(memory, mHeapAllocator->AllocateResourceHeap(mMemoryBlockSize));
         mTrackedSubAllocations[memoryIndex] = {/*refcount*/ 0, std::move(memory)};
+        mHeapCount++;
     }
 
     mTrackedSubAllocations[memoryIndex].refcount++;
@@ -115,6 +116,8 @@ void BuddyMemoryAllocator::Deallocate(const ResourceMemoryAllocation& allocation
     if (mTrackedSubAllocations[memoryIndex].refcount == 0) {
         mHeapAllocator->DeallocateResourceHeap(
             std::move(mTrackedSubAllocations[memoryIndex].mMemoryAllocation));
+        DAWN_ASSERT(mHeapCount > 0);
+        mHeapCount--;
     }
 
     mBuddyBlockAllocator.Deallocate(info.mBlockOffset);
@@ -124,6 +127,14 @@ uint64_t BuddyMemoryAllocator::GetMemoryBlockSize() const {
     return mMemoryBlockSize;
 }
 
+uint64_t BuddyMemoryAllocator::GetHeapCount() const {
+    return mHeapCount;
+}
+
+uint64_t BuddyMemoryAllocator::GetAllocatedSize() const {
+    return mBuddyBlockAllocator.GetAllocatedSize();
+}
+
 uint64_t BuddyMemoryAllocator::ComputeTotalNumOfHeapsForTesting() const {
     uint64_t count = 0;
     for (const TrackedSubAllocations& allocation : mTrackedSubAllocations) {
@@ -63,6 +63,13 @@ class BuddyMemoryAllocator {
 
     uint64_t GetMemoryBlockSize() const;
 
+    // Returns the number of resource heaps currently allocated by the buddy system, and the sum
+    // of the block sizes handed out of them. Together they measure the fragmentation of the
+    // system: GetAllocatedSize() / (GetHeapCount() * GetMemoryBlockSize()) is the used fraction
+    // of the committed memory.
+    uint64_t GetHeapCount() const;
+    uint64_t GetAllocatedSize() const;
+
     // For testing purposes.
     uint64_t ComputeTotalNumOfHeapsForTesting() const;
 
@@ -70,6 +77,7 @@ class BuddyMemoryAllocator {
     uint64_t GetMemoryIndex(uint64_t offset) const;
 
     uint64_t mMemoryBlockSize = 0;
+    uint64_t mHeapCount = 0;
 
     BuddyAllocator mBuddyBlockAllocator;
     // TODO(https://crbug.com/dawn/2349): Investigate DanglingUntriaged in dawn/native.
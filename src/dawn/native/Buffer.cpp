@@ -43,6 +43,7 @@
 #include "dawn/native/DynamicUploader.h"
 #include "dawn/native/ErrorData.h"
 #include "dawn/native/EventManager.h"
+#include "dawn/native/IndirectDrawValidationEncoder.h"
 #include "dawn/native/Instance.h"
 #include "dawn/native/ObjectType_autogen.h"
 #include "dawn/native/PhysicalDevice.h"
@@ -326,6 +327,12 @@ BufferBase::BufferBase(DeviceBase* device, const UnpackedPtr<BufferDescriptor>&
         mState = BufferState::HostMappedPersistent;
     }
 
+    // The contents of these buffers can be written through a CPU pointer while they are used by
+    // the queue, possibly by a producer outside of Dawn, so validated indirect draw parameters
+    // can't be kept for them. Writes to buffers mapped at creation are only possible before
+    // their first unmap, which invalidates the cache.
+    mHasUntrackedWriters = (mUsage & wgpu::BufferUsage::MapWrite) || hostMappedDesc != nullptr;
+
     GetObjectTrackingList()->Track(this);
 }
 
@@ -366,6 +373,7 @@ void BufferBase::DestroyImpl() {
     }
 
     mState = BufferState::Destroyed;
+    mIndirectDrawValidationCache = nullptr;
 }
 
 // static
@@ -719,6 +727,8 @@ void BufferBase::UnmapInternal(WGPUBufferMapAsyncStatus callbackStatus) {
         }
     }
 
+    // The mapped range may have been written.
+    InvalidateIndirectDrawValidationCache();
     mState = BufferState::Unmapped;
 }
 
@@ -864,6 +874,22 @@ void BufferBase::MarkUsedInPendingCommands() {
     mLastUsageSerial = serial;
 }
 
+IndirectDrawValidationCache* BufferBase::GetIndirectDrawValidationCache() {
+    if (mHasUntrackedWriters || mState != BufferState::Unmapped) {
+        return nullptr;
+    }
+    if (mIndirectDrawValidationCache == nullptr) {
+        mIndirectDrawValidationCache = std::make_unique<IndirectDrawValidationCache>();
+    }
+    return mIndirectDrawValidationCache.get();
+}
+
+void BufferBase::InvalidateIndirectDrawValidationCache() {
+    if (mIndirectDrawValidationCache != nullptr) {
+        mIndirectDrawValidationCache->Clear();
+    }
+}
+
 bool BufferBase::IsFullBufferRange(uint64_t offset, uint64_t size) const {
     return offset == 0 && size == GetSize();
 }
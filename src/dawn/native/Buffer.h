@@ -28,6 +28,7 @@
 #ifndef SRC_DAWN_NATIVE_BUFFER_H_
 #define SRC_DAWN_NATIVE_BUFFER_H_
 
+#include <atomic>
 #include <functional>
 #include <memory>
 
@@ -45,6 +46,7 @@
 namespace dawn::native {
 
 struct CopyTextureToBufferCmd;
+class IndirectDrawValidationCache;
 
 enum class MapType : uint32_t;
 
@@ -101,6 +103,13 @@ class BufferBase : public ApiObjectBase {
     void SetIsDataInitialized();
     void MarkUsedInPendingCommands();
 
+    // Returns the validated parameters of indirect draws kept for this buffer, or nullptr if its
+    // contents may change without Dawn knowing, for example if it is mappable for writing or
+    // wraps host memory.
+    IndirectDrawValidationCache* GetIndirectDrawValidationCache();
+    // Must be called when the contents of the buffer may have changed.
+    void InvalidateIndirectDrawValidationCache();
+
     virtual void* GetMappedPointer() = 0;
     void* GetMappedRange(size_t offset, size_t size, bool writable = true);
     MaybeError Unmap();
@@ -138,6 +147,8 @@ class BufferBase : public ApiObjectBase {
     ExecutionSerial mLastUsageSerial = ExecutionSerial(0);
 
   private:
+    friend class SyncScopeUsageTracker;
+
     std::function<void()> PrepareMappingCallback(MapRequestID mapID,
                                                  WGPUBufferMapAsyncStatus status);
 
@@ -169,6 +180,11 @@ class BufferBase : public ApiObjectBase {
     // i.e. buffer->mStagingBuffer->mStagingBuffer... is not possible.
     Ref<BufferBase> mStagingBuffer;
 
+    // Set for buffers whose contents may change without Dawn knowing, which never keep an
+    // IndirectDrawValidationCache.
+    bool mHasUntrackedWriters = false;
+    std::unique_ptr<IndirectDrawValidationCache> mIndirectDrawValidationCache;
+
     WGPUBufferMapCallback mMapCallback = nullptr;
     // TODO(https://crbug.com/dawn/2349): Investigate DanglingUntriaged in dawn/native.
     raw_ptr<void, DanglingUntriaged> mMapUserdata = nullptr;
@@ -179,6 +195,9 @@ class BufferBase : public ApiObjectBase {
 
     struct MapAsyncEvent;
     Ref<MapAsyncEvent> mPendingMapEvent;
+
+    // Identifies the entry of this buffer in the last SyncScopeUsageTracker that used it.
+    std::atomic<uint64_t> mSyncScopeUsageStamp = 0;
 };
 
 }  // namespace dawn::native
@@ -37,6 +37,96 @@
 
 namespace dawn::native {
 
+namespace {
+
+void FreeBlock(const BlockDef& block) {
+    if (block.pool != nullptr) {
+        block.pool->Deallocate(block.block, block.size);
+    } else {
+        free(block.block);
+    }
+}
+
+}  // anonymous namespace
+
+// CommandBlockPool
+
+CommandBlockPool::CommandBlockPool() = default;
+
+CommandBlockPool::~CommandBlockPool() {
+    for (SizeClass& sizeClass : mSizeClasses) {
+        DAWN_ASSERT(sizeClass.inUseCount == 0);
+        for (uint8_t* block : sizeClass.freeBlocks) {
+            free(block);
+        }
+    }
+}
+
+// static
+size_t CommandBlockPool::GetSizeClass(size_t size) {
+    if (size < detail::kMinCommandBlockSize || size > detail::kMaxCommandBlockSize ||
+        !IsPowerOfTwo(size)) {
+        return kSizeClassCount;
+    }
+    return Log2(uint64_t(size)) - ConstexprLog2(detail::kMinCommandBlockSize);
+}
+
+uint8_t* CommandBlockPool::Allocate(size_t size) {
+    size_t sizeClassIndex = GetSizeClass(size);
+    if (sizeClassIndex != kSizeClassCount) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        SizeClass& sizeClass = mSizeClasses[sizeClassIndex];
+        sizeClass.inUseCount++;
+        sizeClass.highWaterMark = std::max(sizeClass.highWaterMark, sizeClass.inUseCount);
+        if (!sizeClass.freeBlocks.empty()) {
+            uint8_t* block = sizeClass.freeBlocks.back();
+            sizeClass.freeBlocks.pop_back();
+            return block;
+        }
+    }
+
+    mSystemAllocationCount++;
+    uint8_t* block = static_cast<uint8_t*>(malloc(size));
+    if (DAWN_UNLIKELY(block == nullptr) && sizeClassIndex != kSizeClassCount) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mSizeClasses[sizeClassIndex].inUseCount--;
+    }
+    return block;
+}
+
+void CommandBlockPool::Deallocate(uint8_t* block, size_t size) {
+    size_t sizeClassIndex = GetSizeClass(size);
+    if (sizeClassIndex == kSizeClassCount) {
+        free(block);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    SizeClass& sizeClass = mSizeClasses[sizeClassIndex];
+    DAWN_ASSERT(sizeClass.inUseCount > 0);
+    sizeClass.inUseCount--;
+    sizeClass.freeBlocks.push_back(block);
+}
+
+void CommandBlockPool::Trim() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (SizeClass& sizeClass : mSizeClasses) {
+        // Keep enough blocks to get back to the peak usage without allocating.
+        size_t blocksToKeep = sizeClass.highWaterMark - sizeClass.inUseCount;
+        while (sizeClass.freeBlocks.size() > blocksToKeep) {
+            free(sizeClass.freeBlocks.back());
+            sizeClass.freeBlocks.pop_back();
+        }
+        sizeClass.highWaterMark = sizeClass.inUseCount;
+    }
+}
+
+uint64_t CommandBlockPool::GetSystemAllocationCountForTesting() const {
+    return mSystemAllocationCount.load();
+}
+
+// CommandIterator
+
 // TODO(cwallez@chromium.org): figure out a way to have more type safety for the iterator
 
 CommandIterator::CommandIterator() {
@@ -116,7 +206,7 @@ void CommandIterator::MakeEmptyAsDataWasDestroyed() {
     }
 
     for (BlockDef& block : mBlocks) {
-        free(block.block);
+        FreeBlock(block);
     }
     mBlocks.clear();
     Reset();
@@ -137,16 +227,24 @@ bool CommandIterator::IsEmpty() const {
 //  - Better block allocation, maybe have Dawn API to say command buffer is going to have size
 //    close to another
 
+// CommandAllocator
+
 CommandAllocator::CommandAllocator() {
     ResetPointers();
 }
 
+CommandAllocator::CommandAllocator(CommandBlockPool* pool) : mPool(pool) {
+    ResetPointers();
+}
+
 CommandAllocator::~CommandAllocator() {
     Reset();
 }
 
 CommandAllocator::CommandAllocator(CommandAllocator&& other)
-    : mBlocks(std::move(other.mBlocks)), mLastAllocationSize(other.mLastAllocationSize) {
+    : mPool(other.mPool),
+      mBlocks(std::move(other.mBlocks)),
+      mLastAllocationSize(other.mLastAllocationSize) {
     other.mBlocks.clear();
     if (!other.IsEmpty()) {
         mCurrentPtr = other.mCurrentPtr;
@@ -159,6 +257,7 @@ CommandAllocator::CommandAllocator(CommandAllocator&& other)
 
 CommandAllocator& CommandAllocator::operator=(CommandAllocator&& other) {
     Reset();
+    mPool = other.mPool;
     if (!other.IsEmpty()) {
         std::swap(mBlocks, other.mBlocks);
         mLastAllocationSize = other.mLastAllocationSize;
@@ -171,7 +270,7 @@ CommandAllocator& CommandAllocator::operator=(CommandAllocator&& other) {
 
 void CommandAllocator::Reset() {
     for (BlockDef& block : mBlocks) {
-        free(block.block);
+        FreeBlock(block);
     }
     mBlocks.clear();
     mLastAllocationSize = kDefaultBaseAllocationSize;
@@ -218,14 +317,17 @@ uint8_t* CommandAllocator::AllocateInNewBlock(uint32_t commandId,
 
 bool CommandAllocator::GetNewBlock(size_t minimumSize) {
     // Allocate blocks doubling sizes each time, to a maximum of 16k (or at least minimumSize).
-    mLastAllocationSize = std::max(minimumSize, std::min(mLastAllocationSize * 2, size_t(16384)));
+    mLastAllocationSize =
+        std::max(minimumSize, std::min(mLastAllocationSize * 2, detail::kMaxCommandBlockSize));
 
-    uint8_t* block = static_cast<uint8_t*>(malloc(mLastAllocationSize));
+    uint8_t* block = mPool != nullptr
+                         ? mPool->Allocate(mLastAllocationSize)
+                         : static_cast<uint8_t*>(malloc(mLastAllocationSize));
     if (DAWN_UNLIKELY(block == nullptr)) {
         return false;
     }
 
-    mBlocks.push_back({mLastAllocationSize, block});
+    mBlocks.push_back({mLastAllocationSize, block, mPool});
     mCurrentPtr = AlignPtr(block, alignof(uint32_t));
     mEndPtr = block + mLastAllocationSize;
     return true;
@@ -28,9 +28,12 @@
 #ifndef SRC_DAWN_NATIVE_COMMANDALLOCATOR_H_
 #define SRC_DAWN_NATIVE_COMMANDALLOCATOR_H_
 
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <mutex>
 #include <vector>
 
 #include "dawn/common/Assert.h"
@@ -67,20 +70,66 @@ namespace dawn::native {
 // and must tell the CommandIterator when the allocated commands have been processed for
 // deletion.
 
+namespace detail {
+constexpr uint32_t kEndOfBlock = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t kAdditionalData = std::numeric_limits<uint32_t>::max() - 1;
+
+// The sizes of the blocks allocated when a CommandAllocator grows, unless a single command needs
+// a larger block.
+constexpr size_t kMinCommandBlockSize = 4096;
+constexpr size_t kMaxCommandBlockSize = 16384;
+}  // namespace detail
+
+// Blocks are recycled through a per-device CommandBlockPool so that encoding a frame doesn't go
+// to the system allocator every time a CommandAllocator runs out of space, and destroying a
+// command buffer doesn't free all its blocks. Only blocks with the sizes used by the regular
+// growth of CommandAllocator are pooled, blocks sized for a single large command are allocated
+// and freed directly.
+class CommandBlockPool : public NonMovable {
+  public:
+    CommandBlockPool();
+    ~CommandBlockPool();
+
+    uint8_t* Allocate(size_t size);
+    void Deallocate(uint8_t* block, size_t size);
+
+    // Frees the cached blocks that weren't needed to cover the peak number of blocks in use since
+    // the previous call to Trim.
+    void Trim();
+
+    uint64_t GetSystemAllocationCountForTesting() const;
+
+  private:
+    // One size class per power of two between kMinCommandBlockSize and kMaxCommandBlockSize.
+    static constexpr size_t kSizeClassCount = 3;
+    static_assert(detail::kMinCommandBlockSize << (kSizeClassCount - 1) ==
+                  detail::kMaxCommandBlockSize);
+
+    // Returns kSizeClassCount if blocks of this size aren't pooled.
+    static size_t GetSizeClass(size_t size);
+
+    struct SizeClass {
+        std::vector<uint8_t*> freeBlocks;
+        size_t inUseCount = 0;
+        size_t highWaterMark = 0;
+    };
+
+    std::mutex mMutex;
+    std::array<SizeClass, kSizeClassCount> mSizeClasses;
+    std::atomic<uint64_t> mSystemAllocationCount = 0;
+};
+
 // These are the lists of blocks, should not be used directly, only through CommandAllocator
 // and CommandIterator
 struct BlockDef {
     size_t size;
     // TODO(https://crbug.com/dawn/2349): Investigate DanglingUntriaged in dawn/native.
     raw_ptr<uint8_t, AllowPtrArithmetic | DanglingUntriaged> block;
+    // The pool the block must be returned to, or nullptr if it must be freed directly.
+    raw_ptr<CommandBlockPool> pool = nullptr;
 };
 using CommandBlocks = std::vector<BlockDef>;
 
-namespace detail {
-constexpr uint32_t kEndOfBlock = std::numeric_limits<uint32_t>::max();
-constexpr uint32_t kAdditionalData = std::numeric_limits<uint32_t>::max() - 1;
-}  // namespace detail
-
 class CommandAllocator;
 
 class CommandIterator : public NonCopyable {
@@ -166,9 +215,12 @@ class CommandIterator : public NonCopyable {
 class CommandAllocator : public NonCopyable {
   public:
     CommandAllocator();
+    // Blocks are borrowed from |pool|, which must outlive the commands allocated.
+    explicit CommandAllocator(CommandBlockPool* pool);
     ~CommandAllocator();
 
-    // NOTE: A moved-from CommandAllocator is reset to its initial empty state.
+    // NOTE: A moved-from CommandAllocator is reset to its initial empty state, but keeps using the
+    // same CommandBlockPool.
     CommandAllocator(CommandAllocator&&);
     CommandAllocator& operator=(CommandAllocator&&);
 
@@ -216,6 +268,7 @@ class CommandAllocator : public NonCopyable {
 
     // The default value of mLastAllocationSize.
     static constexpr size_t kDefaultBaseAllocationSize = 2048;
+    static_assert(kDefaultBaseAllocationSize * 2 == detail::kMinCommandBlockSize);
 
     friend CommandIterator;
     CommandBlocks&& AcquireBlocks();
@@ -269,6 +322,7 @@ class CommandAllocator : public NonCopyable {
 
     void ResetPointers();
 
+    raw_ptr<CommandBlockPool> mPool = nullptr;
     CommandBlocks mBlocks;
     size_t mLastAllocationSize = kDefaultBaseAllocationSize;
 
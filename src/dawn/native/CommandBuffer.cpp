@@ -43,6 +43,7 @@ CommandBufferBase::CommandBufferBase(CommandEncoder* encoder,
     : ApiObjectBase(encoder->GetDevice(), descriptor->label),
       mCommands(encoder->AcquireCommands()),
       mResourceUsages(encoder->AcquireResourceUsages()),
+      mDeferredIndirectDrawValidations(encoder->AcquireDeferredIndirectDrawValidations()),
       mEncoderLabel(encoder->GetLabel()) {
     GetObjectTrackingList()->Track(this);
 }
@@ -93,12 +94,25 @@ MaybeError CommandBufferBase::ValidateCanUseInSubmitNow() const {
 void CommandBufferBase::DestroyImpl() {
     FreeCommands(&mCommands);
     mResourceUsages = {};
+    mDeferredIndirectDrawValidations.clear();
 }
 
 const CommandBufferResourceUsage& CommandBufferBase::GetResourceUsages() const {
     return mResourceUsages;
 }
 
+const std::vector<DeferredIndirectDrawValidation>&
+CommandBufferBase::GetDeferredIndirectDrawValidations() const {
+    return mDeferredIndirectDrawValidations;
+}
+
+void CommandBufferBase::AddRenderPassIndirectBufferUsage(size_t renderPassIndex,
+                                                         BufferBase* buffer) {
+    RenderPassResourceUsage& usages = mResourceUsages.renderPasses[renderPassIndex];
+    usages.buffers.push_back(buffer);
+    usages.bufferSyncInfos.push_back({wgpu::BufferUsage::Indirect, wgpu::ShaderStage::None});
+}
+
 CommandIterator* CommandBufferBase::GetCommandIteratorForTesting() {
     return &mCommands;
 }
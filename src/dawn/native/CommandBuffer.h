@@ -29,12 +29,14 @@
 #define SRC_DAWN_NATIVE_COMMANDBUFFER_H_
 
 #include <string>
+#include <vector>
 
 #include "dawn/native/dawn_platform.h"
 
 #include "dawn/native/CommandAllocator.h"
 #include "dawn/native/Error.h"
 #include "dawn/native/Forward.h"
+#include "dawn/native/IndirectDrawMetadata.h"
 #include "dawn/native/ObjectBase.h"
 #include "dawn/native/PassResourceUsage.h"
 #include "dawn/native/Texture.h"
@@ -61,6 +63,12 @@ class CommandBufferBase : public ApiObjectBase {
 
     const CommandBufferResourceUsage& GetResourceUsages() const;
 
+    // The render passes whose indirect draws are validated when this command buffer is
+    // submitted, see EncodeDeferredIndirectDrawValidationCommands.
+    const std::vector<DeferredIndirectDrawValidation>& GetDeferredIndirectDrawValidations() const;
+    // Records that the render pass at |renderPassIndex| reads indirect parameters from |buffer|.
+    void AddRenderPassIndirectBufferUsage(size_t renderPassIndex, BufferBase* buffer);
+
     CommandIterator* GetCommandIteratorForTesting();
 
   protected:
@@ -72,6 +80,7 @@ class CommandBufferBase : public ApiObjectBase {
     CommandBufferBase(DeviceBase* device, ObjectBase::ErrorTag tag, const char* label);
 
     CommandBufferResourceUsage mResourceUsages;
+    std::vector<DeferredIndirectDrawValidation> mDeferredIndirectDrawValidations;
 
     std::string mEncoderLabel;
 };
@@ -36,6 +36,8 @@
 #include "absl/container/flat_hash_map.h"
 #include "dawn/common/Assert.h"
 #include "dawn/common/BitSetIterator.h"
+#include "dawn/common/HashUtils.h"
+#include "dawn/common/Range.h"
 #include "dawn/common/StackContainer.h"
 #include "dawn/native/BindGroup.h"
 #include "dawn/native/ComputePassEncoder.h"
@@ -325,6 +327,9 @@ static constexpr CommandBufferStateTracker::ValidationAspects kLazyAspects =
     1 << VALIDATION_ASPECT_BIND_GROUPS | 1 << VALIDATION_ASPECT_VERTEX_BUFFERS |
     1 << VALIDATION_ASPECT_INDEX_BUFFER;
 
+// Upper bound on the number of memoized bind group validations kept by a tracker.
+static constexpr size_t kMaxValidatedBindGroupsCacheSize = 256;
+
 CommandBufferStateTracker::CommandBufferStateTracker() = default;
 
 CommandBufferStateTracker::CommandBufferStateTracker(const CommandBufferStateTracker&) = default;
@@ -520,6 +525,15 @@ void CommandBufferStateTracker::RecomputeLazyAspects(ValidationAspects aspects)
     DAWN_ASSERT(mAspects[VALIDATION_ASPECT_PIPELINE]);
     DAWN_ASSERT((aspects & ~kLazyAspects).none());
 
+    if (aspects[VALIDATION_ASPECT_BIND_GROUPS]) {
+        // Skip the checks below for combinations that were already validated on this encoder.
+        UpdateCurrentBindGroupsKey();
+        if (mValidatedBindGroups.contains(mCurrentBindGroupsKey)) {
+            mAspects.set(VALIDATION_ASPECT_BIND_GROUPS);
+            aspects.reset(VALIDATION_ASPECT_BIND_GROUPS);
+        }
+    }
+
     if (aspects[VALIDATION_ASPECT_BIND_GROUPS]) {
         bool matches = true;
 
@@ -544,6 +558,13 @@ void CommandBufferStateTracker::RecomputeLazyAspects(ValidationAspects aspects)
 
         if (matches) {
             mAspects.set(VALIDATION_ASPECT_BIND_GROUPS);
+
+            // Start over rather than growing without bound when the encoder goes through many
+            // distinct combinations that are unlikely to be reused.
+            if (mValidatedBindGroups.size() >= kMaxValidatedBindGroupsCacheSize) {
+                mValidatedBindGroups.clear();
+            }
+            mValidatedBindGroups.insert(mCurrentBindGroupsKey);
         }
     }
 
@@ -732,6 +753,44 @@ MaybeError CommandBufferStateTracker::CheckMissingAspects(ValidationAspects aspe
     DAWN_UNREACHABLE();
 }
 
+void CommandBufferStateTracker::UpdateCurrentBindGroupsKey() {
+    mCurrentBindGroupsKey.pipeline = mLastPipeline;
+    mCurrentBindGroupsKey.bindGroups.fill(nullptr);
+    mCurrentBindGroupsKey.dynamicOffsets.clear();
+    for (BindGroupIndex i : IterateBitSet(mLastPipelineLayout->GetBindGroupLayoutsMask())) {
+        mCurrentBindGroupsKey.bindGroups[i] = mBindgroups[i];
+        mCurrentBindGroupsKey.dynamicOffsets.insert(mCurrentBindGroupsKey.dynamicOffsets.end(),
+                                                    mDynamicOffsets[i].begin(),
+                                                    mDynamicOffsets[i].end());
+    }
+}
+
+size_t CommandBufferStateTracker::ValidatedBindGroupsKey::HashFunc::operator()(
+    const ValidatedBindGroupsKey& key) const {
+    size_t hash = Hash(key.pipeline);
+    for (const BindGroupBase* bindGroup : key.bindGroups) {
+        HashCombine(&hash, bindGroup);
+    }
+    for (uint32_t offset : key.dynamicOffsets) {
+        HashCombine(&hash, offset);
+    }
+    return hash;
+}
+
+bool CommandBufferStateTracker::ValidatedBindGroupsKey::EqualityFunc::operator()(
+    const ValidatedBindGroupsKey& a,
+    const ValidatedBindGroupsKey& b) const {
+    if (a.pipeline != b.pipeline || a.dynamicOffsets != b.dynamicOffsets) {
+        return false;
+    }
+    for (BindGroupIndex i : Range(kMaxBindGroupsTyped)) {
+        if (a.bindGroups[i] != b.bindGroups[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void CommandBufferStateTracker::SetComputePipeline(ComputePipelineBase* pipeline) {
     SetPipelineCommon(pipeline);
 }
@@ -30,6 +30,7 @@
 
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "dawn/common/Constants.h"
 #include "dawn/common/ityp_array.h"
 #include "dawn/common/ityp_bitset.h"
@@ -91,6 +92,28 @@ class CommandBufferStateTracker {
 
     void SetPipelineCommon(PipelineBase* pipeline);
 
+    // Identifies a combination of pipeline, bind groups and dynamic offsets for which
+    // VALIDATION_ASPECT_BIND_GROUPS was already computed successfully. The pipeline is part of the
+    // key because the minimum buffer binding sizes are per-pipeline. Pointers are safe to use as
+    // identities because the encoder keeps a reference on every pipeline and bind group it records
+    // for at least as long as this tracker is alive.
+    struct ValidatedBindGroupsKey {
+        const PipelineBase* pipeline = nullptr;
+        PerBindGroup<const BindGroupBase*> bindGroups = {};
+        // The dynamic offsets of all the bind groups in the layout, concatenated in group order.
+        std::vector<uint32_t> dynamicOffsets;
+
+        struct HashFunc {
+            size_t operator()(const ValidatedBindGroupsKey& key) const;
+        };
+
+        struct EqualityFunc {
+            bool operator()(const ValidatedBindGroupsKey& a, const ValidatedBindGroupsKey& b) const;
+        };
+    };
+    // Fills mCurrentBindGroupsKey with the current pipeline and bindings.
+    void UpdateCurrentBindGroupsKey();
+
     ValidationAspects mAspects;
 
     PerBindGroup<BindGroupBase*> mBindgroups = {};
@@ -110,6 +133,16 @@ class CommandBufferStateTracker {
 
     // TODO(https://crbug.com/dawn/2349): Investigate DanglingUntriaged in dawn/native.
     raw_ptr<const RequiredBufferSizes, DanglingUntriaged> mMinBufferSizes = nullptr;
+
+    // Memoizes the bind group validation so that draws and dispatches alternating between a small
+    // set of bind groups (for example one per material) don't redo the layout, buffer size and
+    // aliasing checks every time. Only successful validations are recorded. mCurrentBindGroupsKey
+    // is kept as a member to reuse the allocation of its dynamic offsets across lookups.
+    absl::flat_hash_set<ValidatedBindGroupsKey,
+                        ValidatedBindGroupsKey::HashFunc,
+                        ValidatedBindGroupsKey::EqualityFunc>
+        mValidatedBindGroups;
+    ValidatedBindGroupsKey mCurrentBindGroupsKey;
 };
 
 }  // namespace dawn::native
@@ -979,6 +979,37 @@ CommandBufferResourceUsage CommandEncoder::AcquireResourceUsages() {
         std::move(mTopLevelBuffers), std::move(mTopLevelTextures), std::move(mUsedQuerySets)};
 }
 
+std::vector<DeferredIndirectDrawValidation>
+CommandEncoder::AcquireDeferredIndirectDrawValidations() {
+    return mEncodingContext.AcquireDeferredIndirectDrawValidations();
+}
+
+bool CommandEncoder::MayHaveEncodedWriteTo(const BufferBase* buffer) const {
+    if (IsSubset(buffer->GetUsage(), kReadOnlyBufferUsages)) {
+        return false;
+    }
+
+    // Copies and compute passes don't record how each buffer is used, so any use is treated as a
+    // potential write.
+    if (mTopLevelBuffers.contains(buffer)) {
+        return true;
+    }
+    for (const ComputePassResourceUsage& pass : mEncodingContext.GetComputePassUsages()) {
+        if (pass.referencedBuffers.contains(buffer)) {
+            return true;
+        }
+    }
+    for (const RenderPassResourceUsage& pass : mEncodingContext.GetRenderPassUsages()) {
+        for (size_t i = 0; i < pass.buffers.size(); ++i) {
+            if (pass.buffers[i] == buffer &&
+                !IsSubset(pass.bufferSyncInfos[i].usage, kReadOnlyBufferUsages)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 CommandIterator CommandEncoder::AcquireCommands() {
     return mEncodingContext.AcquireCommands();
 }
@@ -1001,15 +1032,14 @@ void CommandEncoder::TrackQueryAvailability(QuerySetBase* querySet, uint32_t que
 // Implementation of the API's command recording methods
 
 ComputePassEncoder* CommandEncoder::APIBeginComputePass(const ComputePassDescriptor* descriptor) {
-    // This function will create new object, need to lock the Device.
-    auto deviceLock(GetDevice()->GetScopedLock());
-
+    // Beginning a compute pass only records into this encoder and creates the pass encoder, which
+    // is tracked by the device's thread-safe object list, so the device doesn't need to be locked.
+    // Errors reported immediately are handled by EncodingContext::HandleError under the lock.
     return ReturnToAPI(BeginComputePass(descriptor));
 }
 
 Ref<ComputePassEncoder> CommandEncoder::BeginComputePass(const ComputePassDescriptor* descriptor) {
     DeviceBase* device = GetDevice();
-    DAWN_ASSERT(device->IsLockedByCurrentThreadIfNeeded());
 
     bool success = mEncodingContext.TryEncode(
         this,
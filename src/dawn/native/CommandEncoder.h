@@ -29,6 +29,7 @@
 #define SRC_DAWN_NATIVE_COMMANDENCODER_H_
 
 #include <string>
+#include <vector>
 
 #include "dawn/native/dawn_platform.h"
 #include "partition_alloc/pointers/raw_ptr.h"
@@ -59,6 +60,10 @@ class CommandEncoder final : public ApiObjectBase {
 
     CommandIterator AcquireCommands();
     CommandBufferResourceUsage AcquireResourceUsages();
+    std::vector<DeferredIndirectDrawValidation> AcquireDeferredIndirectDrawValidations();
+
+    // Returns whether the commands encoded so far may write to |buffer|.
+    bool MayHaveEncodedWriteTo(const BufferBase* buffer) const;
 
     void TrackUsedQuerySet(QuerySetBase* querySet);
     void TrackQueryAvailability(QuerySetBase* querySet, uint32_t queryIndex);
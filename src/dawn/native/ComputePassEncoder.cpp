@@ -168,6 +168,8 @@ ObjectType ComputePassEncoder::GetType() const {
 
 void ComputePassEncoder::APIEnd() {
     if (mEnded && IsValidationEnabled()) {
+        // Pass encoders are not locked by default, but reporting the error modifies the device.
+        auto deviceLock(GetDevice()->GetScopedLock());
         GetDevice()->HandleError(DAWN_VALIDATION_ERROR("%s was already ended.", this));
         return;
     }
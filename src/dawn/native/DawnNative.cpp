@@ -223,6 +223,15 @@ size_t GetLazyClearCountForTesting(WGPUDevice device) {
     return FromAPI(device)->GetLazyClearCountForTesting();
 }
 
+uint64_t GetCommandBlockAllocationCountForTesting(WGPUDevice device) {
+    return FromAPI(device)->GetCommandBlockPool()->GetSystemAllocationCountForTesting();
+}
+
+void SetMaxRenderPassRecordingChunksForTesting(WGPUDevice device, uint32_t maxChunks) {
+    auto deviceLock(FromAPI(device)->GetScopedLock());
+    FromAPI(device)->SetMaxRenderPassRecordingChunksForTesting(maxChunks);
+}
+
 size_t GetDeprecationWarningCountForTesting(WGPUDevice device) {
     return FromAPI(device)->GetDeprecationWarningCountForTesting();
 }
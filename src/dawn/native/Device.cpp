@@ -1394,6 +1394,7 @@ MaybeError DeviceBase::Tick() {
     // reclaiming resources one tick earlier.
     mDynamicUploader->Deallocate(mQueue->GetCompletedCommandSerial());
     mQueue->Tick(mQueue->GetCompletedCommandSerial());
+    mCommandBlockPool.Trim();
 
     return {};
 }
@@ -1541,6 +1542,8 @@ size_t DeviceBase::GetDeprecationWarningCountForTesting() {
     return mDeprecationWarnings->count;
 }
 
+void DeviceBase::SetMaxRenderPassRecordingChunksForTesting(uint32_t maxChunks) {}
+
 void DeviceBase::EmitDeprecationWarning(const std::string& message) {
     mDeprecationWarnings->count++;
     if (mDeprecationWarnings->emitted.insert(message).second) {
@@ -2014,6 +2017,10 @@ DynamicUploader* DeviceBase::GetDynamicUploader() const {
     return mDynamicUploader.get();
 }
 
+CommandBlockPool* DeviceBase::GetCommandBlockPool() {
+    return &mCommandBlockPool;
+}
+
 // The Toggle device facility
 
 std::vector<const char*> DeviceBase::GetTogglesUsed() const {
@@ -37,6 +37,7 @@
 #include "dawn/common/ContentLessObjectCache.h"
 #include "dawn/common/Mutex.h"
 #include "dawn/native/CacheKey.h"
+#include "dawn/native/CommandAllocator.h"
 #include "dawn/native/Commands.h"
 #include "dawn/native/ComputePipeline.h"
 #include "dawn/native/Error.h"
@@ -347,6 +348,7 @@ class DeviceBase : public RefCountedWithExternalCount {
                                         const Extent3D& copySizePixels);
 
     DynamicUploader* GetDynamicUploader() const;
+    CommandBlockPool* GetCommandBlockPool();
 
     // The device state which is a combination of creation state and loss state.
     //
@@ -383,6 +385,9 @@ class DeviceBase : public RefCountedWithExternalCount {
     size_t GetLazyClearCountForTesting();
     void IncrementLazyClearCountForTesting();
     size_t GetDeprecationWarningCountForTesting();
+    // Limits the number of chunks render passes are split in to be recorded in parallel. Does
+    // nothing on backends that don't record render passes in parallel.
+    virtual void SetMaxRenderPassRecordingChunksForTesting(uint32_t maxChunks);
     void EmitDeprecationWarning(const std::string& warning);
     void EmitWarningOnce(const std::string& message);
     void EmitLog(const char* message);
@@ -565,6 +570,12 @@ class DeviceBase : public RefCountedWithExternalCount {
                                                     const TextureCopy& dst,
                                                     const Extent3D& copySizePixels) = 0;
 
+    // Must stay the first data member of DeviceBase: members are destroyed in reverse order and
+    // backend devices' members before DeviceBase's, so this makes the pool outlive everything the
+    // device owns that might still hold commands (render bundles in mCaches, the internal
+    // pipeline store, the queue, ...). ~CommandBlockPool asserts that no block is still in use.
+    CommandBlockPool mCommandBlockPool;
+
     wgpu::ErrorCallback mUncapturedErrorCallback = nullptr;
     // TODO(https://crbug.com/dawn/2349): Investigate DanglingUntriaged in dawn/native.
     raw_ptr<void, DanglingUntriaged> mUncapturedErrorUserdata = nullptr;
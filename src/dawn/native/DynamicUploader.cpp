@@ -27,18 +27,29 @@
 
 #include "dawn/native/DynamicUploader.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "dawn/common/Math.h"
 #include "dawn/native/Buffer.h"
 #include "dawn/native/Device.h"
 #include "dawn/native/Queue.h"
+#include "dawn/platform/DawnPlatform.h"
+#include "dawn/platform/tracing/TraceEvent.h"
 
 namespace dawn::native {
 
 DynamicUploader::DynamicUploader(DeviceBase* device) : mDevice(device) {
-    mRingBuffers.emplace_back(
-        std::unique_ptr<RingBuffer>(new RingBuffer{nullptr, RingBufferAllocator(kRingBufferSize)}));
+    mRingBuffers.emplace_back(std::unique_ptr<RingBuffer>(
+        new RingBuffer{nullptr, RingBufferAllocator(kMinRingBufferSize)}));
+}
+
+// static
+uint64_t DynamicUploader::GetStagingBufferSizeClass(uint64_t size) {
+    DAWN_ASSERT(size > 0);
+    size = Align(size, 4);
+    uint64_t step = std::max(NextPowerOfTwo(size) / 16, uint64_t(4));
+    return Align(size, step);
 }
 
 void DynamicUploader::ReleaseStagingBuffer(Ref<BufferBase> stagingBuffer) {
@@ -46,29 +57,79 @@ void DynamicUploader::ReleaseStagingBuffer(Ref<BufferBase> stagingBuffer) {
                                     mDevice->GetQueue()->GetPendingCommandSerial());
 }
 
-ResultOrError<UploadHandle> DynamicUploader::AllocateInternal(uint64_t allocationSize,
-                                                              ExecutionSerial serial,
-                                                              uint64_t offsetAlignment) {
-    // Disable further sub-allocation should the request be too large.
-    if (allocationSize > kRingBufferSize) {
-        BufferDescriptor bufferDesc = {};
-        bufferDesc.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::MapWrite;
-        bufferDesc.size = Align(allocationSize, 4);
-        bufferDesc.mappedAtCreation = true;
-        bufferDesc.label = "Dawn_DynamicUploaderStaging";
+ResultOrError<Ref<BufferBase>> DynamicUploader::CreateStagingBuffer(uint64_t size) {
+    BufferDescriptor bufferDesc = {};
+    bufferDesc.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::MapWrite;
+    bufferDesc.size = Align(size, 4);
+    bufferDesc.mappedAtCreation = true;
+    bufferDesc.label = "Dawn_DynamicUploaderStaging";
+
+    IgnoreLazyClearCountScope scope(mDevice);
+    Ref<BufferBase> stagingBuffer;
+    DAWN_TRY_ASSIGN(stagingBuffer, mDevice->CreateBuffer(&bufferDesc));
+    mFrameStats.stagingBuffersCreated++;
+    return stagingBuffer;
+}
+
+uint64_t DynamicUploader::GetNextRingBufferSize(uint64_t allocationSize) const {
+    // Grow geometrically from the largest ring buffer, which is always the last one, so that
+    // workloads uploading a lot of data every frame quickly end up needing a single ring buffer.
+    uint64_t size = std::max(mRingBuffers.back()->mAllocator.GetSize() * 2,
+                             NextPowerOfTwo(allocationSize));
+    return std::clamp(size, kMinRingBufferSize, kMaxRingBufferSize);
+}
+
+ResultOrError<UploadHandle> DynamicUploader::AllocateDedicated(uint64_t allocationSize,
+                                                               ExecutionSerial serial) {
+    uint64_t sizeClass = GetStagingBufferSizeClass(allocationSize);
 
-        IgnoreLazyClearCountScope scope(mDevice);
-        Ref<BufferBase> stagingBuffer;
-        DAWN_TRY_ASSIGN(stagingBuffer, mDevice->CreateBuffer(&bufferDesc));
+    Ref<BufferBase> stagingBuffer;
+    if (sizeClass > mDevice->GetLimits().v1.maxBufferSize) {
+        // Rounding up to the size class would exceed the device's maxBufferSize, which is
+        // usually not a power of two. Use an exactly sized staging buffer that isn't pooled.
+        DAWN_TRY_ASSIGN(stagingBuffer, CreateStagingBuffer(allocationSize));
+        mFrameStats.dedicatedUploadSize += allocationSize;
 
         UploadHandle uploadHandle;
         uploadHandle.mappedBuffer = static_cast<uint8_t*>(stagingBuffer->GetMappedPointer());
         uploadHandle.stagingBuffer = stagingBuffer.Get();
 
-        ReleaseStagingBuffer(std::move(stagingBuffer));
+        mReleasedStagingBuffers.Enqueue(std::move(stagingBuffer), serial);
         return uploadHandle;
     }
 
+    auto it = mFreeStagingBuffers.find(sizeClass);
+    if (it != mFreeStagingBuffers.end()) {
+        DAWN_ASSERT(!it->second.empty());
+        stagingBuffer = std::move(it->second.back());
+        it->second.pop_back();
+        if (it->second.empty()) {
+            mFreeStagingBuffers.erase(it);
+        }
+        mFreeStagingBuffersSize -= sizeClass;
+        mFrameStats.pooledStagingBuffersReused++;
+    } else {
+        DAWN_TRY_ASSIGN(stagingBuffer, CreateStagingBuffer(sizeClass));
+    }
+    DAWN_ASSERT(stagingBuffer->GetSize() == sizeClass);
+    mFrameStats.dedicatedUploadSize += allocationSize;
+
+    UploadHandle uploadHandle;
+    uploadHandle.mappedBuffer = static_cast<uint8_t*>(stagingBuffer->GetMappedPointer());
+    uploadHandle.stagingBuffer = stagingBuffer.Get();
+
+    mInFlightPooledStagingBuffers.Enqueue(std::move(stagingBuffer), serial);
+    return uploadHandle;
+}
+
+ResultOrError<UploadHandle> DynamicUploader::AllocateInternal(uint64_t allocationSize,
+                                                              ExecutionSerial serial,
+                                                              uint64_t offsetAlignment) {
+    // Disable further sub-allocation should the request be too large.
+    if (allocationSize > kMaxRingSubAllocationSize) {
+        return AllocateDedicated(allocationSize, serial);
+    }
+
     // Note: Validation ensures size is already aligned.
     // First-fit: find next buffer large enough to satisfy the allocation request.
     uint64_t startOffset = RingBufferAllocator::kInvalidOffset;
@@ -87,8 +148,9 @@ ResultOrError<UploadHandle> DynamicUploader::AllocateInternal(uint64_t allocatio
     // Upon failure, append a newly created ring buffer to fulfill the
     // request.
     if (startOffset == RingBufferAllocator::kInvalidOffset) {
+        uint64_t ringBufferSize = GetNextRingBufferSize(allocationSize);
         mRingBuffers.emplace_back(std::unique_ptr<RingBuffer>(
-            new RingBuffer{nullptr, RingBufferAllocator(kRingBufferSize)}));
+            new RingBuffer{nullptr, RingBufferAllocator(ringBufferSize)}));
 
         targetRingBuffer = mRingBuffers.back().get();
         startOffset = targetRingBuffer->mAllocator.Allocate(allocationSize, serial);
@@ -99,19 +161,12 @@ ResultOrError<UploadHandle> DynamicUploader::AllocateInternal(uint64_t allocatio
     // Allocate the staging buffer backing the ringbuffer.
     // Note: the first ringbuffer will be lazily created.
     if (targetRingBuffer->mStagingBuffer == nullptr) {
-        BufferDescriptor bufferDesc = {};
-        bufferDesc.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::MapWrite;
-        bufferDesc.size = Align(targetRingBuffer->mAllocator.GetSize(), 4);
-        bufferDesc.mappedAtCreation = true;
-        bufferDesc.label = "Dawn_DynamicUploaderStaging";
-
-        IgnoreLazyClearCountScope scope(mDevice);
-        Ref<BufferBase> stagingBuffer;
-        DAWN_TRY_ASSIGN(stagingBuffer, mDevice->CreateBuffer(&bufferDesc));
-        targetRingBuffer->mStagingBuffer = std::move(stagingBuffer);
+        DAWN_TRY_ASSIGN(targetRingBuffer->mStagingBuffer,
+                        CreateStagingBuffer(targetRingBuffer->mAllocator.GetSize()));
     }
 
     DAWN_ASSERT(targetRingBuffer->mStagingBuffer != nullptr);
+    mFrameStats.ringUploadSize += allocationSize;
 
     UploadHandle uploadHandle;
     uploadHandle.stagingBuffer = targetRingBuffer->mStagingBuffer.Get();
@@ -135,6 +190,40 @@ void DynamicUploader::Deallocate(ExecutionSerial lastCompletedSerial) {
         }
     }
     mReleasedStagingBuffers.ClearUpTo(lastCompletedSerial);
+
+    // Return the dedicated staging buffers that are no longer in use to the pool, or destroy them
+    // if the pool is already full.
+    for (Ref<BufferBase>& stagingBuffer :
+         mInFlightPooledStagingBuffers.IterateUpTo(lastCompletedSerial)) {
+        uint64_t sizeClass = stagingBuffer->GetSize();
+        if (mFreeStagingBuffersSize + sizeClass > kMaxPooledStagingBufferSize) {
+            continue;
+        }
+        mFreeStagingBuffersSize += sizeClass;
+        mFreeStagingBuffers[sizeClass].push_back(std::move(stagingBuffer));
+    }
+    mInFlightPooledStagingBuffers.ClearUpTo(lastCompletedSerial);
+
+    ReportAndResetFrameStats();
+}
+
+void DynamicUploader::ReportAndResetFrameStats() {
+    if (mFrameStats.ringUploadSize == 0 && mFrameStats.dedicatedUploadSize == 0) {
+        return;
+    }
+
+    // Counters are 32-bit so sizes are reported in KiB.
+    dawn::platform::Platform* platform = mDevice->GetPlatform();
+    TRACE_COUNTER2(platform, General, "DynamicUploader::UploadSizeKiB", "ring",
+                   mFrameStats.ringUploadSize / 1024, "dedicated",
+                   mFrameStats.dedicatedUploadSize / 1024);
+    TRACE_COUNTER2(platform, General, "DynamicUploader::StagingBuffers", "created",
+                   mFrameStats.stagingBuffersCreated, "reused",
+                   mFrameStats.pooledStagingBuffersReused);
+    TRACE_COUNTER2(platform, General, "DynamicUploader::AllocatedSizeKiB", "total",
+                   GetTotalAllocatedSize() / 1024, "pooled", mFreeStagingBuffersSize / 1024);
+
+    mFrameStats = {};
 }
 
 ResultOrError<UploadHandle> DynamicUploader::Allocate(uint64_t allocationSize,
@@ -156,6 +245,9 @@ uint64_t DynamicUploader::GetTotalAllocatedSize() {
     for (const auto& buffer : mReleasedStagingBuffers.IterateAll()) {
         size += buffer->GetSize();
     }
+    for (const auto& buffer : mInFlightPooledStagingBuffers.IterateAll()) {
+        size += buffer->GetSize();
+    }
     for (const auto& buffer : mRingBuffers) {
         if (buffer->mStagingBuffer != nullptr) {
             size += buffer->mStagingBuffer->GetSize();
@@ -28,6 +28,7 @@
 #ifndef SRC_DAWN_NATIVE_DYNAMICUPLOADER_H_
 #define SRC_DAWN_NATIVE_DYNAMICUPLOADER_H_
 
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -68,8 +69,21 @@ class DynamicUploader {
 
     bool ShouldFlush();
 
+    // Rounds |size| up to the size class used to pool dedicated staging buffers. Size classes are
+    // spaced 8 per power of two so that reused buffers waste at most 12.5% of their size.
+    static uint64_t GetStagingBufferSizeClass(uint64_t size);
+
   private:
-    static constexpr uint64_t kRingBufferSize = 4 * 1024 * 1024;
+    // Ring buffers start at kMinRingBufferSize and double each time all of them are exhausted, up
+    // to kMaxRingBufferSize. Requests larger than kMaxRingSubAllocationSize don't use the rings
+    // and instead get a dedicated staging buffer which is recycled through a pool after use,
+    // unless its size class exceeds the device's maxBufferSize.
+    static constexpr uint64_t kMinRingBufferSize = 4 * 1024 * 1024;
+    static constexpr uint64_t kMaxRingBufferSize = 32 * 1024 * 1024;
+    static constexpr uint64_t kMaxRingSubAllocationSize = kMaxRingBufferSize / 4;
+    // Free dedicated staging buffers are destroyed instead of pooled past this total size.
+    static constexpr uint64_t kMaxPooledStagingBufferSize = 128 * 1024 * 1024;
+
     uint64_t GetTotalAllocatedSize();
 
     struct RingBuffer {
@@ -77,12 +91,34 @@ class DynamicUploader {
         RingBufferAllocator mAllocator;
     };
 
+    // Upload statistics accumulated between two calls to Deallocate and reported with trace
+    // counters.
+    struct FrameStats {
+        uint64_t ringUploadSize = 0;
+        uint64_t dedicatedUploadSize = 0;
+        uint32_t stagingBuffersCreated = 0;
+        uint32_t pooledStagingBuffersReused = 0;
+    };
+
     ResultOrError<UploadHandle> AllocateInternal(uint64_t allocationSize,
                                                  ExecutionSerial serial,
                                                  uint64_t offsetAlignment);
+    ResultOrError<UploadHandle> AllocateDedicated(uint64_t allocationSize,
+                                                  ExecutionSerial serial);
+    ResultOrError<Ref<BufferBase>> CreateStagingBuffer(uint64_t size);
+    uint64_t GetNextRingBufferSize(uint64_t allocationSize) const;
+    void ReportAndResetFrameStats();
 
     std::vector<std::unique_ptr<RingBuffer>> mRingBuffers;
     SerialQueue<ExecutionSerial, Ref<BufferBase>> mReleasedStagingBuffers;
+
+    // Dedicated staging buffers that are in flight, and the free ones keyed by size class. They
+    // are created mapped and stay mapped for their whole lifetime like the ring buffers.
+    SerialQueue<ExecutionSerial, Ref<BufferBase>> mInFlightPooledStagingBuffers;
+    std::map<uint64_t, std::vector<Ref<BufferBase>>> mFreeStagingBuffers;
+    uint64_t mFreeStagingBuffersSize = 0;
+
+    FrameStats mFrameStats;
     raw_ptr<DeviceBase> mDevice;
 };
 }  // namespace dawn::native
@@ -41,6 +41,7 @@ EncodingContext::EncodingContext(DeviceBase* device, const ApiObjectBase* initia
     : mDevice(device),
       mTopLevelEncoder(initialEncoder),
       mCurrentEncoder(initialEncoder),
+      mPendingCommands(device->GetCommandBlockPool()),
       mDestroyed(device->IsLost()) {}
 
 EncodingContext::~EncodingContext() {
@@ -61,6 +62,7 @@ void EncodingContext::Destroy() {
     }
     mDestroyed = true;
     mCurrentEncoder = nullptr;
+    mDeferredIndirectDrawValidations.clear();
 }
 
 CommandIterator EncodingContext::AcquireCommands() {
@@ -99,6 +101,8 @@ void EncodingContext::HandleError(std::unique_ptr<ErrorData> error) {
         if (mError == nullptr) {
             mError = std::move(error);
         }
+    } else if (mHoldsDeviceLock) {
+        mDevice->HandleError(std::move(error));
     } else {
         // EncodingContext is unprotected from multiple threads by default, but this code will
         // modify Device's internal states so we need to lock the device now.
@@ -107,6 +111,16 @@ void EncodingContext::HandleError(std::unique_ptr<ErrorData> error) {
     }
 }
 
+EncodingContext::ScopedDeviceLock::ScopedDeviceLock(EncodingContext* context)
+    : mContext(context), mLock(context->mDevice->GetScopedLock()) {
+    DAWN_ASSERT(!mContext->mHoldsDeviceLock);
+    mContext->mHoldsDeviceLock = true;
+}
+
+EncodingContext::ScopedDeviceLock::~ScopedDeviceLock() {
+    mContext->mHoldsDeviceLock = false;
+}
+
 void EncodingContext::WillBeginRenderPass() {
     DAWN_ASSERT(mCurrentEncoder == mTopLevelEncoder);
     if (mDevice->IsValidationEnabled() || mDevice->MayRequireDuplicationOfIndirectParameters()) {
@@ -137,7 +151,13 @@ MaybeError EncodingContext::ExitRenderPass(const ApiObjectBase* passEncoder,
 
     mCurrentEncoder = mTopLevelEncoder;
 
-    if (mDevice->IsValidationEnabled() || mDevice->MayRequireDuplicationOfIndirectParameters()) {
+    if (CanDeferIndirectDrawValidation(commandEncoder, indirectDrawMetadata)) {
+        // The validation commands will be encoded by Queue::Submit in a command buffer submitted
+        // before this one, see EncodeDeferredIndirectDrawValidationCommands.
+        mDeferredIndirectDrawValidations.push_back(
+            {std::move(indirectDrawMetadata), mRenderPassUsages.size()});
+    } else if (mDevice->IsValidationEnabled() ||
+               mDevice->MayRequireDuplicationOfIndirectParameters()) {
         // With validation enabled, commands were committed just before BeginRenderPassCmd was
         // encoded by our RenderPassEncoder (see WillBeginRenderPass above). This means
         // mPendingCommands contains only the commands from BeginRenderPassCmd to
@@ -147,18 +167,14 @@ MaybeError EncodingContext::ExitRenderPass(const ApiObjectBase* passEncoder,
         //       so swap back the renderCommands to ensure that they are not leaked.
         CommandAllocator renderCommands = std::move(mPendingCommands);
 
-        // The below function might create new resources. Device must already be locked via
-        // renderpassEncoder's APIEnd().
+        // The below function might create new resources if there are indirect draws to validate.
+        // Device must already be locked via renderpassEncoder's APIEnd() in that case.
         // TODO(crbug.com/dawn/1618): In future, all temp resources should be created at
         // Command Submit time, so the locking would be removed from here at that point.
-        {
-            DAWN_ASSERT(mDevice->IsLockedByCurrentThreadIfNeeded());
-
-            DAWN_TRY_WITH_CLEANUP(
-                EncodeIndirectDrawValidationCommands(mDevice, commandEncoder, &usageTracker,
-                                                     &indirectDrawMetadata),
-                { mPendingCommands = std::move(renderCommands); });
-        }
+        DAWN_TRY_WITH_CLEANUP(
+            EncodeIndirectDrawValidationCommands(mDevice, commandEncoder, &usageTracker,
+                                                 &indirectDrawMetadata),
+            { mPendingCommands = std::move(renderCommands); });
 
         CommitCommands(std::move(mPendingCommands));
         CommitCommands(std::move(renderCommands));
@@ -208,6 +224,37 @@ ComputePassUsages EncodingContext::AcquireComputePassUsages() {
     return std::move(mComputePassUsages);
 }
 
+std::vector<DeferredIndirectDrawValidation>
+EncodingContext::AcquireDeferredIndirectDrawValidations() {
+    return std::move(mDeferredIndirectDrawValidations);
+}
+
+bool EncodingContext::CanDeferIndirectDrawValidation(
+    const CommandEncoder* commandEncoder,
+    const IndirectDrawMetadata& indirectDrawMetadata) const {
+    if (!mDevice->IsToggleEnabled(Toggle::BatchIndirectDrawValidationAtSubmit) ||
+        !(mDevice->IsValidationEnabled() || mDevice->MayRequireDuplicationOfIndirectParameters())) {
+        return false;
+    }
+
+    // Draw commands of render bundles are shared by all the render passes executing the bundle,
+    // so they must be updated by validation encoded right before each of these render passes.
+    const IndirectDrawMetadata::IndexedIndirectBufferValidationInfoMap& validationInfo =
+        *indirectDrawMetadata.GetIndexedIndirectBufferValidationInfo();
+    if (validationInfo.empty() || indirectDrawMetadata.HasRenderBundles()) {
+        return false;
+    }
+
+    // Validation at submit time reads the indirect buffers before any of the commands of this
+    // command buffer executes.
+    for (const auto& [config, _] : validationInfo) {
+        if (commandEncoder->MayHaveEncodedWriteTo(config.inputIndirectBuffer.get())) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void EncodingContext::PushDebugGroupLabel(const char* groupLabel) {
     mDebugGroupLabels.emplace_back(groupLabel);
 }
@@ -33,6 +33,8 @@
 #include <utility>
 #include <vector>
 
+#include "dawn/common/Mutex.h"
+#include "dawn/common/NonCopyable.h"
 #include "dawn/native/CommandAllocator.h"
 #include "dawn/native/Error.h"
 #include "dawn/native/ErrorData.h"
@@ -62,7 +64,20 @@ class EncodingContext {
     CommandIterator AcquireCommands();
     CommandIterator* GetIterator();
 
-    // Functions to handle encoder errors
+    // Locks the device for encoding work that might create device objects. While it is alive,
+    // errors reported immediately by HandleError reuse this lock instead of taking it again.
+    class ScopedDeviceLock : NonMovable {
+      public:
+        explicit ScopedDeviceLock(EncodingContext* context);
+        ~ScopedDeviceLock();
+
+      private:
+        raw_ptr<EncodingContext> mContext;
+        Mutex::AutoLock mLock;
+    };
+
+    // Functions to handle encoder errors. Errors that are reported to the device immediately
+    // lock it unless a ScopedDeviceLock is held, so encoders don't need the device to be locked.
     void HandleError(std::unique_ptr<ErrorData> error);
 
     inline bool ConsumedError(MaybeError maybeError) {
@@ -165,6 +180,7 @@ class EncodingContext {
     const ComputePassUsages& GetComputePassUsages() const;
     RenderPassUsages AcquireRenderPassUsages();
     ComputePassUsages AcquireComputePassUsages();
+    std::vector<DeferredIndirectDrawValidation> AcquireDeferredIndirectDrawValidations();
 
     void PushDebugGroupLabel(const char* groupLabel);
     void PopDebugGroupLabel();
@@ -175,6 +191,10 @@ class EncodingContext {
     bool IsFinished() const;
     void MoveToIterator();
 
+    // Whether the indirect draw validation of a render pass can be encoded at Queue::Submit time.
+    bool CanDeferIndirectDrawValidation(const CommandEncoder* commandEncoder,
+                                        const IndirectDrawMetadata& indirectDrawMetadata) const;
+
     raw_ptr<DeviceBase> mDevice;
 
     // There can only be two levels of encoders. Top-level and render/compute pass.
@@ -191,6 +211,7 @@ class EncodingContext {
     bool mWereRenderPassUsagesAcquired = false;
     ComputePassUsages mComputePassUsages;
     bool mWereComputePassUsagesAcquired = false;
+    std::vector<DeferredIndirectDrawValidation> mDeferredIndirectDrawValidations;
 
     CommandAllocator mPendingCommands;
 
@@ -199,6 +220,7 @@ class EncodingContext {
     bool mWasMovedToIterator = false;
     bool mWereCommandsAcquired = false;
     bool mDestroyed = false;
+    bool mHoldsDeviceLock = false;
 
     std::unique_ptr<ErrorData> mError;
     std::vector<std::string> mDebugGroupLabels;
@@ -148,14 +148,31 @@ IndirectDrawMetadata::GetIndexedIndirectBufferValidationInfo() {
     return &mIndexedIndirectBufferValidationInfo;
 }
 
+const IndirectDrawMetadata::IndexedIndirectBufferValidationInfoMap*
+IndirectDrawMetadata::GetIndexedIndirectBufferValidationInfo() const {
+    return &mIndexedIndirectBufferValidationInfo;
+}
+
 void IndirectDrawMetadata::AddBundle(RenderBundleBase* bundle) {
     auto [_, inserted] = mAddedBundles.insert(bundle);
     if (!inserted) {
         return;
     }
 
-    for (const auto& [config, validationInfo] :
-         bundle->GetIndirectDrawMetadata().mIndexedIndirectBufferValidationInfo) {
+    AddValidationInfo(bundle->GetIndirectDrawMetadata().mIndexedIndirectBufferValidationInfo);
+}
+
+void IndirectDrawMetadata::AddMetadata(const IndirectDrawMetadata& other) {
+    AddValidationInfo(other.mIndexedIndirectBufferValidationInfo);
+}
+
+bool IndirectDrawMetadata::HasRenderBundles() const {
+    return !mAddedBundles.empty();
+}
+
+void IndirectDrawMetadata::AddValidationInfo(
+    const IndexedIndirectBufferValidationInfoMap& validationInfoMap) {
+    for (const auto& [config, validationInfo] : validationInfoMap) {
         auto it = mIndexedIndirectBufferValidationInfo.lower_bound(config);
         if (it != mIndexedIndirectBufferValidationInfo.end() && it->first == config) {
             // We already have batches for the same config. Merge the new ones in.
@@ -132,8 +132,13 @@ class IndirectDrawMetadata : public NonCopyable {
     IndirectDrawMetadata& operator=(IndirectDrawMetadata&&);
 
     IndexedIndirectBufferValidationInfoMap* GetIndexedIndirectBufferValidationInfo();
+    const IndexedIndirectBufferValidationInfoMap* GetIndexedIndirectBufferValidationInfo() const;
 
     void AddBundle(RenderBundleBase* bundle);
+    // Adds the draws of |other|, for example to validate those of several render passes at once.
+    void AddMetadata(const IndirectDrawMetadata& other);
+    bool HasRenderBundles() const;
+
     void AddIndexedIndirectDraw(wgpu::IndexFormat indexFormat,
                                 uint64_t indexBufferSize,
                                 BufferBase* indirectBuffer,
@@ -147,6 +152,8 @@ class IndirectDrawMetadata : public NonCopyable {
                          DrawIndirectCmd* cmd);
 
   private:
+    void AddValidationInfo(const IndexedIndirectBufferValidationInfoMap& validationInfoMap);
+
     IndexedIndirectBufferValidationInfoMap mIndexedIndirectBufferValidationInfo;
     absl::flat_hash_set<RenderBundleBase*> mAddedBundles;
 
@@ -154,6 +161,15 @@ class IndirectDrawMetadata : public NonCopyable {
     uint32_t mMaxDrawCallsPerBatch;
 };
 
+// The indirect draw validation of a render pass that is encoded when its command buffer is
+// submitted instead of just before the render pass, see
+// Toggle::BatchIndirectDrawValidationAtSubmit.
+struct DeferredIndirectDrawValidation {
+    IndirectDrawMetadata metadata;
+    // The index of the render pass in CommandBufferResourceUsage::renderPasses.
+    size_t renderPassIndex;
+};
+
 }  // namespace dawn::native
 
 #endif  // SRC_DAWN_NATIVE_INDIRECTDRAWMETADATA_H_
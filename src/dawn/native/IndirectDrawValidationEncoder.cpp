@@ -29,6 +29,7 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <deque>
 #include <limits>
 #include <memory>
 #include <utility>
@@ -38,6 +39,7 @@
 #include "dawn/common/Math.h"
 #include "dawn/native/BindGroup.h"
 #include "dawn/native/BindGroupLayout.h"
+#include "dawn/native/CommandBuffer.h"
 #include "dawn/native/CommandEncoder.h"
 #include "dawn/native/ComputePassEncoder.h"
 #include "dawn/native/ComputePipeline.h"
@@ -268,23 +270,48 @@ uint32_t ComputeMaxDrawCallsPerIndirectValidationBatch(const CombinedLimits& lim
                   uint64_t(std::numeric_limits<uint32_t>::max())}));
 }
 
-MaybeError EncodeIndirectDrawValidationCommands(DeviceBase* device,
-                                                CommandEncoder* commandEncoder,
-                                                RenderPassResourceUsageTracker* usageTracker,
-                                                IndirectDrawMetadata* indirectDrawMetadata) {
-    DAWN_ASSERT(device->IsLockedByCurrentThreadIfNeeded());
-    // Since encoding validation commands may create new objects, verify that the device is alive.
-    // TODO(dawn:1199): This check is obsolete if device loss causes device.destroy().
-    //   - This function only happens within the context of a TryEncode which would catch the
-    //     same issue if device loss implied device.destroy().
-    DAWN_TRY(device->ValidateIsAlive());
+namespace {
+
+// The minimum size of the buffers holding validated parameters kept across submits.
+constexpr uint64_t kMinValidatedDrawsBufferSize = 4096;
+
+// A batch of draws to validate along with where to write their validated parameters.
+struct BatchToValidate {
+    raw_ptr<const IndirectDrawMetadata::IndexedIndirectConfig> config;
+    raw_ptr<const IndirectDrawMetadata::IndirectValidationBatch> batch;
+    // When null, the validated parameters are written to the scratch buffer given to
+    // EncodeValidationBatches at an offset it chooses. Otherwise they are written to this buffer at
+    // |outputParamsOffset|.
+    raw_ptr<BufferBase> outputParamsBuffer = nullptr;
+    uint64_t outputParamsOffset = 0;
+};
+
+uint64_t GetOutputIndirectSize(const IndirectDrawMetadata::IndexedIndirectConfig& config) {
+    uint64_t outputIndirectSize = config.drawType == IndirectDrawMetadata::DrawType::Indexed
+                                      ? kDrawIndexedIndirectSize
+                                      : kDrawIndirectSize;
+    if (config.duplicateBaseVertexInstance) {
+        outputIndirectSize += 2 * sizeof(uint32_t);
+    }
+    return outputIndirectSize;
+}
 
+// Encodes the compute passes validating |batchesToValidate| into |commandEncoder| and points
+// their draw commands at the validated parameters. Batches without an output buffer write their
+// parameters to |outputParamsScratchBuffer|. The buffers the draw commands now read from are
+// appended to |outputParamsBuffers|.
+MaybeError EncodeValidationBatches(DeviceBase* device,
+                                   CommandEncoder* commandEncoder,
+                                   const std::vector<BatchToValidate>& batchesToValidate,
+                                   ScratchBuffer* outputParamsScratchBuffer,
+                                   std::vector<BufferBase*>* outputParamsBuffers) {
     struct Batch {
         raw_ptr<const IndirectDrawMetadata::IndirectValidationBatch> metadata;
         uint64_t dataBufferOffset;
         uint64_t dataSize;
         uint64_t inputIndirectOffset;
         uint64_t inputIndirectSize;
+        raw_ptr<BufferBase> outputParamsBuffer;
         uint64_t outputParamsOffset;
         uint64_t outputParamsSize;
         raw_ptr<BatchInfo, AllowPtrArithmetic> batchInfo;
@@ -300,6 +327,13 @@ MaybeError EncodeIndirectDrawValidationCommands(DeviceBase* device,
         std::vector<Batch> batches;
     };
 
+    if (batchesToValidate.empty()) {
+        return {};
+    }
+    // Resources are created below, so the device must be locked. It is only locked by
+    // RenderPassEncoder::APIEnd when there are indirect draws to validate, or by Queue::Submit.
+    DAWN_ASSERT(device->IsLockedByCurrentThreadIfNeeded());
+
     // First stage is grouping all batches into passes. We try to pack as many batches into a
     // single pass as possible. Batches can be grouped together as long as they're validating
     // data from the same indirect buffer and draw type, but they may still be split into
@@ -307,88 +341,84 @@ MaybeError EncodeIndirectDrawValidationCommands(DeviceBase* device,
     // upper bound.
     uint64_t outputParamsSize = 0;
     std::vector<Pass> passes;
-    IndirectDrawMetadata::IndexedIndirectBufferValidationInfoMap& bufferInfoMap =
-        *indirectDrawMetadata->GetIndexedIndirectBufferValidationInfo();
-    if (bufferInfoMap.empty()) {
-        return {};
-    }
 
     const uint64_t maxStorageBufferBindingSize = device->GetLimits().v1.maxStorageBufferBindingSize;
     const uint32_t minStorageBufferOffsetAlignment =
         device->GetLimits().v1.minStorageBufferOffsetAlignment;
 
-    for (auto& [config, validationInfo] : bufferInfoMap) {
+    for (const BatchToValidate& batchToValidate : batchesToValidate) {
+        const IndirectDrawMetadata::IndexedIndirectConfig& config = *batchToValidate.config;
+        const IndirectDrawMetadata::IndirectValidationBatch& batch = *batchToValidate.batch;
+
         const uint64_t indirectDrawCommandSize =
             config.drawType == IndirectDrawMetadata::DrawType::Indexed ? kDrawIndexedIndirectSize
                                                                        : kDrawIndirectSize;
 
-        uint64_t outputIndirectSize = indirectDrawCommandSize;
-        if (config.duplicateBaseVertexInstance) {
-            outputIndirectSize += 2 * sizeof(uint32_t);
-        }
-
-        for (const IndirectDrawMetadata::IndirectValidationBatch& batch :
-             validationInfo.GetBatches()) {
-            const uint64_t minOffsetFromAlignedBoundary =
-                batch.minOffset % minStorageBufferOffsetAlignment;
-            const uint64_t minOffsetAlignedDown = batch.minOffset - minOffsetFromAlignedBoundary;
-
-            Batch newBatch;
-            newBatch.metadata = &batch;
-            newBatch.dataSize = GetBatchDataSize(batch.draws.size());
-            newBatch.inputIndirectOffset = minOffsetAlignedDown;
-            newBatch.inputIndirectSize =
-                batch.maxOffset + indirectDrawCommandSize - minOffsetAlignedDown;
-
-            newBatch.outputParamsSize = batch.draws.size() * outputIndirectSize;
-            newBatch.outputParamsOffset = Align(outputParamsSize, minStorageBufferOffsetAlignment);
+        const uint64_t minOffsetFromAlignedBoundary =
+            batch.minOffset % minStorageBufferOffsetAlignment;
+        const uint64_t minOffsetAlignedDown = batch.minOffset - minOffsetFromAlignedBoundary;
+
+        Batch newBatch;
+        newBatch.metadata = &batch;
+        newBatch.dataSize = GetBatchDataSize(batch.draws.size());
+        newBatch.inputIndirectOffset = minOffsetAlignedDown;
+        newBatch.inputIndirectSize =
+            batch.maxOffset + indirectDrawCommandSize - minOffsetAlignedDown;
+
+        newBatch.outputParamsSize = batch.draws.size() * GetOutputIndirectSize(config);
+        newBatch.outputParamsBuffer = batchToValidate.outputParamsBuffer;
+        if (newBatch.outputParamsBuffer != nullptr) {
+            newBatch.outputParamsOffset = batchToValidate.outputParamsOffset;
+        } else {
+            newBatch.outputParamsOffset =
+                Align(outputParamsSize, minStorageBufferOffsetAlignment);
             outputParamsSize = newBatch.outputParamsOffset + newBatch.outputParamsSize;
             if (outputParamsSize > maxStorageBufferBindingSize) {
                 return DAWN_INTERNAL_ERROR("Too many drawIndexedIndirect calls to validate");
             }
+        }
 
-            Pass* currentPass = passes.empty() ? nullptr : &passes.back();
-            if (currentPass && currentPass->inputIndirectBuffer == config.inputIndirectBuffer &&
-                currentPass->drawType == config.drawType) {
-                uint64_t nextBatchDataOffset =
-                    Align(currentPass->batchDataSize, minStorageBufferOffsetAlignment);
-                uint64_t newPassBatchDataSize = nextBatchDataOffset + newBatch.dataSize;
-                if (newPassBatchDataSize <= maxStorageBufferBindingSize) {
-                    // We can fit this batch in the current pass.
-                    newBatch.dataBufferOffset = nextBatchDataOffset;
-                    currentPass->batchDataSize = newPassBatchDataSize;
-                    currentPass->batches.push_back(newBatch);
-                    continue;
-                }
+        Pass* currentPass = passes.empty() ? nullptr : &passes.back();
+        if (currentPass && currentPass->inputIndirectBuffer == config.inputIndirectBuffer &&
+            currentPass->drawType == config.drawType) {
+            uint64_t nextBatchDataOffset =
+                Align(currentPass->batchDataSize, minStorageBufferOffsetAlignment);
+            uint64_t newPassBatchDataSize = nextBatchDataOffset + newBatch.dataSize;
+            if (newPassBatchDataSize <= maxStorageBufferBindingSize) {
+                // We can fit this batch in the current pass.
+                newBatch.dataBufferOffset = nextBatchDataOffset;
+                currentPass->batchDataSize = newPassBatchDataSize;
+                currentPass->batches.push_back(newBatch);
+                continue;
             }
+        }
 
-            // We need to start a new pass for this batch.
-            newBatch.dataBufferOffset = 0;
-
-            Pass newPass{};
-            newPass.inputIndirectBuffer = config.inputIndirectBuffer.get();
-            newPass.drawType = config.drawType;
-            newPass.batchDataSize = newBatch.dataSize;
-            newPass.batches.push_back(newBatch);
-            newPass.flags = 0;
-            if (config.duplicateBaseVertexInstance) {
-                newPass.flags |= kDuplicateBaseVertexInstance;
-            }
-            if (config.drawType == IndirectDrawMetadata::DrawType::Indexed) {
-                newPass.flags |= kIndexedDraw;
-            }
-            if (device->IsValidationEnabled()) {
-                newPass.flags |= kValidationEnabled;
-            }
-            if (device->HasFeature(Feature::IndirectFirstInstance)) {
-                newPass.flags |= kIndirectFirstInstanceEnabled;
-            }
-            passes.push_back(std::move(newPass));
+        // We need to start a new pass for this batch.
+        newBatch.dataBufferOffset = 0;
+
+        Pass newPass{};
+        newPass.inputIndirectBuffer = config.inputIndirectBuffer.get();
+        newPass.drawType = config.drawType;
+        newPass.batchDataSize = newBatch.dataSize;
+        newPass.batches.push_back(newBatch);
+        newPass.flags = 0;
+        if (config.duplicateBaseVertexInstance) {
+            newPass.flags |= kDuplicateBaseVertexInstance;
+        }
+        if (config.drawType == IndirectDrawMetadata::DrawType::Indexed) {
+            newPass.flags |= kIndexedDraw;
+        }
+        if (device->IsValidationEnabled()) {
+            newPass.flags |= kValidationEnabled;
+        }
+        if (device->HasFeature(Feature::IndirectFirstInstance)) {
+            newPass.flags |= kIndirectFirstInstanceEnabled;
         }
+        passes.push_back(std::move(newPass));
     }
 
     auto* const store = device->GetInternalPipelineStore();
-    ScratchBuffer& outputParamsBuffer = store->scratchIndirectStorage;
+    ScratchBuffer& outputParamsBuffer = *outputParamsScratchBuffer;
     ScratchBuffer& batchDataBuffer = store->scratchStorage;
 
     uint64_t requiredBatchDataBufferSize = 0;
@@ -397,9 +427,10 @@ MaybeError EncodeIndirectDrawValidationCommands(DeviceBase* device,
     }
     DAWN_TRY(batchDataBuffer.EnsureCapacity(requiredBatchDataBufferSize));
 
-    DAWN_TRY(outputParamsBuffer.EnsureCapacity(outputParamsSize));
-    // We swap the indirect buffer used so we need to explicitly add the usage.
-    usageTracker->BufferUsedAs(outputParamsBuffer.GetBuffer(), wgpu::BufferUsage::Indirect);
+    if (outputParamsSize > 0) {
+        DAWN_TRY(outputParamsBuffer.EnsureCapacity(outputParamsSize));
+        outputParamsBuffers->push_back(outputParamsBuffer.GetBuffer());
+    }
 
     // Now we allocate and populate host-side batch data to be copied to the GPU.
     for (Pass& pass : passes) {
@@ -408,6 +439,10 @@ MaybeError EncodeIndirectDrawValidationCommands(DeviceBase* device,
         memset(pass.batchData.get(), 0, pass.batchDataSize);
         uint8_t* batchData = static_cast<uint8_t*>(pass.batchData.get());
         for (Batch& batch : pass.batches) {
+            if (batch.outputParamsBuffer == nullptr) {
+                batch.outputParamsBuffer = outputParamsBuffer.GetBuffer();
+            }
+
             batch.batchInfo = new (&batchData[batch.dataBufferOffset]) BatchInfo();
             batch.batchInfo->numDraws = static_cast<uint32_t>(batch.metadata->draws.size());
             batch.batchInfo->flags = pass.flags;
@@ -426,7 +461,7 @@ MaybeError EncodeIndirectDrawValidationCommands(DeviceBase* device,
                     static_cast<uint32_t>((draw.numIndexBufferElements >> 32) & 0xFFFFFFFF);
                 indirectDraw++;
 
-                draw.cmd->indirectBuffer = outputParamsBuffer.GetBuffer();
+                draw.cmd->indirectBuffer = batch.outputParamsBuffer.get();
                 draw.cmd->indirectOffset = outputParamsOffset;
                 if (pass.flags & kIndexedDraw) {
                     outputParamsOffset += kDrawIndexedIndirectSize;
@@ -457,7 +492,6 @@ MaybeError EncodeIndirectDrawValidationCommands(DeviceBase* device,
 
     BindGroupEntry& outputParamsBinding = bindings[2];
     outputParamsBinding.binding = 2;
-    outputParamsBinding.buffer = outputParamsBuffer.GetBuffer();
 
     BindGroupDescriptor bindGroupDescriptor = {};
     bindGroupDescriptor.layout = layout.Get();
@@ -483,6 +517,7 @@ MaybeError EncodeIndirectDrawValidationCommands(DeviceBase* device,
             bufferDataBinding.size = batch.dataSize;
             inputIndirectBinding.offset = batch.inputIndirectOffset;
             inputIndirectBinding.size = batch.inputIndirectSize;
+            outputParamsBinding.buffer = batch.outputParamsBuffer;
             outputParamsBinding.offset = batch.outputParamsOffset;
             outputParamsBinding.size = batch.outputParamsSize;
 
@@ -501,4 +536,344 @@ MaybeError EncodeIndirectDrawValidationCommands(DeviceBase* device,
     return {};
 }
 
+// Points the draws of |validationInfo| that were validated by a previous submit at their cached
+// parameters in |validatedDraws|. The other draws are gathered in new batches, stored in
+// |missedBatches| and appended to |batchesToValidate|, which write their parameters to the
+// cache. Returns false without changing anything if the draws can't be cached.
+ResultOrError<bool> UseValidatedDrawsCache(
+    DeviceBase* device,
+    const IndirectDrawMetadata::IndexedIndirectConfig& config,
+    const IndirectDrawMetadata::IndexedIndirectBufferValidationInfo& validationInfo,
+    IndirectDrawValidationCache::ValidatedDraws* validatedDraws,
+    std::deque<IndirectDrawMetadata::IndirectValidationBatch>* missedBatches,
+    std::vector<BatchToValidate>* batchesToValidate) {
+    const uint64_t maxStorageBufferBindingSize = device->GetLimits().v1.maxStorageBufferBindingSize;
+    const uint32_t minStorageBufferOffsetAlignment =
+        device->GetLimits().v1.minStorageBufferOffsetAlignment;
+    const uint64_t outputIndirectSize = GetOutputIndirectSize(config);
+
+    auto GetRequiredSize = [&](uint64_t usedSize, bool onlyMissedDraws) {
+        for (const IndirectDrawMetadata::IndirectValidationBatch& batch :
+             validationInfo.GetBatches()) {
+            uint64_t numDraws = 0;
+            for (const IndirectDrawMetadata::IndirectDraw& draw : batch.draws) {
+                if (!onlyMissedDraws ||
+                    !validatedDraws->outputParamsOffsets.contains(
+                        std::pair(draw.inputBufferOffset, draw.numIndexBufferElements))) {
+                    ++numDraws;
+                }
+            }
+            if (numDraws > 0) {
+                usedSize = Align(usedSize, minStorageBufferOffsetAlignment) +
+                           numDraws * outputIndirectSize;
+            }
+        }
+        return usedSize;
+    };
+
+    // Draws that hit the cache must be able to keep using it while the missed draws are written
+    // after the already cached ones. If they don't fit, start over with all the draws.
+    BufferBase* cacheBuffer = validatedDraws->outputParamsBuffer.Get();
+    if (cacheBuffer == nullptr ||
+        GetRequiredSize(validatedDraws->outputParamsSize, true) > cacheBuffer->GetSize()) {
+        const uint64_t requiredSize = GetRequiredSize(0, false);
+        if (requiredSize > maxStorageBufferBindingSize) {
+            return false;
+        }
+
+        validatedDraws->outputParamsOffsets.clear();
+        validatedDraws->outputParamsSize = 0;
+        if (cacheBuffer == nullptr || requiredSize > cacheBuffer->GetSize()) {
+            BufferDescriptor descriptor;
+            descriptor.size = std::min(std::max(2 * requiredSize, kMinValidatedDrawsBufferSize),
+                                       maxStorageBufferBindingSize);
+            descriptor.usage = wgpu::BufferUsage::Indirect | wgpu::BufferUsage::Storage;
+            DAWN_TRY_ASSIGN(validatedDraws->outputParamsBuffer, device->CreateBuffer(&descriptor));
+            validatedDraws->outputParamsBuffer->SetIsDataInitialized();
+            cacheBuffer = validatedDraws->outputParamsBuffer.Get();
+        }
+    }
+
+    for (const IndirectDrawMetadata::IndirectValidationBatch& batch :
+         validationInfo.GetBatches()) {
+        IndirectDrawMetadata::IndirectValidationBatch* missedBatch = nullptr;
+        uint64_t missedBatchOutputOffset = 0;
+
+        for (const IndirectDrawMetadata::IndirectDraw& draw : batch.draws) {
+            auto [it, inserted] = validatedDraws->outputParamsOffsets.try_emplace(
+                std::pair(draw.inputBufferOffset, draw.numIndexBufferElements), 0);
+            if (!inserted) {
+                draw.cmd->indirectBuffer = cacheBuffer;
+                draw.cmd->indirectOffset = it->second;
+                continue;
+            }
+
+            if (missedBatch == nullptr) {
+                missedBatchOutputOffset =
+                    Align(validatedDraws->outputParamsSize, minStorageBufferOffsetAlignment);
+                missedBatch = &missedBatches->emplace_back();
+                missedBatch->minOffset = draw.inputBufferOffset;
+                missedBatch->maxOffset = draw.inputBufferOffset;
+            }
+            it->second = missedBatchOutputOffset + missedBatch->draws.size() * outputIndirectSize;
+            missedBatch->minOffset = std::min(missedBatch->minOffset, draw.inputBufferOffset);
+            missedBatch->maxOffset = std::max(missedBatch->maxOffset, draw.inputBufferOffset);
+            missedBatch->draws.push_back(draw);
+        }
+
+        if (missedBatch != nullptr) {
+            validatedDraws->outputParamsSize =
+                missedBatchOutputOffset + missedBatch->draws.size() * outputIndirectSize;
+            batchesToValidate->push_back(
+                {&config, missedBatch, cacheBuffer, missedBatchOutputOffset});
+        }
+    }
+
+    return true;
+}
+
+// Appends the buffers that may be written by the commands using |usages|. Copies and compute
+// passes don't record how each buffer is used, so all of their writable buffers are included.
+void GetPossiblyWrittenBuffers(const CommandBufferResourceUsage& usages,
+                               std::vector<BufferBase*>* buffers) {
+    auto IsWritable = [](const BufferBase* buffer) {
+        return !IsSubset(buffer->GetUsage(), kReadOnlyBufferUsages);
+    };
+
+    for (BufferBase* buffer : usages.topLevelBuffers) {
+        if (IsWritable(buffer)) {
+            buffers->push_back(buffer);
+        }
+    }
+    for (const ComputePassResourceUsage& pass : usages.computePasses) {
+        for (BufferBase* buffer : pass.referencedBuffers) {
+            if (IsWritable(buffer)) {
+                buffers->push_back(buffer);
+            }
+        }
+    }
+    for (const RenderPassResourceUsage& pass : usages.renderPasses) {
+        for (size_t i = 0; i < pass.buffers.size(); ++i) {
+            if (!IsSubset(pass.bufferSyncInfos[i].usage, kReadOnlyBufferUsages)) {
+                buffers->push_back(pass.buffers[i]);
+            }
+        }
+    }
+}
+
+// Encodes the deferred indirect draw validation of all the render passes of |commandBuffers| in
+// a single command buffer. |buffersWrittenInSubmit| are the buffers that may have been written
+// since the previous submit, for which previously validated parameters can't be reused.
+ResultOrError<Ref<CommandBufferBase>> EncodeDeferredValidationGroup(
+    DeviceBase* device,
+    const std::vector<CommandBufferBase*>& commandBuffers,
+    const absl::flat_hash_set<BufferBase*>& buffersWrittenInSubmit) {
+    IndirectDrawMetadata indirectDrawMetadata(device->GetLimits());
+    for (CommandBufferBase* commandBuffer : commandBuffers) {
+        for (const DeferredIndirectDrawValidation& deferred :
+             commandBuffer->GetDeferredIndirectDrawValidations()) {
+            indirectDrawMetadata.AddMetadata(deferred.metadata);
+        }
+    }
+
+    const bool useValidatedDrawsCache =
+        device->IsToggleEnabled(Toggle::SkipUnchangedIndirectDrawValidation);
+
+    std::vector<BatchToValidate> batchesToValidate;
+    std::deque<IndirectDrawMetadata::IndirectValidationBatch> missedBatches;
+    std::vector<BufferBase*> outputParamsBuffers;
+    for (auto& [config, validationInfo] :
+         *indirectDrawMetadata.GetIndexedIndirectBufferValidationInfo()) {
+        IndirectDrawValidationCache* cache = nullptr;
+        if (useValidatedDrawsCache &&
+            !buffersWrittenInSubmit.contains(config.inputIndirectBuffer.get())) {
+            cache = config.inputIndirectBuffer->GetIndirectDrawValidationCache();
+        }
+
+        if (cache != nullptr) {
+            IndirectDrawValidationCache::ValidatedDraws* validatedDraws =
+                cache->GetValidatedDraws(config.duplicateBaseVertexInstance, config.drawType);
+            bool usedCache;
+            DAWN_TRY_ASSIGN(usedCache,
+                            UseValidatedDrawsCache(device, config, validationInfo, validatedDraws,
+                                                   &missedBatches, &batchesToValidate));
+            if (usedCache) {
+                outputParamsBuffers.push_back(validatedDraws->outputParamsBuffer.Get());
+                continue;
+            }
+        }
+
+        for (const IndirectDrawMetadata::IndirectValidationBatch& batch :
+             validationInfo.GetBatches()) {
+            batchesToValidate.push_back({&config, &batch});
+        }
+    }
+
+    Ref<CommandBufferBase> validationCommands;
+    if (!batchesToValidate.empty()) {
+        Ref<CommandEncoder> commandEncoder;
+        DAWN_TRY_ASSIGN(commandEncoder, device->CreateCommandEncoder());
+        // The command buffers of the submit may validate other render passes when they are
+        // executed, rewriting scratchIndirectStorage before the deferred draws read it, so the
+        // deferred draws get their own scratch buffer. When it grows, the command buffers of this
+        // submit keep the previous buffer alive until they completed.
+        DAWN_TRY(EncodeValidationBatches(
+            device, commandEncoder.Get(), batchesToValidate,
+            &device->GetInternalPipelineStore()->scratchDeferredIndirectStorage,
+            &outputParamsBuffers));
+        DAWN_TRY_ASSIGN(validationCommands, commandEncoder->Finish());
+    }
+
+    // The render passes now read their indirect parameters from |outputParamsBuffers|.
+    for (CommandBufferBase* commandBuffer : commandBuffers) {
+        for (const DeferredIndirectDrawValidation& deferred :
+             commandBuffer->GetDeferredIndirectDrawValidations()) {
+            for (BufferBase* buffer : outputParamsBuffers) {
+                commandBuffer->AddRenderPassIndirectBufferUsage(deferred.renderPassIndex, buffer);
+            }
+        }
+    }
+
+    return validationCommands;
+}
+
+}  // namespace
+
+void IndirectDrawValidationCache::Clear() {
+    for (ValidatedDraws& validatedDraws : mValidatedDraws) {
+        validatedDraws.outputParamsOffsets.clear();
+        validatedDraws.outputParamsSize = 0;
+    }
+}
+
+IndirectDrawValidationCache::ValidatedDraws* IndirectDrawValidationCache::GetValidatedDraws(
+    bool duplicateBaseVertexInstance,
+    IndirectDrawMetadata::DrawType drawType) {
+    size_t index = duplicateBaseVertexInstance ? 1 : 0;
+    if (drawType == IndirectDrawMetadata::DrawType::Indexed) {
+        index += 2;
+    }
+    return &mValidatedDraws[index];
+}
+
+MaybeError EncodeIndirectDrawValidationCommands(DeviceBase* device,
+                                                CommandEncoder* commandEncoder,
+                                                RenderPassResourceUsageTracker* usageTracker,
+                                                IndirectDrawMetadata* indirectDrawMetadata) {
+    // Since encoding validation commands may create new objects, verify that the device is alive.
+    // TODO(dawn:1199): This check is obsolete if device loss causes device.destroy().
+    //   - This function only happens within the context of a TryEncode which would catch the
+    //     same issue if device loss implied device.destroy().
+    DAWN_TRY(device->ValidateIsAlive());
+
+    std::vector<BatchToValidate> batchesToValidate;
+    for (auto& [config, validationInfo] :
+         *indirectDrawMetadata->GetIndexedIndirectBufferValidationInfo()) {
+        for (const IndirectDrawMetadata::IndirectValidationBatch& batch :
+             validationInfo.GetBatches()) {
+            batchesToValidate.push_back({&config, &batch});
+        }
+    }
+
+    std::vector<BufferBase*> outputParamsBuffers;
+    DAWN_TRY(EncodeValidationBatches(device, commandEncoder, batchesToValidate,
+                                     &device->GetInternalPipelineStore()->scratchIndirectStorage,
+                                     &outputParamsBuffers));
+
+    // We swap the indirect buffer used so we need to explicitly add the usage.
+    for (BufferBase* buffer : outputParamsBuffers) {
+        usageTracker->BufferUsedAs(buffer, wgpu::BufferUsage::Indirect);
+    }
+
+    return {};
+}
+
+MaybeError EncodeDeferredIndirectDrawValidationCommands(
+    DeviceBase* device,
+    uint32_t commandCount,
+    CommandBufferBase* const* commands,
+    std::vector<CommandBufferBase*>* commandsToSubmit,
+    std::vector<Ref<CommandBufferBase>>* validationCommands) {
+    bool hasDeferredValidation = false;
+    for (uint32_t i = 0; i < commandCount; ++i) {
+        if (!commands[i]->GetDeferredIndirectDrawValidations().empty()) {
+            hasDeferredValidation = true;
+            break;
+        }
+    }
+    const bool skipUnchangedValidation =
+        device->IsToggleEnabled(Toggle::SkipUnchangedIndirectDrawValidation);
+    if (!hasDeferredValidation && !skipUnchangedValidation) {
+        return {};
+    }
+
+    // The validation of consecutive command buffers is encoded in a single command buffer
+    // submitted before the first of them. The indirect buffers are read at that point, so a new
+    // group is started when a command buffer of the current group may have written one of the
+    // indirect buffers to validate.
+    std::vector<CommandBufferBase*> group;
+    size_t groupSubmitIndex = 0;
+    absl::flat_hash_set<BufferBase*> buffersWrittenInGroup;
+    absl::flat_hash_set<BufferBase*> buffersWrittenInSubmit;
+    std::vector<BufferBase*> writtenBuffers;
+
+    auto FlushGroup = [&]() -> MaybeError {
+        if (group.empty()) {
+            return {};
+        }
+        Ref<CommandBufferBase> groupValidationCommands;
+        DAWN_TRY_ASSIGN(groupValidationCommands,
+                        EncodeDeferredValidationGroup(device, group, buffersWrittenInSubmit));
+        if (groupValidationCommands != nullptr) {
+            commandsToSubmit->insert(commandsToSubmit->begin() + groupSubmitIndex,
+                                     groupValidationCommands.Get());
+            validationCommands->push_back(std::move(groupValidationCommands));
+        }
+        group.clear();
+        buffersWrittenInGroup.clear();
+        return {};
+    };
+
+    commandsToSubmit->reserve(commandCount + 1);
+    for (uint32_t i = 0; i < commandCount; ++i) {
+        CommandBufferBase* commandBuffer = commands[i];
+        const std::vector<DeferredIndirectDrawValidation>& deferredValidations =
+            commandBuffer->GetDeferredIndirectDrawValidations();
+
+        if (!deferredValidations.empty()) {
+            bool readsBufferWrittenInGroup = false;
+            for (const DeferredIndirectDrawValidation& deferred : deferredValidations) {
+                for (const auto& [config, _] :
+                     *deferred.metadata.GetIndexedIndirectBufferValidationInfo()) {
+                    readsBufferWrittenInGroup |=
+                        buffersWrittenInGroup.contains(config.inputIndirectBuffer.get());
+                }
+            }
+            if (readsBufferWrittenInGroup) {
+                DAWN_TRY(FlushGroup());
+            }
+            if (group.empty()) {
+                groupSubmitIndex = commandsToSubmit->size();
+            }
+            group.push_back(commandBuffer);
+        }
+        commandsToSubmit->push_back(commandBuffer);
+
+        writtenBuffers.clear();
+        GetPossiblyWrittenBuffers(commandBuffer->GetResourceUsages(), &writtenBuffers);
+        buffersWrittenInSubmit.insert(writtenBuffers.begin(), writtenBuffers.end());
+        if (!group.empty()) {
+            buffersWrittenInGroup.insert(writtenBuffers.begin(), writtenBuffers.end());
+        }
+    }
+    DAWN_TRY(FlushGroup());
+
+    // Parameters validated before these writes can't be reused by later submits.
+    for (BufferBase* buffer : buffersWrittenInSubmit) {
+        buffer->InvalidateIndirectDrawValidationCache();
+    }
+
+    return {};
+}
+
 }  // namespace dawn::native
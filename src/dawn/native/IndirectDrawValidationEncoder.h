@@ -28,11 +28,19 @@
 #ifndef SRC_DAWN_NATIVE_INDIRECTDRAWVALIDATIONENCODER_H_
 #define SRC_DAWN_NATIVE_INDIRECTDRAWVALIDATIONENCODER_H_
 
+#include <array>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "dawn/common/Ref.h"
 #include "dawn/native/Error.h"
 #include "dawn/native/IndirectDrawMetadata.h"
 
 namespace dawn::native {
 
+class BufferBase;
+class CommandBufferBase;
 class CommandEncoder;
 struct CombinedLimits;
 class DeviceBase;
@@ -43,11 +51,45 @@ class RenderPassResourceUsageTracker;
 // allowed storage binding size (with the base limits, it is about 6.7M).
 uint32_t ComputeMaxDrawCallsPerIndirectValidationBatch(const CombinedLimits& limits);
 
+// The validated parameters of the indirect draws reading from a buffer, kept across submits
+// while the contents of the buffer don't change so that draws at the same offsets don't need to
+// be validated again. See Toggle::SkipUnchangedIndirectDrawValidation.
+class IndirectDrawValidationCache {
+  public:
+    struct ValidatedDraws {
+        Ref<BufferBase> outputParamsBuffer;
+        uint64_t outputParamsSize = 0;
+        // Maps the offset of a draw in the indirect buffer and the number of elements of its
+        // index buffer to the offset of its validated parameters in |outputParamsBuffer|.
+        absl::flat_hash_map<std::pair<uint64_t, uint64_t>, uint64_t> outputParamsOffsets;
+    };
+
+    // Forgets all the validated parameters but keeps the buffers to reuse them.
+    void Clear();
+
+    ValidatedDraws* GetValidatedDraws(bool duplicateBaseVertexInstance,
+                                      IndirectDrawMetadata::DrawType drawType);
+
+  private:
+    std::array<ValidatedDraws, 4> mValidatedDraws;
+};
+
 MaybeError EncodeIndirectDrawValidationCommands(DeviceBase* device,
                                                 CommandEncoder* commandEncoder,
                                                 RenderPassResourceUsageTracker* usageTracker,
                                                 IndirectDrawMetadata* indirectDrawMetadata);
 
+// Encodes the indirect draw validation that the render passes of |commands| deferred to submit
+// time. |commandsToSubmit| receives |commands| with the command buffers doing the validation
+// inserted before the command buffers they validate. The validation command buffers are also
+// added to |validationCommands| so that they can be destroyed after the submit.
+MaybeError EncodeDeferredIndirectDrawValidationCommands(
+    DeviceBase* device,
+    uint32_t commandCount,
+    CommandBufferBase* const* commands,
+    std::vector<CommandBufferBase*>* commandsToSubmit,
+    std::vector<Ref<CommandBufferBase>>* validationCommands);
+
 }  // namespace dawn::native
 
 #endif  // SRC_DAWN_NATIVE_INDIRECTDRAWVALIDATIONENCODER_H_
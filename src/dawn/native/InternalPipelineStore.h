@@ -71,6 +71,11 @@ struct InternalPipelineStore {
     // buffer for indirect dispatch or draw calls.
     ScratchBuffer scratchIndirectStorage;
 
+    // Like scratchIndirectStorage, but holds the indirect draw parameters validated at
+    // Queue::Submit. Those are written before the command buffers of the submit execute, so they
+    // must not share storage with the validation encoded in these command buffers.
+    ScratchBuffer scratchDeferredIndirectStorage;
+
     Ref<ComputePipelineBase> renderValidationPipeline;
     Ref<ShaderModuleBase> renderValidationShader;
     Ref<ComputePipelineBase> dispatchIndirectValidationPipeline;
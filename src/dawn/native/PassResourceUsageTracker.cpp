@@ -27,6 +27,7 @@
 
 #include "dawn/native/PassResourceUsageTracker.h"
 
+#include <atomic>
 #include <utility>
 
 #include "dawn/common/MatchVariant.h"
@@ -40,20 +41,83 @@
 
 namespace dawn::native {
 
-SyncScopeUsageTracker::SyncScopeUsageTracker() = default;
+namespace {
 
-SyncScopeUsageTracker::SyncScopeUsageTracker(SyncScopeUsageTracker&&) = default;
+// Stamps store the ID of the tracker in the upper bits and the index of the resource's entry in
+// the lower bits. Zero is never a valid stamp since tracker IDs start at 1.
+constexpr uint64_t kStampIndexBits = 24;
+constexpr uint64_t kStampIndexMask = (uint64_t(1) << kStampIndexBits) - 1;
+
+uint64_t NextTrackerId() {
+    static std::atomic<uint64_t> sNextTrackerId = 1;
+    return sNextTrackerId.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t MakeStamp(uint64_t trackerId, size_t index) {
+    return (trackerId << kStampIndexBits) | index;
+}
+
+}  // anonymous namespace
+
+SyncScopeUsageTracker::SyncScopeUsageTracker() : mId(NextTrackerId()) {}
+
+SyncScopeUsageTracker::SyncScopeUsageTracker(SyncScopeUsageTracker&& other)
+    : mId(std::exchange(other.mId, NextTrackerId())),
+      mUsage(std::move(other.mUsage)),
+      mExternalTextureUsages(std::move(other.mExternalTextureUsages)) {}
 
 SyncScopeUsageTracker::~SyncScopeUsageTracker() = default;
 
-SyncScopeUsageTracker& SyncScopeUsageTracker::operator=(SyncScopeUsageTracker&&) = default;
+SyncScopeUsageTracker& SyncScopeUsageTracker::operator=(SyncScopeUsageTracker&& other) {
+    // The stamps of the entries of `other` stay valid since the ID moves with them.
+    mId = std::exchange(other.mId, NextTrackerId());
+    mUsage = std::move(other.mUsage);
+    mExternalTextureUsages = std::move(other.mExternalTextureUsages);
+    return *this;
+}
+
+template <typename Resource, typename Info, typename MakeInfo>
+size_t SyncScopeUsageTracker::GetOrAppendEntry(Resource* resource,
+                                               std::vector<Resource*>* resources,
+                                               std::vector<Info>* infos,
+                                               MakeInfo makeInfo) {
+    uint64_t stamp = resource->mSyncScopeUsageStamp.load(std::memory_order_relaxed);
+    if ((stamp >> kStampIndexBits) == mId) {
+        DAWN_ASSERT((stamp & kStampIndexMask) < resources->size());
+        return stamp & kStampIndexMask;
+    }
+
+    size_t index = resources->size();
+    resources->push_back(resource);
+    infos->push_back(makeInfo());
+
+    // Entries past what fits in a stamp are left unstamped. AcquireSyncScopeUsage then sees a
+    // mismatch and merges the duplicate entries this produces.
+    if (index <= kStampIndexMask) {
+        resource->mSyncScopeUsageStamp.store(MakeStamp(mId, index), std::memory_order_relaxed);
+    }
+    return index;
+}
+
+TextureSubresourceSyncInfo& SyncScopeUsageTracker::GetOrCreateTextureSyncInfo(
+    TextureBase* texture) {
+    // New entries are initially filled with wgpu::TextureUsage::None and WGPUShaderStage_None.
+    size_t index =
+        GetOrAppendEntry(texture, &mUsage.textures, &mUsage.textureSyncInfos, [texture] {
+            return TextureSubresourceSyncInfo(
+                texture->GetFormat().aspects, texture->GetArrayLayers(),
+                texture->GetNumMipLevels(),
+                TextureSyncInfo{wgpu::TextureUsage::None, wgpu::ShaderStage::None});
+        });
+    return mUsage.textureSyncInfos[index];
+}
 
 void SyncScopeUsageTracker::BufferUsedAs(BufferBase* buffer,
                                          wgpu::BufferUsage usage,
                                          wgpu::ShaderStage shaderStages) {
-    // std::map's operator[] will create a new element using the default constructor
-    // if the key didn't exist before.
-    BufferSyncInfo& bufferSyncInfo = mBufferSyncInfos[buffer];
+    size_t index = GetOrAppendEntry(buffer, &mUsage.buffers, &mUsage.bufferSyncInfos,
+                                    [] { return BufferSyncInfo{}; });
+    BufferSyncInfo& bufferSyncInfo = mUsage.bufferSyncInfos[index];
 
     bufferSyncInfo.usage |= usage;
     bufferSyncInfo.shaderStages |= shaderStages;
@@ -69,14 +133,7 @@ void SyncScopeUsageTracker::TextureRangeUsedAs(TextureBase* texture,
                                                const SubresourceRange& range,
                                                wgpu::TextureUsage usage,
                                                wgpu::ShaderStage shaderStages) {
-    // Get or create a new TextureSubresourceSyncInfo for that texture (initially filled with
-    // wgpu::TextureUsage::None and WGPUShaderStage_None)
-    auto it = mTextureSyncInfos.try_emplace(
-        texture, texture->GetFormat().aspects, texture->GetArrayLayers(),
-        texture->GetNumMipLevels(),
-        TextureSyncInfo{wgpu::TextureUsage::None, wgpu::ShaderStage::None});
-    TextureSubresourceSyncInfo& textureSyncInfo = it.first->second;
-
+    TextureSubresourceSyncInfo& textureSyncInfo = GetOrCreateTextureSyncInfo(texture);
     textureSyncInfo.Update(
         range, [usage, shaderStages](const SubresourceRange&, TextureSyncInfo* storedSyncInfo) {
             storedSyncInfo->usage |= usage;
@@ -87,14 +144,7 @@ void SyncScopeUsageTracker::TextureRangeUsedAs(TextureBase* texture,
 void SyncScopeUsageTracker::AddRenderBundleTextureUsage(
     TextureBase* texture,
     const TextureSubresourceSyncInfo& textureSyncInfo) {
-    // Get or create a new TextureSubresourceSyncInfo for that texture (initially filled with
-    // wgpu::TextureUsage::None and WGPUShaderStage_None)
-    auto it = mTextureSyncInfos.try_emplace(
-        texture, texture->GetFormat().aspects, texture->GetArrayLayers(),
-        texture->GetNumMipLevels(),
-        TextureSyncInfo{wgpu::TextureUsage::None, wgpu::ShaderStage::None});
-    TextureSubresourceSyncInfo* passTextureSyncInfo = &it.first->second;
-
+    TextureSubresourceSyncInfo* passTextureSyncInfo = &GetOrCreateTextureSyncInfo(texture);
     passTextureSyncInfo->Merge(
         textureSyncInfo, [](const SubresourceRange&, TextureSyncInfo* storedSyncInfo,
                             const TextureSyncInfo& addedSyncInfo) {
@@ -168,31 +218,75 @@ void SyncScopeUsageTracker::AddBindGroup(BindGroupBase* group) {
     }
 }
 
-SyncScopeResourceUsage SyncScopeUsageTracker::AcquireSyncScopeUsage() {
-    SyncScopeResourceUsage result;
-    result.buffers.reserve(mBufferSyncInfos.size());
-    result.bufferSyncInfos.reserve(mBufferSyncInfos.size());
-    result.textures.reserve(mTextureSyncInfos.size());
-    result.textureSyncInfos.reserve(mTextureSyncInfos.size());
-
-    for (auto& [buffer, syncInfo] : mBufferSyncInfos) {
-        result.buffers.push_back(buffer);
-        result.bufferSyncInfos.push_back(std::move(syncInfo));
+bool SyncScopeUsageTracker::AllStampsMatch() const {
+    for (size_t i = 0; i < mUsage.buffers.size(); ++i) {
+        if (mUsage.buffers[i]->mSyncScopeUsageStamp.load(std::memory_order_relaxed) !=
+            MakeStamp(mId, i)) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < mUsage.textures.size(); ++i) {
+        if (mUsage.textures[i]->mSyncScopeUsageStamp.load(std::memory_order_relaxed) !=
+            MakeStamp(mId, i)) {
+            return false;
+        }
     }
+    return true;
+}
 
-    for (auto& [texture, syncInfo] : mTextureSyncInfos) {
-        result.textures.push_back(texture);
-        result.textureSyncInfos.push_back(std::move(syncInfo));
+void SyncScopeUsageTracker::MergeDuplicateEntries() {
+    SyncScopeResourceUsage merged;
+
+    absl::flat_hash_map<BufferBase*, size_t> bufferIndices;
+    for (size_t i = 0; i < mUsage.buffers.size(); ++i) {
+        auto [it, inserted] = bufferIndices.try_emplace(mUsage.buffers[i], merged.buffers.size());
+        if (inserted) {
+            merged.buffers.push_back(mUsage.buffers[i]);
+            merged.bufferSyncInfos.push_back(mUsage.bufferSyncInfos[i]);
+            continue;
+        }
+        BufferSyncInfo& bufferSyncInfo = merged.bufferSyncInfos[it->second];
+        bufferSyncInfo.usage |= mUsage.bufferSyncInfos[i].usage;
+        bufferSyncInfo.shaderStages |= mUsage.bufferSyncInfos[i].shaderStages;
     }
 
-    for (auto* const it : mExternalTextureUsages) {
-        result.externalTextures.push_back(it);
+    absl::flat_hash_map<TextureBase*, size_t> textureIndices;
+    for (size_t i = 0; i < mUsage.textures.size(); ++i) {
+        auto [it, inserted] =
+            textureIndices.try_emplace(mUsage.textures[i], merged.textures.size());
+        if (inserted) {
+            merged.textures.push_back(mUsage.textures[i]);
+            merged.textureSyncInfos.push_back(std::move(mUsage.textureSyncInfos[i]));
+            continue;
+        }
+        merged.textureSyncInfos[it->second].Merge(
+            mUsage.textureSyncInfos[i], [](const SubresourceRange&, TextureSyncInfo* storedSyncInfo,
+                                           const TextureSyncInfo& addedSyncInfo) {
+                storedSyncInfo->usage |= addedSyncInfo.usage;
+                storedSyncInfo->shaderStages |= addedSyncInfo.shaderStages;
+            });
     }
 
-    mBufferSyncInfos.clear();
-    mTextureSyncInfos.clear();
+    mUsage = std::move(merged);
+}
+
+SyncScopeResourceUsage SyncScopeUsageTracker::AcquireSyncScopeUsage() {
+    // Duplicate entries are only possible if the stamp of one of the resources was overwritten.
+    if (!AllStampsMatch()) {
+        MergeDuplicateEntries();
+    }
+
+    mUsage.externalTextures.reserve(mExternalTextureUsages.size());
+    for (auto* const it : mExternalTextureUsages) {
+        mUsage.externalTextures.push_back(it);
+    }
     mExternalTextureUsages.clear();
 
+    // Hand out the storage directly and invalidate the stamps of all its entries by changing
+    // the ID of the tracker.
+    SyncScopeResourceUsage result = std::move(mUsage);
+    mUsage = {};
+    mId = NextTrackerId();
     return result;
 }
 
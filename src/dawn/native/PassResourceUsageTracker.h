@@ -28,6 +28,7 @@
 #ifndef SRC_DAWN_NATIVE_PASSRESOURCEUSAGETRACKER_H_
 #define SRC_DAWN_NATIVE_PASSRESOURCEUSAGETRACKER_H_
 
+#include <cstdint>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
@@ -46,7 +47,17 @@ class TextureBase;
 
 using QueryAvailabilityMap = absl::flat_hash_map<QuerySetBase*, std::vector<bool>>;
 
-// Helper class to build SyncScopeResourceUsages
+// Helper class to build SyncScopeResourceUsages.
+//
+// Resources are appended to the vectors of the SyncScopeResourceUsage being built, and each
+// resource is stamped with the ID of the tracker and the index of its entry so that finding the
+// entry again doesn't need a hash map. Trackers get a new ID each time their usage is acquired
+// which invalidates all the previous stamps at once.
+//
+// The same resource can be used concurrently by encoders on different threads which overwrite
+// each other's stamp, in which case a tracker may append a resource twice. This is detected in
+// AcquireSyncScopeUsage since at least one entry's resource no longer has a matching stamp, and
+// the duplicate entries are merged there.
 class SyncScopeUsageTracker {
   public:
     SyncScopeUsageTracker();
@@ -75,8 +86,19 @@ class SyncScopeUsageTracker {
     SyncScopeResourceUsage AcquireSyncScopeUsage();
 
   private:
-    absl::flat_hash_map<BufferBase*, BufferSyncInfo> mBufferSyncInfos;
-    absl::flat_hash_map<TextureBase*, TextureSubresourceSyncInfo> mTextureSyncInfos;
+    // Returns the index of the entry for `resource`, appending one initialized with `makeInfo()`
+    // if it isn't in the tracker yet.
+    template <typename Resource, typename Info, typename MakeInfo>
+    size_t GetOrAppendEntry(Resource* resource,
+                            std::vector<Resource*>* resources,
+                            std::vector<Info>* infos,
+                            MakeInfo makeInfo);
+    TextureSubresourceSyncInfo& GetOrCreateTextureSyncInfo(TextureBase* texture);
+    bool AllStampsMatch() const;
+    void MergeDuplicateEntries();
+
+    uint64_t mId;
+    SyncScopeResourceUsage mUsage;
     absl::flat_hash_set<ExternalTextureBase*> mExternalTextureUsages;
 };
 
@@ -45,6 +45,7 @@
 #include "dawn/native/DynamicUploader.h"
 #include "dawn/native/EventManager.h"
 #include "dawn/native/ExternalTexture.h"
+#include "dawn/native/IndirectDrawValidationEncoder.h"
 #include "dawn/native/Instance.h"
 #include "dawn/native/ObjectType_autogen.h"
 #include "dawn/native/QuerySet.h"
@@ -412,6 +413,7 @@ MaybeError QueueBase::WriteBuffer(BufferBase* buffer,
     DAWN_TRY(GetDevice()->ValidateObject(this));
     DAWN_TRY(ValidateWriteBuffer(GetDevice(), buffer, bufferOffset, size));
     DAWN_TRY(buffer->ValidateCanUseOnQueueNow());
+    buffer->InvalidateIndirectDrawValidationCache();
     return WriteBufferImpl(buffer, bufferOffset, data, size);
 }
 
@@ -670,7 +672,29 @@ MaybeError QueueBase::SubmitInternal(uint32_t commandCount, CommandBufferBase* c
     }
     DAWN_ASSERT(!IsError());
 
-    DAWN_TRY(SubmitImpl(commandCount, commands));
+    // Indirect draw validation deferred to submit time is done by extra command buffers that are
+    // submitted along with |commands|.
+    std::vector<CommandBufferBase*> commandsWithValidation;
+    std::vector<Ref<CommandBufferBase>> validationCommands;
+    auto DestroyValidationCommands = [&] {
+        for (Ref<CommandBufferBase>& validation : validationCommands) {
+            validation->Destroy();
+        }
+    };
+    if (device->IsToggleEnabled(Toggle::BatchIndirectDrawValidationAtSubmit)) {
+        DAWN_TRY_WITH_CLEANUP(
+            EncodeDeferredIndirectDrawValidationCommands(device, commandCount, commands,
+                                                         &commandsWithValidation,
+                                                         &validationCommands),
+            { DestroyValidationCommands(); });
+        if (!validationCommands.empty()) {
+            commandCount = static_cast<uint32_t>(commandsWithValidation.size());
+            commands = commandsWithValidation.data();
+        }
+    }
+
+    DAWN_TRY_WITH_CLEANUP(SubmitImpl(commandCount, commands), { DestroyValidationCommands(); });
+    DestroyValidationCommands();
 
     // Call Tick() to flush pending work.
     DAWN_TRY(device->Tick());
@@ -38,6 +38,8 @@
 
 namespace dawn::native {
 
+BakedRenderBundleCommands::~BakedRenderBundleCommands() = default;
+
 RenderBundleBase::RenderBundleBase(RenderBundleEncoder* encoder,
                                    const RenderBundleDescriptor* descriptor,
                                    Ref<AttachmentState> attachmentState,
@@ -59,6 +61,7 @@ RenderBundleBase::RenderBundleBase(RenderBundleEncoder* encoder,
 
 void RenderBundleBase::DestroyImpl() {
     FreeCommands(&mCommands);
+    mBakedCommands = nullptr;
 
     // Remove reference to the attachment state so that we don't have lingering references to
     // it preventing it from being uncached in the device.
@@ -132,4 +135,14 @@ const IndirectDrawMetadata& RenderBundleBase::GetIndirectDrawMetadata() {
     return mIndirectDrawMetadata;
 }
 
+BakedRenderBundleCommands* RenderBundleBase::GetBakedCommands() const {
+    DAWN_ASSERT(!IsError());
+    return mBakedCommands.get();
+}
+
+void RenderBundleBase::SetBakedCommands(std::unique_ptr<BakedRenderBundleCommands> bakedCommands) {
+    DAWN_ASSERT(!IsError());
+    mBakedCommands = std::move(bakedCommands);
+}
+
 }  // namespace dawn::native
@@ -29,6 +29,7 @@
 #define SRC_DAWN_NATIVE_RENDERBUNDLE_H_
 
 #include <bitset>
+#include <memory>
 #include <string>
 
 #include "dawn/common/Constants.h"
@@ -47,6 +48,13 @@ namespace dawn::native {
 struct RenderBundleDescriptor;
 class RenderBundleEncoder;
 
+// The commands of a render bundle translated by the backend to a form that can be replayed each
+// time the bundle is executed. See Toggle::BakeRenderBundleCommands.
+class BakedRenderBundleCommands {
+  public:
+    virtual ~BakedRenderBundleCommands();
+};
+
 class RenderBundleBase final : public ApiObjectBase {
   public:
     RenderBundleBase(RenderBundleEncoder* encoder,
@@ -74,6 +82,11 @@ class RenderBundleBase final : public ApiObjectBase {
     const RenderPassResourceUsage& GetResourceUsage() const;
     const IndirectDrawMetadata& GetIndirectDrawMetadata();
 
+    // The baked commands are created lazily by the backend when the bundle is first executed in
+    // a submitted command buffer, so this is nullptr until then.
+    BakedRenderBundleCommands* GetBakedCommands() const;
+    void SetBakedCommands(std::unique_ptr<BakedRenderBundleCommands> bakedCommands);
+
   private:
     RenderBundleBase(DeviceBase* device, ErrorTag errorTag, const char* label);
 
@@ -87,6 +100,7 @@ class RenderBundleBase final : public ApiObjectBase {
     uint64_t mDrawCount;
     RenderPassResourceUsage mResourceUsage;
     std::string mEncoderLabel;
+    std::unique_ptr<BakedRenderBundleCommands> mBakedCommands;
 };
 
 }  // namespace dawn::native
@@ -228,7 +228,8 @@ void RenderEncoderBase::APIDrawIndirect(BufferBase* indirectBuffer, uint64_t ind
                 // buffer which will store the validated or duplicated indirect data. The buffer
                 // and offset will be updated to point to it.
                 // |EncodeIndirectDrawValidationCommands| is called at the end of encoding the
-                // render pass, while the |cmd| pointer is still valid.
+                // render pass, or at Queue::Submit time when the validation is deferred, while
+                // the |cmd| pointer is still valid.
                 cmd->indirectBuffer = nullptr;
 
                 mIndirectDrawMetadata.AddIndirectDraw(indirectBuffer, indirectOffset,
@@ -284,7 +285,8 @@ void RenderEncoderBase::APIDrawIndexedIndirect(BufferBase* indirectBuffer,
                 // buffer which will store the validated or duplicated indirect data. The buffer
                 // and offset will be updated to point to it.
                 // |EncodeIndirectDrawValidationCommands| is called at the end of encoding the
-                // render pass, while the |cmd| pointer is still valid.
+                // render pass, or at Queue::Submit time when the validation is deferred, while
+                // the |cmd| pointer is still valid.
                 cmd->indirectBuffer = nullptr;
 
                 mIndirectDrawMetadata.AddIndexedIndirectDraw(
@@ -151,14 +151,20 @@ void RenderPassEncoder::TrackQueryAvailability(QuerySetBase* querySet, uint32_t
 }
 
 void RenderPassEncoder::APIEnd() {
-    // The encoding context might create additional resources, so we need to lock the device.
-    auto deviceLock(GetDevice()->GetScopedLock());
+    // Ending the pass only records into the encoding context, unless the pass has indirect draws
+    // to validate or workarounds to apply, which might create additional resources. Only lock the
+    // device in these cases, or to report an error. Errors reported by the encoding context in
+    // the unlocked case lock the device themselves, see EncodingContext::HandleError.
+    if (mEndCallback || (mEnded && IsValidationEnabled()) ||
+        !mIndirectDrawMetadata.GetIndexedIndirectBufferValidationInfo()->empty()) {
+        EncodingContext::ScopedDeviceLock deviceLock(mEncodingContext);
+        End();
+        return;
+    }
     End();
 }
 
 void RenderPassEncoder::End() {
-    DAWN_ASSERT(GetDevice()->IsLockedByCurrentThreadIfNeeded());
-
     if (mEnded && IsValidationEnabled()) {
         GetDevice()->HandleError(DAWN_VALIDATION_ERROR("%s was already ended.", this));
         return;
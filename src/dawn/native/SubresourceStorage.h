@@ -28,6 +28,7 @@
 #ifndef SRC_DAWN_NATIVE_SUBRESOURCESTORAGE_H_
 #define SRC_DAWN_NATIVE_SUBRESOURCESTORAGE_H_
 
+#include <algorithm>
 #include <array>
 #include <limits>
 #include <memory>
@@ -67,33 +68,38 @@ namespace dawn::native {
 //      // `data`.
 //   });
 //
-// SubresourceStorage internally tracks compression state per aspect and then per layer of each
-// aspect. This means that a 2-aspect texture can have the following compression state:
+// SubresourceStorage internally tracks compression state per aspect and then per run of
+// consecutive layers of each aspect. This means that a 2-aspect texture can have the following
+// compression state:
 //
 //  - Aspect 0 is fully compressed.
 //  - Aspect 1 is partially compressed:
 //    - Aspect 1 layer 3 is decompressed.
-//    - Aspect 1 layer 0-2 and 4-42 are compressed.
+//    - Aspect 1 layers 0-2 are compressed in a run.
+//    - Aspect 1 layers 4-42 are compressed in another run.
 //
 // A useful model to reason about SubresourceStorage is to represent is as a tree:
 //
 //  - SubresourceStorage is the root.
 //    |-> Nodes 1 deep represent each aspect. If an aspect is compressed, its node doesn't have
 //       any children because the data is constant across all of the subtree.
-//      |-> Nodes 2 deep represent layers (for uncompressed aspects). If a layer is compressed,
-//         its node doesn't have any children because the data is constant across all of the
-//         subtree.
+//      |-> Nodes 2 deep represent runs of layers (for uncompressed aspects). If a run is
+//         compressed, its node doesn't have any children because the data is constant across
+//         all of the subtree. Decompressed runs always contain a single layer.
 //        |-> Nodes 3 deep represent individial mip levels (for uncompressed layers).
 //
 // The concept of recompression is the removal of all child nodes of a non-leaf node when the
-// data is constant across them. Decompression is the addition of child nodes to a leaf node
-// and copying of its data to all its children.
+// data is constant across them, or the merging of adjacent compressed runs with the same data.
+// Decompression is the addition of child nodes to a leaf node and copying of its data to all
+// its children, or the splitting of a compressed run at a layer boundary.
 //
 // The choice of having secondary compression for array layers is to optimize for the cases
 // where transfer operations are used to update specific layers of texture with render or
 // transfer operations, while the rest is untouched. It seems much less likely that there
 // would be operations that touch all Nth mips of a 2D array texture without touching the
-// others.
+// others. Runs are used instead of per-layer state so that a partial update of a texture with
+// thousands of layers only splits the runs around the updated layers, and iterating over the
+// storage stays proportional to the number of runs instead of the number of layers.
 //
 // There are several hot code paths that create new SubresourceStorage like the tracking of
 // resource usage per-pass. We don't want to allocate a container for the decompressed data
@@ -204,18 +210,35 @@ class SubresourceStorage {
     template <typename U>
     friend class SubresourceStorage;
 
+    // A run of consecutive layers of a decompressed aspect. The data of a compressed run is
+    // stored in the slot for (aspect, baseLayer, 0). Decompressed runs contain a single layer.
+    struct LayerRun {
+        uint16_t baseLayer;
+        uint16_t layerCount;
+        bool compressed;
+    };
+
     void DecompressAspect(uint32_t aspectIndex);
-    void RecompressAspect(uint32_t aspectIndex);
 
-    void DecompressLayer(uint32_t aspectIndex, uint32_t layer);
-    void RecompressLayer(uint32_t aspectIndex, uint32_t layer);
+    // Merges the adjacent compressed runs with the same data in [beginRun, endRun) and
+    // recompresses the aspect if a single compressed run is left.
+    void RecompressLayerRuns(uint32_t aspectIndex, size_t beginRun, size_t endRun);
+
+    // Makes a run start at `layer` by splitting the compressed run containing it and returns
+    // the index of that run.
+    size_t SplitLayerRun(uint32_t aspectIndex, uint32_t layer);
+    // Splits the compressed run at runIndex in compressed runs of a single layer.
+    void SplitLayerRunInLayers(uint32_t aspectIndex, size_t runIndex);
+
+    void DecompressLayer(uint32_t aspectIndex, size_t runIndex);
+    void RecompressLayer(uint32_t aspectIndex, size_t runIndex);
 
-    SubresourceRange GetFullLayerRange(Aspect aspect, uint32_t layer) const;
+    SubresourceRange GetLayerRunRange(Aspect aspect, const LayerRun& run) const;
 
-    // LayerCompressed should never be called when the aspect is compressed otherwise it would
-    // need to check that mLayerCompressed is not null before indexing it.
-    bool& LayerCompressed(uint32_t aspectIndex, uint32_t layerIndex);
-    bool LayerCompressed(uint32_t aspectIndex, uint32_t layerIndex) const;
+    // FindLayerRun and LayerCompressed should never be called when the aspect is compressed
+    // otherwise they would need to check that mLayerRuns is not null before indexing it.
+    size_t FindLayerRun(uint32_t aspectIndex, uint32_t layer) const;
+    bool LayerCompressed(uint32_t aspectIndex, uint32_t layer) const;
 
     // Return references to the data for a compressed plane / layer or subresource.
     // Each variant should be called exactly under the correct compression level.
@@ -228,18 +251,18 @@ class SubresourceStorage {
     uint8_t mMipLevelCount;
     uint16_t mArrayLayerCount;
 
-    // Invariant: if an aspect is marked compressed, then all it's layers are marked as
-    // compressed.
+    // The layer runs are only valid for decompressed aspects.
     static constexpr size_t kMaxAspects = 3;
     std::array<bool, kMaxAspects> mAspectCompressed;
     std::array<T, kMaxAspects> mInlineAspectData;
 
-    // Indexed as mLayerCompressed[aspectIndex * mArrayLayerCount + layer].
-    std::unique_ptr<bool[]> mLayerCompressed;
+    // Indexed as mLayerRuns[aspectIndex]. The runs are sorted by baseLayer and cover all the
+    // layers of the aspect without overlapping.
+    std::unique_ptr<std::vector<LayerRun>[]> mLayerRuns;
 
     // Indexed as mData[(aspectIndex * mArrayLayerCount + layer) * mMipLevelCount + level].
-    // The data for a compressed aspect is stored in the slot for (aspect, 0, 0). Similarly
-    // the data for a compressed layer of aspect if in the slot for (aspect, layer, 0).
+    // The data for a compressed run of layers of an aspect is in the slot for
+    // (aspect, baseLayer, 0).
     std::unique_ptr<T[]> mData;
 };
 
@@ -288,20 +311,31 @@ void SubresourceStorage<T>::Update(const SubresourceRange& range, F&& updateFunc
             DecompressAspect(aspectIndex);
         }
 
+        // Split the runs at the boundaries of the range so that the runs in it are fully
+        // updated. The split at layerEnd is after firstRun so it doesn't change its index.
         uint32_t layerEnd = range.baseArrayLayer + range.layerCount;
-        for (uint32_t layer = range.baseArrayLayer; layer < layerEnd; layer++) {
-            // Call the updateFunc once for the whole layer if possible or decompress and
+        size_t firstRun = SplitLayerRun(aspectIndex, range.baseArrayLayer);
+        if (layerEnd < mArrayLayerCount) {
+            SplitLayerRun(aspectIndex, layerEnd);
+        }
+
+        const std::vector<LayerRun>& runs = mLayerRuns[aspectIndex];
+        size_t runIndex = firstRun;
+        for (; runIndex < runs.size() && runs[runIndex].baseLayer < layerEnd; runIndex++) {
+            // Call the updateFunc once for the whole run if possible or decompress and
             // fallback to per-level handling.
-            if (LayerCompressed(aspectIndex, layer)) {
+            if (runs[runIndex].compressed) {
                 if (fullLayers) {
-                    SubresourceRange updateRange = GetFullLayerRange(aspect, layer);
-                    updateFunc(updateRange, &Data(aspectIndex, layer));
+                    SubresourceRange updateRange = GetLayerRunRange(aspect, runs[runIndex]);
+                    updateFunc(updateRange, &Data(aspectIndex, runs[runIndex].baseLayer));
                     continue;
                 }
-                DecompressLayer(aspectIndex, layer);
+                SplitLayerRunInLayers(aspectIndex, runIndex);
+                DecompressLayer(aspectIndex, runIndex);
             }
 
             // Worst case: call updateFunc per level.
+            uint32_t layer = runs[runIndex].baseLayer;
             uint32_t levelEnd = range.baseMipLevel + range.levelCount;
             for (uint32_t level = range.baseMipLevel; level < levelEnd; level++) {
                 SubresourceRange updateRange = SubresourceRange::MakeSingle(aspect, layer, level);
@@ -310,17 +344,15 @@ void SubresourceStorage<T>::Update(const SubresourceRange& range, F&& updateFunc
 
             // If the range has fullLayers then it is likely we can recompress after the calls
             // to updateFunc (this branch is skipped if updateFunc was called for the whole
-            // layer).
+            // run).
             if (fullLayers) {
-                RecompressLayer(aspectIndex, layer);
+                RecompressLayer(aspectIndex, runIndex);
             }
         }
 
-        // If the range has fullAspects then it is likely we can recompress after the calls to
-        // updateFunc (this branch is skipped if updateFunc was called for the whole aspect).
-        if (fullAspects) {
-            RecompressAspect(aspectIndex);
-        }
+        // The updated runs might now have the same data as each other or as the runs around
+        // them, merge them back together. This also recompresses the aspect if possible.
+        RecompressLayerRuns(aspectIndex, firstRun > 0 ? firstRun - 1 : 0, runIndex + 1);
     }
 }
 
@@ -351,32 +383,76 @@ void SubresourceStorage<T>::Merge(const SubresourceStorage<U>& other, F&& mergeF
             DecompressAspect(aspectIndex);
         }
 
-        for (uint32_t layer = 0; layer < mArrayLayerCount; layer++) {
-            // Similarly to above, use a fast path if other's layer is compressed.
-            if (other.LayerCompressed(aspectIndex, layer)) {
-                const U& otherData = other.Data(aspectIndex, layer);
-                Update(GetFullLayerRange(aspect, layer),
-                       [&](const SubresourceRange& subrange, T* data) {
-                           mergeFunc(subrange, data, otherData);
-                       });
-                continue;
+        // Walk the runs of both storages at once and cut the layers at the boundaries of the
+        // runs of either of them. The pieces are merged in order and their runs appended to a new
+        // run list, which keeps the merge linear in the number of runs.
+        const auto& otherRuns = other.mLayerRuns[aspectIndex];
+        const std::vector<LayerRun> runs = std::move(mLayerRuns[aspectIndex]);
+        std::vector<LayerRun>& mergedRuns = mLayerRuns[aspectIndex];
+        mergedRuns.clear();
+        mergedRuns.reserve(runs.size() + otherRuns.size());
+
+        size_t runIndex = 0;
+        size_t otherRunIndex = 0;
+        uint32_t layer = 0;
+        while (layer < mArrayLayerCount) {
+            const LayerRun& run = runs[runIndex];
+            const auto& otherRun = otherRuns[otherRunIndex];
+            uint32_t runEnd = run.baseLayer + run.layerCount;
+            uint32_t otherRunEnd = otherRun.baseLayer + otherRun.layerCount;
+            uint32_t pieceEnd = std::min(runEnd, otherRunEnd);
+
+            // The data of the piece is in the slot of its first layer. If the compressed run
+            // continues after the piece, copy its data to the first layer of the next piece
+            // before it is modified by the merge.
+            if (pieceEnd < runEnd) {
+                DAWN_ASSERT(run.compressed);
+                Data(aspectIndex, pieceEnd) = Data(aspectIndex, layer);
             }
 
-            // Sad case, other is decompressed for this layer, do per-level merging.
-            if (LayerCompressed(aspectIndex, layer)) {
-                DecompressLayer(aspectIndex, layer);
-            }
+            if (run.compressed && otherRun.compressed) {
+                // Fast path, both runs are compressed so merge the whole piece at once.
+                LayerRun piece = {static_cast<uint16_t>(layer),
+                                  static_cast<uint16_t>(pieceEnd - layer), true};
+                mergedRuns.push_back(piece);
+                mergeFunc(GetLayerRunRange(aspect, piece), &Data(aspectIndex, layer),
+                          other.Data(aspectIndex, otherRun.baseLayer));
+            } else {
+                // Sad case, one of the runs is decompressed for this layer, do per-level
+                // merging.
+                DAWN_ASSERT(pieceEnd == layer + 1);
+                mergedRuns.push_back(LayerRun{static_cast<uint16_t>(layer), 1, false});
+                if (run.compressed) {
+                    const T& layerData = Data(aspectIndex, layer);
+                    for (uint32_t level = 1; level < mMipLevelCount; level++) {
+                        Data(aspectIndex, layer, level) = layerData;
+                    }
+                }
 
-            for (uint32_t level = 0; level < mMipLevelCount; level++) {
-                SubresourceRange updateRange = SubresourceRange::MakeSingle(aspect, layer, level);
-                mergeFunc(updateRange, &Data(aspectIndex, layer, level),
-                          other.Data(aspectIndex, layer, level));
+                for (uint32_t level = 0; level < mMipLevelCount; level++) {
+                    SubresourceRange updateRange =
+                        SubresourceRange::MakeSingle(aspect, layer, level);
+                    const U& otherData = otherRun.compressed
+                                             ? other.Data(aspectIndex, otherRun.baseLayer)
+                                             : other.Data(aspectIndex, layer, level);
+                    mergeFunc(updateRange, &Data(aspectIndex, layer, level), otherData);
+                }
+
+                RecompressLayer(aspectIndex, mergedRuns.size() - 1);
             }
 
-            RecompressLayer(aspectIndex, layer);
+            layer = pieceEnd;
+            if (pieceEnd == runEnd) {
+                runIndex++;
+            }
+            if (pieceEnd == otherRunEnd) {
+                otherRunIndex++;
+            }
         }
 
-        RecompressAspect(aspectIndex);
+        // The merged pieces might now have the same data as each other, merge them back
+        // together. This also recompresses the aspect if possible.
+        RecompressLayerRuns(aspectIndex, 0, mergedRuns.size());
     }
 }
 
@@ -402,19 +478,20 @@ R SubresourceStorage<T>::Iterate(F&& iterateFunc) const {
             continue;
         }
 
-        for (uint32_t layer = 0; layer < mArrayLayerCount; layer++) {
-            // Fast path, call iterateFunc on the whole array layer at once.
-            if (LayerCompressed(aspectIndex, layer)) {
-                SubresourceRange range = GetFullLayerRange(aspect, layer);
+        for (const LayerRun& run : mLayerRuns[aspectIndex]) {
+            // Fast path, call iterateFunc on the whole run of array layers at once.
+            if (run.compressed) {
+                SubresourceRange range = GetLayerRunRange(aspect, run);
                 if constexpr (mayError) {
-                    DAWN_TRY(iterateFunc(range, Data(aspectIndex, layer)));
+                    DAWN_TRY(iterateFunc(range, Data(aspectIndex, run.baseLayer)));
                 } else {
-                    iterateFunc(range, Data(aspectIndex, layer));
+                    iterateFunc(range, Data(aspectIndex, run.baseLayer));
                 }
                 continue;
             }
 
             // Slow path, call iterateFunc for each mip level.
+            uint32_t layer = run.baseLayer;
             for (uint32_t level = 0; level < mMipLevelCount; level++) {
                 SubresourceRange range = SubresourceRange::MakeSingle(aspect, layer, level);
                 if constexpr (mayError) {
@@ -442,9 +519,10 @@ const T& SubresourceStorage<T>::Get(Aspect aspect, uint32_t arrayLayer, uint32_t
         return DataInline(aspectIndex);
     }
 
-    // Fast path, the array layer is compressed.
-    if (LayerCompressed(aspectIndex, arrayLayer)) {
-        return Data(aspectIndex, arrayLayer);
+    // Fast path, the array layer is in a compressed run.
+    const LayerRun& run = mLayerRuns[aspectIndex][FindLayerRun(aspectIndex, arrayLayer)];
+    if (run.compressed) {
+        return Data(aspectIndex, run.baseLayer);
     }
 
     return Data(aspectIndex, arrayLayer, mipLevel);
@@ -473,7 +551,7 @@ bool SubresourceStorage<T>::IsAspectCompressedForTesting(Aspect aspect) const {
 template <typename T>
 bool SubresourceStorage<T>::IsLayerCompressedForTesting(Aspect aspect, uint32_t layer) const {
     return mAspectCompressed[GetAspectIndex(aspect)] ||
-           mLayerCompressed[GetAspectIndex(aspect) * mArrayLayerCount + layer];
+           LayerCompressed(GetAspectIndex(aspect), layer);
 }
 
 template <typename T>
@@ -484,89 +562,142 @@ void SubresourceStorage<T>::DecompressAspect(uint32_t aspectIndex) {
 
     // Extra allocations are only needed when aspects are decompressed. Create them lazily.
     if (mData == nullptr) {
-        DAWN_ASSERT(mLayerCompressed == nullptr);
+        DAWN_ASSERT(mLayerRuns == nullptr);
 
         uint32_t aspectCount = GetAspectCount(mAspects);
-        mLayerCompressed = std::make_unique<bool[]>(aspectCount * mArrayLayerCount);
+        mLayerRuns = std::make_unique<std::vector<LayerRun>[]>(aspectCount);
         mData = std::make_unique<T[]>(aspectCount * mArrayLayerCount * mMipLevelCount);
-
-        for (uint32_t layerIndex = 0; layerIndex < aspectCount * mArrayLayerCount; layerIndex++) {
-            mLayerCompressed[layerIndex] = true;
-        }
     }
 
-    DAWN_ASSERT(LayerCompressed(aspectIndex, 0));
-    for (uint32_t layer = 0; layer < mArrayLayerCount; layer++) {
-        Data(aspectIndex, layer) = aspectData;
-        DAWN_ASSERT(LayerCompressed(aspectIndex, layer));
-    }
+    // All the layers start in a single compressed run.
+    mLayerRuns[aspectIndex].assign(1, LayerRun{0, mArrayLayerCount, true});
+    Data(aspectIndex, 0) = aspectData;
 }
 
 template <typename T>
-void SubresourceStorage<T>::RecompressAspect(uint32_t aspectIndex) {
+void SubresourceStorage<T>::RecompressLayerRuns(uint32_t aspectIndex,
+                                                size_t beginRun,
+                                                size_t endRun) {
     DAWN_ASSERT(!mAspectCompressed[aspectIndex]);
-    // All layers of the aspect must be compressed for the aspect to possibly recompress.
-    for (uint32_t layer = 0; layer < mArrayLayerCount; layer++) {
-        if (!LayerCompressed(aspectIndex, layer)) {
-            return;
+    std::vector<LayerRun>& runs = mLayerRuns[aspectIndex];
+    endRun = std::min(endRun, runs.size());
+    DAWN_ASSERT(beginRun < endRun);
+
+    // Append each run to the last kept run if they are both compressed with the same data,
+    // otherwise keep it.
+    size_t lastRun = beginRun;
+    for (size_t runIndex = beginRun + 1; runIndex < endRun; runIndex++) {
+        LayerRun run = runs[runIndex];
+        LayerRun& last = runs[lastRun];
+        if (last.compressed && run.compressed &&
+            Data(aspectIndex, run.baseLayer) == Data(aspectIndex, last.baseLayer)) {
+            last.layerCount += run.layerCount;
+        } else {
+            runs[++lastRun] = run;
         }
     }
+    runs.erase(runs.begin() + lastRun + 1, runs.begin() + endRun);
 
-    T layer0Data = Data(aspectIndex, 0);
-    for (uint32_t layer = 1; layer < mArrayLayerCount; layer++) {
-        if (!(Data(aspectIndex, layer) == layer0Data)) {
-            return;
-        }
+    // The aspect can be recompressed when a single compressed run covers all the layers.
+    if (runs.size() != 1 || !runs[0].compressed) {
+        return;
     }
 
+    T layer0Data = Data(aspectIndex, 0);
     mAspectCompressed[aspectIndex] = true;
     DataInline(aspectIndex) = layer0Data;
 }
 
 template <typename T>
-void SubresourceStorage<T>::DecompressLayer(uint32_t aspectIndex, uint32_t layer) {
-    DAWN_ASSERT(LayerCompressed(aspectIndex, layer));
+size_t SubresourceStorage<T>::SplitLayerRun(uint32_t aspectIndex, uint32_t layer) {
+    std::vector<LayerRun>& runs = mLayerRuns[aspectIndex];
+    size_t runIndex = FindLayerRun(aspectIndex, layer);
+    LayerRun run = runs[runIndex];
+    if (run.baseLayer == layer) {
+        return runIndex;
+    }
+
+    // Only compressed runs contain more than one layer. The new run starts with the same data.
+    DAWN_ASSERT(run.compressed);
+    uint32_t runEnd = run.baseLayer + run.layerCount;
+    runs[runIndex].layerCount = static_cast<uint16_t>(layer - run.baseLayer);
+    LayerRun newRun = {static_cast<uint16_t>(layer), static_cast<uint16_t>(runEnd - layer), true};
+    runs.insert(runs.begin() + runIndex + 1, newRun);
+    Data(aspectIndex, layer) = Data(aspectIndex, run.baseLayer);
+    return runIndex + 1;
+}
+
+template <typename T>
+void SubresourceStorage<T>::SplitLayerRunInLayers(uint32_t aspectIndex, size_t runIndex) {
+    std::vector<LayerRun>& runs = mLayerRuns[aspectIndex];
+    LayerRun run = runs[runIndex];
+    DAWN_ASSERT(run.compressed);
+    if (run.layerCount == 1) {
+        return;
+    }
+
+    // Insert all the new runs at once to avoid moving the following runs once per layer.
+    runs[runIndex].layerCount = 1;
+    runs.insert(runs.begin() + runIndex + 1, static_cast<size_t>(run.layerCount - 1), run);
+    const T& runData = Data(aspectIndex, run.baseLayer);
+    for (uint32_t i = 1; i < run.layerCount; i++) {
+        uint32_t layer = run.baseLayer + i;
+        runs[runIndex + i] = LayerRun{static_cast<uint16_t>(layer), 1, true};
+        Data(aspectIndex, layer) = runData;
+    }
+}
+
+template <typename T>
+void SubresourceStorage<T>::DecompressLayer(uint32_t aspectIndex, size_t runIndex) {
+    LayerRun& run = mLayerRuns[aspectIndex][runIndex];
+    DAWN_ASSERT(run.compressed && run.layerCount == 1);
     DAWN_ASSERT(!mAspectCompressed[aspectIndex]);
-    const T& layerData = Data(aspectIndex, layer);
-    LayerCompressed(aspectIndex, layer) = false;
+    const T& layerData = Data(aspectIndex, run.baseLayer);
+    run.compressed = false;
 
     // We assume that (aspect, layer, 0) is stored at the same place as (aspect, layer) which
     // allows starting the iteration at level 1.
     for (uint32_t level = 1; level < mMipLevelCount; level++) {
-        Data(aspectIndex, layer, level) = layerData;
+        Data(aspectIndex, run.baseLayer, level) = layerData;
     }
 }
 
 template <typename T>
-void SubresourceStorage<T>::RecompressLayer(uint32_t aspectIndex, uint32_t layer) {
-    DAWN_ASSERT(!LayerCompressed(aspectIndex, layer));
+void SubresourceStorage<T>::RecompressLayer(uint32_t aspectIndex, size_t runIndex) {
+    LayerRun& run = mLayerRuns[aspectIndex][runIndex];
+    DAWN_ASSERT(!run.compressed && run.layerCount == 1);
     DAWN_ASSERT(!mAspectCompressed[aspectIndex]);
-    const T& level0Data = Data(aspectIndex, layer, 0);
+    const T& level0Data = Data(aspectIndex, run.baseLayer, 0);
 
     for (uint32_t level = 1; level < mMipLevelCount; level++) {
-        if (!(Data(aspectIndex, layer, level) == level0Data)) {
+        if (!(Data(aspectIndex, run.baseLayer, level) == level0Data)) {
             return;
         }
     }
 
-    LayerCompressed(aspectIndex, layer) = true;
+    run.compressed = true;
 }
 
 template <typename T>
-SubresourceRange SubresourceStorage<T>::GetFullLayerRange(Aspect aspect, uint32_t layer) const {
-    return {aspect, {layer, 1}, {0, mMipLevelCount}};
+SubresourceRange SubresourceStorage<T>::GetLayerRunRange(Aspect aspect,
+                                                         const LayerRun& run) const {
+    return {aspect, {run.baseLayer, run.layerCount}, {0, mMipLevelCount}};
 }
 
 template <typename T>
-bool& SubresourceStorage<T>::LayerCompressed(uint32_t aspectIndex, uint32_t layer) {
+size_t SubresourceStorage<T>::FindLayerRun(uint32_t aspectIndex, uint32_t layer) const {
     DAWN_ASSERT(!mAspectCompressed[aspectIndex]);
-    return mLayerCompressed[aspectIndex * mArrayLayerCount + layer];
+    const std::vector<LayerRun>& runs = mLayerRuns[aspectIndex];
+    auto it = std::upper_bound(
+        runs.begin(), runs.end(), layer,
+        [](uint32_t searchedLayer, const LayerRun& run) { return searchedLayer < run.baseLayer; });
+    DAWN_ASSERT(it != runs.begin());
+    return static_cast<size_t>(it - runs.begin()) - 1;
 }
 
 template <typename T>
 bool SubresourceStorage<T>::LayerCompressed(uint32_t aspectIndex, uint32_t layer) const {
-    DAWN_ASSERT(!mAspectCompressed[aspectIndex]);
-    return mLayerCompressed[aspectIndex * mArrayLayerCount + layer];
+    return mLayerRuns[aspectIndex][FindLayerRun(aspectIndex, layer)].compressed;
 }
 
 template <typename T>
@@ -28,6 +28,7 @@
 #ifndef SRC_DAWN_NATIVE_TEXTURE_H_
 #define SRC_DAWN_NATIVE_TEXTURE_H_
 
+#include <atomic>
 #include <vector>
 
 #include "dawn/common/WeakRef.h"
@@ -173,6 +174,8 @@ class TextureBase : public ApiObjectBase {
     Ref<SharedTextureMemoryContents> mSharedTextureMemoryContents;
 
   private:
+    friend class SyncScopeUsageTracker;
+
     struct TextureState {
         TextureState();
 
@@ -203,6 +206,9 @@ class TextureBase : public ApiObjectBase {
 
     // TODO(crbug.com/dawn/845): Use a more optimized data structure to save space
     std::vector<bool> mIsSubresourceContentInitializedAtIndex;
+
+    // Identifies the entry of this texture in the last SyncScopeUsageTracker that used it.
+    std::atomic<uint64_t> mSyncScopeUsageStamp = 0;
 };
 
 class TextureViewBase : public ApiObjectBase {
@@ -521,6 +521,64 @@ static constexpr ToggleEnumAndInfoList kToggleNameAndInfoList = {{
       "waiting for the next Tick. This enables using the stack trace in which the uncaptured error "
       "occured when breaking into the uncaptured error callback.",
       "https://crbug.com/dawn/1789", ToggleStage::Device}},
+    {Toggle::VulkanTrimIdleResourceHeaps,
+     {"vulkan_trim_idle_resource_heaps",
+      "Release the empty sub-allocation heaps kept in the Vulkan resource memory pools once the "
+      "device has been idle for a number of ticks, returning their VkDeviceMemory to the driver "
+      "instead of keeping it around for reuse.",
+      "https://crbug.com/dawn/849", ToggleStage::Device}},
+    {Toggle::VulkanBoundRenderPassCache,
+     {"vulkan_bound_render_pass_cache",
+      "Bound the number of VkRenderPasses cached by the Vulkan backend and evict the least "
+      "recently used ones when it is full. This keeps the number of live VkRenderPasses in check "
+      "for applications that use many different attachment formats and load/store operations.",
+      "https://crbug.com/dawn/849", ToggleStage::Device}},
+    {Toggle::VulkanRecordRenderPassesInParallel,
+     {"vulkan_record_render_passes_in_parallel",
+      "Split render passes with many draws in up to one chunk per hardware thread. The chunks are "
+      "recorded in parallel in secondary command buffers on threads owned by the device. Render "
+      "passes using debug groups, occlusion queries or timestamp writes are still recorded in the "
+      "primary command buffer.",
+      "https://crbug.com/dawn/849", ToggleStage::Device}},
+    {Toggle::VulkanUseTimelineSemaphore,
+     {"vulkan_use_timeline_semaphore",
+      "Track the completion of the Vulkan queue submits with a single timeline semaphore whose "
+      "value is the submit's serial, instead of a fence per submit. Only takes effect when "
+      "VK_KHR_timeline_semaphore or Vulkan 1.2 is supported. Enabled by default when supported.",
+      "https://crbug.com/dawn/849", ToggleStage::Device}},
+    {Toggle::VulkanMonolithicPipelineCache,
+     {"vulkan_monolithic_pipeline_cache",
+      "Create all the Vulkan pipelines of the device with a single VkPipelineCache stored in the "
+      "blob cache under a device-wide key, instead of one VkPipelineCache per pipeline. The cache "
+      "is serialized on a worker thread after pipelines are added to it.",
+      "https://crbug.com/dawn/549", ToggleStage::Device}},
+    {Toggle::VulkanDirectWriteBufferOnUMA,
+     {"vulkan_direct_write_buffer_on_uma",
+      "Implement Queue::WriteBuffer with a CPU copy into the destination buffer when its memory is "
+      "host-visible and host-coherent and the GPU is done using it, instead of going through a "
+      "staging buffer and a GPU copy. Enabled by default on integrated and CPU adapters.",
+      "https://crbug.com/dawn/849", ToggleStage::Device}},
+    {Toggle::BatchIndirectDrawValidationAtSubmit,
+     {"batch_indirect_draw_validation_at_submit",
+      "Validate the indirect draws of render passes at Queue::Submit time, with one compute pass "
+      "shared by all the command buffers of the submit, instead of inserting a compute pass "
+      "before each render pass. Render passes that execute render bundles, or whose indirect "
+      "buffers may have been written earlier in the same command buffer, are still validated "
+      "during encoding.",
+      "https://crbug.com/dawn/1039", ToggleStage::Device}},
+    {Toggle::SkipUnchangedIndirectDrawValidation,
+     {"skip_unchanged_indirect_draw_validation",
+      "Keep the validated parameters of indirect draws across submits and reuse them while the "
+      "contents of the indirect buffer are known to be unchanged. Only has an effect when "
+      "batch_indirect_draw_validation_at_submit is enabled.",
+      "https://crbug.com/dawn/1039", ToggleStage::Device}},
+    {Toggle::BakeRenderBundleCommands,
+     {"bake_render_bundle_commands",
+      "Translate the commands of render bundles to a backend-specific form the first time they "
+      "are executed and replay it on the following executions, instead of translating them each "
+      "time. On Vulkan the bundles are recorded in secondary command buffers, one for each "
+      "render pass configuration and dynamic state they are executed with.",
+      "https://crbug.com/dawn/849", ToggleStage::Device}},
     {Toggle::NoWorkaroundSampleMaskBecomesZeroForAllButLastColorTarget,
      {"no_workaround_sample_mask_becomes_zero_for_all_but_last_color_target",
       "MacOS 12.0+ Intel has a bug where the sample mask is only applied for the last color "
@@ -129,6 +129,15 @@ enum class Toggle {
     ExposeWGSLExperimentalFeatures,
     DisablePolyfillsOnIntegerDivisonAndModulo,
     EnableImmediateErrorHandling,
+    VulkanTrimIdleResourceHeaps,
+    VulkanBoundRenderPassCache,
+    VulkanRecordRenderPassesInParallel,
+    VulkanUseTimelineSemaphore,
+    VulkanMonolithicPipelineCache,
+    VulkanDirectWriteBufferOnUMA,
+    BatchIndirectDrawValidationAtSubmit,
+    SkipUnchangedIndirectDrawValidation,
+    BakeRenderBundleCommands,
 
     // Unresolved issues.
     NoWorkaroundSampleMaskBecomesZeroForAllButLastColorTarget,
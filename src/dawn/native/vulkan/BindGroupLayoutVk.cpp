@@ -143,10 +143,9 @@ MaybeError BindGroupLayout::Initialize() {
         descriptorCountPerType[vulkanType]++;
     }
 
-    // TODO(enga): Consider deduping allocators for layouts with the same descriptor type
-    // counts.
+    // Layouts with the same descriptor type counts share their descriptor pools.
     mDescriptorSetAllocator =
-        DescriptorSetAllocator::Create(this, std::move(descriptorCountPerType));
+        device->GetOrCreateDescriptorSetAllocator(std::move(descriptorCountPerType));
 
     SetLabelImpl();
 
@@ -184,18 +183,29 @@ VkDescriptorSetLayout BindGroupLayout::GetHandle() const {
 ResultOrError<Ref<BindGroup>> BindGroupLayout::AllocateBindGroup(
     Device* device,
     const BindGroupDescriptor* descriptor) {
-    DescriptorSetAllocation descriptorSetAllocation;
-    DAWN_TRY_ASSIGN(descriptorSetAllocation, mDescriptorSetAllocator->Allocate());
-
-    return AcquireRef(mBindGroupAllocator->Allocate(device, descriptor, descriptorSetAllocation));
+    Ref<BindGroup> bindGroup = AcquireRef(mBindGroupAllocator->Allocate(device, descriptor));
+    DAWN_TRY(bindGroup->Initialize());
+    return bindGroup;
 }
 
-void BindGroupLayout::DeallocateBindGroup(BindGroup* bindGroup,
-                                          DescriptorSetAllocation* descriptorSetAllocation) {
-    mDescriptorSetAllocator->Deallocate(descriptorSetAllocation);
+void BindGroupLayout::DeallocateBindGroup(BindGroup* bindGroup) {
     mBindGroupAllocator->Deallocate(bindGroup);
 }
 
+ResultOrError<DescriptorSetAllocation> BindGroupLayout::AcquireDescriptorSet(BindGroup* bindGroup) {
+    return mDescriptorSetCache->GetOrCreate(bindGroup, mDescriptorSetAllocator.Get());
+}
+
+void BindGroupLayout::ReleaseDescriptorSet(BindGroup* bindGroup,
+                                           DescriptorSetAllocation* descriptorSetAllocation) {
+    mDescriptorSetCache->Release(bindGroup, descriptorSetAllocation,
+                                 mDescriptorSetAllocator.Get());
+}
+
+DescriptorSetAllocator* BindGroupLayout::GetDescriptorSetAllocatorForTesting() const {
+    return mDescriptorSetAllocator.Get();
+}
+
 void BindGroupLayout::SetLabelImpl() {
     SetDebugName(ToBackend(GetDevice()), mHandle, "Dawn_BindGroupLayout", GetLabel());
 }
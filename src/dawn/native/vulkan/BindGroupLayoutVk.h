@@ -35,6 +35,7 @@
 #include "dawn/common/vulkan_platform.h"
 #include "dawn/native/BindGroupLayoutInternal.h"
 #include "dawn/native/vulkan/BindGroupVk.h"
+#include "dawn/native/vulkan/DescriptorSetCache.h"
 
 namespace dawn::native {
 class CacheKey;
@@ -71,8 +72,13 @@ class BindGroupLayout final : public BindGroupLayoutInternalBase {
 
     ResultOrError<Ref<BindGroup>> AllocateBindGroup(Device* device,
                                                     const BindGroupDescriptor* descriptor);
-    void DeallocateBindGroup(BindGroup* bindGroup,
-                             DescriptorSetAllocation* descriptorSetAllocation);
+    void DeallocateBindGroup(BindGroup* bindGroup);
+
+    ResultOrError<DescriptorSetAllocation> AcquireDescriptorSet(BindGroup* bindGroup);
+    void ReleaseDescriptorSet(BindGroup* bindGroup,
+                              DescriptorSetAllocation* descriptorSetAllocation);
+
+    DescriptorSetAllocator* GetDescriptorSetAllocatorForTesting() const;
 
   private:
     ~BindGroupLayout() override;
@@ -85,7 +91,8 @@ class BindGroupLayout final : public BindGroupLayoutInternalBase {
     VkDescriptorSetLayout mHandle = VK_NULL_HANDLE;
 
     MutexProtected<SlabAllocator<BindGroup>> mBindGroupAllocator;
-    MutexProtected<Ref<DescriptorSetAllocator>> mDescriptorSetAllocator;
+    Ref<DescriptorSetAllocator> mDescriptorSetAllocator;
+    MutexProtected<DescriptorSetCache> mDescriptorSetCache;
 };
 
 }  // namespace dawn::native::vulkan
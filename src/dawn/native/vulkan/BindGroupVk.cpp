@@ -49,11 +49,19 @@ ResultOrError<Ref<BindGroup>> BindGroup::Create(Device* device,
         ->AllocateBindGroup(device, descriptor);
 }
 
-BindGroup::BindGroup(Device* device,
-                     const BindGroupDescriptor* descriptor,
-                     DescriptorSetAllocation descriptorSetAllocation)
-    : BindGroupBase(this, device, descriptor), mDescriptorSetAllocation(descriptorSetAllocation) {
-    // Now do a write of a single descriptor set with all possible chained data allocated on the
+BindGroup::BindGroup(Device* device, const BindGroupDescriptor* descriptor)
+    : BindGroupBase(this, device, descriptor) {}
+
+BindGroup::~BindGroup() = default;
+
+MaybeError BindGroup::Initialize() {
+    DAWN_TRY_ASSIGN(mDescriptorSetAllocation, ToBackend(GetLayout())->AcquireDescriptorSet(this));
+    SetLabelImpl();
+    return {};
+}
+
+void BindGroup::WriteDescriptorSet(VkDescriptorSet set) {
+    // Do a write of a single descriptor set with all possible chained data allocated on the
     // stack.
     const uint32_t bindingCount = static_cast<uint32_t>((GetLayout()->GetBindingCount()));
     ityp::stack_vec<uint32_t, VkWriteDescriptorSet, kMaxOptimalBindingsPerGroup> writes(
@@ -73,7 +81,7 @@ BindGroup::BindGroup(Device* device,
         auto& write = writes[numWrites];
         write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
         write.pNext = nullptr;
-        write.dstSet = GetHandle();
+        write.dstSet = set;
         write.dstBinding = static_cast<uint32_t>(bindingIndex);
         write.dstArrayElement = 0;
         write.descriptorCount = 1;
@@ -153,16 +161,18 @@ BindGroup::BindGroup(Device* device,
     }
 
     // TODO(crbug.com/dawn/855): Batch these updates
+    Device* device = ToBackend(GetDevice());
     device->fn.UpdateDescriptorSets(device->GetVkDevice(), numWrites, writes.data(), 0, nullptr);
-
-    SetLabelImpl();
 }
 
-BindGroup::~BindGroup() = default;
-
 void BindGroup::DestroyImpl() {
+    // The descriptor set cache identifies the descriptor set by the bindings, so release it
+    // before the bindings are released. The allocation is empty if Initialize failed.
+    if (mDescriptorSetAllocation.set != VK_NULL_HANDLE) {
+        ToBackend(GetLayout())->ReleaseDescriptorSet(this, &mDescriptorSetAllocation);
+    }
     BindGroupBase::DestroyImpl();
-    ToBackend(GetLayout())->DeallocateBindGroup(this, &mDescriptorSetAllocation);
+    ToBackend(GetLayout())->DeallocateBindGroup(this);
 }
 
 VkDescriptorSet BindGroup::GetHandle() const {
@@ -170,6 +180,8 @@ VkDescriptorSet BindGroup::GetHandle() const {
 }
 
 void BindGroup::SetLabelImpl() {
+    // The descriptor set is shared by all the bind groups with the same contents, so it is named
+    // after the last of them that was created or relabeled.
     SetDebugName(ToBackend(GetDevice()), mDescriptorSetAllocation.set, "Dawn_BindGroup",
                  GetLabel());
 }
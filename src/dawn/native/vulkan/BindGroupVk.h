@@ -43,12 +43,15 @@ class BindGroup final : public BindGroupBase, public PlacementAllocated {
     static ResultOrError<Ref<BindGroup>> Create(Device* device,
                                                 const BindGroupDescriptor* descriptor);
 
-    BindGroup(Device* device,
-              const BindGroupDescriptor* descriptor,
-              DescriptorSetAllocation descriptorSetAllocation);
+    BindGroup(Device* device, const BindGroupDescriptor* descriptor);
+
+    MaybeError Initialize();
 
     VkDescriptorSet GetHandle() const;
 
+    // Writes the bindings of this bind group in `set`.
+    void WriteDescriptorSet(VkDescriptorSet set);
+
   private:
     ~BindGroup() override;
 
@@ -58,7 +61,8 @@ class BindGroup final : public BindGroupBase, public PlacementAllocated {
     void SetLabelImpl() override;
 
     // The descriptor set in this allocation outlives the BindGroup because it is owned by
-    // the BindGroupLayout which is referenced by the BindGroup.
+    // the BindGroupLayout which is referenced by the BindGroup. It may be shared with other bind
+    // groups with the same contents through the layout's DescriptorSetCache.
     DescriptorSetAllocation mDescriptorSetAllocation;
 };
 
@@ -375,16 +375,20 @@ VkBuffer Buffer::GetHandle() const {
 void Buffer::TransitionUsageNow(CommandRecordingContext* recordingContext,
                                 wgpu::BufferUsage usage,
                                 wgpu::ShaderStage shaderStage) {
+    TransitionUsageLater(recordingContext, usage, shaderStage);
+    recordingContext->RecordPendingBarriers(ToBackend(GetDevice())->fn);
+}
+
+void Buffer::TransitionUsageLater(CommandRecordingContext* recordingContext,
+                                  wgpu::BufferUsage usage,
+                                  wgpu::ShaderStage shaderStage) {
     VkBufferMemoryBarrier barrier;
     VkPipelineStageFlags srcStages = 0;
     VkPipelineStageFlags dstStages = 0;
 
     if (TrackUsageAndGetResourceBarrier(recordingContext, usage, shaderStage, &barrier, &srcStages,
                                         &dstStages)) {
-        DAWN_ASSERT(srcStages != 0 && dstStages != 0);
-        ToBackend(GetDevice())
-            ->fn.CmdPipelineBarrier(recordingContext->commandBuffer, srcStages, dstStages, 0, 0,
-                                    nullptr, 1u, &barrier, 0, nullptr);
+        recordingContext->pendingBarriers.AddBufferBarrier(srcStages, dstStages, barrier);
     }
 }
 
@@ -628,41 +632,103 @@ void Buffer::TransitionMappableBuffersEagerly(const VulkanFunctions& fn,
                                               const std::set<Ref<Buffer>>& buffers) {
     DAWN_ASSERT(!buffers.empty());
 
-    VkPipelineStageFlags srcStages = 0;
-    VkPipelineStageFlags dstStages = 0;
-
-    std::vector<VkBufferMemoryBarrier> barriers;
-    barriers.reserve(buffers.size());
-
     size_t originalBufferCount = buffers.size();
     for (const Ref<Buffer>& buffer : buffers) {
         wgpu::BufferUsage mapUsage = buffer->GetUsage() & kMappableBufferUsages;
         DAWN_ASSERT(mapUsage == wgpu::BufferUsage::MapRead ||
                     mapUsage == wgpu::BufferUsage::MapWrite);
         VkBufferMemoryBarrier barrier;
+        VkPipelineStageFlags srcStages = 0;
+        VkPipelineStageFlags dstStages = 0;
 
         if (buffer->TrackUsageAndGetResourceBarrier(recordingContext, mapUsage,
                                                     wgpu::ShaderStage::None, &barrier, &srcStages,
                                                     &dstStages)) {
-            barriers.push_back(barrier);
+            recordingContext->pendingBarriers.AddBufferBarrier(srcStages, dstStages, barrier);
         }
     }
     // TrackUsageAndGetResourceBarrier() should not modify recordingContext for map usages.
     DAWN_ASSERT(buffers.size() == originalBufferCount);
 
-    if (barriers.empty()) {
-        return;
-    }
-
-    DAWN_ASSERT(srcStages != 0 && dstStages != 0);
-    fn.CmdPipelineBarrier(recordingContext->commandBuffer, srcStages, dstStages, 0, 0, nullptr,
-                          barriers.size(), barriers.data(), 0, nullptr);
+    recordingContext->RecordPendingBarriers(fn);
 }
 
 void Buffer::SetLabelImpl() {
     SetDebugName(ToBackend(GetDevice()), mHandle, "Dawn_Buffer", GetLabel());
 }
 
+bool Buffer::CanWriteDirectly() const {
+    Device* device = ToBackend(GetDevice());
+    if (!device->IsToggleEnabled(Toggle::VulkanDirectWriteBufferOnUMA)) {
+        return false;
+    }
+
+    // Host-mapped buffers use dedicated memory that isn't in mMemoryAllocation.
+    ResourceHeap* heap = ToBackend(mMemoryAllocation.GetResourceHeap());
+    if (heap == nullptr) {
+        return false;
+    }
+    constexpr VkMemoryPropertyFlags kHostWritableFlags =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    VkMemoryPropertyFlags memoryFlags =
+        device->GetDeviceInfo().memoryTypes[heap->GetMemoryType()].propertyFlags;
+    return (memoryFlags & kHostWritableFlags) == kHostWritableFlags;
+}
+
+bool Buffer::IsUsedInPendingOrInFlightCommands() const {
+    return mLastUsageSerial > GetDevice()->GetQueue()->GetCompletedCommandSerial();
+}
+
+void Buffer::TransitionForDirectWrites(CommandRecordingContext* recordingContext) {
+    if (CanWriteDirectly()) {
+        TransitionUsageNow(recordingContext, wgpu::BufferUsage::MapWrite);
+    }
+}
+
+ResultOrError<bool> Buffer::TryWriteDirectly(uint64_t offset, const void* data, size_t size) {
+    if (!CanWriteDirectly()) {
+        return false;
+    }
+
+    // The buffer might be used by commands that are still executing on the GPU or that are
+    // recorded in the pending recording context, in which case the write must be ordered after
+    // them on the queue timeline.
+    if (IsUsedInPendingOrInFlightCommands()) {
+        return false;
+    }
+
+    // A completed fence doesn't make device writes available to the host: like for MapAsync, a
+    // barrier to the host stage must be executed between the last GPU write and the host write.
+    if (!IsSubset(mLastWriteUsage, kMappableBufferUsages)) {
+        return false;
+    }
+
+    // Mappable buffers are mapped by the allocator. Other host-visible memory is mapped lazily
+    // and stays mapped, whether it is sub-allocated or not.
+    Device* device = ToBackend(GetDevice());
+    uint8_t* memory = mMemoryAllocation.GetMappedPointer();
+    if (memory == nullptr) {
+        ResourceHeap* heap = ToBackend(mMemoryAllocation.GetResourceHeap());
+        DAWN_TRY_ASSIGN(memory, heap->GetOrMapPointer(device));
+        memory += mMemoryAllocation.GetOffset();
+    }
+
+    if (NeedsInitialization()) {
+        if (IsFullBufferRange(offset, size)) {
+            SetIsDataInitialized();
+        } else {
+            memset(memory, 0, GetAllocatedSize());
+            device->IncrementLazyClearCountForTesting();
+            SetIsDataInitialized();
+        }
+    }
+
+    // Host writes to coherent memory are made available to the device by the next
+    // vkQueueSubmit, so no barrier is needed.
+    memcpy(memory + offset, data, size);
+    return true;
+}
+
 void Buffer::InitializeToZero(CommandRecordingContext* recordingContext) {
     DAWN_ASSERT(NeedsInitialization());
 
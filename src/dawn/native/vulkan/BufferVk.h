@@ -51,11 +51,15 @@ class Buffer final : public BufferBase {
     VkBuffer GetHandle() const;
 
     // Transitions the buffer to be used as `usage`, recording any necessary barrier in
-    // `commands`.
-    // TODO(crbug.com/dawn/851): coalesce barriers and do them early when possible.
+    // `commands` along with the other pending barriers of the recording context.
     void TransitionUsageNow(CommandRecordingContext* recordingContext,
                             wgpu::BufferUsage usage,
                             wgpu::ShaderStage shaderStage = wgpu::ShaderStage::None);
+    // Same as TransitionUsageNow, but only adds the barrier to the pending barriers of the
+    // recording context so that it can be coalesced with the barriers of other transitions.
+    void TransitionUsageLater(CommandRecordingContext* recordingContext,
+                              wgpu::BufferUsage usage,
+                              wgpu::ShaderStage shaderStage = wgpu::ShaderStage::None);
     bool TrackUsageAndGetResourceBarrier(CommandRecordingContext* recordingContext,
                                          wgpu::BufferUsage usage,
                                          wgpu::ShaderStage shaderStage,
@@ -71,6 +75,16 @@ class Buffer final : public BufferBase {
     bool EnsureDataInitializedAsDestination(CommandRecordingContext* recordingContext,
                                             const CopyTextureToBufferCmd* copy);
 
+    // Implements Queue::WriteBuffer with a CPU copy if the buffer's memory is host-visible and
+    // host-coherent, the GPU is done using the buffer and its last write is visible to the host.
+    // Returns false if the caller must use a staging buffer instead.
+    ResultOrError<bool> TryWriteDirectly(uint64_t offset, const void* data, size_t size);
+    // Records the barrier that makes the GPU writes of the buffer visible to the host, so that
+    // TryWriteDirectly can succeed once the recorded commands are complete.
+    void TransitionForDirectWrites(CommandRecordingContext* recordingContext);
+    // Whether the buffer is used by commands that are pending or still executing on the GPU.
+    bool IsUsedInPendingOrInFlightCommands() const;
+
     // Dawn API
     void SetLabelImpl() override;
 
@@ -84,6 +98,7 @@ class Buffer final : public BufferBase {
 
     MaybeError Initialize(bool mappedAtCreation);
     MaybeError InitializeHostMapped(const BufferHostMappedPointer* hostMappedDesc);
+    bool CanWriteDirectly() const;
     void InitializeToZero(CommandRecordingContext* recordingContext);
     void ClearBuffer(CommandRecordingContext* recordingContext,
                      uint32_t clearValue,
@@ -28,6 +28,9 @@
 #include "dawn/native/vulkan/CommandBufferVk.h"
 
 #include <algorithm>
+#include <memory>
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include "dawn/native/BindGroupTracker.h"
@@ -52,6 +55,7 @@
 #include "dawn/native/vulkan/TextureVk.h"
 #include "dawn/native/vulkan/UtilsVulkan.h"
 #include "dawn/native/vulkan/VulkanError.h"
+#include "dawn/platform/DawnPlatform.h"
 
 namespace dawn::native::vulkan {
 
@@ -153,53 +157,30 @@ class DescriptorSetTracker : public BindGroupTrackerBase<true, uint32_t> {
   public:
     DescriptorSetTracker() = default;
 
-    void Apply(Device* device,
-               CommandRecordingContext* recordingContext,
-               VkPipelineBindPoint bindPoint) {
+    void Apply(Device* device, VkCommandBuffer commands, VkPipelineBindPoint bindPoint) {
         BeforeApply();
         for (BindGroupIndex dirtyIndex : IterateBitSet(mDirtyBindGroupsObjectChangedOrIsDynamic)) {
             VkDescriptorSet set = ToBackend(mBindGroups[dirtyIndex])->GetHandle();
             uint32_t count = static_cast<uint32_t>(mDynamicOffsets[dirtyIndex].size());
             const uint32_t* dynamicOffset =
                 count > 0 ? mDynamicOffsets[dirtyIndex].data() : nullptr;
-            device->fn.CmdBindDescriptorSets(
-                recordingContext->commandBuffer, bindPoint, ToBackend(mPipelineLayout)->GetHandle(),
-                static_cast<uint32_t>(dirtyIndex), 1, &*set, count, dynamicOffset);
+            device->fn.CmdBindDescriptorSets(commands, bindPoint,
+                                             ToBackend(mPipelineLayout)->GetHandle(),
+                                             static_cast<uint32_t>(dirtyIndex), 1, &*set, count,
+                                             dynamicOffset);
         }
         AfterApply();
     }
 };
 
-// Records the necessary barriers for a synchronization scope using the resource usage
-// data pre-computed in the frontend. Also performs lazy initialization if required.
+// Adds the necessary barriers for a synchronization scope to the pending barriers of the recording
+// context using the resource usage data pre-computed in the frontend. Also performs lazy
+// initialization if required. The pending barriers must be recorded before the commands of the
+// synchronization scope.
 MaybeError TransitionAndClearForSyncScope(Device* device,
                                           CommandRecordingContext* recordingContext,
                                           const SyncScopeResourceUsage& scope) {
-    // Separate barriers with vertex stages in destination stages from all other barriers.
-    // This avoids creating unnecessary fragment->vertex dependencies when merging barriers.
-    // Eg. merging a compute->vertex barrier and a fragment->fragment barrier would create
-    // a compute|fragment->vertex|fragment barrier.
-    const VkPipelineStageFlags vertexStages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
-                                              VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
-                                              VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
-
-    struct Barriers {
-        std::vector<VkBufferMemoryBarrier> bufferBarriers;
-        std::vector<VkImageMemoryBarrier> imageBarriers;
-        VkPipelineStageFlags srcStages = 0;
-        VkPipelineStageFlags dstStages = 0;
-    };
-
-    Barriers vertexBarriers;
-    Barriers nonVertexBarriers;
-
-    auto MergeBufferBarrier = [](Barriers* barriers, VkPipelineStageFlags srcStages,
-                                 VkPipelineStageFlags dstStages,
-                                 const VkBufferMemoryBarrier& bufferBarrier) {
-        barriers->srcStages |= srcStages;
-        barriers->dstStages |= dstStages;
-        barriers->bufferBarriers.push_back(bufferBarrier);
-    };
+    PipelineBarrierBatch* barriers = &recordingContext->pendingBarriers;
 
     for (size_t i = 0; i < scope.buffers.size(); ++i) {
         Buffer* buffer = ToBackend(scope.buffers[i]);
@@ -212,21 +193,11 @@ MaybeError TransitionAndClearForSyncScope(Device* device,
         if (buffer->TrackUsageAndGetResourceBarrier(
                 recordingContext, scope.bufferSyncInfos[i].usage,
                 scope.bufferSyncInfos[i].shaderStages, &bufferBarrier, &srcStages, &dstStages)) {
-            MergeBufferBarrier((dstStages & vertexStages) ? &vertexBarriers : &nonVertexBarriers,
-                               srcStages, dstStages, bufferBarrier);
+            barriers->AddBufferBarrier(srcStages, dstStages, bufferBarrier);
         }
     }
 
-    auto MergeImageBarriers = [](Barriers* barriers, VkPipelineStageFlags srcStages,
-                                 VkPipelineStageFlags dstStages,
-                                 const std::vector<VkImageMemoryBarrier>& imageBarriers) {
-        barriers->srcStages |= srcStages;
-        barriers->dstStages |= dstStages;
-        barriers->imageBarriers.insert(barriers->imageBarriers.end(), imageBarriers.begin(),
-                                       imageBarriers.end());
-    };
-
-    // TODO(crbug.com/dawn/851): Add image barriers directly to the correct vector.
+    // TODO(crbug.com/dawn/851): Add image barriers directly to the pending barriers.
     std::vector<VkImageMemoryBarrier> imageBarriers;
     for (size_t i = 0; i < scope.textures.size(); ++i) {
         Texture* texture = ToBackend(scope.textures[i]);
@@ -247,20 +218,8 @@ MaybeError TransitionAndClearForSyncScope(Device* device,
         texture->TransitionUsageForPass(recordingContext, scope.textureSyncInfos[i], &imageBarriers,
                                         &srcStages, &dstStages);
 
-        if (!imageBarriers.empty()) {
-            MergeImageBarriers((dstStages & vertexStages) ? &vertexBarriers : &nonVertexBarriers,
-                               srcStages, dstStages, imageBarriers);
-            imageBarriers.clear();
-        }
-    }
-
-    for (const Barriers& barriers : {vertexBarriers, nonVertexBarriers}) {
-        if (!barriers.bufferBarriers.empty() || !barriers.imageBarriers.empty()) {
-            device->fn.CmdPipelineBarrier(
-                recordingContext->commandBuffer, barriers.srcStages, barriers.dstStages, 0, 0,
-                nullptr, barriers.bufferBarriers.size(), barriers.bufferBarriers.data(),
-                barriers.imageBarriers.size(), barriers.imageBarriers.data());
-        }
+        barriers->AddImageBarriers(srcStages, dstStages, imageBarriers);
+        imageBarriers.clear();
     }
 
     return {};
@@ -362,7 +321,8 @@ void RecordResolveQuerySetCmd(VkCommandBuffer commands,
 
 MaybeError RecordBeginRenderPass(CommandRecordingContext* recordingContext,
                                  Device* device,
-                                 BeginRenderPassCmd* renderPass) {
+                                 BeginRenderPassCmd* renderPass,
+                                 VkCommandBufferInheritanceInfo* secondaryInheritanceInfo) {
     VkCommandBuffer commands = recordingContext->commandBuffer;
 
     // Query a VkRenderPass from the cache
@@ -501,11 +461,1041 @@ MaybeError RecordBeginRenderPass(CommandRecordingContext* recordingContext,
     beginInfo.clearValueCount = attachmentCount;
     beginInfo.pClearValues = clearValues.data();
 
-    device->fn.CmdBeginRenderPass(commands, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+    VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE;
+    if (secondaryInheritanceInfo != nullptr) {
+        contents = VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS;
+
+        secondaryInheritanceInfo->sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        secondaryInheritanceInfo->pNext = nullptr;
+        secondaryInheritanceInfo->renderPass = renderPassVK;
+        secondaryInheritanceInfo->subpass = 0;
+        secondaryInheritanceInfo->framebuffer = framebuffer;
+        secondaryInheritanceInfo->occlusionQueryEnable = VK_FALSE;
+        secondaryInheritanceInfo->queryFlags = 0;
+        secondaryInheritanceInfo->pipelineStatistics = 0;
+    }
+
+    device->fn.CmdBeginRenderPass(commands, &beginInfo, contents);
 
     return {};
 }
 
+namespace {
+
+// Render passes with at least this many draws per chunk are split into chunks recorded in
+// parallel when Toggle::VulkanRecordRenderPassesInParallel is enabled.
+constexpr uint32_t kMinDrawsPerParallelChunk = 256;
+
+// A render pass command read out of a CommandIterator. The command and its additional data stay
+// in the memory of the CommandIterator, so they can be recorded later, possibly on another thread.
+struct RenderCommand {
+    Command type;
+    void* cmd = nullptr;
+    void* data = nullptr;
+};
+
+RenderCommand ReadRenderCommand(CommandIterator* iter, Command type) {
+    RenderCommand command = {type};
+    switch (type) {
+        case Command::Draw:
+            command.cmd = iter->NextCommand<DrawCmd>();
+            break;
+        case Command::DrawIndexed:
+            command.cmd = iter->NextCommand<DrawIndexedCmd>();
+            break;
+        case Command::DrawIndirect:
+            command.cmd = iter->NextCommand<DrawIndirectCmd>();
+            break;
+        case Command::DrawIndexedIndirect:
+            command.cmd = iter->NextCommand<DrawIndexedIndirectCmd>();
+            break;
+        case Command::InsertDebugMarker: {
+            InsertDebugMarkerCmd* cmd = iter->NextCommand<InsertDebugMarkerCmd>();
+            command.cmd = cmd;
+            command.data = iter->NextData<char>(cmd->length + 1);
+            break;
+        }
+        case Command::PopDebugGroup:
+            command.cmd = iter->NextCommand<PopDebugGroupCmd>();
+            break;
+        case Command::PushDebugGroup: {
+            PushDebugGroupCmd* cmd = iter->NextCommand<PushDebugGroupCmd>();
+            command.cmd = cmd;
+            command.data = iter->NextData<char>(cmd->length + 1);
+            break;
+        }
+        case Command::SetBindGroup: {
+            SetBindGroupCmd* cmd = iter->NextCommand<SetBindGroupCmd>();
+            command.cmd = cmd;
+            if (cmd->dynamicOffsetCount > 0) {
+                command.data = iter->NextData<uint32_t>(cmd->dynamicOffsetCount);
+            }
+            break;
+        }
+        case Command::SetIndexBuffer:
+            command.cmd = iter->NextCommand<SetIndexBufferCmd>();
+            break;
+        case Command::SetRenderPipeline:
+            command.cmd = iter->NextCommand<SetRenderPipelineCmd>();
+            break;
+        case Command::SetVertexBuffer:
+            command.cmd = iter->NextCommand<SetVertexBufferCmd>();
+            break;
+        case Command::SetBlendConstant:
+            command.cmd = iter->NextCommand<SetBlendConstantCmd>();
+            break;
+        case Command::SetStencilReference:
+            command.cmd = iter->NextCommand<SetStencilReferenceCmd>();
+            break;
+        case Command::SetViewport:
+            command.cmd = iter->NextCommand<SetViewportCmd>();
+            break;
+        case Command::SetScissorRect:
+            command.cmd = iter->NextCommand<SetScissorRectCmd>();
+            break;
+        case Command::ExecuteBundles: {
+            ExecuteBundlesCmd* cmd = iter->NextCommand<ExecuteBundlesCmd>();
+            command.cmd = cmd;
+            command.data = iter->NextData<Ref<RenderBundleBase>>(cmd->count);
+            break;
+        }
+        case Command::BeginOcclusionQuery:
+            command.cmd = iter->NextCommand<BeginOcclusionQueryCmd>();
+            break;
+        case Command::EndOcclusionQuery:
+            command.cmd = iter->NextCommand<EndOcclusionQueryCmd>();
+            break;
+        case Command::WriteTimestamp:
+            command.cmd = iter->NextCommand<WriteTimestampCmd>();
+            break;
+        default:
+            DAWN_UNREACHABLE();
+            break;
+    }
+    return command;
+}
+
+// Records the commands of a render pass in a VkCommandBuffer: either the primary command buffer,
+// or one of the secondary command buffers of a render pass recorded in parallel. It tracks the
+// state that is applied lazily, like descriptor sets and push constants.
+class RenderCommandRecorder {
+  public:
+    // |recordingContext| is only needed to record timestamps, which aren't recorded in secondary
+    // command buffers.
+    RenderCommandRecorder(Device* device,
+                          VkCommandBuffer commands,
+                          CommandRecordingContext* recordingContext)
+        : mDevice(device), mCommands(commands), mRecordingContext(recordingContext) {}
+
+    // Set the default value for the dynamic state
+    void SetDefaultDynamicState(uint32_t width, uint32_t height) {
+        mDevice->fn.CmdSetLineWidth(mCommands, 1.0f);
+        mDevice->fn.CmdSetDepthBounds(mCommands, 0.0f, 1.0f);
+
+        mDevice->fn.CmdSetStencilReference(mCommands, VK_STENCIL_FRONT_AND_BACK, 0);
+
+        float blendConstants[4] = {
+            0.0f,
+            0.0f,
+            0.0f,
+            0.0f,
+        };
+        mDevice->fn.CmdSetBlendConstants(mCommands, blendConstants);
+
+        // The viewport and scissor default to cover all of the attachments
+        VkViewport viewport;
+        viewport.x = 0.0f;
+        viewport.y = static_cast<float>(height);
+        viewport.width = static_cast<float>(width);
+        viewport.height = -static_cast<float>(height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        mDevice->fn.CmdSetViewport(mCommands, 0, 1, &viewport);
+
+        VkRect2D scissorRect;
+        scissorRect.offset.x = 0;
+        scissorRect.offset.y = 0;
+        scissorRect.extent.width = width;
+        scissorRect.extent.height = height;
+        mDevice->fn.CmdSetScissor(mCommands, 0, 1, &scissorRect);
+    }
+
+    void Record(const RenderCommand& command) {
+        Device* device = mDevice;
+        VkCommandBuffer commands = mCommands;
+
+        switch (command.type) {
+            case Command::Draw: {
+                DrawCmd* draw = static_cast<DrawCmd*>(command.cmd);
+
+                mDescriptorSets.Apply(device, commands, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                device->fn.CmdDraw(commands, draw->vertexCount, draw->instanceCount,
+                                   draw->firstVertex, draw->firstInstance);
+                break;
+            }
+
+            case Command::DrawIndexed: {
+                DrawIndexedCmd* draw = static_cast<DrawIndexedCmd*>(command.cmd);
+
+                mDescriptorSets.Apply(device, commands, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                device->fn.CmdDrawIndexed(commands, draw->indexCount, draw->instanceCount,
+                                          draw->firstIndex, draw->baseVertex, draw->firstInstance);
+                break;
+            }
+
+            case Command::DrawIndirect: {
+                DrawIndirectCmd* draw = static_cast<DrawIndirectCmd*>(command.cmd);
+                Buffer* buffer = ToBackend(draw->indirectBuffer.Get());
+
+                mDescriptorSets.Apply(device, commands, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                device->fn.CmdDrawIndirect(commands, buffer->GetHandle(),
+                                           static_cast<VkDeviceSize>(draw->indirectOffset), 1, 0);
+                break;
+            }
+
+            case Command::DrawIndexedIndirect: {
+                DrawIndexedIndirectCmd* draw = static_cast<DrawIndexedIndirectCmd*>(command.cmd);
+                Buffer* buffer = ToBackend(draw->indirectBuffer.Get());
+                DAWN_ASSERT(buffer != nullptr);
+
+                mDescriptorSets.Apply(device, commands, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                device->fn.CmdDrawIndexedIndirect(commands, buffer->GetHandle(),
+                                                  static_cast<VkDeviceSize>(draw->indirectOffset),
+                                                  1, 0);
+                break;
+            }
+
+            case Command::InsertDebugMarker: {
+                if (device->GetGlobalInfo().HasExt(InstanceExt::DebugUtils)) {
+                    const char* label = static_cast<const char*>(command.data);
+                    VkDebugUtilsLabelEXT utilsLabel;
+                    utilsLabel.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+                    utilsLabel.pNext = nullptr;
+                    utilsLabel.pLabelName = label;
+                    // Default color to black
+                    utilsLabel.color[0] = 0.0;
+                    utilsLabel.color[1] = 0.0;
+                    utilsLabel.color[2] = 0.0;
+                    utilsLabel.color[3] = 1.0;
+                    device->fn.CmdInsertDebugUtilsLabelEXT(commands, &utilsLabel);
+                }
+                break;
+            }
+
+            case Command::PopDebugGroup: {
+                if (device->GetGlobalInfo().HasExt(InstanceExt::DebugUtils)) {
+                    device->fn.CmdEndDebugUtilsLabelEXT(commands);
+                }
+                break;
+            }
+
+            case Command::PushDebugGroup: {
+                if (device->GetGlobalInfo().HasExt(InstanceExt::DebugUtils)) {
+                    const char* label = static_cast<const char*>(command.data);
+                    VkDebugUtilsLabelEXT utilsLabel;
+                    utilsLabel.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+                    utilsLabel.pNext = nullptr;
+                    utilsLabel.pLabelName = label;
+                    // Default color to black
+                    utilsLabel.color[0] = 0.0;
+                    utilsLabel.color[1] = 0.0;
+                    utilsLabel.color[2] = 0.0;
+                    utilsLabel.color[3] = 1.0;
+                    device->fn.CmdBeginDebugUtilsLabelEXT(commands, &utilsLabel);
+                }
+                break;
+            }
+
+            case Command::SetBindGroup: {
+                SetBindGroupCmd* cmd = static_cast<SetBindGroupCmd*>(command.cmd);
+                BindGroup* bindGroup = ToBackend(cmd->group.Get());
+                uint32_t* dynamicOffsets = static_cast<uint32_t*>(command.data);
+
+                mDescriptorSets.OnSetBindGroup(cmd->index, bindGroup, cmd->dynamicOffsetCount,
+                                               dynamicOffsets);
+                break;
+            }
+
+            case Command::SetIndexBuffer: {
+                SetIndexBufferCmd* cmd = static_cast<SetIndexBufferCmd*>(command.cmd);
+                VkBuffer indexBuffer = ToBackend(cmd->buffer)->GetHandle();
+
+                device->fn.CmdBindIndexBuffer(commands, indexBuffer, cmd->offset,
+                                              VulkanIndexType(cmd->format));
+                break;
+            }
+
+            case Command::SetRenderPipeline: {
+                SetRenderPipelineCmd* cmd = static_cast<SetRenderPipelineCmd*>(command.cmd);
+                RenderPipeline* pipeline = ToBackend(cmd->pipeline).Get();
+
+                device->fn.CmdBindPipeline(commands, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                           pipeline->GetHandle());
+                mLastPipeline = pipeline;
+
+                mDescriptorSets.OnSetPipeline(pipeline);
+
+                // Apply the deferred min/maxDepth push constants update if needed.
+                ApplyClampFragDepthArgs();
+                break;
+            }
+
+            case Command::SetVertexBuffer: {
+                SetVertexBufferCmd* cmd = static_cast<SetVertexBufferCmd*>(command.cmd);
+                VkBuffer buffer = ToBackend(cmd->buffer)->GetHandle();
+                VkDeviceSize offset = static_cast<VkDeviceSize>(cmd->offset);
+
+                device->fn.CmdBindVertexBuffers(commands, static_cast<uint8_t>(cmd->slot), 1,
+                                                &*buffer, &offset);
+                break;
+            }
+
+            case Command::SetBlendConstant: {
+                SetBlendConstantCmd* cmd = static_cast<SetBlendConstantCmd*>(command.cmd);
+                const std::array<float, 4> blendConstants = ConvertToFloatColor(cmd->color);
+                device->fn.CmdSetBlendConstants(commands, blendConstants.data());
+                break;
+            }
+
+            case Command::SetStencilReference: {
+                SetStencilReferenceCmd* cmd = static_cast<SetStencilReferenceCmd*>(command.cmd);
+                device->fn.CmdSetStencilReference(commands, VK_STENCIL_FRONT_AND_BACK,
+                                                  cmd->reference);
+                break;
+            }
+
+            case Command::SetViewport: {
+                SetViewportCmd* cmd = static_cast<SetViewportCmd*>(command.cmd);
+                VkViewport viewport;
+                viewport.x = cmd->x;
+                viewport.y = cmd->y + cmd->height;
+                viewport.width = cmd->width;
+                viewport.height = -cmd->height;
+                viewport.minDepth = cmd->minDepth;
+                viewport.maxDepth = cmd->maxDepth;
+
+                // Vulkan disallows width = 0, but VK_KHR_maintenance1 which we require allows
+                // height = 0 so use that to do an empty viewport.
+                if (viewport.width == 0) {
+                    viewport.height = 0;
+
+                    // Set the viewport x range to a range that's always valid.
+                    viewport.x = 0;
+                    viewport.width = 1;
+                }
+
+                device->fn.CmdSetViewport(commands, 0, 1, &viewport);
+
+                // Try applying the push constants that contain min/maxDepth immediately. This can
+                // be deferred if no pipeline is currently bound.
+                mClampFragDepthArgs = {viewport.minDepth, viewport.maxDepth};
+                mClampFragDepthArgsDirty = true;
+                ApplyClampFragDepthArgs();
+                break;
+            }
+
+            case Command::SetScissorRect: {
+                SetScissorRectCmd* cmd = static_cast<SetScissorRectCmd*>(command.cmd);
+                VkRect2D rect;
+                rect.offset.x = cmd->x;
+                rect.offset.y = cmd->y;
+                rect.extent.width = cmd->width;
+                rect.extent.height = cmd->height;
+
+                device->fn.CmdSetScissor(commands, 0, 1, &rect);
+                break;
+            }
+
+            case Command::ExecuteBundles: {
+                ExecuteBundlesCmd* cmd = static_cast<ExecuteBundlesCmd*>(command.cmd);
+                auto bundles = static_cast<Ref<RenderBundleBase>*>(command.data);
+
+                for (uint32_t i = 0; i < cmd->count; ++i) {
+                    CommandIterator* iter = bundles[i]->GetCommands();
+                    iter->Reset();
+                    Command type;
+                    while (iter->NextCommandId(&type)) {
+                        Record(ReadRenderCommand(iter, type));
+                    }
+                }
+                break;
+            }
+
+            case Command::BeginOcclusionQuery: {
+                BeginOcclusionQueryCmd* cmd = static_cast<BeginOcclusionQueryCmd*>(command.cmd);
+
+                device->fn.CmdBeginQuery(commands, ToBackend(cmd->querySet.Get())->GetHandle(),
+                                         cmd->queryIndex, 0);
+                break;
+            }
+
+            case Command::EndOcclusionQuery: {
+                EndOcclusionQueryCmd* cmd = static_cast<EndOcclusionQueryCmd*>(command.cmd);
+
+                device->fn.CmdEndQuery(commands, ToBackend(cmd->querySet.Get())->GetHandle(),
+                                       cmd->queryIndex);
+                break;
+            }
+
+            case Command::WriteTimestamp: {
+                WriteTimestampCmd* cmd = static_cast<WriteTimestampCmd*>(command.cmd);
+                DAWN_ASSERT(mRecordingContext != nullptr);
+
+                RecordWriteTimestampCmd(mRecordingContext, device, cmd->querySet.Get(),
+                                        cmd->queryIndex, true, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+                break;
+            }
+
+            default:
+                DAWN_UNREACHABLE();
+                break;
+        }
+    }
+
+  private:
+    // Tracking for the push constants needed by the ClampFragDepth transform.
+    // TODO(dawn:1125): Avoid the need for this when the depthClamp feature is available, but doing
+    // so would require fixing issue dawn:1576 first to have more dynamic push constant usage. (and
+    // also additional tests that the dirtying logic here is correct so with a Toggle we can test it
+    // on our infra).
+    void ApplyClampFragDepthArgs() {
+        if (!mClampFragDepthArgsDirty || mLastPipeline == nullptr) {
+            return;
+        }
+        mDevice->fn.CmdPushConstants(mCommands, ToBackend(mLastPipeline->GetLayout())->GetHandle(),
+                                     VK_SHADER_STAGE_FRAGMENT_BIT, kClampFragDepthArgsOffset,
+                                     kClampFragDepthArgsSize, &mClampFragDepthArgs);
+        mClampFragDepthArgsDirty = false;
+    }
+
+    raw_ptr<Device> mDevice;
+    VkCommandBuffer mCommands;
+    raw_ptr<CommandRecordingContext> mRecordingContext;
+
+    DescriptorSetTracker mDescriptorSets = {};
+    raw_ptr<RenderPipeline> mLastPipeline = nullptr;
+    ClampFragDepthArgs mClampFragDepthArgs = {0.0f, 1.0f};
+    bool mClampFragDepthArgsDirty = true;
+};
+
+// The last command setting each piece of render pass state. Replaying them at the start of a
+// secondary command buffer restores the state it would have inherited when recorded serially.
+struct RenderPassState {
+    const RenderCommand* pipeline = nullptr;
+    PerBindGroup<const RenderCommand*> bindGroups = {};
+    PerVertexBuffer<const RenderCommand*> vertexBuffers = {};
+    const RenderCommand* indexBuffer = nullptr;
+    const RenderCommand* viewport = nullptr;
+    const RenderCommand* scissorRect = nullptr;
+    const RenderCommand* blendConstant = nullptr;
+    const RenderCommand* stencilReference = nullptr;
+
+    void Update(const RenderCommand* command) {
+        switch (command->type) {
+            case Command::SetRenderPipeline:
+                pipeline = command;
+                break;
+            case Command::SetBindGroup:
+                bindGroups[static_cast<SetBindGroupCmd*>(command->cmd)->index] = command;
+                break;
+            case Command::SetVertexBuffer:
+                vertexBuffers[static_cast<SetVertexBufferCmd*>(command->cmd)->slot] = command;
+                break;
+            case Command::SetIndexBuffer:
+                indexBuffer = command;
+                break;
+            case Command::SetViewport:
+                viewport = command;
+                break;
+            case Command::SetScissorRect:
+                scissorRect = command;
+                break;
+            case Command::SetBlendConstant:
+                blendConstant = command;
+                break;
+            case Command::SetStencilReference:
+                stencilReference = command;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Executing render bundles resets the pipeline and the bindings of the render pass.
+    void ResetBindings() {
+        pipeline = nullptr;
+        bindGroups = {};
+        vertexBuffers = {};
+        indexBuffer = nullptr;
+    }
+
+    void Replay(RenderCommandRecorder* recorder) const {
+        for (const RenderCommand* command : {viewport, scissorRect, blendConstant,
+                                             stencilReference, pipeline, indexBuffer}) {
+            if (command != nullptr) {
+                recorder->Record(*command);
+            }
+        }
+        for (const RenderCommand* command : bindGroups) {
+            if (command != nullptr) {
+                recorder->Record(*command);
+            }
+        }
+        for (const RenderCommand* command : vertexBuffers) {
+            if (command != nullptr) {
+                recorder->Record(*command);
+            }
+        }
+    }
+};
+
+// A range of the commands of a render pass that is recorded in its own secondary command buffer.
+struct ParallelRecordingChunk {
+    raw_ptr<Device> device;
+    raw_ptr<const VkCommandBufferInheritanceInfo> inheritanceInfo;
+    uint32_t width;
+    uint32_t height;
+    RenderPassState initialState;
+    const RenderCommand* begin;
+    const RenderCommand* end;
+
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    ::VkResult result = VK_SUCCESS;
+    const char* failedCall = nullptr;
+
+    void Record() {
+        VkCommandBufferBeginInfo beginInfo;
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.pNext = nullptr;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+                          VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        beginInfo.pInheritanceInfo = inheritanceInfo;
+
+        result = device->fn.BeginCommandBuffer(commandBuffer, &beginInfo);
+        if (result != VK_SUCCESS) {
+            failedCall = "vkBeginCommandBuffer";
+            return;
+        }
+
+        RenderCommandRecorder recorder(device, commandBuffer, nullptr);
+        recorder.SetDefaultDynamicState(width, height);
+        initialState.Replay(&recorder);
+        for (const RenderCommand* command = begin; command != end; ++command) {
+            recorder.Record(*command);
+        }
+
+        result = device->fn.EndCommandBuffer(commandBuffer);
+        if (result != VK_SUCCESS) {
+            failedCall = "vkEndCommandBuffer";
+        }
+    }
+
+    static void RecordOnWorkerThread(void* userdata) {
+        static_cast<ParallelRecordingChunk*>(userdata)->Record();
+    }
+};
+
+bool IsDrawCommand(Command type) {
+    switch (type) {
+        case Command::Draw:
+        case Command::DrawIndexed:
+        case Command::DrawIndirect:
+        case Command::DrawIndexedIndirect:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Queries and debug groups must begin and end in the same command buffer so render passes using
+// them can't be split between secondary command buffers.
+bool CanSplitRenderCommand(Command type) {
+    switch (type) {
+        case Command::BeginOcclusionQuery:
+        case Command::EndOcclusionQuery:
+        case Command::WriteTimestamp:
+        case Command::PushDebugGroup:
+        case Command::PopDebugGroup:
+            return false;
+        default:
+            return true;
+    }
+}
+
+// Returns |commands| with the commands of the executed render bundles inlined.
+std::vector<RenderCommand> FlattenRenderBundles(const std::vector<RenderCommand>& commands) {
+    std::vector<RenderCommand> flattenedCommands;
+    flattenedCommands.reserve(commands.size());
+    for (const RenderCommand& command : commands) {
+        if (command.type != Command::ExecuteBundles) {
+            flattenedCommands.push_back(command);
+            continue;
+        }
+
+        ExecuteBundlesCmd* cmd = static_cast<ExecuteBundlesCmd*>(command.cmd);
+        auto bundles = static_cast<Ref<RenderBundleBase>*>(command.data);
+        for (uint32_t i = 0; i < cmd->count; ++i) {
+            CommandIterator* iter = bundles[i]->GetCommands();
+            iter->Reset();
+            Command type;
+            while (iter->NextCommandId(&type)) {
+                flattenedCommands.push_back(ReadRenderCommand(iter, type));
+            }
+        }
+    }
+    return flattenedCommands;
+}
+
+// Records the commands of a render pass in the primary command buffer.
+MaybeError RecordRenderPassCommandsInline(Device* device,
+                                          CommandRecordingContext* recordingContext,
+                                          BeginRenderPassCmd* renderPassCmd,
+                                          const std::vector<RenderCommand>& commands) {
+    DAWN_TRY(RecordBeginRenderPass(recordingContext, device, renderPassCmd));
+    RenderCommandRecorder recorder(device, recordingContext->commandBuffer, recordingContext);
+    recorder.SetDefaultDynamicState(renderPassCmd->width, renderPassCmd->height);
+    for (const RenderCommand& command : commands) {
+        recorder.Record(command);
+    }
+    return {};
+}
+
+// Records the commands of a render pass split in chunks recorded in parallel in secondary command
+// buffers, or in the primary command buffer if the render pass is too small or uses commands
+// that can't be split between command buffers. The render bundles have already been flattened in
+// |commands|.
+MaybeError RecordRenderPassCommandsInParallel(Device* device,
+                                              CommandRecordingContext* recordingContext,
+                                              BeginRenderPassCmd* renderPassCmd,
+                                              const std::vector<RenderCommand>& commands) {
+    uint32_t drawCount = 0;
+    bool canSplit = true;
+    for (const RenderCommand& command : commands) {
+        canSplit &= CanSplitRenderCommand(command.type);
+        drawCount += IsDrawCommand(command.type);
+    }
+
+    uint32_t chunkCount = std::min(device->GetMaxRenderPassRecordingChunks(),
+                                   drawCount / kMinDrawsPerParallelChunk);
+    if (!canSplit || chunkCount < 2) {
+        return RecordRenderPassCommandsInline(device, recordingContext, renderPassCmd, commands);
+    }
+
+    VkCommandBufferInheritanceInfo inheritanceInfo;
+    DAWN_TRY(RecordBeginRenderPass(recordingContext, device, renderPassCmd, &inheritanceInfo));
+
+    // Split the commands in chunks with the same number of draws, keeping track of the state each
+    // chunk starts with.
+    std::vector<ParallelRecordingChunk> chunks(chunkCount);
+    {
+        RenderPassState state;
+        const RenderCommand* chunkBegin = commands.data();
+        uint32_t drawsInChunk = 0;
+        uint32_t chunkIndex = 0;
+        for (const RenderCommand* command = commands.data();
+             command != commands.data() + commands.size(); ++command) {
+            state.Update(command);
+            drawsInChunk += IsDrawCommand(command->type);
+
+            bool isLastChunk = chunkIndex == chunkCount - 1;
+            if (!isLastChunk && drawsInChunk == drawCount / chunkCount) {
+                chunks[chunkIndex].begin = chunkBegin;
+                chunks[chunkIndex].end = command + 1;
+                chunks[++chunkIndex].initialState = state;
+                chunkBegin = command + 1;
+                drawsInChunk = 0;
+            }
+        }
+        chunks[chunkIndex].begin = chunkBegin;
+        chunks[chunkIndex].end = commands.data() + commands.size();
+    }
+
+    std::vector<VkCommandBuffer> secondaryCommandBuffers(chunkCount);
+    for (uint32_t i = 0; i < chunkCount; ++i) {
+        DAWN_TRY_ASSIGN(secondaryCommandBuffers[i],
+                        ToBackend(device->GetQueue())->GetSecondaryCommandBuffer(recordingContext));
+
+        chunks[i].device = device;
+        chunks[i].inheritanceInfo = &inheritanceInfo;
+        chunks[i].width = renderPassCmd->width;
+        chunks[i].height = renderPassCmd->height;
+        chunks[i].commandBuffer = secondaryCommandBuffers[i];
+    }
+
+    // Record the first chunk on this thread while the device's recording threads record the
+    // others. Waiting for them with the device locked is fine as they only run recording tasks.
+    std::vector<std::unique_ptr<platform::WaitableEvent>> events;
+    for (uint32_t i = 1; i < chunkCount; ++i) {
+        events.push_back(device->GetRenderPassRecordingPool()->PostWorkerTask(
+            ParallelRecordingChunk::RecordOnWorkerThread, &chunks[i]));
+    }
+    chunks[0].Record();
+    for (auto& event : events) {
+        event->Wait();
+    }
+
+    for (const ParallelRecordingChunk& chunk : chunks) {
+        if (chunk.failedCall != nullptr) {
+            DAWN_TRY(CheckVkSuccess(chunk.result, chunk.failedCall));
+        }
+    }
+
+    device->fn.CmdExecuteCommands(recordingContext->commandBuffer, chunkCount,
+                                  secondaryCommandBuffers.data());
+    return {};
+}
+
+// The maximum number of different BakedRenderBundleKeys a render bundle is baked for. Baking the
+// bundle for another key replaces the least recently used variant.
+constexpr size_t kMaxBakedRenderBundleVariants = 4;
+
+// The state of the render pass a render bundle is executed in that its baked commands depend
+// on. Secondary command buffers only need to be recorded for a compatible VkRenderPass, which for
+// a given bundle only varies with the resolve targets, but they don't inherit the dynamic state.
+struct BakedRenderBundleKey {
+    ColorAttachmentMask resolveTargetMask;
+    uint32_t width;
+    uint32_t height;
+    SetViewportCmd viewport;
+    SetScissorRectCmd scissorRect;
+    SetBlendConstantCmd blendConstant;
+    SetStencilReferenceCmd stencilReference;
+
+    bool operator==(const BakedRenderBundleKey& other) const {
+        return resolveTargetMask == other.resolveTargetMask && width == other.width &&
+               height == other.height && viewport.x == other.viewport.x &&
+               viewport.y == other.viewport.y && viewport.width == other.viewport.width &&
+               viewport.height == other.viewport.height &&
+               viewport.minDepth == other.viewport.minDepth &&
+               viewport.maxDepth == other.viewport.maxDepth &&
+               scissorRect.x == other.scissorRect.x && scissorRect.y == other.scissorRect.y &&
+               scissorRect.width == other.scissorRect.width &&
+               scissorRect.height == other.scissorRect.height &&
+               blendConstant.color.r == other.blendConstant.color.r &&
+               blendConstant.color.g == other.blendConstant.color.g &&
+               blendConstant.color.b == other.blendConstant.color.b &&
+               blendConstant.color.a == other.blendConstant.color.a &&
+               stencilReference.reference == other.stencilReference.reference;
+    }
+};
+
+BakedRenderBundleKey MakeBakedRenderBundleKey(const BeginRenderPassCmd* renderPassCmd,
+                                              const RenderPassState& state) {
+    BakedRenderBundleKey key;
+    for (auto i : IterateBitSet(renderPassCmd->attachmentState->GetColorAttachmentsMask())) {
+        key.resolveTargetMask[i] = renderPassCmd->colorAttachments[i].resolveTarget != nullptr;
+    }
+    key.width = renderPassCmd->width;
+    key.height = renderPassCmd->height;
+
+    // Use the same defaults as RenderCommandRecorder::SetDefaultDynamicState.
+    key.viewport = {0.0f, 0.0f, static_cast<float>(key.width), static_cast<float>(key.height),
+                    0.0f, 1.0f};
+    if (state.viewport != nullptr) {
+        key.viewport = *static_cast<const SetViewportCmd*>(state.viewport->cmd);
+    }
+    key.scissorRect = {0, 0, key.width, key.height};
+    if (state.scissorRect != nullptr) {
+        key.scissorRect = *static_cast<const SetScissorRectCmd*>(state.scissorRect->cmd);
+    }
+    key.blendConstant = {};
+    if (state.blendConstant != nullptr) {
+        key.blendConstant = *static_cast<const SetBlendConstantCmd*>(state.blendConstant->cmd);
+    }
+    key.stencilReference = {0};
+    if (state.stencilReference != nullptr) {
+        key.stencilReference =
+            *static_cast<const SetStencilReferenceCmd*>(state.stencilReference->cmd);
+    }
+    return key;
+}
+
+// The secondary command buffers a render bundle is baked in, one for each of the last
+// BakedRenderBundleKeys it was executed with. Each of them is allocated from its own command pool
+// so that it can be freed on its own, and is recorded for a VkRenderPass owned by the bundle as
+// well since the ones of the RenderPassCache can be evicted.
+class BakedRenderBundle final : public BakedRenderBundleCommands {
+  public:
+    explicit BakedRenderBundle(Device* device) : mDevice(device) {}
+
+    ~BakedRenderBundle() override {
+        for (const Variant& variant : mVariants) {
+            DeleteWhenUnused(variant);
+        }
+    }
+
+    // Returns the secondary command buffer |bundle| is baked in for |key|, recording it if needed.
+    ResultOrError<VkCommandBuffer> GetOrRecord(RenderBundleBase* bundle,
+                                               const BakedRenderBundleKey& key) {
+        // Variants are ordered from the least to the most recently used.
+        for (auto it = mVariants.begin(); it != mVariants.end(); ++it) {
+            if (it->key == key) {
+                std::rotate(it, it + 1, mVariants.end());
+                return mVariants.back().commandBuffer;
+            }
+        }
+
+        VkDevice vkDevice = mDevice->GetVkDevice();
+        Variant variant = {key};
+        VkCommandPoolCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.queueFamilyIndex = mDevice->GetGraphicsQueueFamily();
+
+        DAWN_TRY(CheckVkSuccess(
+            mDevice->fn.CreateCommandPool(vkDevice, &createInfo, nullptr, &*variant.pool),
+            "vkCreateCommandPool"));
+
+        VkCommandBufferAllocateInfo allocateInfo;
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.pNext = nullptr;
+        allocateInfo.commandPool = variant.pool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocateInfo.commandBufferCount = 1;
+
+        DAWN_TRY_WITH_CLEANUP(
+            CheckVkSuccess(mDevice->fn.AllocateCommandBuffers(vkDevice, &allocateInfo,
+                                                              &variant.commandBuffer),
+                           "vkAllocateCommandBuffers"),
+            { mDevice->GetFencedDeleter()->DeleteWhenUnused(variant.pool); });
+
+        // Only the formats, the sample count and the resolve targets matter for the render pass
+        // compatibility, so any load and store operations can be used.
+        RenderPassCacheQuery query;
+        const AttachmentState* attachmentState = bundle->GetAttachmentState();
+        for (auto i : IterateBitSet(attachmentState->GetColorAttachmentsMask())) {
+            query.SetColor(i, attachmentState->GetColorAttachmentFormat(i), wgpu::LoadOp::Load,
+                           wgpu::StoreOp::Store, key.resolveTargetMask[i]);
+        }
+        if (attachmentState->HasDepthStencilAttachment()) {
+            query.SetDepthStencil(attachmentState->GetDepthStencilFormat(), wgpu::LoadOp::Load,
+                                  wgpu::StoreOp::Store, bundle->IsDepthReadOnly(),
+                                  wgpu::LoadOp::Load, wgpu::StoreOp::Store,
+                                  bundle->IsStencilReadOnly());
+        }
+        query.SetSampleCount(attachmentState->GetSampleCount());
+        DAWN_TRY_ASSIGN_WITH_CLEANUP(
+            variant.renderPass, mDevice->GetRenderPassCache()->CreateRenderPassForQuery(query),
+            { mDevice->GetFencedDeleter()->DeleteWhenUnused(variant.pool); });
+
+        DAWN_TRY_WITH_CLEANUP(Record(bundle, variant), { DeleteWhenUnused(variant); });
+
+        // Replace the least recently used variant, so that a bundle executed with a new state, for
+        // example after a resize, is baked again instead of recorded on every execution.
+        if (mVariants.size() >= kMaxBakedRenderBundleVariants) {
+            DeleteWhenUnused(mVariants.front());
+            mVariants.erase(mVariants.begin());
+        }
+        mVariants.push_back(variant);
+        return variant.commandBuffer;
+    }
+
+  private:
+    struct Variant {
+        BakedRenderBundleKey key;
+        VkCommandPool pool = VK_NULL_HANDLE;
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    };
+
+    void DeleteWhenUnused(const Variant& variant) {
+        // The command buffer may still be pending, and is freed with the pool.
+        mDevice->GetFencedDeleter()->DeleteWhenUnused(variant.pool);
+        mDevice->GetFencedDeleter()->DeleteWhenUnused(variant.renderPass);
+    }
+
+    MaybeError Record(RenderBundleBase* bundle, const Variant& variant) {
+        VkCommandBufferInheritanceInfo inheritanceInfo;
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.pNext = nullptr;
+        inheritanceInfo.renderPass = variant.renderPass;
+        inheritanceInfo.subpass = 0;
+        inheritanceInfo.framebuffer = VK_NULL_HANDLE;
+        inheritanceInfo.occlusionQueryEnable = VK_FALSE;
+        inheritanceInfo.queryFlags = 0;
+        inheritanceInfo.pipelineStatistics = 0;
+
+        // The command buffer can be executed several times in the same render pass, and in
+        // render passes of command buffers that are pending at the same time.
+        VkCommandBufferBeginInfo beginInfo;
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.pNext = nullptr;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT |
+                          VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+        DAWN_TRY(CheckVkSuccess(mDevice->fn.BeginCommandBuffer(variant.commandBuffer, &beginInfo),
+                                "vkBeginCommandBuffer"));
+
+        // Set the dynamic state the bundle is executed with, then record its commands.
+        BakedRenderBundleKey dynamicState = variant.key;
+        RenderCommandRecorder recorder(mDevice, variant.commandBuffer, nullptr);
+        recorder.SetDefaultDynamicState(dynamicState.width, dynamicState.height);
+        recorder.Record({Command::SetViewport, &dynamicState.viewport});
+        recorder.Record({Command::SetScissorRect, &dynamicState.scissorRect});
+        recorder.Record({Command::SetBlendConstant, &dynamicState.blendConstant});
+        recorder.Record({Command::SetStencilReference, &dynamicState.stencilReference});
+
+        CommandIterator* iter = bundle->GetCommands();
+        iter->Reset();
+        Command type;
+        while (iter->NextCommandId(&type)) {
+            recorder.Record(ReadRenderCommand(iter, type));
+        }
+
+        return CheckVkSuccess(mDevice->fn.EndCommandBuffer(variant.commandBuffer),
+                              "vkEndCommandBuffer");
+    }
+
+    raw_ptr<Device> mDevice;
+    std::vector<Variant> mVariants;
+};
+
+// Returns the secondary command buffer |bundle| is baked in for |key|, baking it if needed, or
+// VK_NULL_HANDLE if the bundle can't be baked.
+ResultOrError<VkCommandBuffer> GetBakedRenderBundle(Device* device,
+                                                    RenderBundleBase* bundle,
+                                                    const BakedRenderBundleKey& key) {
+    // The indirect draws that need validation are patched to use the validated parameters each
+    // time the bundle is executed.
+    if (!bundle->GetIndirectDrawMetadata().GetIndexedIndirectBufferValidationInfo()->empty()) {
+        return VkCommandBuffer(VK_NULL_HANDLE);
+    }
+
+    if (bundle->GetBakedCommands() == nullptr) {
+        bundle->SetBakedCommands(std::make_unique<BakedRenderBundle>(device));
+    }
+    return static_cast<BakedRenderBundle*>(bundle->GetBakedCommands())->GetOrRecord(bundle, key);
+}
+
+// Records the commands of a render pass in secondary command buffers, executing the secondary
+// command buffers the render bundles are baked in, and recording the other commands in transient
+// secondary command buffers between them. Returns false without recording anything if none of
+// the bundles can be baked, or if the render pass can't be split between command buffers.
+ResultOrError<bool> RecordRenderPassCommandsWithBakedBundles(
+    Device* device,
+    CommandRecordingContext* recordingContext,
+    BeginRenderPassCmd* renderPassCmd,
+    const std::vector<RenderCommand>& commands) {
+    bool hasBundles = false;
+    for (const RenderCommand& command : commands) {
+        if (!CanSplitRenderCommand(command.type)) {
+            return false;
+        }
+        hasBundles |= command.type == Command::ExecuteBundles;
+    }
+    if (!hasBundles) {
+        return false;
+    }
+
+    // Get the baked command buffers of all the executed bundles first, with the dynamic state
+    // they are executed with.
+    std::vector<VkCommandBuffer> bakedBundles;
+    bool hasBakedBundles = false;
+    {
+        RenderPassState state;
+        for (const RenderCommand& command : commands) {
+            state.Update(&command);
+            if (command.type != Command::ExecuteBundles) {
+                continue;
+            }
+
+            ExecuteBundlesCmd* cmd = static_cast<ExecuteBundlesCmd*>(command.cmd);
+            auto bundles = static_cast<Ref<RenderBundleBase>*>(command.data);
+            BakedRenderBundleKey key = MakeBakedRenderBundleKey(renderPassCmd, state);
+            for (uint32_t i = 0; i < cmd->count; ++i) {
+                VkCommandBuffer bakedBundle;
+                DAWN_TRY_ASSIGN(bakedBundle, GetBakedRenderBundle(device, bundles[i].Get(), key));
+                hasBakedBundles |= bakedBundle != VK_NULL_HANDLE;
+                bakedBundles.push_back(bakedBundle);
+            }
+        }
+    }
+    if (!hasBakedBundles) {
+        return false;
+    }
+
+    VkCommandBufferInheritanceInfo inheritanceInfo;
+    DAWN_TRY(RecordBeginRenderPass(recordingContext, device, renderPassCmd, &inheritanceInfo));
+
+    std::vector<VkCommandBuffer> secondaryCommandBuffers;
+    RenderPassState state;
+    VkCommandBuffer transientCommands = VK_NULL_HANDLE;
+    std::optional<RenderCommandRecorder> recorder;
+
+    // Transient command buffers start with the state set by the previous commands.
+    auto EnsureTransientCommands = [&]() -> MaybeError {
+        if (recorder.has_value()) {
+            return {};
+        }
+        DAWN_TRY_ASSIGN(transientCommands, ToBackend(device->GetQueue())
+                                               ->GetSecondaryCommandBuffer(recordingContext));
+
+        VkCommandBufferBeginInfo beginInfo;
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.pNext = nullptr;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+                          VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+        DAWN_TRY(CheckVkSuccess(device->fn.BeginCommandBuffer(transientCommands, &beginInfo),
+                                "vkBeginCommandBuffer"));
+
+        recorder.emplace(device, transientCommands, nullptr);
+        recorder->SetDefaultDynamicState(renderPassCmd->width, renderPassCmd->height);
+        state.Replay(&*recorder);
+        return {};
+    };
+    auto EndTransientCommands = [&]() -> MaybeError {
+        if (!recorder.has_value()) {
+            return {};
+        }
+        recorder.reset();
+        DAWN_TRY(CheckVkSuccess(device->fn.EndCommandBuffer(transientCommands),
+                                "vkEndCommandBuffer"));
+        secondaryCommandBuffers.push_back(transientCommands);
+        return {};
+    };
+
+    auto bakedBundle = bakedBundles.begin();
+    for (const RenderCommand& command : commands) {
+        if (command.type != Command::ExecuteBundles) {
+            DAWN_TRY(EnsureTransientCommands());
+            recorder->Record(command);
+            state.Update(&command);
+            continue;
+        }
+
+        ExecuteBundlesCmd* cmd = static_cast<ExecuteBundlesCmd*>(command.cmd);
+        auto bundles = static_cast<Ref<RenderBundleBase>*>(command.data);
+        for (uint32_t i = 0; i < cmd->count; ++i, ++bakedBundle) {
+            if (*bakedBundle != VK_NULL_HANDLE) {
+                DAWN_TRY(EndTransientCommands());
+                secondaryCommandBuffers.push_back(*bakedBundle);
+                continue;
+            }
+
+            DAWN_TRY(EnsureTransientCommands());
+            CommandIterator* iter = bundles[i]->GetCommands();
+            iter->Reset();
+            Command type;
+            while (iter->NextCommandId(&type)) {
+                recorder->Record(ReadRenderCommand(iter, type));
+            }
+        }
+        state.ResetBindings();
+    }
+    DAWN_ASSERT(bakedBundle == bakedBundles.end());
+    DAWN_TRY(EndTransientCommands());
+
+    device->fn.CmdExecuteCommands(recordingContext->commandBuffer,
+                                  static_cast<uint32_t>(secondaryCommandBuffers.size()),
+                                  secondaryCommandBuffers.data());
+    return true;
+}
+
+}  // anonymous namespace
+
 // static
 Ref<CommandBuffer> CommandBuffer::Create(CommandEncoder* encoder,
                                          const CommandBufferDescriptor* descriptor) {
@@ -585,6 +1575,7 @@ MaybeError CommandBuffer::RecordCommands(CommandRecordingContext* recordingConte
                                             CommandRecordingContext* recordingContext,
                                             const RenderPassResourceUsage& usages) -> MaybeError {
         DAWN_TRY(TransitionAndClearForSyncScope(device, recordingContext, usages));
+        recordingContext->RecordPendingBarriers(device->fn);
 
         // Reset all query set used on current render pass together before beginning render pass
         // because the reset command must be called outside render pass
@@ -615,7 +1606,7 @@ MaybeError CommandBuffer::RecordCommands(CommandRecordingContext* recordingConte
                 dstBuffer->EnsureDataInitializedAsDestination(recordingContext,
                                                               copy->destinationOffset, copy->size);
 
-                srcBuffer->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopySrc);
+                srcBuffer->TransitionUsageLater(recordingContext, wgpu::BufferUsage::CopySrc);
                 dstBuffer->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopyDst);
 
                 VkBufferCopy region;
@@ -656,7 +1647,7 @@ MaybeError CommandBuffer::RecordCommands(CommandRecordingContext* recordingConte
                                  ->EnsureSubresourceContentInitialized(recordingContext, range));
                 }
                 ToBackend(src.buffer)
-                    ->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopySrc);
+                    ->TransitionUsageLater(recordingContext, wgpu::BufferUsage::CopySrc);
                 ToBackend(dst.texture)
                     ->TransitionUsageNow(recordingContext, wgpu::TextureUsage::CopyDst,
                                          wgpu::ShaderStage::None, range);
@@ -691,8 +1682,8 @@ MaybeError CommandBuffer::RecordCommands(CommandRecordingContext* recordingConte
                              ->EnsureSubresourceContentInitialized(recordingContext, range));
 
                 ToBackend(src.texture)
-                    ->TransitionUsageNow(recordingContext, wgpu::TextureUsage::CopySrc,
-                                         wgpu::ShaderStage::None, range);
+                    ->TransitionUsageLater(recordingContext, wgpu::TextureUsage::CopySrc,
+                                           wgpu::ShaderStage::None, range);
                 ToBackend(dst.buffer)
                     ->TransitionUsageNow(recordingContext, wgpu::BufferUsage::CopyDst);
 
@@ -737,8 +1728,8 @@ MaybeError CommandBuffer::RecordCommands(CommandRecordingContext* recordingConte
                 }
 
                 ToBackend(src.texture)
-                    ->TransitionUsageNow(recordingContext, wgpu::TextureUsage::CopySrc,
-                                         wgpu::ShaderStage::None, srcRange);
+                    ->TransitionUsageLater(recordingContext, wgpu::TextureUsage::CopySrc,
+                                           wgpu::ShaderStage::None, srcRange);
                 ToBackend(dst.texture)
                     ->TransitionUsageNow(recordingContext, wgpu::TextureUsage::CopyDst,
                                          wgpu::ShaderStage::None, dstRange);
@@ -1015,7 +2006,8 @@ MaybeError CommandBuffer::RecordComputePass(CommandRecordingContext* recordingCo
 
                 DAWN_TRY(TransitionAndClearForSyncScope(
                     device, recordingContext, resourceUsages.dispatchUsages[currentDispatch]));
-                descriptorSets.Apply(device, recordingContext, VK_PIPELINE_BIND_POINT_COMPUTE);
+                recordingContext->RecordPendingBarriers(device->fn);
+                descriptorSets.Apply(device, commands, VK_PIPELINE_BIND_POINT_COMPUTE);
 
                 device->fn.CmdDispatch(commands, dispatch->x, dispatch->y, dispatch->z);
                 currentDispatch++;
@@ -1028,7 +2020,8 @@ MaybeError CommandBuffer::RecordComputePass(CommandRecordingContext* recordingCo
 
                 DAWN_TRY(TransitionAndClearForSyncScope(
                     device, recordingContext, resourceUsages.dispatchUsages[currentDispatch]));
-                descriptorSets.Apply(device, recordingContext, VK_PIPELINE_BIND_POINT_COMPUTE);
+                recordingContext->RecordPendingBarriers(device->fn);
+                descriptorSets.Apply(device, commands, VK_PIPELINE_BIND_POINT_COMPUTE);
 
                 device->fn.CmdDispatchIndirect(commands, indirectBuffer,
                                                static_cast<VkDeviceSize>(dispatch->indirectOffset));
@@ -1130,7 +2123,6 @@ MaybeError CommandBuffer::RecordComputePass(CommandRecordingContext* recordingCo
 MaybeError CommandBuffer::RecordRenderPass(CommandRecordingContext* recordingContext,
                                            BeginRenderPassCmd* renderPassCmd) {
     Device* device = ToBackend(GetDevice());
-    VkCommandBuffer commands = recordingContext->commandBuffer;
 
     // Write timestamp at the beginning of render pass if it's set.
     // We've observed that this must be called before the render pass or the timestamps produced
@@ -1142,331 +2134,60 @@ MaybeError CommandBuffer::RecordRenderPass(CommandRecordingContext* recordingCon
                                 VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
     }
 
-    DAWN_TRY(RecordBeginRenderPass(recordingContext, device, renderPassCmd));
-
-    // Set the default value for the dynamic state
-    {
-        device->fn.CmdSetLineWidth(commands, 1.0f);
-        device->fn.CmdSetDepthBounds(commands, 0.0f, 1.0f);
-
-        device->fn.CmdSetStencilReference(commands, VK_STENCIL_FRONT_AND_BACK, 0);
-
-        float blendConstants[4] = {
-            0.0f,
-            0.0f,
-            0.0f,
-            0.0f,
-        };
-        device->fn.CmdSetBlendConstants(commands, blendConstants);
-
-        // The viewport and scissor default to cover all of the attachments
-        VkViewport viewport;
-        viewport.x = 0.0f;
-        viewport.y = static_cast<float>(renderPassCmd->height);
-        viewport.width = static_cast<float>(renderPassCmd->width);
-        viewport.height = -static_cast<float>(renderPassCmd->height);
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
-        device->fn.CmdSetViewport(commands, 0, 1, &viewport);
-
-        VkRect2D scissorRect;
-        scissorRect.offset.x = 0;
-        scissorRect.offset.y = 0;
-        scissorRect.extent.width = renderPassCmd->width;
-        scissorRect.extent.height = renderPassCmd->height;
-        device->fn.CmdSetScissor(commands, 0, 1, &scissorRect);
-    }
-
-    DescriptorSetTracker descriptorSets = {};
-    RenderPipeline* lastPipeline = nullptr;
-
-    // Tracking for the push constants needed by the ClampFragDepth transform.
-    // TODO(dawn:1125): Avoid the need for this when the depthClamp feature is available, but doing
-    // so would require fixing issue dawn:1576 first to have more dynamic push constant usage. (and
-    // also additional tests that the dirtying logic here is correct so with a Toggle we can test it
-    // on our infra).
-    ClampFragDepthArgs clampFragDepthArgs = {0.0f, 1.0f};
-    bool clampFragDepthArgsDirty = true;
-    auto ApplyClampFragDepthArgs = [&] {
-        if (!clampFragDepthArgsDirty || lastPipeline == nullptr) {
-            return;
+    bool bakeRenderBundles = device->IsToggleEnabled(Toggle::BakeRenderBundleCommands);
+    bool recordInParallel = device->IsToggleEnabled(Toggle::VulkanRecordRenderPassesInParallel);
+    if (bakeRenderBundles || recordInParallel) {
+        // Gather all the commands of the render pass so that they can be split between secondary
+        // command buffers.
+        std::vector<RenderCommand> commands;
+        Command type;
+        while (mCommands.NextCommandId(&type) && type != Command::EndRenderPass) {
+            commands.push_back(ReadRenderCommand(&mCommands, type));
         }
-        device->fn.CmdPushConstants(commands, ToBackend(lastPipeline->GetLayout())->GetHandle(),
-                                    VK_SHADER_STAGE_FRAGMENT_BIT, kClampFragDepthArgsOffset,
-                                    kClampFragDepthArgsSize, &clampFragDepthArgs);
-        clampFragDepthArgsDirty = false;
-    };
-
-    auto EncodeRenderBundleCommand = [&](CommandIterator* iter, Command type) {
-        switch (type) {
-            case Command::Draw: {
-                DrawCmd* draw = iter->NextCommand<DrawCmd>();
-
-                descriptorSets.Apply(device, recordingContext, VK_PIPELINE_BIND_POINT_GRAPHICS);
-                device->fn.CmdDraw(commands, draw->vertexCount, draw->instanceCount,
-                                   draw->firstVertex, draw->firstInstance);
-                break;
-            }
-
-            case Command::DrawIndexed: {
-                DrawIndexedCmd* draw = iter->NextCommand<DrawIndexedCmd>();
-
-                descriptorSets.Apply(device, recordingContext, VK_PIPELINE_BIND_POINT_GRAPHICS);
-                device->fn.CmdDrawIndexed(commands, draw->indexCount, draw->instanceCount,
-                                          draw->firstIndex, draw->baseVertex, draw->firstInstance);
-                break;
-            }
-
-            case Command::DrawIndirect: {
-                DrawIndirectCmd* draw = iter->NextCommand<DrawIndirectCmd>();
-                Buffer* buffer = ToBackend(draw->indirectBuffer.Get());
-
-                descriptorSets.Apply(device, recordingContext, VK_PIPELINE_BIND_POINT_GRAPHICS);
-                device->fn.CmdDrawIndirect(commands, buffer->GetHandle(),
-                                           static_cast<VkDeviceSize>(draw->indirectOffset), 1, 0);
-                break;
-            }
-
-            case Command::DrawIndexedIndirect: {
-                DrawIndexedIndirectCmd* draw = iter->NextCommand<DrawIndexedIndirectCmd>();
-                Buffer* buffer = ToBackend(draw->indirectBuffer.Get());
-                DAWN_ASSERT(buffer != nullptr);
-
-                descriptorSets.Apply(device, recordingContext, VK_PIPELINE_BIND_POINT_GRAPHICS);
-                device->fn.CmdDrawIndexedIndirect(commands, buffer->GetHandle(),
-                                                  static_cast<VkDeviceSize>(draw->indirectOffset),
-                                                  1, 0);
-                break;
-            }
-
-            case Command::InsertDebugMarker: {
-                if (device->GetGlobalInfo().HasExt(InstanceExt::DebugUtils)) {
-                    InsertDebugMarkerCmd* cmd = iter->NextCommand<InsertDebugMarkerCmd>();
-                    const char* label = iter->NextData<char>(cmd->length + 1);
-                    VkDebugUtilsLabelEXT utilsLabel;
-                    utilsLabel.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
-                    utilsLabel.pNext = nullptr;
-                    utilsLabel.pLabelName = label;
-                    // Default color to black
-                    utilsLabel.color[0] = 0.0;
-                    utilsLabel.color[1] = 0.0;
-                    utilsLabel.color[2] = 0.0;
-                    utilsLabel.color[3] = 1.0;
-                    device->fn.CmdInsertDebugUtilsLabelEXT(commands, &utilsLabel);
-                } else {
-                    SkipCommand(iter, Command::InsertDebugMarker);
-                }
-                break;
-            }
-
-            case Command::PopDebugGroup: {
-                if (device->GetGlobalInfo().HasExt(InstanceExt::DebugUtils)) {
-                    iter->NextCommand<PopDebugGroupCmd>();
-                    device->fn.CmdEndDebugUtilsLabelEXT(commands);
-                } else {
-                    SkipCommand(iter, Command::PopDebugGroup);
-                }
-                break;
-            }
-
-            case Command::PushDebugGroup: {
-                if (device->GetGlobalInfo().HasExt(InstanceExt::DebugUtils)) {
-                    PushDebugGroupCmd* cmd = iter->NextCommand<PushDebugGroupCmd>();
-                    const char* label = iter->NextData<char>(cmd->length + 1);
-                    VkDebugUtilsLabelEXT utilsLabel;
-                    utilsLabel.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
-                    utilsLabel.pNext = nullptr;
-                    utilsLabel.pLabelName = label;
-                    // Default color to black
-                    utilsLabel.color[0] = 0.0;
-                    utilsLabel.color[1] = 0.0;
-                    utilsLabel.color[2] = 0.0;
-                    utilsLabel.color[3] = 1.0;
-                    device->fn.CmdBeginDebugUtilsLabelEXT(commands, &utilsLabel);
-                } else {
-                    SkipCommand(iter, Command::PushDebugGroup);
-                }
-                break;
-            }
-
-            case Command::SetBindGroup: {
-                SetBindGroupCmd* cmd = iter->NextCommand<SetBindGroupCmd>();
-                BindGroup* bindGroup = ToBackend(cmd->group.Get());
-                uint32_t* dynamicOffsets = nullptr;
-                if (cmd->dynamicOffsetCount > 0) {
-                    dynamicOffsets = iter->NextData<uint32_t>(cmd->dynamicOffsetCount);
-                }
-
-                descriptorSets.OnSetBindGroup(cmd->index, bindGroup, cmd->dynamicOffsetCount,
-                                              dynamicOffsets);
-                break;
-            }
-
-            case Command::SetIndexBuffer: {
-                SetIndexBufferCmd* cmd = iter->NextCommand<SetIndexBufferCmd>();
-                VkBuffer indexBuffer = ToBackend(cmd->buffer)->GetHandle();
-
-                device->fn.CmdBindIndexBuffer(commands, indexBuffer, cmd->offset,
-                                              VulkanIndexType(cmd->format));
-                break;
-            }
-
-            case Command::SetRenderPipeline: {
-                SetRenderPipelineCmd* cmd = iter->NextCommand<SetRenderPipelineCmd>();
-                RenderPipeline* pipeline = ToBackend(cmd->pipeline).Get();
-
-                device->fn.CmdBindPipeline(commands, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                           pipeline->GetHandle());
-                lastPipeline = pipeline;
-
-                descriptorSets.OnSetPipeline(pipeline);
-
-                // Apply the deferred min/maxDepth push constants update if needed.
-                ApplyClampFragDepthArgs();
-                break;
-            }
-
-            case Command::SetVertexBuffer: {
-                SetVertexBufferCmd* cmd = iter->NextCommand<SetVertexBufferCmd>();
-                VkBuffer buffer = ToBackend(cmd->buffer)->GetHandle();
-                VkDeviceSize offset = static_cast<VkDeviceSize>(cmd->offset);
-
-                device->fn.CmdBindVertexBuffers(commands, static_cast<uint8_t>(cmd->slot), 1,
-                                                &*buffer, &offset);
-                break;
-            }
+        DAWN_ASSERT(type == Command::EndRenderPass);
 
-            default:
-                DAWN_UNREACHABLE();
-                break;
+        bool recordedWithBakedBundles = false;
+        if (bakeRenderBundles) {
+            DAWN_TRY_ASSIGN(recordedWithBakedBundles,
+                            RecordRenderPassCommandsWithBakedBundles(device, recordingContext,
+                                                                     renderPassCmd, commands));
         }
-    };
-
-    Command type;
-    while (mCommands.NextCommandId(&type)) {
-        switch (type) {
-            case Command::EndRenderPass: {
-                mCommands.NextCommand<EndRenderPassCmd>();
-
-                device->fn.CmdEndRenderPass(commands);
-
-                // Write timestamp at the end of render pass if it's set.
-                // We've observed that this must be called after the render pass ends or the
-                // timestamps produced are nonsensical on multiple Android devices.
-                if (renderPassCmd->timestampWrites.endOfPassWriteIndex !=
-                    wgpu::kQuerySetIndexUndefined) {
-                    RecordWriteTimestampCmd(recordingContext, device,
-                                            renderPassCmd->timestampWrites.querySet.Get(),
-                                            renderPassCmd->timestampWrites.endOfPassWriteIndex,
-                                            true, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
-                }
-
-                return {};
-            }
-
-            case Command::SetBlendConstant: {
-                SetBlendConstantCmd* cmd = mCommands.NextCommand<SetBlendConstantCmd>();
-                const std::array<float, 4> blendConstants = ConvertToFloatColor(cmd->color);
-                device->fn.CmdSetBlendConstants(commands, blendConstants.data());
-                break;
-            }
-
-            case Command::SetStencilReference: {
-                SetStencilReferenceCmd* cmd = mCommands.NextCommand<SetStencilReferenceCmd>();
-                device->fn.CmdSetStencilReference(commands, VK_STENCIL_FRONT_AND_BACK,
-                                                  cmd->reference);
-                break;
-            }
-
-            case Command::SetViewport: {
-                SetViewportCmd* cmd = mCommands.NextCommand<SetViewportCmd>();
-                VkViewport viewport;
-                viewport.x = cmd->x;
-                viewport.y = cmd->y + cmd->height;
-                viewport.width = cmd->width;
-                viewport.height = -cmd->height;
-                viewport.minDepth = cmd->minDepth;
-                viewport.maxDepth = cmd->maxDepth;
-
-                // Vulkan disallows width = 0, but VK_KHR_maintenance1 which we require allows
-                // height = 0 so use that to do an empty viewport.
-                if (viewport.width == 0) {
-                    viewport.height = 0;
-
-                    // Set the viewport x range to a range that's always valid.
-                    viewport.x = 0;
-                    viewport.width = 1;
-                }
-
-                device->fn.CmdSetViewport(commands, 0, 1, &viewport);
-
-                // Try applying the push constants that contain min/maxDepth immediately. This can
-                // be deferred if no pipeline is currently bound.
-                clampFragDepthArgs = {viewport.minDepth, viewport.maxDepth};
-                clampFragDepthArgsDirty = true;
-                ApplyClampFragDepthArgs();
-                break;
-            }
-
-            case Command::SetScissorRect: {
-                SetScissorRectCmd* cmd = mCommands.NextCommand<SetScissorRectCmd>();
-                VkRect2D rect;
-                rect.offset.x = cmd->x;
-                rect.offset.y = cmd->y;
-                rect.extent.width = cmd->width;
-                rect.extent.height = cmd->height;
-
-                device->fn.CmdSetScissor(commands, 0, 1, &rect);
-                break;
-            }
-
-            case Command::ExecuteBundles: {
-                ExecuteBundlesCmd* cmd = mCommands.NextCommand<ExecuteBundlesCmd>();
-                auto bundles = mCommands.NextData<Ref<RenderBundleBase>>(cmd->count);
-
-                for (uint32_t i = 0; i < cmd->count; ++i) {
-                    CommandIterator* iter = bundles[i]->GetCommands();
-                    iter->Reset();
-                    while (iter->NextCommandId(&type)) {
-                        EncodeRenderBundleCommand(iter, type);
-                    }
-                }
-                break;
-            }
-
-            case Command::BeginOcclusionQuery: {
-                BeginOcclusionQueryCmd* cmd = mCommands.NextCommand<BeginOcclusionQueryCmd>();
-
-                device->fn.CmdBeginQuery(commands, ToBackend(cmd->querySet.Get())->GetHandle(),
-                                         cmd->queryIndex, 0);
-                break;
-            }
+        if (!recordedWithBakedBundles && recordInParallel) {
+            DAWN_TRY(RecordRenderPassCommandsInParallel(device, recordingContext, renderPassCmd,
+                                                        FlattenRenderBundles(commands)));
+        } else if (!recordedWithBakedBundles) {
+            DAWN_TRY(
+                RecordRenderPassCommandsInline(device, recordingContext, renderPassCmd, commands));
+        }
+    } else {
+        DAWN_TRY(RecordBeginRenderPass(recordingContext, device, renderPassCmd));
 
-            case Command::EndOcclusionQuery: {
-                EndOcclusionQueryCmd* cmd = mCommands.NextCommand<EndOcclusionQueryCmd>();
+        RenderCommandRecorder recorder(device, recordingContext->commandBuffer, recordingContext);
+        recorder.SetDefaultDynamicState(renderPassCmd->width, renderPassCmd->height);
 
-                device->fn.CmdEndQuery(commands, ToBackend(cmd->querySet.Get())->GetHandle(),
-                                       cmd->queryIndex);
-                break;
-            }
+        Command type;
+        while (mCommands.NextCommandId(&type) && type != Command::EndRenderPass) {
+            recorder.Record(ReadRenderCommand(&mCommands, type));
+        }
+        // EndRenderPass should have been called
+        DAWN_ASSERT(type == Command::EndRenderPass);
+    }
 
-            case Command::WriteTimestamp: {
-                WriteTimestampCmd* cmd = mCommands.NextCommand<WriteTimestampCmd>();
+    mCommands.NextCommand<EndRenderPassCmd>();
 
-                RecordWriteTimestampCmd(recordingContext, device, cmd->querySet.Get(),
-                                        cmd->queryIndex, true, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
-                break;
-            }
+    device->fn.CmdEndRenderPass(recordingContext->commandBuffer);
 
-            default: {
-                EncodeRenderBundleCommand(&mCommands, type);
-                break;
-            }
-        }
+    // Write timestamp at the end of render pass if it's set.
+    // We've observed that this must be called after the render pass ends or the timestamps
+    // produced are nonsensical on multiple Android devices.
+    if (renderPassCmd->timestampWrites.endOfPassWriteIndex != wgpu::kQuerySetIndexUndefined) {
+        RecordWriteTimestampCmd(recordingContext, device,
+                                renderPassCmd->timestampWrites.querySet.Get(),
+                                renderPassCmd->timestampWrites.endOfPassWriteIndex, true,
+                                VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
     }
 
-    // EndRenderPass should have been called
-    DAWN_UNREACHABLE();
+    return {};
 }
 
 }  // namespace dawn::native::vulkan
@@ -46,9 +46,14 @@ namespace dawn::native::vulkan {
 struct CommandRecordingContext;
 class Device;
 
-MaybeError RecordBeginRenderPass(CommandRecordingContext* recordingContext,
-                                 Device* device,
-                                 BeginRenderPassCmd* renderPass);
+// Begins the render pass. If |secondaryInheritanceInfo| is not null, the render pass contents
+// are recorded in secondary command buffers that inherit the render pass using the info written
+// to |secondaryInheritanceInfo|.
+MaybeError RecordBeginRenderPass(
+    CommandRecordingContext* recordingContext,
+    Device* device,
+    BeginRenderPassCmd* renderPass,
+    VkCommandBufferInheritanceInfo* secondaryInheritanceInfo = nullptr);
 
 class CommandBuffer final : public CommandBufferBase {
   public:
@@ -0,0 +1,103 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "dawn/native/vulkan/CommandRecordingContext.h"
+
+#include "dawn/common/Assert.h"
+
+namespace dawn::native::vulkan {
+
+void PipelineBarrierBatch::AddBufferBarrier(VkPipelineStageFlags srcStages,
+                                            VkPipelineStageFlags dstStages,
+                                            const VkBufferMemoryBarrier& barrier) {
+    DAWN_ASSERT(srcStages != 0 && dstStages != 0);
+    Barriers* barriers = GetBarriersFor(dstStages);
+    barriers->srcStages |= srcStages;
+    barriers->dstStages |= dstStages;
+    barriers->bufferBarriers.push_back(barrier);
+}
+
+void PipelineBarrierBatch::AddImageBarriers(VkPipelineStageFlags srcStages,
+                                            VkPipelineStageFlags dstStages,
+                                            const std::vector<VkImageMemoryBarrier>& barriers) {
+    if (barriers.empty()) {
+        return;
+    }
+    DAWN_ASSERT(srcStages != 0 && dstStages != 0);
+    Barriers* batch = GetBarriersFor(dstStages);
+    batch->srcStages |= srcStages;
+    batch->dstStages |= dstStages;
+    batch->imageBarriers.insert(batch->imageBarriers.end(), barriers.begin(), barriers.end());
+}
+
+bool PipelineBarrierBatch::Empty() const {
+    return mVertexBarriers.bufferBarriers.empty() && mVertexBarriers.imageBarriers.empty() &&
+           mNonVertexBarriers.bufferBarriers.empty() && mNonVertexBarriers.imageBarriers.empty();
+}
+
+void PipelineBarrierBatch::Record(const VulkanFunctions& fn, VkCommandBuffer commands) {
+    for (Barriers* barriers : {&mVertexBarriers, &mNonVertexBarriers}) {
+        if (barriers->bufferBarriers.empty() && barriers->imageBarriers.empty()) {
+            continue;
+        }
+
+        fn.CmdPipelineBarrier(commands, barriers->srcStages, barriers->dstStages, 0, 0, nullptr,
+                              barriers->bufferBarriers.size(), barriers->bufferBarriers.data(),
+                              barriers->imageBarriers.size(), barriers->imageBarriers.data());
+        mRecordedPipelineBarrierCount++;
+        mRecordedMemoryBarrierCount +=
+            barriers->bufferBarriers.size() + barriers->imageBarriers.size();
+
+        // Clear the vectors instead of replacing them to reuse their storage for the next batch.
+        barriers->bufferBarriers.clear();
+        barriers->imageBarriers.clear();
+        barriers->srcStages = 0;
+        barriers->dstStages = 0;
+    }
+}
+
+uint64_t PipelineBarrierBatch::GetRecordedPipelineBarrierCount() const {
+    return mRecordedPipelineBarrierCount;
+}
+
+uint64_t PipelineBarrierBatch::GetRecordedMemoryBarrierCount() const {
+    return mRecordedMemoryBarrierCount;
+}
+
+PipelineBarrierBatch::Barriers* PipelineBarrierBatch::GetBarriersFor(
+    VkPipelineStageFlags dstStages) {
+    constexpr VkPipelineStageFlags kVertexStages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+                                                   VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                                                   VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+    return (dstStages & kVertexStages) ? &mVertexBarriers : &mNonVertexBarriers;
+}
+
+void CommandRecordingContext::RecordPendingBarriers(const VulkanFunctions& fn) {
+    pendingBarriers.Record(fn, commandBuffer);
+}
+
+}  // namespace dawn::native::vulkan
@@ -48,9 +48,54 @@ struct CommandPoolAndBuffer {
     VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
 };
 
-// Used to track operations that are handled after recording.
-// Currently only tracks semaphores, but may be used to do barrier coalescing in the future.
+// Accumulates pipeline barriers so that the barriers of consecutive transitions are recorded in as
+// few vkCmdPipelineBarrier as possible. All the barriers added to the batch must be for different
+// resources (or subresources) since the barriers of a single vkCmdPipelineBarrier aren't ordered.
+class PipelineBarrierBatch {
+  public:
+    void AddBufferBarrier(VkPipelineStageFlags srcStages,
+                          VkPipelineStageFlags dstStages,
+                          const VkBufferMemoryBarrier& barrier);
+    void AddImageBarriers(VkPipelineStageFlags srcStages,
+                          VkPipelineStageFlags dstStages,
+                          const std::vector<VkImageMemoryBarrier>& barriers);
+
+    bool Empty() const;
+
+    // Records all the barriers added since the last call in at most two vkCmdPipelineBarrier.
+    void Record(const VulkanFunctions& fn, VkCommandBuffer commands);
+
+    // Statistics about the barriers recorded by this batch, for tracing.
+    uint64_t GetRecordedPipelineBarrierCount() const;
+    uint64_t GetRecordedMemoryBarrierCount() const;
+
+  private:
+    struct Barriers {
+        std::vector<VkBufferMemoryBarrier> bufferBarriers;
+        std::vector<VkImageMemoryBarrier> imageBarriers;
+        VkPipelineStageFlags srcStages = 0;
+        VkPipelineStageFlags dstStages = 0;
+    };
+    Barriers* GetBarriersFor(VkPipelineStageFlags dstStages);
+
+    // Barriers with vertex stages in destination stages are separated from all other barriers.
+    // This avoids creating unnecessary fragment->vertex dependencies when merging barriers.
+    // Eg. merging a compute->vertex barrier and a fragment->fragment barrier would create
+    // a compute|fragment->vertex|fragment barrier.
+    Barriers mVertexBarriers;
+    Barriers mNonVertexBarriers;
+
+    uint64_t mRecordedPipelineBarrierCount = 0;
+    uint64_t mRecordedMemoryBarrierCount = 0;
+};
+
+// Used to track operations that are handled after recording, like semaphores and the coalescing
+// of barriers.
 struct CommandRecordingContext {
+    // Records the pending barriers in the current command buffer. Must be called before recording
+    // a command that uses resources transitioned with one of the *Later methods.
+    void RecordPendingBarriers(const VulkanFunctions& fn);
+
     VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
     std::vector<VkSemaphore> waitSemaphores = {};
     std::vector<VkSemaphore> signalSemaphores = {};
@@ -67,6 +112,9 @@ struct CommandRecordingContext {
     // VkSubmit.
     std::set<Ref<Buffer>> mappableBuffersForEagerTransition;
 
+    // Barriers that haven't been recorded yet. See RecordPendingBarriers.
+    PipelineBarrierBatch pendingBarriers;
+
     // For Device state tracking only.
     VkCommandPool commandPool = VK_NULL_HANDLE;
     bool needsSubmit = false;
@@ -79,6 +127,11 @@ struct CommandRecordingContext {
     std::vector<VkCommandBuffer> commandBufferList;
     std::vector<VkCommandPool> commandPoolList;
 
+    // Secondary command buffers executed by the primary command buffers of this recording
+    // context, for example render passes recorded in parallel. Each one has its own pool so that
+    // they can be recorded on different threads.
+    std::vector<CommandPoolAndBuffer> secondaryCommands;
+
     // Need to track if a render pass has already been recorded for the
     // VulkanSplitCommandBufferOnComputePassAfterRenderPass workaround.
     bool hasRecordedRenderPass = false;
@@ -133,8 +133,8 @@ MaybeError ComputePipeline::InitializeImpl() {
             "CreateComputePipelines"));
         cacheTimer.RecordMicroseconds("Vulkan.CreateComputePipelines.CacheMiss");
     }
-    // TODO(dawn:549): Flush is currently in the same thread, but perhaps deferrable.
-    DAWN_TRY(cache->FlushIfNeeded());
+    // The monolithic cache is flushed on a worker thread, see Device::TickImpl.
+    DAWN_TRY(cache->DidCreatePipeline());
 
     SetLabelImpl();
 
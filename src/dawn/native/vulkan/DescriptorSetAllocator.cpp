@@ -27,67 +27,69 @@
 
 #include "dawn/native/vulkan/DescriptorSetAllocator.h"
 
+#include <algorithm>
 #include <utility>
 
+#include "dawn/common/HashUtils.h"
 #include "dawn/native/Queue.h"
 #include "dawn/native/vulkan/BindGroupLayoutVk.h"
 #include "dawn/native/vulkan/DeviceVk.h"
 #include "dawn/native/vulkan/FencedDeleter.h"
 #include "dawn/native/vulkan/VulkanError.h"
+#include "dawn/platform/DawnPlatform.h"
+#include "dawn/platform/tracing/TraceEvent.h"
 
 namespace dawn::native::vulkan {
 
 // TODO(enga): Figure out this value.
 static constexpr uint32_t kMaxDescriptorsPerPool = 512;
+// Pools grow geometrically so that heavily used allocators need few pools, but no pool gets more
+// than this many times bigger than the first one.
+static constexpr uint32_t kMaxPoolGrowthFactor = 32;
 
 // static
 Ref<DescriptorSetAllocator> DescriptorSetAllocator::Create(
-    BindGroupLayout* layout,
+    Device* device,
     absl::flat_hash_map<VkDescriptorType, uint32_t> descriptorCountPerType) {
-    return AcquireRef(new DescriptorSetAllocator(layout, descriptorCountPerType));
+    return AcquireRef(new DescriptorSetAllocator(device, std::move(descriptorCountPerType)));
 }
 
 DescriptorSetAllocator::DescriptorSetAllocator(
-    BindGroupLayout* layout,
+    Device* device,
     absl::flat_hash_map<VkDescriptorType, uint32_t> descriptorCountPerType)
-    : ObjectBase(layout->GetDevice()), mLayout(layout) {
-    DAWN_ASSERT(layout != nullptr);
-
+    : ObjectBase(device) {
     // Compute the total number of descriptors for this layout.
     uint32_t totalDescriptorCount = 0;
-    mPoolSizes.reserve(descriptorCountPerType.size());
+    mDescriptorCountPerType.reserve(descriptorCountPerType.size());
     for (const auto& [type, count] : descriptorCountPerType) {
         DAWN_ASSERT(count > 0);
         totalDescriptorCount += count;
-        mPoolSizes.push_back(VkDescriptorPoolSize{type, count});
+        mDescriptorCountPerType.push_back(VkDescriptorPoolSize{type, count});
     }
+    // Sort the counts so that they can be compared when deduplicating allocators.
+    std::sort(mDescriptorCountPerType.begin(), mDescriptorCountPerType.end(),
+              [](const VkDescriptorPoolSize& a, const VkDescriptorPoolSize& b) {
+                  return a.type < b.type;
+              });
 
     if (totalDescriptorCount == 0) {
-        // Vulkan requires that valid usage of vkCreateDescriptorPool must have a non-zero
-        // number of pools, each of which has non-zero descriptor counts.
         // Since the descriptor set layout is empty, we should be able to allocate
-        // |kMaxDescriptorsPerPool| sets from this 1-sized descriptor pool.
-        // The type of this descriptor pool doesn't matter because it is never used.
-        mPoolSizes.push_back(VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1});
-        mMaxSets = kMaxDescriptorsPerPool;
+        // |kMaxDescriptorsPerPool| sets from a 1-sized descriptor pool.
+        mBaseMaxSets = kMaxDescriptorsPerPool;
     } else {
         DAWN_ASSERT(totalDescriptorCount <= kMaxBindingsPerPipelineLayout);
         static_assert(kMaxBindingsPerPipelineLayout <= kMaxDescriptorsPerPool);
 
         // Compute the total number of descriptors sets that fits given the max.
-        mMaxSets = kMaxDescriptorsPerPool / totalDescriptorCount;
-        DAWN_ASSERT(mMaxSets > 0);
-
-        // Grow the number of desciptors in the pool to fit the computed |mMaxSets|.
-        for (auto& poolSize : mPoolSizes) {
-            poolSize.descriptorCount *= mMaxSets;
-        }
+        mBaseMaxSets = kMaxDescriptorsPerPool / totalDescriptorCount;
+        DAWN_ASSERT(mBaseMaxSets > 0);
     }
+    mNextPoolMaxSets = mBaseMaxSets;
 }
 
 DescriptorSetAllocator::~DescriptorSetAllocator() {
     for (auto& pool : mDescriptorPools) {
-        DAWN_ASSERT(pool.freeSetIndices.size() == mMaxSets);
+        DAWN_ASSERT(pool.freeSetCount == pool.maxSets);
         if (pool.vkPool != VK_NULL_HANDLE) {
             Device* device = ToBackend(GetDevice());
             device->GetFencedDeleter()->DeleteWhenUnused(pool.vkPool);
@@ -95,38 +97,77 @@ DescriptorSetAllocator::~DescriptorSetAllocator() {
     }
 }
 
-ResultOrError<DescriptorSetAllocation> DescriptorSetAllocator::Allocate() {
-    if (mAvailableDescriptorPoolIndices.empty()) {
-        DAWN_TRY(AllocateDescriptorPool());
-    }
+void DescriptorSetAllocator::DeleteThis() {
+    Uncache();
+    ObjectBase::DeleteThis();
+}
 
-    DAWN_ASSERT(!mAvailableDescriptorPoolIndices.empty());
+ResultOrError<DescriptorSetAllocation> DescriptorSetAllocator::Allocate(
+    const BindGroupLayout* layout) {
+    std::lock_guard<std::mutex> lock(mMutex);
 
-    const PoolIndex poolIndex = mAvailableDescriptorPoolIndices.back();
-    DescriptorPool* pool = &mDescriptorPools[poolIndex];
+    Device* device = ToBackend(GetDevice());
+    VkDescriptorSetLayout vkLayout = layout->GetHandle();
 
-    DAWN_ASSERT(!pool->freeSetIndices.empty());
+    while (true) {
+        if (mAvailableDescriptorPoolIndices.empty()) {
+            DAWN_TRY(AllocateDescriptorPool());
+        }
 
-    SetIndex setIndex = pool->freeSetIndices.back();
-    pool->freeSetIndices.pop_back();
+        DAWN_ASSERT(!mAvailableDescriptorPoolIndices.empty());
+
+        const PoolIndex poolIndex = mAvailableDescriptorPoolIndices.back();
+        DescriptorPool* pool = &mDescriptorPools[poolIndex];
+
+        DAWN_ASSERT(pool->freeSetCount > 0);
+        DAWN_ASSERT(!pool->retired);
+
+        VkDescriptorSetAllocateInfo allocateInfo;
+        allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocateInfo.pNext = nullptr;
+        allocateInfo.descriptorPool = pool->vkPool;
+        allocateInfo.descriptorSetCount = 1;
+        allocateInfo.pSetLayouts = AsVkArray(&vkLayout);
+
+        VkDescriptorSet set;
+        VkResult result = VkResult::WrapUnsafe(
+            device->fn.AllocateDescriptorSets(device->GetVkDevice(), &allocateInfo, &*set));
+
+        // Since sets are freed individually, the pool may be too fragmented to allocate a set
+        // even though it has space for it. Stop allocating from it until all its sets are freed
+        // and use another pool instead. This can't happen for an empty pool, which would make
+        // the loop allocate new pools forever.
+        bool poolIsEmpty = pool->freeSetCount == pool->maxSets;
+        if (!poolIsEmpty &&
+            (result == VK_ERROR_FRAGMENTED_POOL || result == VK_ERROR_OUT_OF_POOL_MEMORY)) {
+            pool->retired = true;
+            mAvailableDescriptorPoolIndices.pop_back();
+            continue;
+        }
+        DAWN_TRY(CheckVkSuccess(::VkResult(result), "AllocateDescriptorSets"));
 
-    if (pool->freeSetIndices.empty()) {
-        mAvailableDescriptorPoolIndices.pop_back();
-    }
+        pool->freeSetCount--;
+        if (pool->freeSetCount == 0) {
+            mAvailableDescriptorPoolIndices.pop_back();
+        }
+        mAllocatedSetCount++;
 
-    return DescriptorSetAllocation{pool->sets[setIndex], poolIndex, setIndex};
+        return DescriptorSetAllocation{set, poolIndex};
+    }
 }
 
 void DescriptorSetAllocator::Deallocate(DescriptorSetAllocation* allocationInfo) {
     DAWN_ASSERT(allocationInfo != nullptr);
     DAWN_ASSERT(allocationInfo->set != VK_NULL_HANDLE);
 
+    std::lock_guard<std::mutex> lock(mMutex);
+
     // We can't reuse the descriptor set right away because the Vulkan spec says in the
     // documentation for vkCmdBindDescriptorSets that the set may be consumed any time between
     // host execution of the command and the end of the draw/dispatch.
     Device* device = ToBackend(GetDevice());
     const ExecutionSerial serial = device->GetQueue()->GetPendingCommandSerial();
-    mPendingDeallocations.Enqueue({allocationInfo->poolIndex, allocationInfo->setIndex}, serial);
+    mPendingDeallocations.Enqueue({allocationInfo->set, allocationInfo->poolIndex}, serial);
 
     if (mLastDeallocationSerial != serial) {
         device->EnqueueDeferredDeallocation(this);
@@ -138,26 +179,88 @@ void DescriptorSetAllocator::Deallocate(DescriptorSetAllocation* allocationInfo)
 }
 
 void DescriptorSetAllocator::FinishDeallocation(ExecutionSerial completedSerial) {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    Device* device = ToBackend(GetDevice());
+
+    // Free the sets of each pool with a single call. Deallocations are usually grouped by pool
+    // so batch consecutive deallocations from the same pool.
+    std::vector<VkDescriptorSet> setsToFree;
+    PoolIndex currentPoolIndex = 0;
+    auto FreeSets = [&] {
+        if (setsToFree.empty()) {
+            return;
+        }
+        DescriptorPool& pool = mDescriptorPools[currentPoolIndex];
+        device->fn.FreeDescriptorSets(device->GetVkDevice(), pool.vkPool,
+                                      static_cast<uint32_t>(setsToFree.size()),
+                                      AsVkArray(setsToFree.data()));
+        // Full pools can be used again as soon as a set is freed, but retired pools only once
+        // all their sets are freed, since they are no longer fragmented then.
+        bool wasFull = pool.freeSetCount == 0;
+        pool.freeSetCount += static_cast<uint32_t>(setsToFree.size());
+        if (pool.retired && pool.freeSetCount == pool.maxSets) {
+            pool.retired = false;
+            mAvailableDescriptorPoolIndices.emplace_back(currentPoolIndex);
+        } else if (!pool.retired && wasFull) {
+            mAvailableDescriptorPoolIndices.emplace_back(currentPoolIndex);
+        }
+        mAllocatedSetCount -= setsToFree.size();
+        setsToFree.clear();
+    };
+
     for (const Deallocation& dealloc : mPendingDeallocations.IterateUpTo(completedSerial)) {
         DAWN_ASSERT(dealloc.poolIndex < mDescriptorPools.size());
 
-        auto& freeSetIndices = mDescriptorPools[dealloc.poolIndex].freeSetIndices;
-        if (freeSetIndices.empty()) {
-            mAvailableDescriptorPoolIndices.emplace_back(dealloc.poolIndex);
+        if (dealloc.poolIndex != currentPoolIndex) {
+            FreeSets();
+            currentPoolIndex = dealloc.poolIndex;
         }
-        freeSetIndices.emplace_back(dealloc.setIndex);
+        setsToFree.push_back(dealloc.set);
     }
+    FreeSets();
     mPendingDeallocations.ClearUpTo(completedSerial);
+
+    TraceUsage();
+}
+
+std::vector<uint32_t> DescriptorSetAllocator::GetPoolMaxSetsForTesting() {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    std::vector<uint32_t> poolMaxSets;
+    for (const DescriptorPool& pool : mDescriptorPools) {
+        poolMaxSets.push_back(pool.maxSets);
+    }
+    return poolMaxSets;
 }
 
 MaybeError DescriptorSetAllocator::AllocateDescriptorPool() {
+    // Grow the pools geometrically so that allocators used for many sets don't need many pools.
+    uint32_t maxSets = mNextPoolMaxSets;
+    mNextPoolMaxSets = std::min(maxSets * 2, mBaseMaxSets * kMaxPoolGrowthFactor);
+
+    std::vector<VkDescriptorPoolSize> poolSizes;
+    if (mDescriptorCountPerType.empty()) {
+        // Vulkan requires that valid usage of vkCreateDescriptorPool must have a non-zero
+        // number of pools, each of which has non-zero descriptor counts.
+        // The type of this descriptor pool doesn't matter because it is never used.
+        poolSizes.push_back(VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1});
+    } else {
+        // Grow the number of desciptors in the pool to fit |maxSets|.
+        poolSizes = mDescriptorCountPerType;
+        for (auto& poolSize : poolSizes) {
+            poolSize.descriptorCount *= maxSets;
+        }
+    }
+
     VkDescriptorPoolCreateInfo createInfo;
     createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
     createInfo.pNext = nullptr;
-    createInfo.flags = 0;
-    createInfo.maxSets = mMaxSets;
-    createInfo.poolSizeCount = static_cast<PoolIndex>(mPoolSizes.size());
-    createInfo.pPoolSizes = mPoolSizes.data();
+    // Sets are freed individually because they may be allocated for different layouts.
+    createInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    createInfo.maxSets = maxSets;
+    createInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    createInfo.pPoolSizes = poolSizes.data();
 
     Device* device = ToBackend(GetDevice());
 
@@ -166,38 +269,37 @@ MaybeError DescriptorSetAllocator::AllocateDescriptorPool() {
                                                             nullptr, &*descriptorPool),
                             "CreateDescriptorPool"));
 
-    std::vector<VkDescriptorSetLayout> layouts(mMaxSets, mLayout->GetHandle());
-
-    VkDescriptorSetAllocateInfo allocateInfo;
-    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocateInfo.pNext = nullptr;
-    allocateInfo.descriptorPool = descriptorPool;
-    allocateInfo.descriptorSetCount = mMaxSets;
-    allocateInfo.pSetLayouts = AsVkArray(layouts.data());
-
-    std::vector<VkDescriptorSet> sets(mMaxSets);
-    MaybeError result =
-        CheckVkSuccess(device->fn.AllocateDescriptorSets(device->GetVkDevice(), &allocateInfo,
-                                                         AsVkArray(sets.data())),
-                       "AllocateDescriptorSets");
-    if (result.IsError()) {
-        // On an error we can destroy the pool immediately because no command references it.
-        device->fn.DestroyDescriptorPool(device->GetVkDevice(), descriptorPool, nullptr);
-        DAWN_TRY(std::move(result));
-    }
+    mAvailableDescriptorPoolIndices.push_back(mDescriptorPools.size());
+    mDescriptorPools.emplace_back(DescriptorPool{descriptorPool, maxSets, maxSets, false});
+    mTotalSetCount += maxSets;
 
-    std::vector<SetIndex> freeSetIndices;
-    freeSetIndices.reserve(mMaxSets);
+    TraceUsage();
 
-    for (SetIndex i = 0; i < mMaxSets; ++i) {
-        freeSetIndices.push_back(i);
-    }
+    return {};
+}
 
-    mAvailableDescriptorPoolIndices.push_back(mDescriptorPools.size());
-    mDescriptorPools.emplace_back(
-        DescriptorPool{descriptorPool, std::move(sets), std::move(freeSetIndices)});
+void DescriptorSetAllocator::TraceUsage() {
+    TRACE_COUNTER_ID2(GetDevice()->GetPlatform(), General, "vulkan::DescriptorSetAllocator", this,
+                      "allocatedSets", mAllocatedSetCount, "freeSets",
+                      mTotalSetCount - mAllocatedSetCount);
+}
 
-    return {};
+size_t DescriptorSetAllocator::HashFunc::operator()(
+    const DescriptorSetAllocator* allocator) const {
+    size_t hash = 0;
+    for (const VkDescriptorPoolSize& count : allocator->mDescriptorCountPerType) {
+        HashCombine(&hash, count.type, count.descriptorCount);
+    }
+    return hash;
+}
+
+bool DescriptorSetAllocator::EqualityFunc::operator()(const DescriptorSetAllocator* a,
+                                                      const DescriptorSetAllocator* b) const {
+    return std::equal(a->mDescriptorCountPerType.begin(), a->mDescriptorCountPerType.end(),
+                      b->mDescriptorCountPerType.begin(), b->mDescriptorCountPerType.end(),
+                      [](const VkDescriptorPoolSize& x, const VkDescriptorPoolSize& y) {
+                          return x.type == y.type && x.descriptorCount == y.descriptorCount;
+                      });
 }
 
 }  // namespace dawn::native::vulkan
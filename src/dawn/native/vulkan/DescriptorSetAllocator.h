@@ -28,59 +28,90 @@
 #ifndef SRC_DAWN_NATIVE_VULKAN_DESCRIPTORSETALLOCATOR_H_
 #define SRC_DAWN_NATIVE_VULKAN_DESCRIPTORSETALLOCATOR_H_
 
+#include <mutex>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "dawn/common/ContentLessObjectCacheable.h"
 #include "dawn/common/SerialQueue.h"
 #include "dawn/common/vulkan_platform.h"
 #include "dawn/native/Error.h"
 #include "dawn/native/IntegerTypes.h"
 #include "dawn/native/ObjectBase.h"
 #include "dawn/native/vulkan/DescriptorSetAllocation.h"
-#include "partition_alloc/pointers/raw_ptr.h"
 
 namespace dawn::native::vulkan {
 
 class BindGroupLayout;
-
-class DescriptorSetAllocator : public ObjectBase {
+class Device;
+
+// Allocates descriptor sets for all the bind group layouts that have the same number of
+// descriptors of each type. The pools are created with FREE_DESCRIPTOR_SET_BIT and every set
+// allocated from them has the same descriptor counts, so sets of any of these layouts can reuse
+// the space freed by sets of another one. Drivers may still report a pool as fragmented, in
+// which case it is retired until all its sets are freed. Allocators are deduplicated by the
+// device based on their descriptor counts.
+class DescriptorSetAllocator : public ObjectBase,
+                               public ContentLessObjectCacheable<DescriptorSetAllocator> {
     using PoolIndex = uint32_t;
-    using SetIndex = uint16_t;
 
   public:
     static Ref<DescriptorSetAllocator> Create(
-        BindGroupLayout* layout,
+        Device* device,
         absl::flat_hash_map<VkDescriptorType, uint32_t> descriptorCountPerType);
 
-    ResultOrError<DescriptorSetAllocation> Allocate();
+    // Public so that blueprints for lookups in the device's cache can be created on the stack.
+    DescriptorSetAllocator(Device* device,
+                           absl::flat_hash_map<VkDescriptorType, uint32_t> descriptorCountPerType);
+    ~DescriptorSetAllocator() override;
+
+    ResultOrError<DescriptorSetAllocation> Allocate(const BindGroupLayout* layout);
     void Deallocate(DescriptorSetAllocation* allocationInfo);
     void FinishDeallocation(ExecutionSerial completedSerial);
 
+    // Returns the number of sets of each pool, in the order they were created.
+    std::vector<uint32_t> GetPoolMaxSetsForTesting();
+
+    // Functors necessary for the unordered_set<DescriptorSetAllocator*>-based cache.
+    struct HashFunc {
+        size_t operator()(const DescriptorSetAllocator* allocator) const;
+    };
+    struct EqualityFunc {
+        bool operator()(const DescriptorSetAllocator* a, const DescriptorSetAllocator* b) const;
+    };
+
   private:
-    DescriptorSetAllocator(BindGroupLayout* layout,
-                           absl::flat_hash_map<VkDescriptorType, uint32_t> descriptorCountPerType);
-    ~DescriptorSetAllocator() override;
+    void DeleteThis() override;
 
     MaybeError AllocateDescriptorPool();
+    void TraceUsage();
 
-    // TODO(https://crbug.com/dawn/2349): Investigate DanglingUntriaged in dawn/native.
-    raw_ptr<const BindGroupLayout, DanglingUntriaged> mLayout;
-
-    std::vector<VkDescriptorPoolSize> mPoolSizes;
-    SetIndex mMaxSets;
+    // The number of descriptors of each type for a single set, sorted by type.
+    std::vector<VkDescriptorPoolSize> mDescriptorCountPerType;
+    // The number of sets in the first pool. Each new pool doubles the number of sets of the
+    // previous one, up to kMaxPoolGrowthFactor times this.
+    uint32_t mBaseMaxSets = 0;
+    uint32_t mNextPoolMaxSets = 0;
 
     struct DescriptorPool {
         VkDescriptorPool vkPool;
-        std::vector<VkDescriptorSet> sets;
-        std::vector<SetIndex> freeSetIndices;
+        uint32_t maxSets;
+        uint32_t freeSetCount;
+        // Whether allocations from the pool failed because it was fragmented or out of pool
+        // memory. Retired pools aren't allocated from until all their sets are freed.
+        bool retired;
     };
 
+    std::mutex mMutex;
+
     std::vector<PoolIndex> mAvailableDescriptorPoolIndices;
     std::vector<DescriptorPool> mDescriptorPools;
+    uint64_t mTotalSetCount = 0;
+    uint64_t mAllocatedSetCount = 0;
 
     struct Deallocation {
+        VkDescriptorSet set;
         PoolIndex poolIndex;
-        SetIndex setIndex;
     };
     SerialQueue<ExecutionSerial, Deallocation> mPendingDeallocations;
     ExecutionSerial mLastDeallocationSerial = ExecutionSerial(0);
@@ -0,0 +1,142 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "dawn/native/vulkan/DescriptorSetCache.h"
+
+#include <utility>
+
+#include "dawn/common/Assert.h"
+#include "dawn/common/HashUtils.h"
+#include "dawn/common/MatchVariant.h"
+#include "dawn/native/vulkan/BindGroupLayoutVk.h"
+#include "dawn/native/vulkan/BindGroupVk.h"
+#include "dawn/native/vulkan/DescriptorSetAllocator.h"
+#include "dawn/native/vulkan/Forward.h"
+#include "dawn/platform/DawnPlatform.h"
+#include "dawn/platform/tracing/TraceEvent.h"
+
+namespace dawn::native::vulkan {
+
+DescriptorSetCache::DescriptorSetCache() = default;
+
+DescriptorSetCache::~DescriptorSetCache() {
+    DAWN_ASSERT(mCache.empty());
+}
+
+ResultOrError<DescriptorSetAllocation> DescriptorSetCache::GetOrCreate(
+    BindGroup* group,
+    DescriptorSetAllocator* allocator) {
+    Key key = ComputeKey(group);
+
+    auto iter = mCache.find(key);
+    if (iter != mCache.end()) {
+        iter->second.refCount++;
+        mBindGroupCount++;
+        TraceUsage(group);
+        return iter->second.allocation;
+    }
+
+    DescriptorSetAllocation allocation;
+    DAWN_TRY_ASSIGN(allocation, allocator->Allocate(ToBackend(group->GetLayout())));
+
+    // The descriptor set is written while the cache is locked so that no other bind group can
+    // find it before it is fully written.
+    group->WriteDescriptorSet(allocation.set);
+
+    mCache.emplace(std::move(key), CachedDescriptorSet{allocation, 1});
+    mBindGroupCount++;
+    TraceUsage(group);
+    return allocation;
+}
+
+void DescriptorSetCache::Release(BindGroup* group,
+                                 DescriptorSetAllocation* allocation,
+                                 DescriptorSetAllocator* allocator) {
+    auto iter = mCache.find(ComputeKey(group));
+    DAWN_ASSERT(iter != mCache.end());
+    DAWN_ASSERT(iter->second.allocation.set == allocation->set);
+    DAWN_ASSERT(iter->second.refCount > 0);
+
+    if (--iter->second.refCount == 0) {
+        allocator->Deallocate(&iter->second.allocation);
+        mCache.erase(iter);
+    }
+    mBindGroupCount--;
+    TraceUsage(group);
+
+    // Clear the content of allocation so that use after frees are more visible.
+    *allocation = {};
+}
+
+// static
+DescriptorSetCache::Key DescriptorSetCache::ComputeKey(BindGroup* group) {
+    const BindGroupLayout* layout = ToBackend(group->GetLayout());
+
+    Key key;
+    key.reserve(static_cast<uint32_t>(layout->GetBindingCount()));
+    for (BindingIndex bindingIndex{0}; bindingIndex < layout->GetBindingCount(); ++bindingIndex) {
+        const BindingInfo& bindingInfo = layout->GetBindingInfo(bindingIndex);
+        key.push_back(MatchVariant(
+            bindingInfo.bindingLayout,
+            [&](const BufferBindingLayout&) -> BindingContent {
+                BufferBinding binding = group->GetBindingAsBufferBinding(bindingIndex);
+                return {binding.buffer, binding.offset, binding.size};
+            },
+            [&](const SamplerBindingLayout&) -> BindingContent {
+                return {group->GetBindingAsSampler(bindingIndex), 0, 0};
+            },
+            [&](const TextureBindingLayout&) -> BindingContent {
+                return {group->GetBindingAsTextureView(bindingIndex), 0, 0};
+            },
+            [&](const StorageTextureBindingLayout&) -> BindingContent {
+                return {group->GetBindingAsTextureView(bindingIndex), 0, 0};
+            }));
+    }
+    return key;
+}
+
+void DescriptorSetCache::TraceUsage(BindGroup* group) {
+    // Counters are reported per layout so that hot layouts and the effectiveness of the cache
+    // can be seen in traces.
+    TRACE_COUNTER_ID2(group->GetDevice()->GetPlatform(), General,
+                      "vulkan::BindGroupLayout::DescriptorSets", group->GetLayout(),
+                      "descriptorSets", mCache.size(), "bindGroups", mBindGroupCount);
+}
+
+bool DescriptorSetCache::BindingContent::operator==(const BindingContent& other) const {
+    return object == other.object && offset == other.offset && size == other.size;
+}
+
+size_t DescriptorSetCache::KeyHashFunc::operator()(const Key& key) const {
+    size_t hash = 0;
+    for (const BindingContent& content : key) {
+        HashCombine(&hash, content.object.get(), content.offset, content.size);
+    }
+    return hash;
+}
+
+}  // namespace dawn::native::vulkan
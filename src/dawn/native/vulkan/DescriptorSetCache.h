@@ -0,0 +1,98 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef SRC_DAWN_NATIVE_VULKAN_DESCRIPTORSETCACHE_H_
+#define SRC_DAWN_NATIVE_VULKAN_DESCRIPTORSETCACHE_H_
+
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "dawn/native/Error.h"
+#include "dawn/native/vulkan/DescriptorSetAllocation.h"
+#include "partition_alloc/pointers/raw_ptr.h"
+
+namespace dawn::native {
+class ObjectBase;
+}  // namespace dawn::native
+
+namespace dawn::native::vulkan {
+
+class BindGroup;
+class DescriptorSetAllocator;
+
+// Bind groups of the same layout that reference the same resources write identical descriptor
+// sets. Applications commonly recreate such bind groups every frame, so instead of allocating
+// and writing a new VkDescriptorSet for each of them, the DescriptorSetCache shares a single
+// reference-counted descriptor set between all the live bind groups with the same contents.
+// When the last of them is destroyed the set goes back to the DescriptorSetAllocator, which
+// only reuses it once the GPU is done with it in FinishDeallocation.
+class DescriptorSetCache {
+  public:
+    DescriptorSetCache();
+    ~DescriptorSetCache();
+
+    // Returns a descriptor set with the contents of `group`, allocating and writing a new one if
+    // no other live bind group has the same contents. Each successful call must be balanced by a
+    // call to Release while the bindings of `group` are still alive.
+    ResultOrError<DescriptorSetAllocation> GetOrCreate(BindGroup* group,
+                                                       DescriptorSetAllocator* allocator);
+    void Release(BindGroup* group,
+                 DescriptorSetAllocation* allocation,
+                 DescriptorSetAllocator* allocator);
+
+  private:
+    // The resources are identified by their frontend object. This is safe because an entry is
+    // only alive while a bind group holding references to the objects is alive.
+    struct BindingContent {
+        raw_ptr<const ObjectBase> object;
+        uint64_t offset;
+        uint64_t size;
+
+        bool operator==(const BindingContent& other) const;
+    };
+    using Key = std::vector<BindingContent>;
+
+    struct KeyHashFunc {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct CachedDescriptorSet {
+        DescriptorSetAllocation allocation;
+        uint32_t refCount;
+    };
+
+    static Key ComputeKey(BindGroup* group);
+    void TraceUsage(BindGroup* group);
+
+    absl::flat_hash_map<Key, CachedDescriptorSet, KeyHashFunc> mCache;
+    // The number of live bind groups using the descriptor sets in the cache.
+    uint64_t mBindGroupCount = 0;
+};
+
+}  // namespace dawn::native::vulkan
+
+#endif  // SRC_DAWN_NATIVE_VULKAN_DESCRIPTORSETCACHE_H_
@@ -27,9 +27,13 @@
 
 #include "dawn/native/vulkan/DeviceVk.h"
 
+#include <algorithm>
+#include <thread>
+
 #include "dawn/common/Log.h"
 #include "dawn/common/NonCopyable.h"
 #include "dawn/common/Platform.h"
+#include "dawn/native/AsyncTask.h"
 #include "dawn/native/BackendConnection.h"
 #include "dawn/native/ChainUtils.h"
 #include "dawn/native/Error.h"
@@ -60,9 +64,18 @@
 #include "dawn/native/vulkan/TextureVk.h"
 #include "dawn/native/vulkan/UtilsVulkan.h"
 #include "dawn/native/vulkan/VulkanError.h"
+#include "dawn/platform/WorkerThread.h"
 
 namespace dawn::native::vulkan {
 
+namespace {
+
+// Bounds the number of threads recording render passes when
+// Toggle::VulkanRecordRenderPassesInParallel is enabled, like the platform's worker thread pool.
+constexpr uint32_t kMaxRenderPassRecordingThreads = 16;
+
+}  // anonymous namespace
+
 // static
 ResultOrError<Ref<Device>> Device::Create(AdapterBase* adapter,
                                           const UnpackedPtr<DeviceDescriptor>& descriptor,
@@ -101,9 +114,20 @@ MaybeError Device::Initialize(const UnpackedPtr<DeviceDescriptor>& descriptor) {
         mDeleter = std::make_unique<MutexProtected<FencedDeleter>>(this);
     }
 
-    mRenderPassCache = std::make_unique<RenderPassCache>(this);
+    mRenderPassCache = std::make_unique<RenderPassCache>(
+        this, IsToggleEnabled(Toggle::VulkanBoundRenderPassCache) ? RenderPassCache::kBoundedMaxSize
+                                                                   : RenderPassCache::kUnbounded);
     mResourceMemoryAllocator = std::make_unique<MutexProtected<ResourceMemoryAllocator>>(this);
 
+    if (IsToggleEnabled(Toggle::VulkanMonolithicPipelineCache)) {
+        mMonolithicPipelineCache = PipelineCache::CreateMonolithic(this);
+    }
+
+    if (IsToggleEnabled(Toggle::VulkanRecordRenderPassesInParallel)) {
+        // Render passes are split in one chunk per hardware thread.
+        SetMaxRenderPassRecordingChunks(std::thread::hardware_concurrency());
+    }
+
     mExternalMemoryService = std::make_unique<external_memory::Service>(this);
 
     if (uint32_t(HasFeature(Feature::SharedFenceVkSemaphoreOpaqueFD)) +
@@ -208,6 +232,9 @@ ResultOrError<Ref<TextureViewBase>> Device::CreateTextureViewImpl(
     return TextureView::Create(texture, descriptor);
 }
 Ref<PipelineCacheBase> Device::GetOrCreatePipelineCacheImpl(const CacheKey& key) {
+    if (mMonolithicPipelineCache != nullptr) {
+        return mMonolithicPipelineCache;
+    }
     return PipelineCache::Create(this, key);
 }
 void Device::InitializeComputePipelineAsyncImpl(Ref<ComputePipelineBase> computePipeline,
@@ -310,6 +337,10 @@ MaybeError Device::TickImpl() {
     GetFencedDeleter()->Tick(completedSerial);
     mDescriptorAllocatorsPendingDeallocation.ClearUpTo(completedSerial);
 
+    if (mMonolithicPipelineCache != nullptr) {
+        mMonolithicPipelineCache->ScheduleFlushIfDirty(GetAsyncTaskManager());
+    }
+
     DAWN_TRY(queue->SubmitPendingCommands());
     DAWN_TRY(CheckDebugLayerAndGenerateErrors());
 
@@ -343,6 +374,32 @@ RenderPassCache* Device::GetRenderPassCache() const {
     return mRenderPassCache.get();
 }
 
+dawn::platform::WorkerTaskPool* Device::GetRenderPassRecordingPool() const {
+    return mRenderPassRecordingPool.get();
+}
+
+uint32_t Device::GetMaxRenderPassRecordingChunks() const {
+    return mMaxRenderPassRecordingChunks;
+}
+
+void Device::SetMaxRenderPassRecordingChunks(uint32_t maxChunks) {
+    mMaxRenderPassRecordingChunks = std::clamp(maxChunks, 1u, kMaxRenderPassRecordingThreads);
+
+    // The submitting thread records the first chunk. Replacing the pool joins its threads, which
+    // are idle since Queue::Submit waits for all the chunks it posts.
+    mRenderPassRecordingPool = nullptr;
+    if (mMaxRenderPassRecordingChunks > 1) {
+        mRenderPassRecordingPool = std::make_unique<dawn::platform::AsyncWorkerThreadPool>(
+            mMaxRenderPassRecordingChunks - 1);
+    }
+}
+
+void Device::SetMaxRenderPassRecordingChunksForTesting(uint32_t maxChunks) {
+    if (IsToggleEnabled(Toggle::VulkanRecordRenderPassesInParallel)) {
+        SetMaxRenderPassRecordingChunks(maxChunks);
+    }
+}
+
 MutexProtected<ResourceMemoryAllocator>& Device::GetResourceMemoryAllocator() const {
     return *mResourceMemoryAllocator;
 }
@@ -356,6 +413,19 @@ void Device::EnqueueDeferredDeallocation(DescriptorSetAllocator* allocator) {
                                                      GetQueue()->GetPendingCommandSerial());
 }
 
+Ref<DescriptorSetAllocator> Device::GetOrCreateDescriptorSetAllocator(
+    absl::flat_hash_map<VkDescriptorType, uint32_t> descriptorCountPerType) {
+    DescriptorSetAllocator blueprint(this, descriptorCountPerType);
+    Ref<DescriptorSetAllocator> allocator = mDescriptorSetAllocators.Find(&blueprint);
+    if (allocator != nullptr) {
+        return allocator;
+    }
+
+    // Inserts can race, in which case the allocator inserted by the other thread is returned.
+    allocator = DescriptorSetAllocator::Create(this, std::move(descriptorCountPerType));
+    return mDescriptorSetAllocators.Insert(allocator.Get()).first;
+}
+
 ResultOrError<VulkanDeviceKnobs> Device::CreateDevice(VkPhysicalDevice vkPhysicalDevice) {
     VulkanDeviceKnobs usedKnobs = {};
 
@@ -421,6 +491,16 @@ ResultOrError<VulkanDeviceKnobs> Device::CreateDevice(VkPhysicalDevice vkPhysica
         featuresChain.Add(&usedKnobs.shaderIntegerDotProductFeatures);
     }
 
+    if (IsToggleEnabled(Toggle::VulkanUseTimelineSemaphore) &&
+        mDeviceInfo.HasExt(DeviceExt::TimelineSemaphore) &&
+        mDeviceInfo.timelineSemaphoreFeatures.timelineSemaphore == VK_TRUE) {
+        DAWN_ASSERT(usedKnobs.HasExt(DeviceExt::TimelineSemaphore));
+
+        usedKnobs.timelineSemaphoreFeatures.timelineSemaphore = VK_TRUE;
+        featuresChain.Add(&usedKnobs.timelineSemaphoreFeatures,
+                          VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR);
+    }
+
     if (mDeviceInfo.features.samplerAnisotropy == VK_TRUE) {
         usedKnobs.features.samplerAnisotropy = VK_TRUE;
     }
@@ -858,6 +938,18 @@ void Device::DestroyImpl() {
     // to them are guaranteed to be finished executing.
     mRenderPassCache = nullptr;
 
+    // Join the threads recording render passes. No submit can happen anymore.
+    mRenderPassRecordingPool = nullptr;
+
+    // Write out the pipelines added to the monolithic cache since its last flush, then destroy
+    // it while the VkDevice is still alive. A flush may still be in flight on a worker thread
+    // and would miss the latest pipelines, so wait for it before flushing on this thread.
+    if (mMonolithicPipelineCache != nullptr) {
+        GetAsyncTaskManager()->WaitAllPendingTasks();
+        mMonolithicPipelineCache->FlushIfDirty();
+        mMonolithicPipelineCache = nullptr;
+    }
+
     // Delete all the remaining VkDevice child objects immediately since the GPU timeline is
     // finished.
     GetFencedDeleter()->Tick(kMaxExecutionSerial);
@@ -34,6 +34,8 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "dawn/common/ContentLessObjectCache.h"
 #include "dawn/common/MutexProtected.h"
 #include "dawn/common/SerialQueue.h"
 #include "dawn/native/Commands.h"
@@ -78,7 +80,17 @@ class Device final : public DeviceBase {
     MutexProtected<ResourceMemoryAllocator>& GetResourceMemoryAllocator() const;
     external_semaphore::Service* GetExternalSemaphoreService() const;
 
+    // The pool recording the chunks of the render passes split by
+    // Toggle::VulkanRecordRenderPassesInParallel, and the maximum number of chunks a render pass
+    // is split in, including the one recorded by the submitting thread.
+    dawn::platform::WorkerTaskPool* GetRenderPassRecordingPool() const;
+    uint32_t GetMaxRenderPassRecordingChunks() const;
+    void SetMaxRenderPassRecordingChunksForTesting(uint32_t maxChunks) override;
+
     void EnqueueDeferredDeallocation(DescriptorSetAllocator* allocator);
+    // Returns the allocator shared by all the layouts with these descriptor counts.
+    Ref<DescriptorSetAllocator> GetOrCreateDescriptorSetAllocator(
+        absl::flat_hash_map<VkDescriptorType, uint32_t> descriptorCountPerType);
 
     // Dawn Native API
 
@@ -128,6 +140,10 @@ class Device final : public DeviceBase {
            const UnpackedPtr<DeviceDescriptor>& descriptor,
            const TogglesState& deviceToggles);
 
+    // Sets the maximum number of chunks render passes are split in, clamped to
+    // [1, kMaxRenderPassRecordingThreads], and recreates the recording pool to match.
+    void SetMaxRenderPassRecordingChunks(uint32_t maxChunks);
+
     ResultOrError<Ref<BindGroupBase>> CreateBindGroupImpl(
         const BindGroupDescriptor* descriptor) override;
     ResultOrError<Ref<BindGroupLayoutInternalBase>> CreateBindGroupLayoutImpl(
@@ -188,11 +204,21 @@ class Device final : public DeviceBase {
     VkDevice mVkDevice = VK_NULL_HANDLE;
     uint32_t mMainQueueFamily = 0;
 
+    // Declared before the pending deallocations so that it outlives the references they hold.
+    ContentLessObjectCache<DescriptorSetAllocator> mDescriptorSetAllocators;
     SerialQueue<ExecutionSerial, Ref<DescriptorSetAllocator>>
         mDescriptorAllocatorsPendingDeallocation;
     std::unique_ptr<MutexProtected<FencedDeleter>> mDeleter;
     std::unique_ptr<MutexProtected<ResourceMemoryAllocator>> mResourceMemoryAllocator;
     std::unique_ptr<RenderPassCache> mRenderPassCache;
+    // Only set when Toggle::VulkanMonolithicPipelineCache is enabled.
+    Ref<PipelineCache> mMonolithicPipelineCache;
+    // Only set when Toggle::VulkanRecordRenderPassesInParallel is enabled. The render passes are
+    // recorded on their own threads instead of the platform's worker task pool because
+    // Queue::Submit waits for them with the device locked, so they must never queue behind tasks
+    // that take the device lock.
+    std::unique_ptr<dawn::platform::WorkerTaskPool> mRenderPassRecordingPool;
+    uint32_t mMaxRenderPassRecordingChunks = 1;
 
     std::unique_ptr<external_memory::Service> mExternalMemoryService;
     std::unique_ptr<external_semaphore::Service> mExternalSemaphoreService;
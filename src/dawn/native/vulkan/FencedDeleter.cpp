@@ -36,6 +36,7 @@ FencedDeleter::FencedDeleter(Device* device) : mDevice(device) {}
 
 FencedDeleter::~FencedDeleter() {
     DAWN_ASSERT(mBuffersToDelete.Empty());
+    DAWN_ASSERT(mCommandPoolsToDelete.Empty());
     DAWN_ASSERT(mDescriptorPoolsToDelete.Empty());
     DAWN_ASSERT(mFramebuffersToDelete.Empty());
     DAWN_ASSERT(mImagesToDelete.Empty());
@@ -56,6 +57,10 @@ void FencedDeleter::DeleteWhenUnused(VkBuffer buffer) {
     mBuffersToDelete.Enqueue(buffer, mDevice->GetQueue()->GetPendingCommandSerial());
 }
 
+void FencedDeleter::DeleteWhenUnused(VkCommandPool pool) {
+    mCommandPoolsToDelete.Enqueue(pool, mDevice->GetQueue()->GetPendingCommandSerial());
+}
+
 void FencedDeleter::DeleteWhenUnused(VkDescriptorPool pool) {
     mDescriptorPoolsToDelete.Enqueue(pool, mDevice->GetQueue()->GetPendingCommandSerial());
 }
@@ -116,6 +121,12 @@ void FencedDeleter::Tick(ExecutionSerial completedSerial) {
     VkDevice vkDevice = mDevice->GetVkDevice();
     VkInstance instance = mDevice->GetVkInstance();
 
+    // Destroying a command pool frees the command buffers allocated from it.
+    for (VkCommandPool pool : mCommandPoolsToDelete.IterateUpTo(completedSerial)) {
+        mDevice->fn.DestroyCommandPool(vkDevice, pool, nullptr);
+    }
+    mCommandPoolsToDelete.ClearUpTo(completedSerial);
+
     // Buffers and images must be deleted before memories because it is invalid to free memory
     // that still have resources bound to it.
     for (VkBuffer buffer : mBuffersToDelete.IterateUpTo(completedSerial)) {
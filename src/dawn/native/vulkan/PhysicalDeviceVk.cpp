@@ -590,6 +590,18 @@ void PhysicalDevice::SetupBackendDeviceToggles(TogglesState* deviceToggles) cons
     // Vulkan SPEC and drivers.
     deviceToggles->Default(Toggle::UseTemporaryBufferInCompressedTextureToTextureCopy, true);
 
+    // Track the completion of submits with a single timeline semaphore instead of a fence per
+    // submit when possible.
+    deviceToggles->Default(Toggle::VulkanUseTimelineSemaphore,
+                           mDeviceInfo.HasExt(DeviceExt::TimelineSemaphore) &&
+                               mDeviceInfo.timelineSemaphoreFeatures.timelineSemaphore == VK_TRUE);
+
+    // On unified memory architectures buffers are usually allocated in host-visible memory, so
+    // Queue::WriteBuffer can skip the staging copy for buffers the GPU is done with.
+    deviceToggles->Default(Toggle::VulkanDirectWriteBufferOnUMA,
+                           mAdapterType == wgpu::AdapterType::IntegratedGPU ||
+                               mAdapterType == wgpu::AdapterType::CPU);
+
 #if DAWN_PLATFORM_IS(ANDROID)
     // Default to the IR backend on Android.
     deviceToggles->Default(Toggle::UseTintIR, true);
@@ -28,7 +28,9 @@
 #include "dawn/native/vulkan/PipelineCacheVk.h"
 
 #include <memory>
+#include <string_view>
 
+#include "dawn/native/AsyncTask.h"
 #include "dawn/native/Device.h"
 #include "dawn/native/Error.h"
 #include "dawn/native/vulkan/DeviceVk.h"
@@ -39,13 +41,27 @@ namespace dawn::native::vulkan {
 
 // static
 Ref<PipelineCache> PipelineCache::Create(DeviceBase* device, const CacheKey& key) {
-    Ref<PipelineCache> cache = AcquireRef(new PipelineCache(device, key));
+    Ref<PipelineCache> cache = AcquireRef(new PipelineCache(device, key, false));
     cache->Initialize();
     return cache;
 }
 
-PipelineCache::PipelineCache(DeviceBase* device, const CacheKey& key)
-    : PipelineCacheBase(device->GetBlobCache(), key), mDevice(device) {}
+// static
+Ref<PipelineCache> PipelineCache::CreateMonolithic(DeviceBase* device) {
+    // The device cache key already contains the adapter properties, the enabled features and
+    // the toggles, so the driver blob is only reused on compatible devices.
+    CacheKey key = device->GetCacheKey();
+    StreamIn(&key, std::string_view("VkMonolithicPipelineCache"));
+
+    Ref<PipelineCache> cache = AcquireRef(new PipelineCache(device, key, true));
+    cache->Initialize();
+    return cache;
+}
+
+PipelineCache::PipelineCache(DeviceBase* device, const CacheKey& key, bool isMonolithic)
+    : PipelineCacheBase(device->GetBlobCache(), key),
+      mDevice(device),
+      mIsMonolithic(isMonolithic) {}
 
 PipelineCache::~PipelineCache() {
     if (mHandle == VK_NULL_HANDLE) {
@@ -64,6 +80,40 @@ VkPipelineCache PipelineCache::GetHandle() const {
     return mHandle;
 }
 
+MaybeError PipelineCache::DidCreatePipeline() {
+    if (!mIsMonolithic) {
+        return FlushIfNeeded();
+    }
+    mDirty.store(true, std::memory_order_release);
+    return {};
+}
+
+void PipelineCache::ScheduleFlushIfDirty(AsyncTaskManager* taskManager) {
+    DAWN_ASSERT(mIsMonolithic);
+    if (!mDirty.load(std::memory_order_acquire) || mFlushInFlight.exchange(true)) {
+        return;
+    }
+
+    // Clear the dirty bit before serializing so that pipelines created during the flush cause
+    // another one later. VkPipelineCache is internally synchronized so pipelines can keep being
+    // created with it while the data is retrieved.
+    mDirty.store(false, std::memory_order_release);
+    taskManager->PostTask([cache = Ref<PipelineCache>(this)] {
+        // Failing to serialize the cache only loses the warm start, so errors are ignored.
+        IgnoreErrors(cache->Flush());
+        cache->mFlushInFlight.store(false, std::memory_order_release);
+    });
+}
+
+void PipelineCache::FlushIfDirty() {
+    DAWN_ASSERT(mIsMonolithic);
+    DAWN_ASSERT(!mFlushInFlight.load(std::memory_order_acquire));
+    if (!mDirty.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    IgnoreErrors(Flush());
+}
+
 MaybeError PipelineCache::SerializeToBlobImpl(Blob* blob) {
     if (mHandle == VK_NULL_HANDLE) {
         // Pipeline cache isn't created successfully
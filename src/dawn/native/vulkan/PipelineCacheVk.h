@@ -28,6 +28,8 @@
 #ifndef SRC_DAWN_NATIVE_VULKAN_PIPELINECACHEVK_H_
 #define SRC_DAWN_NATIVE_VULKAN_PIPELINECACHEVK_H_
 
+#include <atomic>
+
 #include "dawn/native/ObjectBase.h"
 #include "dawn/native/PipelineCache.h"
 #include "partition_alloc/pointers/raw_ptr.h"
@@ -35,20 +37,35 @@
 #include "dawn/common/vulkan_platform.h"
 
 namespace dawn::native {
+class AsyncTaskManager;
 class DeviceBase;
-}
+}  // namespace dawn::native
 
 namespace dawn::native::vulkan {
 
 class PipelineCache final : public PipelineCacheBase {
   public:
     static Ref<PipelineCache> Create(DeviceBase* device, const CacheKey& key);
+    // Creates the cache shared by all the pipelines of the device. It is stored in the blob cache
+    // under a single device-wide key and flushed on a worker thread by ScheduleFlushIfDirty().
+    static Ref<PipelineCache> CreateMonolithic(DeviceBase* device);
 
     DeviceBase* GetDevice() const;
     VkPipelineCache GetHandle() const;
 
+    // Called after a pipeline was created with this cache. Per-pipeline caches are flushed
+    // immediately if the initial load missed, while the monolithic cache is only marked dirty.
+    MaybeError DidCreatePipeline();
+
+    // Posts a task that serializes the monolithic cache to the blob cache if pipelines were
+    // added since the last flush and no flush is already in flight.
+    void ScheduleFlushIfDirty(AsyncTaskManager* taskManager);
+    // Serializes the monolithic cache on this thread if pipelines were added since the last
+    // flush. Must only be called when no flush is in flight, e.g. when destroying the device.
+    void FlushIfDirty();
+
   private:
-    explicit PipelineCache(DeviceBase* device, const CacheKey& key);
+    PipelineCache(DeviceBase* device, const CacheKey& key, bool isMonolithic);
     ~PipelineCache() override;
 
     void Initialize();
@@ -56,6 +73,10 @@ class PipelineCache final : public PipelineCacheBase {
 
     raw_ptr<DeviceBase> mDevice;
     VkPipelineCache mHandle = VK_NULL_HANDLE;
+
+    const bool mIsMonolithic;
+    std::atomic<bool> mDirty = false;
+    std::atomic<bool> mFlushInFlight = false;
 };
 
 }  // namespace dawn::native::vulkan
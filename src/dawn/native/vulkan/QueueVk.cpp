@@ -32,6 +32,7 @@
 #include "dawn/native/CommandValidation.h"
 #include "dawn/native/Commands.h"
 #include "dawn/native/DynamicUploader.h"
+#include "dawn/native/vulkan/BufferVk.h"
 #include "dawn/native/vulkan/CommandBufferVk.h"
 #include "dawn/native/vulkan/CommandRecordingContext.h"
 #include "dawn/native/vulkan/DeviceVk.h"
@@ -106,6 +107,25 @@ MaybeError Queue::Initialize() {
     Device* device = ToBackend(GetDevice());
     device->fn.GetDeviceQueue(device->GetVkDevice(), mQueueFamily, 0, &mQueue);
 
+    // The timeline semaphore feature is only enabled when Toggle::VulkanUseTimelineSemaphore is.
+    if (device->GetDeviceInfo().timelineSemaphoreFeatures.timelineSemaphore == VK_TRUE) {
+        VkSemaphoreTypeCreateInfo typeCreateInfo;
+        typeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        typeCreateInfo.pNext = nullptr;
+        typeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeCreateInfo.initialValue = static_cast<uint64_t>(GetCompletedCommandSerial());
+        mLastTimelineSignalValue = typeCreateInfo.initialValue;
+
+        VkSemaphoreCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        createInfo.pNext = &typeCreateInfo;
+        createInfo.flags = 0;
+
+        DAWN_TRY(CheckVkSuccess(device->fn.CreateSemaphore(device->GetVkDevice(), &createInfo,
+                                                           nullptr, &*mTimelineSemaphore),
+                                "vkCreateSemaphore"));
+    }
+
     DAWN_TRY(PrepareRecordingContext());
 
     SetLabelImpl();
@@ -125,6 +145,36 @@ MaybeError Queue::SubmitImpl(uint32_t commandCount, CommandBufferBase* const* co
     return {};
 }
 
+MaybeError Queue::WriteBufferImpl(BufferBase* buffer,
+                                  uint64_t bufferOffset,
+                                  const void* data,
+                                  size_t size) {
+    if (size == 0) {
+        // skip the empty write
+        return {};
+    }
+
+    Buffer* bufferVk = ToBackend(buffer);
+    bool wroteDirectly = false;
+    DAWN_TRY_ASSIGN(wroteDirectly, bufferVk->TryWriteDirectly(bufferOffset, data, size));
+    if (wroteDirectly) {
+        return {};
+    }
+
+    // Buffers the GPU is still using, like uniforms updated every frame, stay on the staging path:
+    // the barrier to the host stage and the one back before their next use would be paid on every
+    // write, while the following writes couldn't be direct anyway.
+    bool wasIdle = !bufferVk->IsUsedInPendingOrInFlightCommands();
+    DAWN_TRY(QueueBase::WriteBufferImpl(buffer, bufferOffset, data, size));
+
+    if (wasIdle) {
+        // Make the GPU writes, including the staging copy above, visible to the host so that the
+        // following writes can be done directly once the pending commands are complete.
+        bufferVk->TransitionForDirectWrites(GetPendingRecordingContext());
+    }
+    return {};
+}
+
 void Queue::SetLabelImpl() {
     Device* device = ToBackend(GetDevice());
     // TODO(crbug.com/dawn/1344): When we start using multiple queues this needs to be adjusted
@@ -142,6 +192,23 @@ VkQueue Queue::GetVkQueue() const {
 
 ResultOrError<ExecutionSerial> Queue::CheckAndUpdateCompletedSerials() {
     Device* device = ToBackend(GetDevice());
+    if (UsesTimelineSemaphore()) {
+        uint64_t value = 0;
+        DAWN_TRY(CheckVkSuccess(
+            INJECT_ERROR_OR_RUN(device->fn.GetSemaphoreCounterValue(device->GetVkDevice(),
+                                                                    mTimelineSemaphore, &value),
+                                VK_ERROR_DEVICE_LOST),
+            "vkGetSemaphoreCounterValue"));
+
+        // The serials might have been bumped without a submit, for example after a device loss.
+        // Return 0 in that case, which means that no new serial completed.
+        ExecutionSerial completedSerial(value);
+        if (completedSerial <= GetCompletedCommandSerial()) {
+            return ExecutionSerial(0);
+        }
+        return completedSerial;
+    }
+
     return mFencesInFlight.Use([&](auto fencesInFlight) -> ResultOrError<ExecutionSerial> {
         ExecutionSerial fenceSerial(0);
         while (!fencesInFlight->empty()) {
@@ -176,12 +243,16 @@ void Queue::ForceEventualFlushOfCommands() {
 
 MaybeError Queue::WaitForIdleForDestruction() {
     // Immediately tag the recording context as unused so we don't try to submit it in Tick.
-    // Move the mRecordingContext.used to mUnusedCommands so it can be cleaned up in
-    // ShutDownImpl
+    // Its commands were never submitted so they can be destroyed immediately. They aren't moved
+    // to mUnusedCommands since that list only contains pools that were reset.
     if (mRecordingContext.used) {
-        CommandPoolAndBuffer commands = {mRecordingContext.commandPool,
-                                         mRecordingContext.commandBuffer};
-        mUnusedCommands.push_back(commands);
+        Device* device = ToBackend(GetDevice());
+        DestroyCommandPoolAndBuffer(
+            device->fn, device->GetVkDevice(),
+            {mRecordingContext.commandPool, mRecordingContext.commandBuffer});
+        for (const CommandPoolAndBuffer& commands : mRecordingContext.secondaryCommands) {
+            DestroyCommandPoolAndBuffer(device->fn, device->GetVkDevice(), commands);
+        }
         mRecordingContext = CommandRecordingContext();
     }
 
@@ -194,6 +265,35 @@ MaybeError Queue::WaitForIdleForDestruction() {
     // (so they are as good as waited on) or success.
     DAWN_UNUSED(waitIdleResult);
 
+    if (UsesTimelineSemaphore()) {
+        // Make sure all the submits are complete by explicitly waiting on the last one.
+        uint64_t lastSubmittedValue = mLastTimelineSignalValue;
+
+        VkSemaphoreWaitInfo waitInfo;
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.pNext = nullptr;
+        waitInfo.flags = 0;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &*mTimelineSemaphore;
+        waitInfo.pValues = &lastSubmittedValue;
+
+        VkResult result = VkResult::WrapUnsafe(VK_TIMEOUT);
+        do {
+            // See the comment in the fence path below for the handling of Disconnected.
+            if (GetDevice()->GetState() == Device::State::Disconnected) {
+                result = VkResult::WrapUnsafe(
+                    device->fn.WaitSemaphores(vkDevice, &waitInfo, UINT64_MAX));
+                continue;
+            }
+
+            result = VkResult::WrapUnsafe(
+                INJECT_ERROR_OR_RUN(device->fn.WaitSemaphores(vkDevice, &waitInfo, UINT64_MAX),
+                                    VK_ERROR_DEVICE_LOST));
+        } while (result == VK_TIMEOUT);
+        // Ignore errors for the same reasons as vkWaitForFences below.
+        return {};
+    }
+
     // Make sure all fences are complete by explicitly waiting on them all
     mFencesInFlight.Use([&](auto fencesInFlight) {
         while (!fencesInFlight->empty()) {
@@ -257,6 +357,7 @@ MaybeError Queue::PrepareRecordingContext() {
 // on some hardware.
 MaybeError Queue::SplitRecordingContext(CommandRecordingContext* recordingContext) {
     DAWN_ASSERT(recordingContext->used);
+    DAWN_ASSERT(recordingContext->pendingBarriers.Empty());
     Device* device = ToBackend(GetDevice());
 
     DAWN_TRY(CheckVkSuccess(device->fn.EndCommandBuffer(recordingContext->commandBuffer),
@@ -274,20 +375,19 @@ MaybeError Queue::SplitRecordingContext(CommandRecordingContext* recordingContex
     return {};
 }
 
-ResultOrError<CommandPoolAndBuffer> Queue::BeginVkCommandBuffer() {
+ResultOrError<CommandPoolAndBuffer> Queue::GetUnusedCommands(
+    std::vector<CommandPoolAndBuffer>* unusedCommands,
+    VkCommandBufferLevel level) {
     Device* device = ToBackend(GetDevice());
     VkDevice vkDevice = device->GetVkDevice();
 
     CommandPoolAndBuffer commands;
 
-    // First try to recycle unused command pools.
-    if (!mUnusedCommands.empty()) {
-        commands = mUnusedCommands.back();
-        mUnusedCommands.pop_back();
-        DAWN_TRY_WITH_CLEANUP(
-            CheckVkSuccess(device->fn.ResetCommandPool(vkDevice, commands.pool, 0),
-                           "vkResetCommandPool"),
-            { DestroyCommandPoolAndBuffer(device->fn, vkDevice, commands); });
+    // First try to recycle unused command pools. They were already reset when their serial
+    // completed.
+    if (!unusedCommands->empty()) {
+        commands = unusedCommands->back();
+        unusedCommands->pop_back();
     } else {
         // Create a new command pool for our commands and allocate the command buffer.
         VkCommandPoolCreateInfo createInfo;
@@ -304,7 +404,7 @@ ResultOrError<CommandPoolAndBuffer> Queue::BeginVkCommandBuffer() {
         allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
         allocateInfo.pNext = nullptr;
         allocateInfo.commandPool = commands.pool;
-        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocateInfo.level = level;
         allocateInfo.commandBufferCount = 1;
 
         DAWN_TRY_WITH_CLEANUP(CheckVkSuccess(device->fn.AllocateCommandBuffers(
@@ -313,6 +413,25 @@ ResultOrError<CommandPoolAndBuffer> Queue::BeginVkCommandBuffer() {
                               { DestroyCommandPoolAndBuffer(device->fn, vkDevice, commands); });
     }
 
+    return commands;
+}
+
+ResultOrError<VkCommandBuffer> Queue::GetSecondaryCommandBuffer(
+    CommandRecordingContext* recordingContext) {
+    CommandPoolAndBuffer commands;
+    DAWN_TRY_ASSIGN(commands, GetUnusedCommands(&mUnusedSecondaryCommands,
+                                                VK_COMMAND_BUFFER_LEVEL_SECONDARY));
+    recordingContext->secondaryCommands.push_back(commands);
+    return commands.commandBuffer;
+}
+
+ResultOrError<CommandPoolAndBuffer> Queue::BeginVkCommandBuffer() {
+    Device* device = ToBackend(GetDevice());
+    VkDevice vkDevice = device->GetVkDevice();
+
+    CommandPoolAndBuffer commands;
+    DAWN_TRY_ASSIGN(commands, GetUnusedCommands(&mUnusedCommands, VK_COMMAND_BUFFER_LEVEL_PRIMARY));
+
     // Start the recording of commands in the command buffer.
     VkCommandBufferBeginInfo beginInfo;
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -329,10 +448,36 @@ ResultOrError<CommandPoolAndBuffer> Queue::BeginVkCommandBuffer() {
 }
 
 void Queue::RecycleCompletedCommands(ExecutionSerial completedSerial) {
-    for (auto& commands : mCommandsInFlight.IterateUpTo(completedSerial)) {
-        mUnusedCommands.push_back(commands);
+    RecycleCompletedCommands(&mCommandsInFlight, &mUnusedCommands, completedSerial);
+    RecycleCompletedCommands(&mSecondaryCommandsInFlight, &mUnusedSecondaryCommands,
+                             completedSerial);
+}
+
+void Queue::RecycleCompletedCommands(SerialQueue<ExecutionSerial, CommandPoolAndBuffer>* inFlight,
+                                     std::vector<CommandPoolAndBuffer>* unusedCommands,
+                                     ExecutionSerial completedSerial) {
+    Device* device = ToBackend(GetDevice());
+    VkDevice vkDevice = device->GetVkDevice();
+
+    // Reset all the pools that completed in one go, while the queue is idle from the CPU's point
+    // of view, instead of paying for it when starting the next recording context.
+    for (const CommandPoolAndBuffer& commands : inFlight->IterateUpTo(completedSerial)) {
+        if (unusedCommands->size() >= kMaxUnusedCommandPools) {
+            DestroyCommandPoolAndBuffer(device->fn, vkDevice, commands);
+            continue;
+        }
+
+        // vkResetCommandPool can only fail with OOM. Drop the pool in that case, a new one will
+        // be created when needed.
+        VkResult result =
+            VkResult::WrapUnsafe(device->fn.ResetCommandPool(vkDevice, commands.pool, 0));
+        if (result != VK_SUCCESS) {
+            DestroyCommandPoolAndBuffer(device->fn, vkDevice, commands);
+            continue;
+        }
+        unusedCommands->push_back(commands);
     }
-    mCommandsInFlight.ClearUpTo(completedSerial);
+    inFlight->ClearUpTo(completedSerial);
 }
 
 MaybeError Queue::SubmitPendingCommands() {
@@ -391,6 +536,15 @@ MaybeError Queue::SubmitPendingCommands() {
         }
     }
 
+    DAWN_ASSERT(mRecordingContext.pendingBarriers.Empty());
+    mLastSubmitPipelineBarrierCount =
+        mRecordingContext.pendingBarriers.GetRecordedPipelineBarrierCount();
+    mLastSubmitMemoryBarrierCount =
+        mRecordingContext.pendingBarriers.GetRecordedMemoryBarrierCount();
+    TRACE_COUNTER_ID2(device->GetPlatform(), General, "vulkan::Queue::Barriers", this,
+                      "pipelineBarriers", mLastSubmitPipelineBarrierCount, "memoryBarriers",
+                      mLastSubmitMemoryBarrierCount);
+
     DAWN_TRY(CheckVkSuccess(device->fn.EndCommandBuffer(mRecordingContext.commandBuffer),
                             "vkEndCommandBuffer"));
 
@@ -401,25 +555,47 @@ MaybeError Queue::SubmitPendingCommands() {
         mRecordingContext.signalSemaphores.push_back(externalTextureSemaphore.Get());
     }
 
+    // With a timeline semaphore, signal it with the serial of this submit in addition to the
+    // other semaphores. The values of binary semaphores are ignored.
+    std::vector<VkSemaphore> signalSemaphores = mRecordingContext.signalSemaphores;
+    std::vector<uint64_t> signalValues;
+    VkTimelineSemaphoreSubmitInfo timelineSubmitInfo;
+    if (UsesTimelineSemaphore()) {
+        signalSemaphores.push_back(mTimelineSemaphore);
+        signalValues.resize(signalSemaphores.size(), 0);
+        signalValues.back() = static_cast<uint64_t>(GetLastSubmittedCommandSerial()) + 1;
+
+        timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineSubmitInfo.pNext = nullptr;
+        timelineSubmitInfo.waitSemaphoreValueCount = 0;
+        timelineSubmitInfo.pWaitSemaphoreValues = nullptr;
+        timelineSubmitInfo.signalSemaphoreValueCount = signalValues.size();
+        timelineSubmitInfo.pSignalSemaphoreValues = signalValues.data();
+    }
+
     VkSubmitInfo submitInfo;
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.pNext = nullptr;
+    submitInfo.pNext = UsesTimelineSemaphore() ? &timelineSubmitInfo : nullptr;
     submitInfo.waitSemaphoreCount = static_cast<uint32_t>(mRecordingContext.waitSemaphores.size());
     submitInfo.pWaitSemaphores = AsVkArray(mRecordingContext.waitSemaphores.data());
     submitInfo.pWaitDstStageMask = dstStageMasks.data();
     submitInfo.commandBufferCount = mRecordingContext.commandBufferList.size();
     submitInfo.pCommandBuffers = mRecordingContext.commandBufferList.data();
-    submitInfo.signalSemaphoreCount = mRecordingContext.signalSemaphores.size();
-    submitInfo.pSignalSemaphores = AsVkArray(mRecordingContext.signalSemaphores.data());
+    submitInfo.signalSemaphoreCount = signalSemaphores.size();
+    submitInfo.pSignalSemaphores = AsVkArray(signalSemaphores.data());
 
     VkFence fence = VK_NULL_HANDLE;
-    DAWN_TRY_ASSIGN(fence, GetUnusedFence());
+    if (!UsesTimelineSemaphore()) {
+        DAWN_TRY_ASSIGN(fence, GetUnusedFence());
+    }
     DAWN_TRY_WITH_CLEANUP(
         CheckVkSuccess(device->fn.QueueSubmit(mQueue, 1, &submitInfo, fence), "vkQueueSubmit"), {
             // If submitting to the queue fails, move the fence back into the unused fence
             // list, as if it were never acquired. Not doing so would leak the fence since
             // it would be neither in the unused list nor in the in-flight list.
-            mUnusedFences.push_back(fence);
+            if (fence != VK_NULL_HANDLE) {
+                mUnusedFences.push_back(fence);
+            }
         });
 
     // Enqueue the semaphores before incrementing the serial, so that they can be deleted as
@@ -429,13 +605,20 @@ MaybeError Queue::SubmitPendingCommands() {
     }
     IncrementLastSubmittedCommandSerial();
     ExecutionSerial lastSubmittedSerial = GetLastSubmittedCommandSerial();
-    mFencesInFlight->emplace_back(fence, lastSubmittedSerial);
+    if (UsesTimelineSemaphore()) {
+        mLastTimelineSignalValue = static_cast<uint64_t>(lastSubmittedSerial);
+    } else {
+        mFencesInFlight->emplace_back(fence, lastSubmittedSerial);
+    }
 
     for (size_t i = 0; i < mRecordingContext.commandBufferList.size(); ++i) {
         CommandPoolAndBuffer submittedCommands = {mRecordingContext.commandPoolList[i],
                                                   mRecordingContext.commandBufferList[i]};
         mCommandsInFlight.Enqueue(submittedCommands, lastSubmittedSerial);
     }
+    for (const CommandPoolAndBuffer& secondaryCommands : mRecordingContext.secondaryCommands) {
+        mSecondaryCommandsInFlight.Enqueue(secondaryCommands, lastSubmittedSerial);
+    }
 
     auto externalTextureSemaphoreIter = externalTextureSemaphores.begin();
     for (auto* texture : mRecordingContext.externalTexturesForEagerTransition) {
@@ -457,6 +640,29 @@ MaybeError Queue::SubmitPendingCommands() {
     return {};
 }
 
+bool Queue::UsesTimelineSemaphore() const {
+    return mTimelineSemaphore != VK_NULL_HANDLE;
+}
+
+std::vector<VkCommandPool> Queue::GetUnusedCommandPoolsForTesting(
+    VkCommandBufferLevel level) const {
+    const std::vector<CommandPoolAndBuffer>& unusedCommands =
+        level == VK_COMMAND_BUFFER_LEVEL_PRIMARY ? mUnusedCommands : mUnusedSecondaryCommands;
+    std::vector<VkCommandPool> pools;
+    for (const CommandPoolAndBuffer& commands : unusedCommands) {
+        pools.push_back(commands.pool);
+    }
+    return pools;
+}
+
+uint64_t Queue::GetLastSubmitPipelineBarrierCountForTesting() const {
+    return mLastSubmitPipelineBarrierCount;
+}
+
+uint64_t Queue::GetLastSubmitMemoryBarrierCountForTesting() const {
+    return mLastSubmitMemoryBarrierCount;
+}
+
 ResultOrError<VkFence> Queue::GetUnusedFence() {
     Device* device = ToBackend(GetDevice());
     VkDevice vkDevice = device->GetVkDevice();
@@ -491,6 +697,10 @@ void Queue::DestroyImpl() {
         DestroyCommandPoolAndBuffer(
             device->fn, vkDevice, {mRecordingContext.commandPool, mRecordingContext.commandBuffer});
     }
+    for (const CommandPoolAndBuffer& commands : mRecordingContext.secondaryCommands) {
+        DestroyCommandPoolAndBuffer(device->fn, vkDevice, commands);
+    }
+    mRecordingContext.secondaryCommands.clear();
 
     for (VkSemaphore semaphore : mRecordingContext.waitSemaphores) {
         device->fn.DestroySemaphore(vkDevice, semaphore, nullptr);
@@ -499,14 +709,22 @@ void Queue::DestroyImpl() {
     mRecordingContext.signalSemaphores.clear();
 
     // Some commands might still be marked as in-flight if we shut down because of a device
-    // loss. Recycle them as unused so that we free them below.
-    RecycleCompletedCommands(kMaxExecutionSerial);
-    DAWN_ASSERT(mCommandsInFlight.Empty());
+    // loss. Free them without resetting them since they will never be reused.
+    for (auto* inFlight : {&mCommandsInFlight, &mSecondaryCommandsInFlight}) {
+        for (const CommandPoolAndBuffer& commands : inFlight->IterateAll()) {
+            DestroyCommandPoolAndBuffer(device->fn, vkDevice, commands);
+        }
+        inFlight->Clear();
+    }
 
     for (const CommandPoolAndBuffer& commands : mUnusedCommands) {
         DestroyCommandPoolAndBuffer(device->fn, vkDevice, commands);
     }
     mUnusedCommands.clear();
+    for (const CommandPoolAndBuffer& commands : mUnusedSecondaryCommands) {
+        DestroyCommandPoolAndBuffer(device->fn, vkDevice, commands);
+    }
+    mUnusedSecondaryCommands.clear();
 
     // Some fences might still be marked as in-flight if we shut down because of a device loss.
     // Delete them since at this point all commands are complete.
@@ -522,12 +740,39 @@ void Queue::DestroyImpl() {
     }
     mUnusedFences.clear();
 
+    if (mTimelineSemaphore != VK_NULL_HANDLE) {
+        device->fn.DestroySemaphore(vkDevice, mTimelineSemaphore, nullptr);
+        mTimelineSemaphore = VK_NULL_HANDLE;
+    }
+
     QueueBase::DestroyImpl();
 }
 
 ResultOrError<bool> Queue::WaitForQueueSerial(ExecutionSerial serial, Nanoseconds timeout) {
     Device* device = ToBackend(GetDevice());
     VkDevice vkDevice = device->GetVkDevice();
+
+    if (UsesTimelineSemaphore()) {
+        DAWN_ASSERT(serial <= GetLastSubmittedCommandSerial());
+        uint64_t value = static_cast<uint64_t>(serial);
+
+        VkSemaphoreWaitInfo waitInfo;
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.pNext = nullptr;
+        waitInfo.flags = 0;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &*mTimelineSemaphore;
+        waitInfo.pValues = &value;
+
+        VkResult waitResult = VkResult::WrapUnsafe(INJECT_ERROR_OR_RUN(
+            device->fn.WaitSemaphores(vkDevice, &waitInfo, static_cast<uint64_t>(timeout)),
+            VK_ERROR_DEVICE_LOST));
+        if (waitResult == VK_TIMEOUT) {
+            return false;
+        }
+        DAWN_TRY(CheckVkSuccess(::VkResult(waitResult), "vkWaitSemaphores"));
+        return true;
+    }
     VkResult waitResult = mFencesInFlight.Use([&](auto fencesInFlight) {
         // Search from for the first fence >= serial.
         VkFence waitFence = VK_NULL_HANDLE;
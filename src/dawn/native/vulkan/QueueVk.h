@@ -52,12 +52,33 @@ class Queue final : public QueueBase {
 
     CommandRecordingContext* GetPendingRecordingContext(SubmitMode submitMode = SubmitMode::Normal);
     MaybeError SplitRecordingContext(CommandRecordingContext* recordingContext);
+    // Returns a secondary command buffer, not yet begun, that is recycled once the commands of
+    // the recording context complete.
+    ResultOrError<VkCommandBuffer> GetSecondaryCommandBuffer(
+        CommandRecordingContext* recordingContext);
     MaybeError SubmitPendingCommands();
 
     void RecycleCompletedCommands(ExecutionSerial completedSerial);
 
     ResultOrError<bool> WaitForQueueSerial(ExecutionSerial serial, Nanoseconds timeout) override;
 
+    // Whether submits are tracked with a timeline semaphore instead of a fence per submit.
+    bool UsesTimelineSemaphore() const;
+
+    // The maximum number of reset command pools kept for reuse per command buffer level. Pools
+    // completing past that count are destroyed so that a burst of submits doesn't keep its
+    // memory alive forever.
+    static constexpr size_t kMaxUnusedCommandPools = 32;
+
+    // Returns the reset command pools waiting to be reused for command buffers of |level|, the
+    // next one to be reused last.
+    std::vector<VkCommandPool> GetUnusedCommandPoolsForTesting(VkCommandBufferLevel level) const;
+
+    // Returns the number of vkCmdPipelineBarrier recorded in the last submit, and the number of
+    // memory barriers they contain.
+    uint64_t GetLastSubmitPipelineBarrierCountForTesting() const;
+    uint64_t GetLastSubmitMemoryBarrierCountForTesting() const;
+
   private:
     Queue(Device* device, const QueueDescriptor* descriptor, uint32_t family);
     ~Queue() override;
@@ -66,6 +87,10 @@ class Queue final : public QueueBase {
     MaybeError Initialize();
 
     MaybeError SubmitImpl(uint32_t commandCount, CommandBufferBase* const* commands) override;
+    MaybeError WriteBufferImpl(BufferBase* buffer,
+                               uint64_t bufferOffset,
+                               const void* data,
+                               size_t size) override;
     bool HasPendingCommands() const override;
     ResultOrError<ExecutionSerial> CheckAndUpdateCompletedSerials() override;
     void ForceEventualFlushOfCommands() override;
@@ -79,20 +104,38 @@ class Queue final : public QueueBase {
 
     // We track which operations are in flight on the GPU with an increasing serial.
     // This works only because we have a single queue. Each submit to a queue is associated
-    // to a serial and a fence, such that when the fence is "ready" we know the operations
-    // have finished.
+    // to a serial. When timeline semaphores are supported, each submit signals
+    // mTimelineSemaphore with its serial so the completed serial is the semaphore's value.
+    // Otherwise each submit is associated to a fence, such that when the fence is "ready" we
+    // know the operations have finished.
+    VkSemaphore mTimelineSemaphore = VK_NULL_HANDLE;
+    // The last value actually signaled by a submit. Serials can also be bumped without a submit.
+    uint64_t mLastTimelineSignalValue = 0;
     MutexProtected<std::deque<std::pair<VkFence, ExecutionSerial>>> mFencesInFlight;
     // Fences in the unused list aren't reset yet.
     std::vector<VkFence> mUnusedFences;
 
     MaybeError PrepareRecordingContext();
     ResultOrError<CommandPoolAndBuffer> BeginVkCommandBuffer();
+    ResultOrError<CommandPoolAndBuffer> GetUnusedCommands(
+        std::vector<CommandPoolAndBuffer>* unusedCommands,
+        VkCommandBufferLevel level);
+    void RecycleCompletedCommands(SerialQueue<ExecutionSerial, CommandPoolAndBuffer>* inFlight,
+                                  std::vector<CommandPoolAndBuffer>* unusedCommands,
+                                  ExecutionSerial completedSerial);
 
     SerialQueue<ExecutionSerial, CommandPoolAndBuffer> mCommandsInFlight;
-    // Command pools in the unused list haven't been reset yet.
+    // Command pools in the unused list are reset in batch when their serial completes, so that
+    // acquiring one for a new recording context is cheap.
     std::vector<CommandPoolAndBuffer> mUnusedCommands;
+    // Same as above but for the pools of secondary command buffers.
+    SerialQueue<ExecutionSerial, CommandPoolAndBuffer> mSecondaryCommandsInFlight;
+    std::vector<CommandPoolAndBuffer> mUnusedSecondaryCommands;
     // There is always a valid recording context stored in mRecordingContext
     CommandRecordingContext mRecordingContext;
+    // The barrier statistics of the recording context of the last submit.
+    uint64_t mLastSubmitPipelineBarrierCount = 0;
+    uint64_t mLastSubmitMemoryBarrierCount = 0;
 
     uint32_t mQueueFamily = 0;
     VkQueue mQueue = VK_NULL_HANDLE;
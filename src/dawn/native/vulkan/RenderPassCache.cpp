@@ -32,8 +32,10 @@
 #include "dawn/common/HashUtils.h"
 #include "dawn/common/Range.h"
 #include "dawn/native/vulkan/DeviceVk.h"
+#include "dawn/native/vulkan/FencedDeleter.h"
 #include "dawn/native/vulkan/TextureVk.h"
 #include "dawn/native/vulkan/VulkanError.h"
+#include "dawn/platform/tracing/TraceEvent.h"
 
 namespace dawn::native::vulkan {
 
@@ -104,30 +106,67 @@ void RenderPassCacheQuery::SetSampleCount(uint32_t sampleCountIn) {
 
 // RenderPassCache
 
-RenderPassCache::RenderPassCache(Device* device) : mDevice(device) {}
+RenderPassCache::RenderPassCache(Device* device, size_t maxSize)
+    : mDevice(device), mMaxSize(maxSize) {}
 
 RenderPassCache::~RenderPassCache() {
     std::lock_guard<std::mutex> lock(mMutex);
-    for (auto [_, renderPass] : mCache) {
+    for (auto [_, renderPass] : mLRU) {
         mDevice->fn.DestroyRenderPass(mDevice->GetVkDevice(), renderPass, nullptr);
     }
 
     mCache.clear();
+    mLRU.clear();
 }
 
 ResultOrError<VkRenderPass> RenderPassCache::GetRenderPass(const RenderPassCacheQuery& query) {
     std::lock_guard<std::mutex> lock(mMutex);
     auto it = mCache.find(query);
     if (it != mCache.end()) {
-        return VkRenderPass(it->second);
+        mStats.hits++;
+        TraceStats();
+        // Move the entry to the front as it is now the most recently used.
+        mLRU.splice(mLRU.begin(), mLRU, it->second);
+        return VkRenderPass(it->second->second);
     }
 
+    mStats.misses++;
+    TraceStats();
     VkRenderPass renderPass;
     DAWN_TRY_ASSIGN(renderPass, CreateRenderPassForQuery(query));
-    mCache.emplace(query, renderPass);
+
+    if (IsBounded() && mLRU.size() >= mMaxSize) {
+        // Evicted render passes are only safe to delete when they can't be in use on another
+        // thread, see the comment on the class.
+        DAWN_ASSERT(mDevice->IsLockedByCurrentThreadIfNeeded());
+        auto& [evictedQuery, evictedRenderPass] = mLRU.back();
+        mDevice->GetFencedDeleter()->DeleteWhenUnused(evictedRenderPass);
+        mCache.erase(evictedQuery);
+        mLRU.pop_back();
+        mStats.evictions++;
+    }
+
+    mLRU.emplace_front(query, renderPass);
+    mCache.emplace(query, mLRU.begin());
     return renderPass;
 }
 
+bool RenderPassCache::IsBounded() const {
+    return mMaxSize != kUnbounded;
+}
+
+void RenderPassCache::TraceStats() {
+    TRACE_COUNTER_ID2(mDevice->GetPlatform(), General, "vulkan::RenderPassCache", this, "hits",
+                      mStats.hits, "misses", mStats.misses);
+}
+
+RenderPassCache::Stats RenderPassCache::GetStats() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    Stats stats = mStats;
+    stats.size = mLRU.size();
+    return stats;
+}
+
 ResultOrError<VkRenderPass> RenderPassCache::CreateRenderPassForQuery(
     const RenderPassCacheQuery& query) const {
     // The Vulkan subpasses want to know the layout of the attachments with VkAttachmentRef.
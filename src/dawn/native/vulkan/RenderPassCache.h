@@ -30,7 +30,9 @@
 
 #include <array>
 #include <bitset>
+#include <list>
 #include <mutex>
+#include <utility>
 
 #include "absl/container/flat_hash_map.h"
 #include "dawn/common/Constants.h"
@@ -89,30 +91,64 @@ struct RenderPassCacheQuery {
 // when creating render pass and framebuffer so that we can always make sure the order of
 // attachments in the rendering pipeline matches the one of the framebuffer.
 // All the operations on RenderPassCache are guaranteed to be thread-safe.
-// TODO(cwallez@chromium.org): Make it an LRU cache somehow?
+//
+// The cache is unbounded by default. When created with a maximum size, it evicts the least
+// recently used VkRenderPass once it is full. Evicted render passes are destroyed by the
+// FencedDeleter once the commands recorded up to now are complete, as they may still be used by
+// pending command buffers. This is only safe for the VkRenderPasses used to record commands,
+// which happens with the device locked: pipelines can be created on worker threads and might
+// still be using a VkRenderPass evicted by another thread, so when the cache is bounded they
+// must use CreateRenderPassForQuery instead of GetRenderPass.
 class RenderPassCache {
   public:
-    explicit RenderPassCache(Device* device);
+    static constexpr size_t kUnbounded = 0;
+    // The maximum size used when Toggle::VulkanBoundRenderPassCache is enabled.
+    static constexpr size_t kBoundedMaxSize = 256;
+
+    explicit RenderPassCache(Device* device, size_t maxSize = kUnbounded);
     ~RenderPassCache();
 
     ResultOrError<VkRenderPass> GetRenderPass(const RenderPassCacheQuery& query);
 
-  private:
-    // Does the actual VkRenderPass creation on a cache miss.
+    // Whether render passes returned by GetRenderPass may be evicted from the cache.
+    bool IsBounded() const;
+
+    // Creates a VkRenderPass for |query| that isn't added to the cache and is owned by the
+    // caller. This is used for render passes that must outlive evictions from the cache.
     ResultOrError<VkRenderPass> CreateRenderPassForQuery(const RenderPassCacheQuery& query) const;
 
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t size = 0;
+    };
+    Stats GetStats();
+
+  private:
     // Implements the functors necessary for to use RenderPassCacheQueries as absl::flat_hash_map
     // keys.
     struct CacheFuncs {
         size_t operator()(const RenderPassCacheQuery& query) const;
         bool operator()(const RenderPassCacheQuery& a, const RenderPassCacheQuery& b) const;
     };
-    using Cache = absl::flat_hash_map<RenderPassCacheQuery, VkRenderPass, CacheFuncs, CacheFuncs>;
+
+    // Reports the hits and misses together so that the hit rate can be read from traces.
+    void TraceStats();
+
+    // The entries are kept in a list ordered from the most to the least recently used one and
+    // the map points into it for the lookups.
+    using LRUList = std::list<std::pair<RenderPassCacheQuery, VkRenderPass>>;
+    using Cache =
+        absl::flat_hash_map<RenderPassCacheQuery, LRUList::iterator, CacheFuncs, CacheFuncs>;
 
     raw_ptr<Device> mDevice = nullptr;
+    const size_t mMaxSize;
 
     std::mutex mMutex;
+    LRUList mLRU;
     Cache mCache;
+    Stats mStats;
 };
 
 }  // namespace dawn::native::vulkan
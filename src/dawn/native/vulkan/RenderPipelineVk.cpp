@@ -547,7 +547,12 @@ MaybeError RenderPipeline::InitializeImpl() {
     // don't matter so set them all to LoadOp::Load / StoreOp::Store. Whether the render pass
     // has resolve target and whether depth/stencil attachment is read-only also don't matter,
     // so set them both to false.
+    // Pipelines may be created on worker threads without the device lock, so when the render
+    // pass cache is bounded a VkRenderPass it returns could be evicted and deleted while the
+    // pipeline is created. Use a VkRenderPass owned by the pipeline creation in that case, which
+    // is only needed until vkCreateGraphicsPipelines returns.
     VkRenderPass renderPass = VK_NULL_HANDLE;
+    bool ownsRenderPass = device->GetRenderPassCache()->IsBounded();
     {
         RenderPassCacheQuery query;
 
@@ -564,7 +569,12 @@ MaybeError RenderPipeline::InitializeImpl() {
         query.SetSampleCount(GetSampleCount());
 
         StreamIn(&mCacheKey, query);
-        DAWN_TRY_ASSIGN(renderPass, device->GetRenderPassCache()->GetRenderPass(query));
+        if (ownsRenderPass) {
+            DAWN_TRY_ASSIGN(renderPass,
+                            device->GetRenderPassCache()->CreateRenderPassForQuery(query));
+        } else {
+            DAWN_TRY_ASSIGN(renderPass, device->GetRenderPassCache()->GetRenderPass(query));
+        }
     }
 
     // The create info chains in a bunch of things created on the stack here or inside state
@@ -597,23 +607,24 @@ MaybeError RenderPipeline::InitializeImpl() {
     // Try to see if we have anything in the blob cache.
     platform::metrics::DawnHistogramTimer cacheTimer(GetDevice()->GetPlatform());
     Ref<PipelineCache> cache = ToBackend(GetDevice()->GetOrCreatePipelineCache(GetCacheKey()));
-    if (cache->CacheHit()) {
-        DAWN_TRY(CheckVkSuccess(
-            device->fn.CreateGraphicsPipelines(device->GetVkDevice(), cache->GetHandle(), 1,
-                                               &createInfo, nullptr, &*mHandle),
-            "CreateGraphicsPipelines"));
-        cacheTimer.RecordMicroseconds("Vulkan.CreateGraphicsPipelines.CacheHit");
-    } else {
+    bool cacheHit = cache->CacheHit();
+    if (!cacheHit) {
         cacheTimer.Reset();
-        DAWN_TRY(CheckVkSuccess(
-            device->fn.CreateGraphicsPipelines(device->GetVkDevice(), cache->GetHandle(), 1,
-                                               &createInfo, nullptr, &*mHandle),
-            "CreateGraphicsPipelines"));
-        cacheTimer.RecordMicroseconds("Vulkan.CreateGraphicsPipelines.CacheMiss");
     }
+    MaybeError createResult = CheckVkSuccess(
+        device->fn.CreateGraphicsPipelines(device->GetVkDevice(), cache->GetHandle(), 1,
+                                           &createInfo, nullptr, &*mHandle),
+        "CreateGraphicsPipelines");
+    if (ownsRenderPass) {
+        // The pipeline doesn't keep a reference to the VkRenderPass it was created with.
+        device->fn.DestroyRenderPass(device->GetVkDevice(), renderPass, nullptr);
+    }
+    DAWN_TRY(std::move(createResult));
+    cacheTimer.RecordMicroseconds(cacheHit ? "Vulkan.CreateGraphicsPipelines.CacheHit"
+                                           : "Vulkan.CreateGraphicsPipelines.CacheMiss");
 
-    // TODO(dawn:549): Flush is currently in the same thread, but perhaps deferrable.
-    DAWN_TRY(cache->FlushIfNeeded());
+    // The monolithic cache is flushed on a worker thread, see Device::TickImpl.
+    DAWN_TRY(cache->DidCreatePipeline());
 
     SetLabelImpl();
 
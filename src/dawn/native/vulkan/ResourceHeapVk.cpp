@@ -27,10 +27,13 @@
 
 #include "dawn/native/vulkan/ResourceHeapVk.h"
 
+#include "dawn/native/vulkan/DeviceVk.h"
+#include "dawn/native/vulkan/VulkanError.h"
+
 namespace dawn::native::vulkan {
 
-ResourceHeap::ResourceHeap(VkDeviceMemory memory, size_t memoryType)
-    : mMemory(memory), mMemoryType(memoryType) {}
+ResourceHeap::ResourceHeap(VkDeviceMemory memory, size_t memoryType, uint64_t size)
+    : mMemory(memory), mMemoryType(memoryType), mSize(size) {}
 
 VkDeviceMemory ResourceHeap::GetMemory() const {
     return mMemory;
@@ -40,4 +43,21 @@ size_t ResourceHeap::GetMemoryType() const {
     return mMemoryType;
 }
 
+uint64_t ResourceHeap::GetSize() const {
+    return mSize;
+}
+
+ResultOrError<uint8_t*> ResourceHeap::GetOrMapPointer(Device* device) {
+    if (mMappedPointer == nullptr) {
+        DAWN_ASSERT(device->GetDeviceInfo().memoryTypes[mMemoryType].propertyFlags &
+                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+        void* mappedPointer = nullptr;
+        DAWN_TRY(CheckVkSuccess(device->fn.MapMemory(device->GetVkDevice(), mMemory, 0, mSize, 0,
+                                                     &mappedPointer),
+                                "vkMapMemory"));
+        mMappedPointer = static_cast<uint8_t*>(mappedPointer);
+    }
+    return mMappedPointer;
+}
+
 }  // namespace dawn::native::vulkan
@@ -29,22 +29,33 @@
 #define SRC_DAWN_NATIVE_VULKAN_RESOURCEHEAPVK_H_
 
 #include "dawn/common/vulkan_platform.h"
+#include "dawn/native/Error.h"
 #include "dawn/native/ResourceHeap.h"
 
 namespace dawn::native::vulkan {
 
+class Device;
+
 // Wrapper for physical memory used with or without a resource object.
 class ResourceHeap : public ResourceHeapBase {
   public:
-    ResourceHeap(VkDeviceMemory memory, size_t memoryType);
+    ResourceHeap(VkDeviceMemory memory, size_t memoryType, uint64_t size);
     ~ResourceHeap() override = default;
 
     VkDeviceMemory GetMemory() const;
     size_t GetMemoryType() const;
+    uint64_t GetSize() const;
+
+    // Maps the whole memory the first time it is called and returns the pointer to its start.
+    // The mapping stays alive until the memory is freed. Only valid for host-visible memory that
+    // isn't mapped by its allocator already.
+    ResultOrError<uint8_t*> GetOrMapPointer(Device* device);
 
   private:
     VkDeviceMemory mMemory = VK_NULL_HANDLE;
+    uint8_t* mMappedPointer = nullptr;
     size_t mMemoryType = 0;
+    uint64_t mSize = 0;
 };
 
 }  // namespace dawn::native::vulkan
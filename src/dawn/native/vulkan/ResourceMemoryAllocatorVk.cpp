@@ -28,6 +28,7 @@
 #include "dawn/native/vulkan/ResourceMemoryAllocatorVk.h"
 
 #include <algorithm>
+#include <array>
 #include <utility>
 
 #include "dawn/common/Math.h"
@@ -38,6 +39,7 @@
 #include "dawn/native/vulkan/FencedDeleter.h"
 #include "dawn/native/vulkan/ResourceHeapVk.h"
 #include "dawn/native/vulkan/VulkanError.h"
+#include "dawn/platform/tracing/TraceEvent.h"
 #include "partition_alloc/pointers/raw_ptr.h"
 
 namespace dawn::native::vulkan {
@@ -49,9 +51,46 @@ namespace {
 // factors.
 constexpr uint64_t kMaxSizeForSubAllocation = 4ull * 1024ull * 1024ull;  // 4MiB
 
-// Have each bucket of the buddy system allocate at least some resource of the maximum
-// size
-constexpr uint64_t kBuddyHeapsSize = 2 * kMaxSizeForSubAllocation;
+// Resources are sub-allocated out of separate buddy systems depending on their size so that
+// small resources don't fragment the heaps used for larger ones, and so that the heaps stay
+// proportional to the resources they contain. A resource uses the first size class it fits in
+// and gets a dedicated VkDeviceMemory if it fits in none of them.
+//
+// Vulkan has no limit describing good sub-allocation sizes, so the size classes are fixed and only
+// adapted to the device through the size of the memory heaps they are used on.
+struct SizeClass {
+    // Largest resource that is sub-allocated in this size class.
+    uint64_t maxAllocationSize;
+    // Size of the VkDeviceMemory blocks backing the buddy system. Each size class must use a
+    // different heap size as it is used to find the size class of an allocation.
+    uint64_t heapSize;
+    // The size class is only used on memory heaps at least this large so that it doesn't take a
+    // significant fraction of small memory heaps.
+    uint64_t minMemoryHeapSize;
+    // Whether only linear resources are sub-allocated in this size class. These can never share
+    // a page with an opaque resource so they don't need bufferImageGranularity alignment.
+    bool linearOnly;
+};
+
+constexpr uint64_t kMiB = 1024ull * 1024ull;
+constexpr std::array<SizeClass, 4> kSizeClasses = {{
+    // Buddy tier of blocks up to 64KiB in 2MiB heaps for the tiniest buffers like uniform
+    // buffers, which would otherwise each waste up to a full bufferImageGranularity page.
+    {64 * 1024, 2 * kMiB, 64 * kMiB, true},
+    {256 * 1024, 4 * kMiB, 64 * kMiB, false},
+    // Have each bucket of the buddy system allocate at least some resource of the maximum
+    // size.
+    {kMaxSizeForSubAllocation, 2 * kMaxSizeForSubAllocation, 0, false},
+    // Large textures that would otherwise quickly exhaust maxMemoryAllocationCount.
+    {32 * kMiB, 64 * kMiB, 1024 * kMiB, false},
+}};
+
+// Bounds the size of the buddy systems, and hence of their bookkeeping, to this many heaps.
+constexpr uint64_t kMaxHeapsPerSizeClass = 1024;
+
+// Number of consecutive ticks without any sub-allocation activity after which the pooled heaps
+// are released when Toggle::VulkanTrimIdleResourceHeaps is enabled.
+constexpr uint32_t kIdleTicksBeforeTrim = 64;
 
 bool IsMemoryKindMappable(MemoryKind memoryKind) {
     switch (memoryKind) {
@@ -71,35 +110,71 @@ bool IsMemoryKindMappable(MemoryKind memoryKind) {
 
 }  // anonymous namespace
 
-// SingleTypeAllocator is a combination of a BuddyMemoryAllocator and its client and can
-// service suballocation requests, but for a single Vulkan memory type.
+// SingleTypeAllocator is a combination of one BuddyMemoryAllocator per size class and their
+// client and can service suballocation requests, but for a single Vulkan memory type.
 
 class ResourceMemoryAllocator::SingleTypeAllocator : public ResourceHeapAllocator {
   public:
     SingleTypeAllocator(Device* device, size_t memoryTypeIndex, VkDeviceSize memoryHeapSize)
-        : mDevice(device),
-          mMemoryTypeIndex(memoryTypeIndex),
-          mMemoryHeapSize(memoryHeapSize),
-          mPooledMemoryAllocator(this),
-          mBuddySystem(
-              // Round down to a power of 2 that's <= mMemoryHeapSize. This will always
-              // be a multiple of kBuddyHeapsSize because kBuddyHeapsSize is a power of 2.
-              uint64_t(1) << Log2(mMemoryHeapSize),
-              // Take the min in the very unlikely case the memory heap is tiny.
-              std::min(uint64_t(1) << Log2(mMemoryHeapSize), kBuddyHeapsSize),
-              &mPooledMemoryAllocator) {
-        DAWN_ASSERT(IsPowerOfTwo(kBuddyHeapsSize));
+        : mDevice(device), mMemoryTypeIndex(memoryTypeIndex), mMemoryHeapSize(memoryHeapSize) {
+        // Round down to a power of 2 that's <= mMemoryHeapSize. This will always be a multiple
+        // of the heap sizes because they are powers of 2.
+        uint64_t maxSystemSize = uint64_t(1) << Log2(mMemoryHeapSize);
+
+        for (const SizeClass& sizeClass : kSizeClasses) {
+            if (mMemoryHeapSize < sizeClass.minMemoryHeapSize) {
+                continue;
+            }
+            DAWN_ASSERT(IsPowerOfTwo(sizeClass.heapSize));
+            // Take the min in the very unlikely case the memory heap is tiny.
+            uint64_t heapSize = std::min(maxSystemSize, sizeClass.heapSize);
+            mSizeClasses.push_back(std::make_unique<SizeClassAllocator>(
+                sizeClass, std::min(maxSystemSize, heapSize * kMaxHeapsPerSizeClass), heapSize,
+                this));
+        }
     }
     ~SingleTypeAllocator() override = default;
 
-    void DestroyPool() { mPooledMemoryAllocator.DestroyPool(); }
+    void DestroyPool() {
+        for (auto& sizeClass : mSizeClasses) {
+            sizeClass->pooledMemoryAllocator.DestroyPool();
+        }
+    }
 
-    ResultOrError<ResourceMemoryAllocation> AllocateMemory(uint64_t size, uint64_t alignment) {
-        return mBuddySystem.Allocate(size, alignment);
+    ResultOrError<ResourceMemoryAllocation> AllocateMemory(uint64_t size,
+                                                           uint64_t alignment,
+                                                           uint64_t bufferImageGranularity,
+                                                           bool isLinear) {
+        for (auto& sizeClass : mSizeClasses) {
+            if (size > sizeClass->info.maxAllocationSize ||
+                (sizeClass->info.linearOnly && !isLinear)) {
+                continue;
+            }
+            if (!sizeClass->info.linearOnly) {
+                alignment = std::max(alignment, bufferImageGranularity);
+            }
+            return sizeClass->buddySystem.Allocate(size, alignment);
+        }
+        return ResourceMemoryAllocation{};
     }
 
     void DeallocateMemory(const ResourceMemoryAllocation& allocation) {
-        mBuddySystem.Deallocate(allocation);
+        uint64_t heapSize = ToBackend(allocation.GetResourceHeap())->GetSize();
+        for (auto& sizeClass : mSizeClasses) {
+            if (sizeClass->buddySystem.GetMemoryBlockSize() == heapSize) {
+                sizeClass->buddySystem.Deallocate(allocation);
+                return;
+            }
+        }
+        DAWN_UNREACHABLE();
+    }
+
+    void AccumulateStats(SubAllocationStats* stats) const {
+        for (const auto& sizeClass : mSizeClasses) {
+            const BuddyMemoryAllocator& buddySystem = sizeClass->buddySystem;
+            stats->committedSize += buddySystem.GetHeapCount() * buddySystem.GetMemoryBlockSize();
+            stats->allocatedSize += buddySystem.GetAllocatedSize();
+        }
     }
 
     // Implementation of the MemoryAllocator interface to be a client of BuddyMemoryAllocator
@@ -124,7 +199,7 @@ class ResourceMemoryAllocator::SingleTypeAllocator : public ResourceHeapAllocato
                                   "vkAllocateMemory"));
 
         DAWN_ASSERT(allocatedMemory != VK_NULL_HANDLE);
-        return {std::make_unique<ResourceHeap>(allocatedMemory, mMemoryTypeIndex)};
+        return {std::make_unique<ResourceHeap>(allocatedMemory, mMemoryTypeIndex, size)};
     }
 
     void DeallocateResourceHeap(std::unique_ptr<ResourceHeapBase> allocation) override {
@@ -132,11 +207,24 @@ class ResourceMemoryAllocator::SingleTypeAllocator : public ResourceHeapAllocato
     }
 
   private:
+    struct SizeClassAllocator {
+        SizeClassAllocator(const SizeClass& info,
+                           uint64_t maxSystemSize,
+                           uint64_t heapSize,
+                           ResourceHeapAllocator* heapAllocator)
+            : info(info),
+              pooledMemoryAllocator(heapAllocator),
+              buddySystem(maxSystemSize, heapSize, &pooledMemoryAllocator) {}
+
+        SizeClass info;
+        PooledResourceMemoryAllocator pooledMemoryAllocator;
+        BuddyMemoryAllocator buddySystem;
+    };
+
     raw_ptr<Device> mDevice;
     size_t mMemoryTypeIndex;
     VkDeviceSize mMemoryHeapSize;
-    PooledResourceMemoryAllocator mPooledMemoryAllocator;
-    BuddyMemoryAllocator mBuddySystem;
+    std::vector<std::unique_ptr<SizeClassAllocator>> mSizeClasses;
 };
 
 // Implementation of ResourceMemoryAllocator
@@ -166,9 +254,10 @@ ResultOrError<ResourceMemoryAllocation> ResourceMemoryAllocator::Allocate(
     // Sub-allocate non-mappable resources because at the moment the mapped pointer
     // is part of the resource and not the heap, which doesn't match the Vulkan model.
     // TODO(crbug.com/dawn/849): allow sub-allocating mappable resources, maybe.
-    if (!forceDisableSubAllocation && requirements.size < kMaxSizeForSubAllocation &&
-        !IsMemoryKindMappable(kind) &&
+    if (!forceDisableSubAllocation && !IsMemoryKindMappable(kind) &&
         !mDevice->IsToggleEnabled(Toggle::DisableResourceSuballocation)) {
+        mIdleTicks = 0;
+
         // When sub-allocating, Vulkan requires that we respect bufferImageGranularity. Some
         // hardware puts information on the memory's page table entry and allocating a linear
         // resource in the same page as a non-linear (aka opaque) resource can cause issues.
@@ -176,17 +265,17 @@ ResultOrError<ResourceMemoryAllocation> ResourceMemoryAllocator::Allocate(
         // and allocating a linear resource removes these flags.
         //
         // Anyway, just to be safe we ask that all sub-allocated resources are allocated with at
-        // least this alignment. TODO(crbug.com/dawn/849): this is suboptimal because multiple
-        // linear (resp. opaque) resources can coexist in the same page. In particular Nvidia
-        // GPUs often use a granularity of 64k which will lead to a lot of wasted spec. Revisit
-        // with a more efficient algorithm later.
-        uint64_t alignment =
-            std::max(requirements.alignment,
-                     mDevice->GetDeviceInfo().properties.limits.bufferImageGranularity);
-
+        // least this alignment, unless they are in a size class that only contains linear
+        // resources. TODO(crbug.com/dawn/849): this is suboptimal because multiple linear (resp.
+        // opaque) resources can coexist in the same page. In particular Nvidia GPUs often use a
+        // granularity of 64k which will lead to a lot of wasted spec. Revisit with a more
+        // efficient algorithm later.
         ResourceMemoryAllocation subAllocation;
-        DAWN_TRY_ASSIGN(subAllocation, mAllocatorsPerType[memoryType]->AllocateMemory(
-                                           requirements.size, alignment));
+        DAWN_TRY_ASSIGN(subAllocation,
+                        mAllocatorsPerType[memoryType]->AllocateMemory(
+                            requirements.size, requirements.alignment,
+                            mDevice->GetDeviceInfo().properties.limits.bufferImageGranularity,
+                            kind == MemoryKind::Linear));
         if (subAllocation.GetInfo().mMethod != AllocationMethod::kInvalid) {
             return std::move(subAllocation);
         }
@@ -234,6 +323,7 @@ void ResourceMemoryAllocator::Deallocate(ResourceMemoryAllocation* allocation) {
         // TODO(crbug.com/dawn/851): Maybe we can produce the correct barriers to reduce the
         // latency to reclaim memory.
         case AllocationMethod::kSubAllocated:
+            mIdleTicks = 0;
             mSubAllocationsToDelete.Enqueue(*allocation,
                                             mDevice->GetQueue()->GetPendingCommandSerial());
             break;
@@ -258,6 +348,27 @@ void ResourceMemoryAllocator::Tick(ExecutionSerial completedSerial) {
     }
 
     mSubAllocationsToDelete.ClearUpTo(completedSerial);
+
+    // Release the memory pooled for sub-allocations once nothing has been sub-allocated or
+    // freed for a while, as the application likely reached a steady state.
+    if (mDevice->IsToggleEnabled(Toggle::VulkanTrimIdleResourceHeaps) &&
+        mSubAllocationsToDelete.Empty() && ++mIdleTicks == kIdleTicksBeforeTrim) {
+        DestroyPool();
+    }
+
+    SubAllocationStats stats = ComputeSubAllocationStats();
+    TRACE_COUNTER_ID2(mDevice->GetPlatform(), General, "vulkan::ResourceMemoryAllocator", this,
+                      "committedSize", stats.committedSize, "allocatedSize",
+                      stats.allocatedSize);
+}
+
+ResourceMemoryAllocator::SubAllocationStats ResourceMemoryAllocator::ComputeSubAllocationStats()
+    const {
+    SubAllocationStats stats;
+    for (const auto& alloc : mAllocatorsPerType) {
+        alloc->AccumulateStats(&stats);
+    }
+    return stats;
 }
 
 int ResourceMemoryAllocator::FindBestTypeIndex(VkMemoryRequirements requirements, MemoryKind kind) {
@@ -69,6 +69,15 @@ class ResourceMemoryAllocator {
 
     int FindBestTypeIndex(VkMemoryRequirements requirements, MemoryKind kind);
 
+    // Memory-fragmentation statistics of the sub-allocated resources: the memory committed in
+    // heaps of the buddy systems and how much of it is used by (power-of-two rounded)
+    // allocations. Pooled heaps that are not in use aren't counted.
+    struct SubAllocationStats {
+        uint64_t committedSize = 0;
+        uint64_t allocatedSize = 0;
+    };
+    SubAllocationStats ComputeSubAllocationStats() const;
+
   private:
     raw_ptr<Device> mDevice;
 
@@ -76,6 +85,9 @@ class ResourceMemoryAllocator {
     std::vector<std::unique_ptr<SingleTypeAllocator>> mAllocatorsPerType;
 
     SerialQueue<ExecutionSerial, ResourceMemoryAllocation> mSubAllocationsToDelete;
+
+    // Number of ticks since the last sub-allocation or sub-allocation deletion.
+    uint32_t mIdleTicks = 0;
 };
 
 }  // namespace dawn::native::vulkan
@@ -1006,8 +1006,8 @@ void Texture::TransitionEagerlyForExport(CommandRecordingContext* recordingConte
     // importing queue.
     dstStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
 
-    device->fn.CmdPipelineBarrier(recordingContext->commandBuffer, srcStages, dstStages, 0, 0,
-                                  nullptr, 0, nullptr, 1, &barrier);
+    recordingContext->pendingBarriers.AddImageBarriers(srcStages, dstStages, barriers);
+    recordingContext->RecordPendingBarriers(device->fn);
 }
 
 std::vector<VkSemaphore> Texture::AcquireWaitRequirements() {
@@ -1363,6 +1363,14 @@ void Texture::TransitionUsageNow(CommandRecordingContext* recordingContext,
                                  wgpu::TextureUsage usage,
                                  wgpu::ShaderStage shaderStages,
                                  const SubresourceRange& range) {
+    TransitionUsageLater(recordingContext, usage, shaderStages, range);
+    recordingContext->RecordPendingBarriers(ToBackend(GetDevice())->fn);
+}
+
+void Texture::TransitionUsageLater(CommandRecordingContext* recordingContext,
+                                   wgpu::TextureUsage usage,
+                                   wgpu::ShaderStage shaderStages,
+                                   const SubresourceRange& range) {
     std::vector<VkImageMemoryBarrier> barriers;
 
     VkPipelineStageFlags srcStages = 0;
@@ -1375,12 +1383,7 @@ void Texture::TransitionUsageNow(CommandRecordingContext* recordingContext,
         TweakTransitionForExternalUsage(recordingContext, &barriers, 0);
     }
 
-    if (!barriers.empty()) {
-        DAWN_ASSERT(srcStages != 0 && dstStages != 0);
-        ToBackend(GetDevice())
-            ->fn.CmdPipelineBarrier(recordingContext->commandBuffer, srcStages, dstStages, 0, 0,
-                                    nullptr, 0, nullptr, barriers.size(), barriers.data());
-    }
+    recordingContext->pendingBarriers.AddImageBarriers(srcStages, dstStages, barriers);
 }
 
 void Texture::TransitionUsageAndGetResourceBarrier(wgpu::TextureUsage usage,
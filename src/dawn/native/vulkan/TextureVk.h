@@ -92,12 +92,17 @@ class Texture final : public TextureBase {
     Aspect GetDisjointVulkanAspects() const;
 
     // Transitions the texture to be used as `usage`, recording any necessary barrier in
-    // `commands`.
-    // TODO(crbug.com/dawn/851): coalesce barriers and do them early when possible.
+    // `commands` along with the other pending barriers of the recording context.
     void TransitionUsageNow(CommandRecordingContext* recordingContext,
                             wgpu::TextureUsage usage,
                             wgpu::ShaderStage shaderStages,
                             const SubresourceRange& range);
+    // Same as TransitionUsageNow, but only adds the barriers to the pending barriers of the
+    // recording context so that they can be coalesced with the barriers of other transitions.
+    void TransitionUsageLater(CommandRecordingContext* recordingContext,
+                              wgpu::TextureUsage usage,
+                              wgpu::ShaderStage shaderStages,
+                              const SubresourceRange& range);
     void TransitionUsageForPass(CommandRecordingContext* recordingContext,
                                 const TextureSubresourceSyncInfo& textureSyncInfos,
                                 std::vector<VkImageMemoryBarrier>* imageBarriers,
@@ -234,14 +234,17 @@ MaybeError VulkanFunctions::LoadInstanceProcs(VkInstance instance,
     return {};
 }
 
-#define GET_DEVICE_PROC(name)                                                        \
-    do {                                                                             \
-        name = AsVkFn<PFN_vk##name>(GetDeviceProcAddr(device, "vk" #name));          \
-        if (name == nullptr) {                                                       \
-            return DAWN_INTERNAL_ERROR(std::string("Couldn't get proc vk") + #name); \
-        }                                                                            \
+#define GET_DEVICE_PROC_BASE(name, procName)                                             \
+    do {                                                                                 \
+        name = AsVkFn<PFN_vk##name>(GetDeviceProcAddr(device, "vk" #procName));          \
+        if (name == nullptr) {                                                           \
+            return DAWN_INTERNAL_ERROR(std::string("Couldn't get proc vk") + #procName); \
+        }                                                                                \
     } while (0)
 
+#define GET_DEVICE_PROC(name) GET_DEVICE_PROC_BASE(name, name)
+#define GET_DEVICE_PROC_VENDOR(name, vendor) GET_DEVICE_PROC_BASE(name, name##vendor)
+
 MaybeError VulkanFunctions::LoadDeviceProcs(VkDevice device, const VulkanDeviceInfo& deviceInfo) {
     GET_DEVICE_PROC(AllocateCommandBuffers);
     GET_DEVICE_PROC(AllocateDescriptorSets);
@@ -377,6 +380,18 @@ MaybeError VulkanFunctions::LoadDeviceProcs(VkDevice device, const VulkanDeviceI
         GET_DEVICE_PROC(GetSemaphoreFdKHR);
     }
 
+    // Vulkan 1.2 is not required to support the vendor entrypoints of promoted extensions, and
+    // doesn't report the extension as enabled since it isn't requested when the device is created.
+    if (deviceInfo.HasExt(DeviceExt::TimelineSemaphore)) {
+        if (deviceInfo.properties.apiVersion >= VK_API_VERSION_1_2) {
+            GET_DEVICE_PROC(GetSemaphoreCounterValue);
+            GET_DEVICE_PROC(WaitSemaphores);
+        } else {
+            GET_DEVICE_PROC_VENDOR(GetSemaphoreCounterValue, KHR);
+            GET_DEVICE_PROC_VENDOR(WaitSemaphores, KHR);
+        }
+    }
+
     if (deviceInfo.HasExt(DeviceExt::Swapchain)) {
         GET_DEVICE_PROC(CreateSwapchainKHR);
         GET_DEVICE_PROC(DestroySwapchainKHR);
@@ -341,6 +341,10 @@ struct VulkanFunctions {
     VkFn<PFN_vkGetImageMemoryRequirements2KHR> GetImageMemoryRequirements2 = nullptr;
     VkFn<PFN_vkGetImageSparseMemoryRequirements2KHR> GetImageSparseMemoryRequirements2 = nullptr;
 
+    // VK_KHR_timeline_semaphore (promoted to Vulkan 1.2)
+    VkFn<PFN_vkGetSemaphoreCounterValue> GetSemaphoreCounterValue = nullptr;
+    VkFn<PFN_vkWaitSemaphores> WaitSemaphores = nullptr;
+
     // VK_KHR_swapchain
     VkFn<PFN_vkCreateSwapchainKHR> CreateSwapchainKHR = nullptr;
     VkFn<PFN_vkDestroySwapchainKHR> DestroySwapchainKHR = nullptr;
@@ -62,6 +62,7 @@ struct VulkanGlobalInfo : VulkanGlobalKnobs {
 struct VulkanDeviceKnobs {
     VkPhysicalDeviceFeatures features;
     VkPhysicalDeviceShaderFloat16Int8FeaturesKHR shaderFloat16Int8Features;
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineSemaphoreFeatures;
     VkPhysicalDevice16BitStorageFeaturesKHR _16BitStorageFeatures;
     VkPhysicalDeviceSubgroupSizeControlFeaturesEXT subgroupSizeControlFeatures;
     VkPhysicalDeviceZeroInitializeWorkgroupMemoryFeaturesKHR zeroInitializeWorkgroupMemoryFeatures;
@@ -30,6 +30,7 @@
 #include <memory>
 
 #include "dawn/common/Assert.h"
+#include "dawn/platform/FileCachingInterface.h"
 #include "dawn/platform/WorkerThread.h"
 
 namespace dawn::platform {
@@ -38,6 +39,10 @@ CachingInterface::CachingInterface() = default;
 
 CachingInterface::~CachingInterface() = default;
 
+std::unique_ptr<CachingInterface> CreateFileCachingInterface(const char* path, uint64_t maxSize) {
+    return FileCachingInterface::Create(path, maxSize);
+}
+
 Platform::Platform() = default;
 
 Platform::~Platform() = default;
@@ -0,0 +1,432 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "dawn/platform/FileCachingInterface.h"
+
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "dawn/common/Assert.h"
+#include "dawn/common/Math.h"
+#include "dawn/common/Platform.h"
+
+#if DAWN_PLATFORM_IS(POSIX)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#endif
+
+namespace dawn::platform {
+
+namespace {
+
+constexpr uint32_t kFileMagic = 0x434e5744;    // "DWNC"
+constexpr uint32_t kRecordMagic = 0x52574e44;  // "DNWR"
+constexpr uint32_t kFileVersion = 1;
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+};
+static_assert(sizeof(FileHeader) == 8);
+
+// Followed by the key, the value and padding to kRecordAlignment.
+struct RecordHeader {
+    uint32_t magic;
+    uint32_t keySize;
+    uint64_t valueSize;
+};
+static_assert(sizeof(RecordHeader) == 16);
+
+constexpr size_t kRecordAlignment = 8;
+
+uint64_t GetRecordSize(uint64_t keySize, uint64_t valueSize) {
+    return Align(sizeof(RecordHeader) + keySize + valueSize, kRecordAlignment);
+}
+
+#if DAWN_PLATFORM_IS(POSIX)
+int OpenAndLockFile(const char* path, bool truncate) {
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+    if (fd < 0) {
+        return -1;
+    }
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void CloseFile(int fd) {
+    close(fd);
+}
+
+bool RenameFile(const char* from, const char* to) {
+    return rename(from, to) == 0;
+}
+
+void RemoveFile(const char* path) {
+    unlink(path);
+}
+
+bool GetFileSize(int fd, uint64_t* size) {
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        return false;
+    }
+    *size = static_cast<uint64_t>(info.st_size);
+    return true;
+}
+
+bool TruncateFile(int fd, uint64_t size) {
+    return ftruncate(fd, static_cast<off_t>(size)) == 0;
+}
+
+bool WriteAll(int fd, const void* data, uint64_t size, uint64_t offset) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t written = pwrite(fd, bytes, size, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<uint64_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+    return true;
+}
+
+const uint8_t* MapFile(int fd, uint64_t size) {
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+    return static_cast<const uint8_t*>(mapping);
+}
+
+void UnmapFile(const uint8_t* mapping, uint64_t size) {
+    munmap(const_cast<uint8_t*>(mapping), size);
+}
+#else
+// Memory mapped pack files are only implemented for POSIX platforms.
+int OpenAndLockFile(const char*, bool) {
+    return -1;
+}
+void CloseFile(int) {}
+bool RenameFile(const char*, const char*) {
+    return false;
+}
+void RemoveFile(const char*) {}
+bool GetFileSize(int, uint64_t*) {
+    return false;
+}
+bool TruncateFile(int, uint64_t) {
+    return false;
+}
+bool WriteAll(int, const void*, uint64_t, uint64_t) {
+    return false;
+}
+const uint8_t* MapFile(int, uint64_t) {
+    return nullptr;
+}
+void UnmapFile(const uint8_t*, uint64_t) {}
+#endif
+
+}  // anonymous namespace
+
+// static
+std::unique_ptr<FileCachingInterface> FileCachingInterface::Create(const char* path,
+                                                                   uint64_t maxSize) {
+    int fd = OpenAndLockFile(path, /* truncate */ false);
+    if (fd < 0) {
+        return nullptr;
+    }
+    std::unique_ptr<FileCachingInterface> cache(new FileCachingInterface(path, maxSize, fd));
+    if (!cache->ReadIndex()) {
+        return nullptr;
+    }
+    return cache;
+}
+
+FileCachingInterface::FileCachingInterface(std::string path, uint64_t maxSize, int fd)
+    : mPath(std::move(path)), mMaxSize(maxSize), mFd(fd) {}
+
+FileCachingInterface::~FileCachingInterface() {
+    Close();
+}
+
+size_t FileCachingInterface::LoadData(const void* key,
+                                      size_t keySize,
+                                      void* valueOut,
+                                      size_t valueSize) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mEntries.find(std::string(static_cast<const char*>(key), keySize));
+    if (it == mEntries.end()) {
+        return 0;
+    }
+    Entry& entry = it->second;
+    mLRU.splice(mLRU.begin(), mLRU, entry.lruPosition);
+
+    if (valueOut == nullptr) {
+        return entry.valueSize;
+    }
+    if (valueSize < entry.valueSize) {
+        return 0;
+    }
+    // The mapping only covers the file as it was on the last remap, records appended since then
+    // need it to be extended.
+    if (entry.recordOffset + entry.recordSize > mMappingSize && !Remap()) {
+        return 0;
+    }
+    memcpy(valueOut, mMapping.get() + entry.recordOffset + sizeof(RecordHeader) + entry.keySize,
+           entry.valueSize);
+    return entry.valueSize;
+}
+
+void FileCachingInterface::StoreData(const void* key,
+                                     size_t keySize,
+                                     const void* value,
+                                     size_t valueSize) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mFd < 0 || keySize > std::numeric_limits<uint32_t>::max() || valueSize > mMaxSize) {
+        return;
+    }
+    uint64_t recordSize = GetRecordSize(keySize, valueSize);
+    if (sizeof(FileHeader) + recordSize > mMaxSize) {
+        return;
+    }
+
+    if (mFileSize + recordSize > mMaxSize) {
+        // Leave some headroom so that the next stores don't need to compact again.
+        uint64_t targetSize = mMaxSize / 4 * 3;
+        targetSize = targetSize > recordSize ? targetSize - recordSize : 0;
+        if (!Compact(targetSize)) {
+            return;
+        }
+    }
+    Append(std::string(static_cast<const char*>(key), keySize), value, valueSize);
+}
+
+size_t FileCachingInterface::GetEntryCountForTesting() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mEntries.size();
+}
+
+uint64_t FileCachingInterface::GetFileSizeForTesting() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mFileSize;
+}
+
+bool FileCachingInterface::ReadIndex() {
+    if (!GetFileSize(mFd, &mFileSize)) {
+        return false;
+    }
+
+    bool isValid = false;
+    if (mFileSize >= sizeof(FileHeader) && Remap()) {
+        FileHeader header;
+        memcpy(&header, mMapping.get(), sizeof(header));
+        isValid = header.magic == kFileMagic && header.version == kFileVersion;
+    }
+    if (!isValid) {
+        // Start over if the file is new, corrupted or written by another version.
+        const FileHeader header = {kFileMagic, kFileVersion};
+        if (!TruncateFile(mFd, 0) || !WriteAll(mFd, &header, sizeof(header), 0)) {
+            return false;
+        }
+        mFileSize = sizeof(header);
+        return Remap();
+    }
+
+    uint64_t offset = sizeof(FileHeader);
+    while (mFileSize - offset >= sizeof(RecordHeader)) {
+        RecordHeader header;
+        memcpy(&header, mMapping.get() + offset, sizeof(header));
+        if (header.magic != kRecordMagic || header.valueSize > mFileSize) {
+            break;
+        }
+        uint64_t recordSize = GetRecordSize(header.keySize, header.valueSize);
+        if (recordSize > mFileSize - offset) {
+            break;
+        }
+        const char* key = reinterpret_cast<const char*>(mMapping.get() + offset + sizeof(header));
+        AddEntry(std::string(key, header.keySize),
+                 {offset, recordSize, header.keySize, header.valueSize, {}});
+        offset += recordSize;
+    }
+
+    if (offset != mFileSize) {
+        if (!TruncateFile(mFd, offset)) {
+            return false;
+        }
+        mFileSize = offset;
+        return Remap();
+    }
+    return true;
+}
+
+bool FileCachingInterface::Remap() {
+    if (mMapping != nullptr) {
+        UnmapFile(mMapping.get(), mMappingSize);
+        mMapping = nullptr;
+        mMappingSize = 0;
+    }
+    mMapping = MapFile(mFd, mFileSize);
+    if (mMapping == nullptr) {
+        return false;
+    }
+    mMappingSize = mFileSize;
+    return true;
+}
+
+bool FileCachingInterface::Compact(uint64_t targetSize) {
+    // All the records are copied from the mapping.
+    if (mMappingSize != mFileSize && !Remap()) {
+        return false;
+    }
+
+    // Keep the most recently used entries that fit in the target size.
+    std::vector<Entry*> kept;
+    uint64_t size = sizeof(FileHeader);
+    for (const std::string* key : mLRU) {
+        Entry* entry = &mEntries.find(*key)->second;
+        if (size + entry->recordSize > targetSize) {
+            break;
+        }
+        size += entry->recordSize;
+        kept.push_back(entry);
+    }
+
+    // Write them oldest first so that the order of the records matches their recency when the
+    // file is reopened.
+    const std::string tempPath = mPath + ".tmp";
+    int fd = OpenAndLockFile(tempPath.c_str(), /* truncate */ true);
+    if (fd < 0) {
+        return false;
+    }
+    const FileHeader header = {kFileMagic, kFileVersion};
+    bool success = WriteAll(fd, &header, sizeof(header), 0);
+    std::vector<uint64_t> newOffsets(kept.size());
+    uint64_t offset = sizeof(FileHeader);
+    for (size_t i = kept.size(); success && i-- > 0;) {
+        success = WriteAll(fd, mMapping.get() + kept[i]->recordOffset, kept[i]->recordSize, offset);
+        newOffsets[i] = offset;
+        offset += kept[i]->recordSize;
+    }
+    if (!success || !RenameFile(tempPath.c_str(), mPath.c_str())) {
+        CloseFile(fd);
+        RemoveFile(tempPath.c_str());
+        return false;
+    }
+    DAWN_ASSERT(offset == size);
+
+    for (size_t i = 0; i < kept.size(); ++i) {
+        kept[i]->recordOffset = newOffsets[i];
+    }
+    // The kept entries are at the front of the LRU list, evict the others.
+    while (mLRU.size() > kept.size()) {
+        RemoveEntry(mEntries.find(*mLRU.back()));
+    }
+
+    UnmapFile(mMapping.get(), mMappingSize);
+    mMapping = nullptr;
+    mMappingSize = 0;
+    CloseFile(mFd);
+    mFd = fd;
+    mFileSize = offset;
+    if (!Remap()) {
+        // The cache can't be read anymore, stop using it.
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool FileCachingInterface::Append(const std::string& key, const void* value, uint64_t valueSize) {
+    static constexpr uint8_t kPadding[kRecordAlignment] = {};
+
+    const RecordHeader header = {kRecordMagic, static_cast<uint32_t>(key.size()), valueSize};
+    const uint64_t recordOffset = mFileSize;
+    const uint64_t recordSize = GetRecordSize(key.size(), valueSize);
+    const uint64_t valueOffset = recordOffset + sizeof(header) + key.size();
+    const uint64_t paddingSize = recordOffset + recordSize - (valueOffset + valueSize);
+
+    if (!WriteAll(mFd, &header, sizeof(header), recordOffset) ||
+        !WriteAll(mFd, key.data(), key.size(), recordOffset + sizeof(header)) ||
+        !WriteAll(mFd, value, valueSize, valueOffset) ||
+        !WriteAll(mFd, kPadding, paddingSize, valueOffset + valueSize)) {
+        // Drop the partially written record.
+        TruncateFile(mFd, recordOffset);
+        return false;
+    }
+
+    mFileSize = recordOffset + recordSize;
+    // Replacing an existing key leaves its previous record in the file until the next compaction.
+    AddEntry(key, {recordOffset, recordSize, header.keySize, valueSize, {}});
+    return true;
+}
+
+void FileCachingInterface::AddEntry(const std::string& key, Entry entry) {
+    auto existing = mEntries.find(key);
+    if (existing != mEntries.end()) {
+        RemoveEntry(existing);
+    }
+    auto it = mEntries.emplace(key, entry).first;
+    mLRU.push_front(&it->first);
+    it->second.lruPosition = mLRU.begin();
+}
+
+void FileCachingInterface::RemoveEntry(std::unordered_map<std::string, Entry>::iterator it) {
+    mLRU.erase(it->second.lruPosition);
+    mEntries.erase(it);
+}
+
+void FileCachingInterface::Close() {
+    if (mMapping != nullptr) {
+        UnmapFile(mMapping.get(), mMappingSize);
+        mMapping = nullptr;
+        mMappingSize = 0;
+    }
+    if (mFd >= 0) {
+        CloseFile(mFd);
+        mFd = -1;
+    }
+    mEntries.clear();
+    mLRU.clear();
+}
+
+}  // namespace dawn::platform
@@ -0,0 +1,106 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef SRC_DAWN_PLATFORM_FILECACHINGINTERFACE_H_
+#define SRC_DAWN_PLATFORM_FILECACHINGINTERFACE_H_
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "dawn/platform/DawnPlatform.h"
+#include "partition_alloc/pointers/raw_ptr.h"
+
+namespace dawn::platform {
+
+// A CachingInterface storing all the entries in a single append-only pack file. Each record in the
+// file holds its key and value, and the index from keys to records is rebuilt by scanning the file
+// when it is opened. Loads read directly from a read-only memory mapping of the file.
+//
+// When appending a record would grow the file beyond the size budget, the file is compacted: the
+// most recently used entries are rewritten to a new file, oldest first, and the least recently
+// used ones are evicted. Recency is only tracked in memory, so after a restart entries are ranked
+// by the order in which they were written.
+//
+// The file is locked for exclusive use while it is open so that concurrent processes don't corrupt
+// each other's writes.
+class FileCachingInterface final : public CachingInterface {
+  public:
+    // Returns nullptr if the file can't be opened or locked, or if memory mapping files isn't
+    // supported on this platform.
+    static std::unique_ptr<FileCachingInterface> Create(const char* path, uint64_t maxSize);
+    ~FileCachingInterface() override;
+
+    size_t LoadData(const void* key, size_t keySize, void* valueOut, size_t valueSize) override;
+    void StoreData(const void* key, size_t keySize, const void* value, size_t valueSize) override;
+
+    size_t GetEntryCountForTesting() const;
+    uint64_t GetFileSizeForTesting() const;
+
+  private:
+    struct Entry {
+        uint64_t recordOffset;
+        uint64_t recordSize;
+        uint32_t keySize;
+        uint64_t valueSize;
+        std::list<const std::string*>::iterator lruPosition;
+    };
+
+    FileCachingInterface(std::string path, uint64_t maxSize, int fd);
+
+    // Validates the file header and builds the index. Torn records at the end of the file, for
+    // example after a crash during a store, are truncated.
+    bool ReadIndex();
+    // Maps the whole file, replacing the previous mapping.
+    bool Remap();
+    // Rewrites the most recently used entries to a new file until `targetSize` is reached.
+    bool Compact(uint64_t targetSize);
+    bool Append(const std::string& key, const void* value, uint64_t valueSize);
+    void AddEntry(const std::string& key, Entry entry);
+    void RemoveEntry(std::unordered_map<std::string, Entry>::iterator it);
+    void Close();
+
+    mutable std::mutex mMutex;
+
+    const std::string mPath;
+    const uint64_t mMaxSize;
+    int mFd;
+    uint64_t mFileSize = 0;
+    raw_ptr<const uint8_t, AllowPtrArithmetic> mMapping = nullptr;
+    uint64_t mMappingSize = 0;
+
+    std::unordered_map<std::string, Entry> mEntries;
+    // Keys of mEntries, most recently used first.
+    std::list<const std::string*> mLRU;
+};
+
+}  // namespace dawn::platform
+
+#endif  // SRC_DAWN_PLATFORM_FILECACHINGINTERFACE_H_
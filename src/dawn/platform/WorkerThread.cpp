@@ -27,9 +27,13 @@
 
 #include "dawn/platform/WorkerThread.h"
 
+#include <algorithm>
 #include <condition_variable>
-#include <functional>
+#include <deque>
+#include <mutex>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "dawn/common/Assert.h"
 
@@ -83,20 +87,111 @@ class AsyncWaitableEvent final : public dawn::platform::WaitableEvent {
 
 namespace dawn::platform {
 
+namespace {
+
+// Upper bound on the number of threads used when no explicit count is given. Pipeline compilation
+// is CPU-bound so more threads than cores doesn't help, and each device owns its own pool.
+constexpr uint32_t kMaxDefaultThreadCount = 16;
+
+struct WorkerTask {
+    PostWorkerTaskCallback callback;
+    void* userdata;
+    std::shared_ptr<AsyncWaitableEventImpl> waitableEventImpl;
+};
+
+}  // anonymous namespace
+
+// The state shared between the pool and its threads. It is ref-counted so that a worker thread
+// which ends up destroying the pool (for example by releasing the last reference to the device
+// from inside a task) can keep running safely after the pool object is gone.
+class AsyncWorkerThreadPool::Workers : public std::enable_shared_from_this<Workers> {
+  public:
+    explicit Workers(uint32_t maxThreadCount) : mMaxThreadCount(maxThreadCount) {}
+
+    void Post(WorkerTask task) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            DAWN_ASSERT(!mShuttingDown);
+            mTasks.push_back(std::move(task));
+
+            // Only grow the pool when all existing threads are busy with other tasks.
+            if (mIdleThreadCount < mTasks.size() && mThreads.size() < mMaxThreadCount) {
+                mThreads.emplace_back(&Workers::ThreadLoop, shared_from_this());
+            }
+        }
+        mCondition.notify_one();
+    }
+
+    void Shutdown() {
+        std::vector<std::thread> threads;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mShuttingDown = true;
+            threads.swap(mThreads);
+        }
+        mCondition.notify_all();
+
+        // Threads drain the remaining tasks before exiting so that all WaitableEvents complete.
+        for (std::thread& thread : threads) {
+            if (thread.get_id() == std::this_thread::get_id()) {
+                thread.detach();
+            } else {
+                thread.join();
+            }
+        }
+    }
+
+  private:
+    static void ThreadLoop(std::shared_ptr<Workers> workers) { workers->RunTasks(); }
+
+    void RunTasks() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (true) {
+            mIdleThreadCount++;
+            mCondition.wait(lock, [this] { return mShuttingDown || !mTasks.empty(); });
+            mIdleThreadCount--;
+
+            if (mTasks.empty()) {
+                DAWN_ASSERT(mShuttingDown);
+                return;
+            }
+
+            WorkerTask task = std::move(mTasks.front());
+            mTasks.pop_front();
+
+            lock.unlock();
+            task.callback(task.userdata);
+            task.waitableEventImpl->MarkAsComplete();
+            lock.lock();
+        }
+    }
+
+    const uint32_t mMaxThreadCount;
+
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::deque<WorkerTask> mTasks;
+    std::vector<std::thread> mThreads;
+    size_t mIdleThreadCount = 0;
+    bool mShuttingDown = false;
+};
+
+AsyncWorkerThreadPool::AsyncWorkerThreadPool(uint32_t maxThreadCount) {
+    if (maxThreadCount == 0) {
+        maxThreadCount = std::clamp(std::thread::hardware_concurrency(), 1u, kMaxDefaultThreadCount);
+    }
+    mWorkers = std::make_shared<Workers>(maxThreadCount);
+}
+
+AsyncWorkerThreadPool::~AsyncWorkerThreadPool() {
+    mWorkers->Shutdown();
+}
+
 std::unique_ptr<dawn::platform::WaitableEvent> AsyncWorkerThreadPool::PostWorkerTask(
     dawn::platform::PostWorkerTaskCallback callback,
     void* userdata) {
     std::unique_ptr<AsyncWaitableEvent> waitableEvent = std::make_unique<AsyncWaitableEvent>();
-
-    std::function<void()> doTask = [callback, userdata,
-                                    waitableEventImpl = waitableEvent->GetWaitableEventImpl()] {
-        callback(userdata);
-        waitableEventImpl->MarkAsComplete();
-    };
-
-    std::thread thread(doTask);
-    thread.detach();
-
+    mWorkers->Post({callback, userdata, waitableEvent->GetWaitableEventImpl()});
     return waitableEvent;
 }
 
@@ -28,18 +28,32 @@
 #ifndef SRC_DAWN_PLATFORM_WORKERTHREAD_H_
 #define SRC_DAWN_PLATFORM_WORKERTHREAD_H_
 
+#include <cstdint>
 #include <memory>
 
 #include "dawn/common/NonCopyable.h"
 #include "dawn/platform/DawnPlatform.h"
+#include "dawn/platform/dawn_platform_export.h"
 
 namespace dawn::platform {
 
-class AsyncWorkerThreadPool : public dawn::platform::WorkerTaskPool, public NonCopyable {
+// A bounded pool of persistent worker threads. Threads are spawned lazily when a task is posted
+// and no worker is idle, up to |maxThreadCount|, and are then reused for subsequent tasks until
+// the pool is destroyed.
+class DAWN_PLATFORM_EXPORT AsyncWorkerThreadPool : public dawn::platform::WorkerTaskPool,
+                                                   public NonCopyable {
   public:
+    // A |maxThreadCount| of 0 picks a default based on the number of hardware threads.
+    explicit AsyncWorkerThreadPool(uint32_t maxThreadCount = 0);
+    ~AsyncWorkerThreadPool() override;
+
     std::unique_ptr<dawn::platform::WaitableEvent> PostWorkerTask(
         dawn::platform::PostWorkerTaskCallback callback,
         void* userdata) override;
+
+  private:
+    class Workers;
+    std::shared_ptr<Workers> mWorkers;
 };
 
 }  // namespace dawn::platform
@@ -0,0 +1,286 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "dawn/common/Platform.h"
+#include "dawn/utils/SharedMemory.h"
+#include "dawn/utils/SharedMemoryCommandBuffer.h"
+#include "dawn/wire/Wire.h"
+
+#if DAWN_PLATFORM_IS(POSIX)
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <thread>
+#endif
+
+namespace dawn {
+namespace {
+
+// Both transports fork a server process that handles the commands serialized by the benchmark.
+#if DAWN_PLATFORM_IS(POSIX)
+
+constexpr size_t kRingCapacity = 4 * 1024 * 1024;
+constexpr size_t kCommandsPerFlush = 64;
+
+// Commands start with their size and the time at which they were serialized.
+struct BenchmarkCommandHeader {
+    uint64_t size;
+    int64_t timestampNs;
+};
+
+int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Latency statistics written by the server process into shared memory.
+struct LatencyStats {
+    std::atomic<uint64_t> commandCount;
+    std::atomic<int64_t> totalLatencyNs;
+    std::atomic<int64_t> maxLatencyNs;
+};
+
+class LatencyHandler : public wire::CommandHandler {
+  public:
+    explicit LatencyHandler(LatencyStats* stats) : mStats(stats) {}
+
+    const volatile char* HandleCommands(const volatile char* commands, size_t size) override {
+        int64_t now = NowNs();
+        int64_t totalLatency = 0;
+        int64_t maxLatency = 0;
+        uint64_t count = 0;
+        while (size >= sizeof(BenchmarkCommandHeader)) {
+            BenchmarkCommandHeader header;
+            for (size_t i = 0; i < sizeof(header); ++i) {
+                reinterpret_cast<char*>(&header)[i] = commands[i];
+            }
+            if (header.size < sizeof(header) || header.size > size) {
+                return nullptr;
+            }
+            // Touch the whole command like a deserializer would.
+            char checksum = 0;
+            for (size_t i = sizeof(header); i < header.size; ++i) {
+                checksum ^= commands[i];
+            }
+            benchmark::DoNotOptimize(checksum);
+
+            int64_t latency = now - header.timestampNs;
+            totalLatency += latency;
+            maxLatency = std::max(maxLatency, latency);
+            count++;
+            commands += header.size;
+            size -= header.size;
+        }
+        mStats->commandCount.fetch_add(count, std::memory_order_relaxed);
+        mStats->totalLatencyNs.fetch_add(totalLatency, std::memory_order_relaxed);
+        if (maxLatency > mStats->maxLatencyNs.load(std::memory_order_relaxed)) {
+            mStats->maxLatencyNs.store(maxLatency, std::memory_order_relaxed);
+        }
+        return commands;
+    }
+
+  private:
+    LatencyStats* mStats;
+};
+
+void SerializeCommands(wire::CommandSerializer* serializer, size_t commandSize) {
+    for (size_t i = 0; i < kCommandsPerFlush; ++i) {
+        char* dst = static_cast<char*>(serializer->GetCmdSpace(commandSize));
+        BenchmarkCommandHeader header = {commandSize, NowNs()};
+        memcpy(dst, &header, sizeof(header));
+        memset(dst + sizeof(header), static_cast<int>(i), commandSize - sizeof(header));
+    }
+    serializer->Flush();
+}
+
+void ReportStats(benchmark::State& state, const LatencyStats& stats, size_t commandSize) {
+    uint64_t count = stats.commandCount.load();
+    state.SetItemsProcessed(count);
+    state.SetBytesProcessed(count * commandSize);
+    if (count > 0) {
+        state.counters["avg_latency_us"] =
+            static_cast<double>(stats.totalLatencyNs.load()) / count / 1000.0;
+        state.counters["max_latency_us"] = static_cast<double>(stats.maxLatencyNs.load()) / 1000.0;
+    }
+}
+
+// Serializes commands directly into a ring buffer in shared memory that the server process reads
+// in place.
+void BM_SharedMemoryTransport(benchmark::State& state) {
+    size_t commandSize = static_cast<size_t>(state.range(0));
+
+    auto memory = utils::SharedMemory::Create(
+        utils::SharedMemoryCommandSerializer::GetRequiredSharedMemorySize(kRingCapacity));
+    auto statsMemory = utils::SharedMemory::Create(sizeof(LatencyStats));
+    if (memory == nullptr || statsMemory == nullptr) {
+        state.SkipWithError("Failed to create shared memory");
+        return;
+    }
+    auto* stats = new (statsMemory->GetPointer()) LatencyStats();
+    int serverFD = dup(memory->GetFD());
+    size_t memorySize = memory->GetSize();
+    auto serializer = utils::SharedMemoryCommandSerializer::Create(std::move(memory));
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        // The server maps the shared memory again, as if it received the file descriptor from
+        // another process.
+        auto receiver = utils::SharedMemoryCommandReceiver::Create(
+            utils::SharedMemory::Map(serverFD, memorySize));
+        LatencyHandler handler(stats);
+        while (receiver != nullptr && !receiver->IsDone()) {
+            if (!receiver->HandleCommands(&handler)) {
+                _exit(1);
+            }
+            std::this_thread::yield();
+        }
+        _exit(0);
+    }
+    close(serverFD);
+
+    for (auto _ : state) {
+        SerializeCommands(serializer.get(), commandSize);
+    }
+    serializer->Close();
+    waitpid(pid, nullptr, 0);
+
+    ReportStats(state, *stats, commandSize);
+}
+
+// The baseline: commands are serialized into a private buffer like utils::TerribleCommandBuffer
+// does, then copied through a pipe into another buffer in the server process.
+class PipeCommandSerializer : public wire::CommandSerializer {
+  public:
+    explicit PipeCommandSerializer(int fd) : mFD(fd), mBuffer(kRingCapacity / 2) {}
+
+    size_t GetMaximumAllocationSize() const override { return mBuffer.size(); }
+
+    void* GetCmdSpace(size_t size) override {
+        if (mBuffer.size() - mOffset < size && !Flush()) {
+            return nullptr;
+        }
+        char* result = mBuffer.data() + mOffset;
+        mOffset += size;
+        return result;
+    }
+
+    bool Flush() override {
+        uint64_t size = mOffset;
+        mOffset = 0;
+        return WriteAll(&size, sizeof(size)) && WriteAll(mBuffer.data(), size);
+    }
+
+  private:
+    bool WriteAll(const void* data, size_t size) {
+        const char* src = static_cast<const char*>(data);
+        while (size > 0) {
+            ssize_t written = write(mFD, src, size);
+            if (written <= 0) {
+                return false;
+            }
+            src += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    int mFD;
+    std::vector<char> mBuffer;
+    size_t mOffset = 0;
+};
+
+bool ReadAll(int fd, void* data, size_t size) {
+    char* dst = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t bytesRead = read(fd, dst, size);
+        if (bytesRead <= 0) {
+            return false;
+        }
+        dst += bytesRead;
+        size -= static_cast<size_t>(bytesRead);
+    }
+    return true;
+}
+
+void BM_PipeTransport(benchmark::State& state) {
+    size_t commandSize = static_cast<size_t>(state.range(0));
+
+    auto statsMemory = utils::SharedMemory::Create(sizeof(LatencyStats));
+    int fds[2];
+    if (statsMemory == nullptr || pipe(fds) != 0) {
+        state.SkipWithError("Failed to create the pipe");
+        return;
+    }
+    auto* stats = new (statsMemory->GetPointer()) LatencyStats();
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[1]);
+        LatencyHandler handler(stats);
+        std::vector<char> buffer(kRingCapacity / 2);
+        uint64_t size;
+        while (ReadAll(fds[0], &size, sizeof(size))) {
+            if (size > buffer.size() || !ReadAll(fds[0], buffer.data(), size) ||
+                handler.HandleCommands(buffer.data(), size) == nullptr) {
+                _exit(1);
+            }
+        }
+        _exit(0);
+    }
+    close(fds[0]);
+
+    {
+        PipeCommandSerializer serializer(fds[1]);
+        for (auto _ : state) {
+            SerializeCommands(&serializer, commandSize);
+        }
+    }
+    close(fds[1]);
+    waitpid(pid, nullptr, 0);
+
+    ReportStats(state, *stats, commandSize);
+}
+
+BENCHMARK(BM_SharedMemoryTransport)->Arg(32)->Arg(256)->Arg(4096)->Arg(65536)->UseRealTime();
+BENCHMARK(BM_PipeTransport)->Arg(32)->Arg(256)->Arg(4096)->Arg(65536)->UseRealTime();
+
+#endif  // DAWN_PLATFORM_IS(POSIX)
+
+}  // anonymous namespace
+}  // namespace dawn
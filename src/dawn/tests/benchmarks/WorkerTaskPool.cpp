@@ -0,0 +1,126 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "dawn/platform/DawnPlatform.h"
+
+namespace dawn {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// The previous implementation of the platform's worker pool which spawned and detached one thread
+// per task, kept as a baseline to compare against.
+class SpawnPerTaskEvent : public platform::WaitableEvent {
+  public:
+    void Wait() override {
+        while (!IsComplete()) {
+            std::this_thread::yield();
+        }
+    }
+    bool IsComplete() override { return mIsComplete->load(std::memory_order_acquire); }
+
+    std::shared_ptr<std::atomic<bool>> GetFlag() const { return mIsComplete; }
+
+  private:
+    std::shared_ptr<std::atomic<bool>> mIsComplete = std::make_shared<std::atomic<bool>>(false);
+};
+
+class SpawnPerTaskPool : public platform::WorkerTaskPool {
+  public:
+    std::unique_ptr<platform::WaitableEvent> PostWorkerTask(platform::PostWorkerTaskCallback callback,
+                                                            void* userdata) override {
+        auto event = std::make_unique<SpawnPerTaskEvent>();
+        std::thread([callback, userdata, flag = event->GetFlag()] {
+            callback(userdata);
+            flag->store(true, std::memory_order_release);
+        }).detach();
+        return event;
+    }
+};
+
+struct LatencyTask {
+    Clock::time_point postTime;
+    Clock::duration latency;
+};
+
+void RecordLatency(void* userdata) {
+    LatencyTask* task = static_cast<LatencyTask*>(userdata);
+    task->latency = Clock::now() - task->postTime;
+}
+
+// Posts a burst of state.range(0) tasks, similar to a scene warming up its pipelines with
+// Create*PipelineAsync, waits for all of them and reports the latency between posting a task and
+// it starting to run.
+void RunBurst(benchmark::State& state, platform::WorkerTaskPool* pool) {
+    const size_t taskCount = state.range(0);
+    std::vector<LatencyTask> tasks(taskCount);
+    std::vector<std::unique_ptr<platform::WaitableEvent>> events(taskCount);
+    std::vector<double> latenciesUs;
+    latenciesUs.reserve(taskCount * 16);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < taskCount; ++i) {
+            tasks[i].postTime = Clock::now();
+            events[i] = pool->PostWorkerTask(RecordLatency, &tasks[i]);
+        }
+        for (size_t i = 0; i < taskCount; ++i) {
+            events[i]->Wait();
+            latenciesUs.push_back(
+                std::chrono::duration<double, std::micro>(tasks[i].latency).count());
+        }
+    }
+
+    std::sort(latenciesUs.begin(), latenciesUs.end());
+    state.SetItemsProcessed(state.iterations() * taskCount);
+    state.counters["p50_latency_us"] = latenciesUs[latenciesUs.size() / 2];
+    state.counters["p99_latency_us"] = latenciesUs[latenciesUs.size() * 99 / 100];
+}
+
+void BM_PlatformWorkerTaskPool(benchmark::State& state) {
+    platform::Platform platform;
+    std::unique_ptr<platform::WorkerTaskPool> pool = platform.CreateWorkerTaskPool();
+    RunBurst(state, pool.get());
+}
+BENCHMARK(BM_PlatformWorkerTaskPool)->Arg(1)->Arg(64)->Arg(1024)->UseRealTime();
+
+void BM_SpawnPerTaskPool(benchmark::State& state) {
+    SpawnPerTaskPool pool;
+    RunBurst(state, &pool);
+}
+BENCHMARK(BM_SpawnPerTaskPool)->Arg(1)->Arg(64)->Arg(1024)->UseRealTime();
+
+}  // anonymous namespace
+}  // namespace dawn
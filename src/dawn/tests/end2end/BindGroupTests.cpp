@@ -1525,6 +1525,55 @@ TEST_P(BindGroupTests, ReadonlyStorage) {
     EXPECT_PIXEL_RGBA8_EQ(utils::RGBA8::kGreen, renderPass.color, 0, 0);
 }
 
+// Test that bind groups with identical contents, which some backends may share descriptors for,
+// keep working independently when some of them are released.
+TEST_P(BindGroupTests, IdenticalBindGroups) {
+    wgpu::ComputePipelineDescriptor pipelineDesc;
+    pipelineDesc.compute.module = utils::CreateShaderModule(device, R"(
+        @group(0) @binding(0) var<storage, read_write> value : u32;
+
+        @compute @workgroup_size(1) fn main() {
+            value = value + 1u;
+        })");
+    wgpu::ComputePipeline pipeline = device.CreateComputePipeline(&pipelineDesc);
+    wgpu::BindGroupLayout bgl = pipeline.GetBindGroupLayout(0);
+
+    wgpu::BufferDescriptor bufferDesc;
+    bufferDesc.size = sizeof(uint32_t);
+    bufferDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopySrc;
+    wgpu::Buffer bufferA = device.CreateBuffer(&bufferDesc);
+    wgpu::Buffer bufferB = device.CreateBuffer(&bufferDesc);
+
+    auto Dispatch = [&](std::vector<wgpu::BindGroup> bindGroups) {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        pass.SetPipeline(pipeline);
+        for (const wgpu::BindGroup& bindGroup : bindGroups) {
+            pass.SetBindGroup(0, bindGroup);
+            pass.DispatchWorkgroups(1);
+        }
+        pass.End();
+        wgpu::CommandBuffer commands = encoder.Finish();
+        queue.Submit(1, &commands);
+    };
+
+    wgpu::BindGroup bindGroupA1 = utils::MakeBindGroup(device, bgl, {{0, bufferA}});
+    wgpu::BindGroup bindGroupA2 = utils::MakeBindGroup(device, bgl, {{0, bufferA}});
+    wgpu::BindGroup bindGroupB = utils::MakeBindGroup(device, bgl, {{0, bufferB}});
+    Dispatch({bindGroupA1, bindGroupA2, bindGroupB});
+
+    // Release one of the identical bind groups, the other one must still be usable.
+    bindGroupA1 = nullptr;
+    Dispatch({bindGroupA2});
+
+    // Release all the bind groups for bufferA then create a new one.
+    bindGroupA2 = nullptr;
+    Dispatch({utils::MakeBindGroup(device, bgl, {{0, bufferA}}), bindGroupB});
+
+    EXPECT_BUFFER_U32_EQ(4u, bufferA, 0);
+    EXPECT_BUFFER_U32_EQ(2u, bufferB, 0);
+}
+
 // This is a regression test for crbug.com/dawn/319 where creating a bind group with a
 // destroyed resource would crash the backend.
 TEST_P(BindGroupTests, CreateWithDestroyedResource) {
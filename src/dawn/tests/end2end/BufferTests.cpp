@@ -664,12 +664,14 @@ TEST_P(BufferMappingTests, RegressChromium1421170) {
 DAWN_INSTANTIATE_PREFIXED_TEST_P(Legacy,
                                  BufferMappingTests,
                                  {D3D11Backend(), D3D12Backend(), MetalBackend(), OpenGLBackend(),
-                                  OpenGLESBackend(), VulkanBackend()},
+                                  OpenGLESBackend(), VulkanBackend(),
+                                  VulkanBackend({}, {"vulkan_use_timeline_semaphore"})},
                                  {std::nullopt});
 
 DAWN_INSTANTIATE_PREFIXED_TEST_P(Future,
                                  BufferMappingTests,
                                  {D3D11Backend(), D3D12Backend(), MetalBackend(), VulkanBackend(),
+                                  VulkanBackend({}, {"vulkan_use_timeline_semaphore"}),
                                   OpenGLBackend(), OpenGLESBackend()},
                                  std::initializer_list<std::optional<wgpu::CallbackMode>>{
                                      wgpu::CallbackMode::WaitAnyOnly,
@@ -1292,7 +1294,9 @@ DAWN_INSTANTIATE_TEST(BufferTests,
                       MetalBackend(),
                       OpenGLBackend(),
                       OpenGLESBackend(),
-                      VulkanBackend());
+                      VulkanBackend(),
+                      VulkanBackend({"vulkan_direct_write_buffer_on_uma"}),
+                      VulkanBackend({}, {"vulkan_direct_write_buffer_on_uma"}));
 
 class BufferNoSuballocationTests : public DawnTest {};
 
@@ -1325,7 +1329,11 @@ DAWN_INSTANTIATE_TEST(BufferNoSuballocationTests,
                       MetalBackend({"disable_resource_suballocation"}),
                       OpenGLBackend({"disable_resource_suballocation"}),
                       OpenGLESBackend({"disable_resource_suballocation"}),
-                      VulkanBackend({"disable_resource_suballocation"}));
+                      VulkanBackend({"disable_resource_suballocation"}),
+                      VulkanBackend({"disable_resource_suballocation",
+                                     "vulkan_direct_write_buffer_on_uma"}),
+                      VulkanBackend({"disable_resource_suballocation"},
+                                    {"vulkan_direct_write_buffer_on_uma"}));
 
 class BufferMapExtendedUsagesTests : public BufferMappingTests {
   protected:
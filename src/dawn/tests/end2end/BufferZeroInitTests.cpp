@@ -1405,7 +1405,11 @@ DAWN_INSTANTIATE_TEST(BufferZeroInitTest,
                       MetalBackend({"nonzero_clear_resources_on_creation_for_testing"}),
                       OpenGLBackend({"nonzero_clear_resources_on_creation_for_testing"}),
                       OpenGLESBackend({"nonzero_clear_resources_on_creation_for_testing"}),
-                      VulkanBackend({"nonzero_clear_resources_on_creation_for_testing"}));
+                      VulkanBackend({"nonzero_clear_resources_on_creation_for_testing"}),
+                      VulkanBackend({"nonzero_clear_resources_on_creation_for_testing",
+                                     "vulkan_direct_write_buffer_on_uma"}),
+                      VulkanBackend({"nonzero_clear_resources_on_creation_for_testing"},
+                                    {"vulkan_direct_write_buffer_on_uma"}));
 
 }  // anonymous namespace
 }  // namespace dawn
@@ -25,6 +25,7 @@
 // OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <array>
 #include <vector>
 
 #include "dawn/tests/DawnTest.h"
@@ -128,6 +129,36 @@ class DrawIndexedIndirectTest : public DawnTest {
         EXPECT_PIXEL_RGBA8_EQ(topRightExpected, renderPass.color, 3, 1);
     }
 
+    // Encodes a render pass clearing |target| and drawing with the parameters in |indirectBuffer|
+    // at |indirectOffset|, either directly or through a render bundle.
+    wgpu::CommandBuffer EncodeDrawToTarget(wgpu::Buffer indirectBuffer,
+                                           uint64_t indirectOffset,
+                                           wgpu::Buffer indexBuffer,
+                                           const utils::BasicRenderPass& target,
+                                           bool useBundle) {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&target.renderPassInfo);
+        if (useBundle) {
+            utils::ComboRenderBundleEncoderDescriptor desc = {};
+            desc.colorFormatCount = 1;
+            desc.cColorFormats[0] = target.colorFormat;
+            wgpu::RenderBundleEncoder bundleEncoder = device.CreateRenderBundleEncoder(&desc);
+            bundleEncoder.SetPipeline(pipeline);
+            bundleEncoder.SetVertexBuffer(0, vertexBuffer);
+            bundleEncoder.SetIndexBuffer(indexBuffer, wgpu::IndexFormat::Uint32, 0);
+            bundleEncoder.DrawIndexedIndirect(indirectBuffer, indirectOffset);
+            wgpu::RenderBundle bundle = bundleEncoder.Finish();
+            pass.ExecuteBundles(1, &bundle);
+        } else {
+            pass.SetPipeline(pipeline);
+            pass.SetVertexBuffer(0, vertexBuffer);
+            pass.SetIndexBuffer(indexBuffer, wgpu::IndexFormat::Uint32, 0);
+            pass.DrawIndexedIndirect(indirectBuffer, indirectOffset);
+        }
+        pass.End();
+        return encoder.Finish();
+    }
+
     void Test(std::initializer_list<uint32_t> bufferList,
               uint64_t indexOffset,
               uint64_t indirectOffset,
@@ -773,13 +804,186 @@ TEST_P(DrawIndexedIndirectTest, ValidateReusedBundleWithChangingParams) {
     EXPECT_PIXEL_RGBA8_EQ(filled, renderPass.color, 3, 1);
 }
 
+// Test render passes validated during encoding, because they use render bundles, submitted along
+// with render passes whose validation is deferred to the submit.
+TEST_P(DrawIndexedIndirectTest, ValidateBundleAndDirectPassesInOneSubmit) {
+    // TODO(crbug.com/dawn/789): Test is failing under SwANGLE on Windows only.
+    DAWN_SUPPRESS_TEST_IF(IsANGLE() && IsWindows());
+
+    // TODO(crbug.com/dawn/1292): Some Intel OpenGL drivers don't seem to like
+    // the offsets that Tint/GLSL produces.
+    DAWN_SUPPRESS_TEST_IF(IsIntel() && IsOpenGL() && IsLinux());
+
+    // It doesn't make sense to test invalid inputs when validation is disabled.
+    DAWN_SUPPRESS_TEST_IF(HasToggleEnabled("skip_validation"));
+
+    utils::RGBA8 filled(0, 255, 0, 255);
+    utils::RGBA8 notFilled(0, 0, 0, 0);
+
+    // A draw of the bottom left triangle at offset 0 and a draw with an excessive firstIndex at
+    // offset 20.
+    wgpu::Buffer indirectBuffer = CreateIndirectBuffer({3, 1, 0, 0, 0, 3, 1, 7, 0, 0});
+    wgpu::Buffer indexBuffer = CreateIndexBuffer({0, 1, 2, 0, 3, 1});
+
+    std::array<utils::BasicRenderPass, 4> targets;
+    for (utils::BasicRenderPass& target : targets) {
+        target = utils::CreateBasicRenderPass(device, kRTSize, kRTSize);
+    }
+    std::array<wgpu::CommandBuffer, 4> commands = {
+        EncodeDrawToTarget(indirectBuffer, 20, indexBuffer, targets[0], true),
+        EncodeDrawToTarget(indirectBuffer, 0, indexBuffer, targets[1], false),
+        EncodeDrawToTarget(indirectBuffer, 0, indexBuffer, targets[2], true),
+        EncodeDrawToTarget(indirectBuffer, 20, indexBuffer, targets[3], false),
+    };
+    queue.Submit(commands.size(), commands.data());
+
+    EXPECT_PIXEL_RGBA8_EQ(notFilled, targets[0].color, 1, 3);
+    EXPECT_PIXEL_RGBA8_EQ(filled, targets[1].color, 1, 3);
+    EXPECT_PIXEL_RGBA8_EQ(filled, targets[2].color, 1, 3);
+    EXPECT_PIXEL_RGBA8_EQ(notFilled, targets[3].color, 1, 3);
+}
+
+// Test submitting the same indirect draws several times, which may reuse the parameters
+// validated by the previous submits.
+TEST_P(DrawIndexedIndirectTest, ValidateRepeatedSubmits) {
+    // TODO(crbug.com/dawn/789): Test is failing under SwANGLE on Windows only.
+    DAWN_SUPPRESS_TEST_IF(IsANGLE() && IsWindows());
+
+    // TODO(crbug.com/dawn/1292): Some Intel OpenGL drivers don't seem to like
+    // the offsets that Tint/GLSL produces.
+    DAWN_SUPPRESS_TEST_IF(IsIntel() && IsOpenGL() && IsLinux());
+
+    // It doesn't make sense to test invalid inputs when validation is disabled.
+    DAWN_SUPPRESS_TEST_IF(HasToggleEnabled("skip_validation"));
+
+    utils::RGBA8 filled(0, 255, 0, 255);
+    utils::RGBA8 notFilled(0, 0, 0, 0);
+
+    // Draws of the bottom left triangle, with an excessive firstIndex and of the top right
+    // triangle.
+    wgpu::Buffer indirectBuffer =
+        CreateIndirectBuffer({3, 1, 0, 0, 0, 3, 1, 7, 0, 0, 3, 1, 3, 0, 0});
+    wgpu::Buffer indexBuffer = CreateIndexBuffer({0, 1, 2, 0, 3, 1});
+
+    for (uint32_t i = 0; i < 3; ++i) {
+        TestDraw(EncodeDrawToTarget(indirectBuffer, 0, indexBuffer, renderPass, false), filled,
+                 notFilled);
+        TestDraw(EncodeDrawToTarget(indirectBuffer, 20, indexBuffer, renderPass, false), notFilled,
+                 notFilled);
+        TestDraw(EncodeDrawToTarget(indirectBuffer, 40, indexBuffer, renderPass, false), notFilled,
+                 filled);
+    }
+
+    // Draws at offsets that were already validated and one that wasn't, in the same pass.
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    {
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass.renderPassInfo);
+        pass.SetPipeline(pipeline);
+        pass.SetVertexBuffer(0, vertexBuffer);
+        pass.SetIndexBuffer(indexBuffer, wgpu::IndexFormat::Uint32, 0);
+        pass.DrawIndexedIndirect(indirectBuffer, 0);
+        pass.DrawIndexedIndirect(indirectBuffer, 20);
+        pass.DrawIndexedIndirect(indirectBuffer, 40);
+        pass.SetIndexBuffer(indexBuffer, wgpu::IndexFormat::Uint32, 3 * sizeof(uint32_t));
+        pass.DrawIndexedIndirect(indirectBuffer, 40);
+        pass.End();
+    }
+    TestDraw(encoder.Finish(), filled, filled);
+}
+
+// Test that parameters validated by a previous submit aren't reused after the indirect buffer is
+// written with WriteBuffer or CopyBufferToBuffer.
+TEST_P(DrawIndexedIndirectTest, ValidateAfterIndirectBufferWrites) {
+    // TODO(crbug.com/dawn/789): Test is failing under SwANGLE on Windows only.
+    DAWN_SUPPRESS_TEST_IF(IsANGLE() && IsWindows());
+
+    // TODO(crbug.com/dawn/1292): Some Intel OpenGL drivers don't seem to like
+    // the offsets that Tint/GLSL produces.
+    DAWN_SUPPRESS_TEST_IF(IsIntel() && IsOpenGL() && IsLinux());
+
+    // It doesn't make sense to test invalid inputs when validation is disabled.
+    DAWN_SUPPRESS_TEST_IF(HasToggleEnabled("skip_validation"));
+
+    utils::RGBA8 filled(0, 255, 0, 255);
+    utils::RGBA8 notFilled(0, 0, 0, 0);
+
+    wgpu::Buffer indirectBuffer = utils::CreateBufferFromData<uint32_t>(
+        device,
+        wgpu::BufferUsage::Indirect | wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst,
+        {3, 1, 0, 0, 0});
+    wgpu::Buffer indexBuffer = CreateIndexBuffer({0, 1, 2, 0, 3, 1});
+    auto DrawAndExpect = [&](utils::RGBA8 bottomLeftExpected, utils::RGBA8 topRightExpected) {
+        TestDraw(EncodeDrawToTarget(indirectBuffer, 0, indexBuffer, renderPass, false),
+                 bottomLeftExpected, topRightExpected);
+    };
+    auto CopyFirstIndex = [&](wgpu::CommandEncoder encoder, uint32_t firstIndex) {
+        wgpu::Buffer source =
+            utils::CreateBufferFromData<uint32_t>(device, wgpu::BufferUsage::CopySrc, {firstIndex});
+        encoder.CopyBufferToBuffer(source, 0, indirectBuffer, 2 * sizeof(uint32_t),
+                                   sizeof(uint32_t));
+    };
+
+    DrawAndExpect(filled, notFilled);
+    DrawAndExpect(filled, notFilled);
+
+    // Change firstIndex to draw the other triangle, then to an excessive value.
+    uint32_t firstIndex = 3;
+    queue.WriteBuffer(indirectBuffer, 2 * sizeof(uint32_t), &firstIndex, sizeof(firstIndex));
+    DrawAndExpect(notFilled, filled);
+    firstIndex = 7;
+    queue.WriteBuffer(indirectBuffer, 2 * sizeof(uint32_t), &firstIndex, sizeof(firstIndex));
+    DrawAndExpect(notFilled, notFilled);
+
+    // Copy in a submit before the draw.
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        CopyFirstIndex(encoder, 0);
+        wgpu::CommandBuffer copy = encoder.Finish();
+        queue.Submit(1, &copy);
+    }
+    DrawAndExpect(filled, notFilled);
+
+    // Copy in an earlier command buffer of the same submit as the draw.
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        CopyFirstIndex(encoder, 3);
+        std::array<wgpu::CommandBuffer, 2> commands = {
+            encoder.Finish(),
+            EncodeDrawToTarget(indirectBuffer, 0, indexBuffer, renderPass, false)};
+        queue.Submit(commands.size(), commands.data());
+        EXPECT_PIXEL_RGBA8_EQ(notFilled, renderPass.color, 1, 3);
+        EXPECT_PIXEL_RGBA8_EQ(filled, renderPass.color, 3, 1);
+    }
+
+    // Copy earlier in the same command buffer as the draw.
+    {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        CopyFirstIndex(encoder, 7);
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass.renderPassInfo);
+        pass.SetPipeline(pipeline);
+        pass.SetVertexBuffer(0, vertexBuffer);
+        pass.SetIndexBuffer(indexBuffer, wgpu::IndexFormat::Uint32, 0);
+        pass.DrawIndexedIndirect(indirectBuffer, 0);
+        pass.End();
+        TestDraw(encoder.Finish(), notFilled, notFilled);
+    }
+    DrawAndExpect(notFilled, notFilled);
+}
+
 DAWN_INSTANTIATE_TEST(DrawIndexedIndirectTest,
                       D3D11Backend(),
                       D3D12Backend(),
+                      D3D12Backend({"batch_indirect_draw_validation_at_submit",
+                                    "skip_unchanged_indirect_draw_validation"}),
                       MetalBackend(),
+                      MetalBackend({"batch_indirect_draw_validation_at_submit",
+                                    "skip_unchanged_indirect_draw_validation"}),
                       OpenGLBackend(),
                       OpenGLESBackend(),
-                      VulkanBackend());
+                      VulkanBackend(),
+                      VulkanBackend({"batch_indirect_draw_validation_at_submit"}),
+                      VulkanBackend({"batch_indirect_draw_validation_at_submit",
+                                     "skip_unchanged_indirect_draw_validation"}));
 
 }  // anonymous namespace
 }  // namespace dawn
@@ -148,7 +148,9 @@ DAWN_INSTANTIATE_TEST(DrawIndirectTest,
                       MetalBackend(),
                       OpenGLBackend(),
                       OpenGLESBackend(),
-                      VulkanBackend());
+                      VulkanBackend(),
+                      VulkanBackend({"batch_indirect_draw_validation_at_submit",
+                                     "skip_unchanged_indirect_draw_validation"}));
 
 class DrawIndirectUsingFirstVertexTest : public DawnTest {
   protected:
@@ -26,6 +26,7 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <algorithm>
+#include <cstring>
 #include <limits>
 #include <string>
 #include <vector>
@@ -843,6 +844,39 @@ TEST_P(MaxLimitTests, MaxBufferSizes) {
     GetAdapter().SetUseTieredLimits(false);
 }
 
+// Test WriteBuffer with a size close to the adapter's maxBufferSize, which usually isn't a power of
+// two, so that the staging buffer of the upload can't be rounded up past it.
+TEST_P(MaxLimitTests, WriteBufferNearMaxBufferSize) {
+    uint64_t maxBufferSize = GetSupportedLimits().limits.maxBufferSize;
+    // Keep the memory used by the test reasonable.
+    DAWN_TEST_UNSUPPORTED_IF(maxBufferSize > uint64_t(4) * 1024 * 1024 * 1024);
+
+    device.PushErrorScope(wgpu::ErrorFilter::OutOfMemory);
+
+    wgpu::BufferDescriptor descriptor;
+    descriptor.size = maxBufferSize & ~uint64_t(3);
+    descriptor.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+    wgpu::Buffer buffer = device.CreateBuffer(&descriptor);
+
+    // Skip the first word so that the size of the upload isn't a size class either.
+    constexpr uint64_t kOffset = 4;
+    uint64_t writeSize = descriptor.size - kOffset;
+    std::vector<uint8_t> data(writeSize, 0);
+    uint32_t lastValue = 0x01020304;
+    memcpy(data.data() + writeSize - sizeof(lastValue), &lastValue, sizeof(lastValue));
+    queue.WriteBuffer(buffer, kOffset, data.data(), writeSize);
+
+    WGPUErrorType oomResult;
+    device.PopErrorScope([](WGPUErrorType type, const char*,
+                            void* userdata) { *static_cast<WGPUErrorType*>(userdata) = type; },
+                         &oomResult);
+    device.Tick();
+    FlushWire();
+    DAWN_TEST_UNSUPPORTED_IF(oomResult == WGPUErrorType_OutOfMemory);
+
+    EXPECT_BUFFER_U32_EQ(lastValue, buffer, descriptor.size - sizeof(lastValue));
+}
+
 DAWN_INSTANTIATE_TEST(MaxLimitTests,
                       D3D11Backend(),
                       D3D12Backend(),
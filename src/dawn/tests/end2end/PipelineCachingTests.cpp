@@ -670,5 +670,41 @@ DAWN_INSTANTIATE_TEST(SinglePipelineCachingTests,
                       OpenGLESBackend(),
                       VulkanBackend());
 
+class MonolithicPipelineCachingTests : public PipelineCachingTests {
+  protected:
+    void SetUp() override {
+        PipelineCachingTests::SetUp();
+        // Releasing the device through the wire doesn't destroy it synchronously.
+        DAWN_TEST_UNSUPPORTED_IF(UsesWire());
+    }
+
+    void CreateComputePipelines(const wgpu::Device& device) {
+        for (std::string_view shader : {kComputeShaderDefault, kComputeShaderMultipleEntryPoints}) {
+            wgpu::ComputePipelineDescriptor desc;
+            desc.compute.module = utils::CreateShaderModule(device, shader.data());
+            desc.compute.entryPoint = "main";
+            device.CreateComputePipeline(&desc);
+        }
+    }
+};
+
+// Tests that all the pipelines of a device are stored in a single blob that is written when the
+// device is destroyed at the latest, and loaded when the next device is created.
+TEST_P(MonolithicPipelineCachingTests, PipelinesShareOneBlob) {
+    // Creating the pipelines only writes out the shader modules.
+    wgpu::Device device = CreateDevice();
+    EXPECT_CACHE_STATS(mMockCache, Hit(0), Add(2 * counts.shaderModule),
+                       CreateComputePipelines(device));
+    EXPECT_CACHE_STATS(mMockCache, Hit(0), Add(1), device = nullptr);
+
+    // The next device loads the shared blob and hits the cache for the shader modules.
+    EXPECT_CACHE_STATS(mMockCache, Hit(1), Add(0), device = CreateDevice());
+    EXPECT_CACHE_STATS(mMockCache, Hit(2 * counts.shaderModule), Add(0),
+                       CreateComputePipelines(device));
+}
+
+DAWN_INSTANTIATE_TEST(MonolithicPipelineCachingTests,
+                      VulkanBackend({"vulkan_monolithic_pipeline_cache"}));
+
 }  // anonymous namespace
 }  // namespace dawn
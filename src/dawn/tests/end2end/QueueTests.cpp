@@ -25,6 +25,7 @@
 // OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <array>
 #include <vector>
 
 #include "dawn/common/Math.h"
@@ -52,7 +53,8 @@ DAWN_INSTANTIATE_TEST(QueueTests,
                       NullBackend(),
                       OpenGLBackend(),
                       OpenGLESBackend(),
-                      VulkanBackend());
+                      VulkanBackend(),
+                      VulkanBackend({}, {"vulkan_use_timeline_semaphore"}));
 
 class QueueWriteBufferTests : public DawnTest {};
 
@@ -187,6 +189,57 @@ TEST_P(QueueWriteBufferTests, SuperLargeWriteBuffer) {
     EXPECT_BUFFER_U32_RANGE_EQ(expectedData.data(), buffer, 0, kElements);
 }
 
+// Test that super large WriteBuffers reusing the dynamic uploader's pooled staging buffers across
+// submits don't see data from the previous uses of the staging buffer.
+TEST_P(QueueWriteBufferTests, SuperLargeWriteBufferReusesStagingBuffers) {
+    constexpr uint64_t kSize = 12000 * 1000;
+    constexpr uint64_t kElements = 3000 * 1000;
+    wgpu::BufferDescriptor descriptor;
+    descriptor.size = kSize;
+    descriptor.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+    wgpu::Buffer buffer = device.CreateBuffer(&descriptor);
+
+    std::vector<uint32_t> expectedData(kElements);
+    for (uint32_t iteration = 0; iteration < 3; ++iteration) {
+        for (uint32_t i = 0; i < kElements; ++i) {
+            expectedData[i] = i * 3 + iteration;
+        }
+
+        queue.WriteBuffer(buffer, 0, expectedData.data(), kElements * sizeof(uint32_t));
+        EXPECT_BUFFER_U32_RANGE_EQ(expectedData.data(), buffer, 0, kElements);
+        WaitForAllOperations();
+    }
+}
+
+// Test interleaving small and super large WriteBuffers, which use the ring buffers and dedicated
+// staging buffers of the dynamic uploader respectively.
+TEST_P(QueueWriteBufferTests, MixedSizeWriteBuffers) {
+    constexpr uint64_t kLargeElements = 3000 * 1000;
+    constexpr uint64_t kSmallElements = 1000;
+    wgpu::BufferDescriptor descriptor;
+    descriptor.size = kLargeElements * sizeof(uint32_t);
+    descriptor.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+    wgpu::Buffer largeBuffer = device.CreateBuffer(&descriptor);
+    descriptor.size = kSmallElements * sizeof(uint32_t);
+    wgpu::Buffer smallBuffer1 = device.CreateBuffer(&descriptor);
+    wgpu::Buffer smallBuffer2 = device.CreateBuffer(&descriptor);
+
+    std::vector<uint32_t> largeData(kLargeElements);
+    for (uint32_t i = 0; i < kLargeElements; ++i) {
+        largeData[i] = i;
+    }
+    std::vector<uint32_t> smallData1(kSmallElements, 0x01020304);
+    std::vector<uint32_t> smallData2(kSmallElements, 0x05060708);
+
+    queue.WriteBuffer(smallBuffer1, 0, smallData1.data(), kSmallElements * sizeof(uint32_t));
+    queue.WriteBuffer(largeBuffer, 0, largeData.data(), kLargeElements * sizeof(uint32_t));
+    queue.WriteBuffer(smallBuffer2, 0, smallData2.data(), kSmallElements * sizeof(uint32_t));
+
+    EXPECT_BUFFER_U32_RANGE_EQ(smallData1.data(), smallBuffer1, 0, kSmallElements);
+    EXPECT_BUFFER_U32_RANGE_EQ(largeData.data(), largeBuffer, 0, kLargeElements);
+    EXPECT_BUFFER_U32_RANGE_EQ(smallData2.data(), smallBuffer2, 0, kSmallElements);
+}
+
 // Test using the max buffer size. Regression test for dawn:1985. We don't bother validating the
 // results for this case since that would take a lot longer, just that there are no errors.
 TEST_P(QueueWriteBufferTests, MaxBufferSizeWriteBuffer) {
@@ -216,13 +269,86 @@ TEST_P(QueueWriteBufferTests, UnalignedDynamicUploader) {
     EXPECT_BUFFER_U32_EQ(value, buffer, 0);
 }
 
+// Test WriteBuffer right after the GPU wrote the buffer with a copy, once the copy is complete.
+TEST_P(QueueWriteBufferTests, AfterCompletedCopyWrite) {
+    constexpr uint32_t kElements = 4;
+    wgpu::Buffer source = utils::CreateBufferFromData(device, wgpu::BufferUsage::CopySrc,
+                                                      {1u, 2u, 3u, 4u});
+
+    wgpu::BufferDescriptor descriptor;
+    descriptor.size = kElements * sizeof(uint32_t);
+    descriptor.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+    wgpu::Buffer buffer = device.CreateBuffer(&descriptor);
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    encoder.CopyBufferToBuffer(source, 0, buffer, 0, descriptor.size);
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+    WaitForAllOperations();
+
+    // The first write follows the GPU write, the second one follows a completed WriteBuffer.
+    uint32_t value = 10;
+    queue.WriteBuffer(buffer, 4, &value, sizeof(value));
+    WaitForAllOperations();
+    value = 20;
+    queue.WriteBuffer(buffer, 8, &value, sizeof(value));
+
+    std::array<uint32_t, kElements> expected = {1u, 10u, 20u, 4u};
+    EXPECT_BUFFER_U32_RANGE_EQ(expected.data(), buffer, 0, kElements);
+}
+
+// Test WriteBuffer right after the GPU wrote the buffer as a storage buffer, once the compute
+// pass is complete.
+TEST_P(QueueWriteBufferTests, AfterCompletedStorageWrite) {
+    constexpr uint32_t kElements = 4;
+    wgpu::BufferDescriptor descriptor;
+    descriptor.size = kElements * sizeof(uint32_t);
+    descriptor.usage =
+        wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+    wgpu::Buffer buffer = device.CreateBuffer(&descriptor);
+
+    wgpu::ComputePipelineDescriptor pipelineDesc;
+    pipelineDesc.compute.module = utils::CreateShaderModule(device, R"(
+        @group(0) @binding(0) var<storage, read_write> data : array<u32, 4>;
+        @compute @workgroup_size(1) fn main() {
+            for (var i = 0u; i < 4u; i++) {
+                data[i] = i + 1u;
+            }
+        })");
+    wgpu::ComputePipeline pipeline = device.CreateComputePipeline(&pipelineDesc);
+    wgpu::BindGroup bindGroup =
+        utils::MakeBindGroup(device, pipeline.GetBindGroupLayout(0), {{0, buffer}});
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+    pass.SetPipeline(pipeline);
+    pass.SetBindGroup(0, bindGroup);
+    pass.DispatchWorkgroups(1);
+    pass.End();
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+    WaitForAllOperations();
+
+    // The first write follows the GPU write, the second one follows a completed WriteBuffer.
+    uint32_t value = 10;
+    queue.WriteBuffer(buffer, 0, &value, sizeof(value));
+    WaitForAllOperations();
+    value = 20;
+    queue.WriteBuffer(buffer, 12, &value, sizeof(value));
+
+    std::array<uint32_t, kElements> expected = {10u, 2u, 3u, 20u};
+    EXPECT_BUFFER_U32_RANGE_EQ(expected.data(), buffer, 0, kElements);
+}
+
 DAWN_INSTANTIATE_TEST(QueueWriteBufferTests,
                       D3D11Backend(),
                       D3D12Backend(),
                       MetalBackend(),
                       OpenGLBackend(),
                       OpenGLESBackend(),
-                      VulkanBackend());
+                      VulkanBackend(),
+                      VulkanBackend({"vulkan_direct_write_buffer_on_uma"}),
+                      VulkanBackend({}, {"vulkan_direct_write_buffer_on_uma"}));
 
 // For MinimumDataSpec bytesPerRow and rowsPerImage, compute a default from the copy extent.
 constexpr uint32_t kStrideComputeDefault = 0xFFFF'FFFEul;
@@ -25,6 +25,9 @@
 // OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <array>
+#include <vector>
+
 #include "dawn/tests/DawnTest.h"
 
 #include "dawn/utils/ComboRenderBundleEncoderDescriptor.h"
@@ -215,7 +218,299 @@ DAWN_INSTANTIATE_TEST(RenderBundleTest,
                       MetalBackend(),
                       OpenGLBackend(),
                       OpenGLESBackend(),
-                      VulkanBackend());
+                      VulkanBackend(),
+                      VulkanBackend({"bake_render_bundle_commands"}));
+
+constexpr uint32_t kCellSize = 4;
+constexpr uint32_t kCellsPerRow = 4;
+constexpr uint32_t kCellCount = kCellsPerRow * kCellsPerRow;
+constexpr uint32_t kDynamicStateRTSize = kCellSize * kCellsPerRow;
+constexpr wgpu::TextureFormat kDepthStencilFormat = wgpu::TextureFormat::Depth24PlusStencil8;
+constexpr uint32_t kClearStencil = 1;
+
+// RenderBundleDynamicStateTest tests executing the same render bundles with different dynamic
+// state set by the render pass. The bundle draws a fullscreen triangle with the blend constant as
+// its color, only where the stencil buffer is equal to the stencil reference, so the viewport,
+// the scissor rect, the blend constant and the stencil reference all change what it draws. The
+// render target is split in cells that the bundle is executed in with different state.
+class RenderBundleDynamicStateTest : public DawnTest {
+  protected:
+    void SetUp() override {
+        DawnTest::SetUp();
+
+        wgpu::ShaderModule module = utils::CreateShaderModule(device, R"(
+            @vertex
+            fn vsMain(@builtin(vertex_index) vertexIndex : u32) -> @builtin(position) vec4f {
+                var pos = array(vec2f(-1.0, -1.0), vec2f(3.0, -1.0), vec2f(-1.0, 3.0));
+                return vec4f(pos[vertexIndex], 0.0, 1.0);
+            }
+
+            @fragment fn fsMain() -> @location(0) vec4f {
+                return vec4f(1.0);
+            })");
+
+        wgpu::BlendComponent blendComponent;
+        blendComponent.operation = wgpu::BlendOperation::Add;
+        blendComponent.srcFactor = wgpu::BlendFactor::Constant;
+        blendComponent.dstFactor = wgpu::BlendFactor::Zero;
+
+        wgpu::BlendState blend;
+        blend.color = blendComponent;
+        blend.alpha = blendComponent;
+
+        utils::ComboRenderPipelineDescriptor descriptor;
+        descriptor.vertex.module = module;
+        descriptor.cFragment.module = module;
+        descriptor.cTargets[0].format = wgpu::TextureFormat::RGBA8Unorm;
+        descriptor.cTargets[0].blend = &blend;
+
+        wgpu::DepthStencilState* depthStencil = descriptor.EnableDepthStencil(kDepthStencilFormat);
+        depthStencil->depthWriteEnabled = false;
+        depthStencil->depthCompare = wgpu::CompareFunction::Always;
+        depthStencil->stencilFront.compare = wgpu::CompareFunction::Equal;
+        depthStencil->stencilBack.compare = wgpu::CompareFunction::Equal;
+
+        pipeline = device.CreateRenderPipeline(&descriptor);
+        renderBundle = CreateRenderBundle();
+
+        wgpu::TextureDescriptor textureDesc;
+        textureDesc.size = {kDynamicStateRTSize, kDynamicStateRTSize};
+        textureDesc.format = wgpu::TextureFormat::RGBA8Unorm;
+        textureDesc.usage = wgpu::TextureUsage::RenderAttachment | wgpu::TextureUsage::CopySrc;
+        color = device.CreateTexture(&textureDesc);
+
+        textureDesc.format = kDepthStencilFormat;
+        textureDesc.usage = wgpu::TextureUsage::RenderAttachment;
+        depthStencilTexture = device.CreateTexture(&textureDesc);
+    }
+
+    wgpu::RenderBundle CreateRenderBundle() {
+        utils::ComboRenderBundleEncoderDescriptor desc = {};
+        desc.colorFormatCount = 1;
+        desc.cColorFormats[0] = wgpu::TextureFormat::RGBA8Unorm;
+        desc.depthStencilFormat = kDepthStencilFormat;
+
+        wgpu::RenderBundleEncoder renderBundleEncoder = device.CreateRenderBundleEncoder(&desc);
+        renderBundleEncoder.SetPipeline(pipeline);
+        renderBundleEncoder.Draw(3);
+        return renderBundleEncoder.Finish();
+    }
+
+    utils::ComboRenderPassDescriptor MakeRenderPassDescriptor() {
+        utils::ComboRenderPassDescriptor renderPassInfo({color.CreateView()},
+                                                        depthStencilTexture.CreateView());
+        renderPassInfo.cColorAttachments[0].clearValue = {0.0f, 0.0f, 0.0f, 0.0f};
+        renderPassInfo.cDepthStencilAttachmentInfo.stencilClearValue = kClearStencil;
+        return renderPassInfo;
+    }
+
+    // A different color for each cell, and for each |seed|, that is exactly representable in
+    // RGBA8Unorm.
+    static utils::RGBA8 CellColor(uint32_t cell, uint8_t seed) {
+        return utils::RGBA8(static_cast<uint8_t>(cell * 16), static_cast<uint8_t>(255 - cell * 16),
+                            seed, 255);
+    }
+
+    static void SetCellViewport(wgpu::RenderPassEncoder pass, uint32_t cell) {
+        pass.SetViewport(static_cast<float>(cell % kCellsPerRow * kCellSize),
+                         static_cast<float>(cell / kCellsPerRow * kCellSize), kCellSize, kCellSize,
+                         0.0f, 1.0f);
+    }
+
+    static void SetBlendConstant(wgpu::RenderPassEncoder pass, const utils::RGBA8& rgba) {
+        wgpu::Color blendConstant = {rgba.r / 255.0, rgba.g / 255.0, rgba.b / 255.0,
+                                     rgba.a / 255.0};
+        pass.SetBlendConstant(&blendConstant);
+    }
+
+    // Executes |bundle|, or the default bundle, in |cell| with the given blend constant.
+    void ExecuteBundleInCell(wgpu::RenderPassEncoder pass,
+                             uint32_t cell,
+                             const utils::RGBA8& rgba,
+                             wgpu::RenderBundle bundle = nullptr) {
+        SetCellViewport(pass, cell);
+        SetBlendConstant(pass, rgba);
+        if (bundle == nullptr) {
+            bundle = renderBundle;
+        }
+        pass.ExecuteBundles(1, &bundle);
+    }
+
+    // Draws the same as the bundle without it. The pipeline is reset by ExecuteBundles but the
+    // dynamic state isn't.
+    void DrawDirectly(wgpu::RenderPassEncoder pass, uint32_t drawCount) {
+        pass.SetPipeline(pipeline);
+        for (uint32_t i = 0; i < drawCount; ++i) {
+            pass.Draw(3);
+        }
+    }
+
+    // Checks the color of each cell of the render target.
+    void ExpectCells(const std::array<utils::RGBA8, kCellCount>& cellColors) {
+        std::vector<utils::RGBA8> expected(kDynamicStateRTSize * kDynamicStateRTSize);
+        for (uint32_t y = 0; y < kDynamicStateRTSize; ++y) {
+            for (uint32_t x = 0; x < kDynamicStateRTSize; ++x) {
+                expected[y * kDynamicStateRTSize + x] =
+                    cellColors[y / kCellSize * kCellsPerRow + x / kCellSize];
+            }
+        }
+        EXPECT_TEXTURE_EQ(expected.data(), color, {0, 0},
+                          {kDynamicStateRTSize, kDynamicStateRTSize});
+    }
+
+    wgpu::RenderPipeline pipeline;
+    wgpu::RenderBundle renderBundle;
+    wgpu::Texture color;
+    wgpu::Texture depthStencilTexture;
+};
+
+// Test executing the same bundle with a different viewport, scissor rect, blend constant and
+// stencil reference in the same render pass.
+TEST_P(RenderBundleDynamicStateTest, SameBundleWithDifferentDynamicState) {
+    std::array<utils::RGBA8, kCellCount> expected = {};
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    utils::ComboRenderPassDescriptor renderPassInfo = MakeRenderPassDescriptor();
+    wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPassInfo);
+    pass.SetStencilReference(kClearStencil);
+
+    // Only the viewport and the blend constant change.
+    ExecuteBundleInCell(pass, 0, CellColor(0, 0));
+    expected[0] = CellColor(0, 0);
+    ExecuteBundleInCell(pass, 5, CellColor(5, 0));
+    expected[5] = CellColor(5, 0);
+
+    // The viewport covers the whole render target but the scissor rect restricts the draw to a
+    // cell.
+    pass.SetViewport(0.0f, 0.0f, kDynamicStateRTSize, kDynamicStateRTSize, 0.0f, 1.0f);
+    pass.SetScissorRect(2 * kCellSize, 2 * kCellSize, kCellSize, kCellSize);
+    SetBlendConstant(pass, CellColor(10, 0));
+    pass.ExecuteBundles(1, &renderBundle);
+    expected[10] = CellColor(10, 0);
+    pass.SetScissorRect(0, 0, kDynamicStateRTSize, kDynamicStateRTSize);
+
+    // The stencil test fails with another stencil reference so nothing is drawn.
+    pass.SetStencilReference(kClearStencil + 1);
+    ExecuteBundleInCell(pass, 15, CellColor(15, 0));
+
+    // The same state as a previous execution of the bundle.
+    pass.SetStencilReference(kClearStencil);
+    ExecuteBundleInCell(pass, 5, CellColor(5, 1));
+    expected[5] = CellColor(5, 1);
+
+    pass.End();
+
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+
+    ExpectCells(expected);
+}
+
+// Test executing the same bundle with more distinct dynamic state than backends keep the bundle
+// baked for (4 for Vulkan), so that baked variants are replaced while they are in use, across
+// render passes and submits.
+TEST_P(RenderBundleDynamicStateTest, ManyDifferentDynamicStates) {
+    for (uint8_t seed = 0; seed < 3; ++seed) {
+        std::array<utils::RGBA8, kCellCount> expected;
+
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        utils::ComboRenderPassDescriptor renderPassInfo = MakeRenderPassDescriptor();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPassInfo);
+        pass.SetStencilReference(kClearStencil);
+        for (uint32_t cell = 0; cell < kCellCount; ++cell) {
+            // Every other seed uses the state of the first one, so some executions can reuse the
+            // state the bundle was first executed with.
+            expected[cell] = CellColor(cell, seed % 2);
+            ExecuteBundleInCell(pass, cell, expected[cell]);
+        }
+        pass.End();
+
+        wgpu::CommandBuffer commands = encoder.Finish();
+        queue.Submit(1, &commands);
+
+        ExpectCells(expected);
+    }
+}
+
+// Test executing bundles between direct draws in the same render pass, with enough draws for
+// Vulkan to record the render pass in parallel. The state changes between each of them.
+TEST_P(RenderBundleDynamicStateTest, BundlesMixedWithDirectDraws) {
+    constexpr uint32_t kDrawsPerCell = 40;
+
+    // Bundles are executed before the direct draws in even cells and after them in odd cells.
+    // Run twice with different colors so that none of the executions of the second submit have
+    // the same state as ones of the first.
+    for (uint8_t seed = 0; seed < 2; ++seed) {
+        std::array<utils::RGBA8, kCellCount> expected;
+        const utils::RGBA8 overwrittenColor(255, 255, 255, seed);
+
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        utils::ComboRenderPassDescriptor renderPassInfo = MakeRenderPassDescriptor();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPassInfo);
+        pass.SetStencilReference(kClearStencil);
+        for (uint32_t cell = 0; cell < kCellCount; ++cell) {
+            // Whatever is drawn last in the cell overwrites what was drawn before.
+            expected[cell] = CellColor(cell, seed);
+            if (cell % 2 == 0) {
+                ExecuteBundleInCell(pass, cell, overwrittenColor);
+                SetBlendConstant(pass, expected[cell]);
+                DrawDirectly(pass, kDrawsPerCell);
+            } else {
+                SetCellViewport(pass, cell);
+                SetBlendConstant(pass, overwrittenColor);
+                DrawDirectly(pass, kDrawsPerCell);
+                ExecuteBundleInCell(pass, cell, expected[cell]);
+            }
+        }
+        pass.End();
+
+        wgpu::CommandBuffer commands = encoder.Finish();
+        queue.Submit(1, &commands);
+
+        ExpectCells(expected);
+    }
+}
+
+// Test releasing bundles while the commands they were baked into are still pending, then
+// executing new bundles that may reuse their resources.
+TEST_P(RenderBundleDynamicStateTest, BundleReleasedWhileSubmitted) {
+    for (uint8_t seed = 0; seed < 3; ++seed) {
+        std::array<utils::RGBA8, kCellCount> expected;
+        std::vector<wgpu::RenderBundle> bundles = {CreateRenderBundle(), CreateRenderBundle()};
+
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        utils::ComboRenderPassDescriptor renderPassInfo = MakeRenderPassDescriptor();
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPassInfo);
+        pass.SetStencilReference(kClearStencil);
+        for (uint32_t cell = 0; cell < kCellCount; ++cell) {
+            expected[cell] = CellColor(cell, seed);
+            ExecuteBundleInCell(pass, cell, expected[cell], bundles[cell % bundles.size()]);
+        }
+        pass.End();
+
+        wgpu::CommandBuffer commands = encoder.Finish();
+        queue.Submit(1, &commands);
+
+        // Drop every reference to the bundles without waiting for the submit to complete.
+        bundles.clear();
+        commands = nullptr;
+        pass = nullptr;
+        encoder = nullptr;
+
+        ExpectCells(expected);
+    }
+}
+
+DAWN_INSTANTIATE_TEST(RenderBundleDynamicStateTest,
+                      D3D11Backend(),
+                      D3D12Backend(),
+                      MetalBackend(),
+                      OpenGLBackend(),
+                      OpenGLESBackend(),
+                      VulkanBackend(),
+                      VulkanBackend({"bake_render_bundle_commands"}),
+                      VulkanBackend({"bake_render_bundle_commands",
+                                     "vulkan_record_render_passes_in_parallel"}));
 
 }  // anonymous namespace
 }  // namespace dawn
@@ -0,0 +1,248 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <array>
+#include <vector>
+
+#include "dawn/tests/DawnTest.h"
+#include "dawn/utils/ComboRenderBundleEncoderDescriptor.h"
+#include "dawn/utils/ComboRenderPipelineDescriptor.h"
+#include "dawn/utils/WGPUHelpers.h"
+
+namespace dawn {
+namespace {
+
+constexpr uint32_t kRTSize = 64;
+constexpr uint32_t kGridSize = 32;
+constexpr uint32_t kDrawCount = kGridSize * kGridSize;
+
+// Draws a point per draw call so that passes have enough draws to be split into chunks when
+// render passes are recorded in parallel, and checks that state set in one chunk is inherited by
+// the following ones.
+class RenderPassManyDrawsTests : public DawnTest {
+  protected:
+    void SetUp() override {
+        DawnTest::SetUp();
+
+        // Draw i covers the pixel (i % 32, i / 32) of a 32x32 viewport.
+        wgpu::ShaderModule module = utils::CreateShaderModule(device, R"(
+            @group(0) @binding(0) var<uniform> color : vec4f;
+
+            @vertex fn vs(@builtin(vertex_index) index : u32) -> @builtin(position) vec4f {
+                let cell = vec2f(f32(index % 32u), f32(index / 32u)) + vec2f(0.5);
+                return vec4f(cell.x / 16.0 - 1.0, 1.0 - cell.y / 16.0, 0.0, 1.0);
+            }
+
+            @fragment fn fsColor() -> @location(0) vec4f {
+                return color;
+            }
+
+            @fragment fn fsInverted() -> @location(0) vec4f {
+                return vec4f(vec3f(1.0) - color.rgb, 1.0);
+            }
+        )");
+
+        wgpu::BindGroupLayout bgl = utils::MakeBindGroupLayout(
+            device, {{0, wgpu::ShaderStage::Fragment, wgpu::BufferBindingType::Uniform}});
+        wgpu::PipelineLayout pipelineLayout = utils::MakeBasicPipelineLayout(device, &bgl);
+
+        const char* fragmentEntryPoints[] = {"fsColor", "fsInverted"};
+        for (uint32_t i = 0; i < mPipelines.size(); ++i) {
+            utils::ComboRenderPipelineDescriptor descriptor;
+            descriptor.layout = pipelineLayout;
+            descriptor.vertex.module = module;
+            descriptor.vertex.entryPoint = "vs";
+            descriptor.cFragment.module = module;
+            descriptor.cFragment.entryPoint = fragmentEntryPoints[i];
+            descriptor.primitive.topology = wgpu::PrimitiveTopology::PointList;
+            descriptor.cTargets[0].format = utils::BasicRenderPass::kDefaultColorFormat;
+            mPipelines[i] = device.CreateRenderPipeline(&descriptor);
+        }
+
+        const std::array<std::array<float, 4>, 3> colors = {{
+            {1.0f, 0.0f, 0.0f, 1.0f},
+            {0.0f, 1.0f, 0.0f, 1.0f},
+            {0.0f, 0.0f, 1.0f, 1.0f},
+        }};
+        for (uint32_t i = 0; i < colors.size(); ++i) {
+            wgpu::Buffer buffer = utils::CreateBufferFromData(
+                device, colors[i].data(), sizeof(colors[i]), wgpu::BufferUsage::Uniform);
+            mBindGroups[i] = utils::MakeBindGroup(device, bgl, {{0, buffer}});
+        }
+    }
+
+    // Returns the color written by mPipelines[pipeline] with mBindGroups[color].
+    static utils::RGBA8 ExpectedColor(uint32_t pipeline, uint32_t color) {
+        const std::array<utils::RGBA8, 3> colors = {utils::RGBA8::kRed, utils::RGBA8::kGreen,
+                                                    utils::RGBA8::kBlue};
+        utils::RGBA8 expected = colors[color];
+        if (pipeline == 1) {
+            expected.r = 255 - expected.r;
+            expected.g = 255 - expected.g;
+            expected.b = 255 - expected.b;
+        }
+        return expected;
+    }
+
+    std::array<wgpu::RenderPipeline, 2> mPipelines;
+    std::array<wgpu::BindGroup, 3> mBindGroups;
+};
+
+// Test pipeline, bind group, viewport and scissor changes spread over a pass with many draws, with
+// a render bundle in the middle of the pass.
+TEST_P(RenderPassManyDrawsTests, StateChangesAcrossManyDraws) {
+    constexpr uint32_t kBundleBegin = 400;
+    constexpr uint32_t kBundleEnd = 700;
+
+    utils::ComboRenderBundleEncoderDescriptor bundleDesc;
+    bundleDesc.colorFormatCount = 1;
+    bundleDesc.cColorFormats[0] = utils::BasicRenderPass::kDefaultColorFormat;
+    wgpu::RenderBundleEncoder bundleEncoder = device.CreateRenderBundleEncoder(&bundleDesc);
+    bundleEncoder.SetPipeline(mPipelines[0]);
+    bundleEncoder.SetBindGroup(0, mBindGroups[2]);
+    for (uint32_t i = kBundleBegin; i < kBundleEnd; ++i) {
+        bundleEncoder.Draw(1, 1, i);
+    }
+    wgpu::RenderBundle bundle = bundleEncoder.Finish();
+
+    std::vector<utils::RGBA8> expected(kRTSize * kRTSize, utils::RGBA8(0, 0, 0, 0));
+    uint32_t pipeline = 0;
+    uint32_t color = 0;
+    uint32_t viewportOffset = 0;
+    uint32_t scissorBottom = kRTSize;
+    auto ExpectDraw = [&](uint32_t index, uint32_t drawPipeline, uint32_t drawColor) {
+        uint32_t x = viewportOffset + index % kGridSize;
+        uint32_t y = viewportOffset + index / kGridSize;
+        if (y < scissorBottom) {
+            expected[y * kRTSize + x] = ExpectedColor(drawPipeline, drawColor);
+        }
+    };
+
+    utils::BasicRenderPass renderPass = utils::CreateBasicRenderPass(device, kRTSize, kRTSize);
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass.renderPassInfo);
+    pass.SetViewport(0, 0, kGridSize, kGridSize, 0, 1);
+    pass.SetPipeline(mPipelines[pipeline]);
+    pass.SetBindGroup(0, mBindGroups[color]);
+    for (uint32_t i = 0; i < kDrawCount; ++i) {
+        switch (i) {
+            case 100:
+                pipeline = 1;
+                pass.SetPipeline(mPipelines[pipeline]);
+                break;
+            case 200:
+                scissorBottom = 60;
+                pass.SetScissorRect(0, 0, kRTSize, scissorBottom);
+                break;
+            case 250:
+                color = 1;
+                pass.SetBindGroup(0, mBindGroups[color]);
+                break;
+            case 300:
+                viewportOffset = kGridSize;
+                pass.SetViewport(viewportOffset, viewportOffset, kGridSize, kGridSize, 0, 1);
+                break;
+            case kBundleBegin:
+                pass.ExecuteBundles(1, &bundle);
+                break;
+            case kBundleEnd:
+                // Executing bundles resets the pipeline and bind groups but not the viewport and
+                // scissor.
+                pipeline = 0;
+                pass.SetPipeline(mPipelines[pipeline]);
+                pass.SetBindGroup(0, mBindGroups[color]);
+                break;
+            case 850:
+                pipeline = 1;
+                pass.SetPipeline(mPipelines[pipeline]);
+                break;
+            case 950:
+                scissorBottom = 62;
+                pass.SetScissorRect(0, 0, kRTSize, scissorBottom);
+                break;
+            default:
+                break;
+        }
+
+        if (i >= kBundleBegin && i < kBundleEnd) {
+            ExpectDraw(i, 0, 2);
+        } else {
+            pass.Draw(1, 1, i);
+            ExpectDraw(i, pipeline, color);
+        }
+    }
+    pass.End();
+
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+
+    EXPECT_TEXTURE_EQ(expected.data(), renderPass.color, {0, 0}, {kRTSize, kRTSize});
+}
+
+// Test several passes with many draws in the same command buffer.
+TEST_P(RenderPassManyDrawsTests, ManyPassesWithManyDraws) {
+    std::vector<utils::RGBA8> expected(kRTSize * kRTSize, utils::RGBA8(0, 0, 0, 0));
+    utils::BasicRenderPass renderPass = utils::CreateBasicRenderPass(device, kRTSize, kRTSize);
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    for (uint32_t quadrant = 0; quadrant < 4; ++quadrant) {
+        uint32_t offsetX = (quadrant % 2) * kGridSize;
+        uint32_t offsetY = (quadrant / 2) * kGridSize;
+        uint32_t color = quadrant % static_cast<uint32_t>(mBindGroups.size());
+
+        if (quadrant > 0) {
+            renderPass.renderPassInfo.cColorAttachments[0].loadOp = wgpu::LoadOp::Load;
+        }
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass.renderPassInfo);
+        pass.SetViewport(offsetX, offsetY, kGridSize, kGridSize, 0, 1);
+        pass.SetPipeline(mPipelines[0]);
+        pass.SetBindGroup(0, mBindGroups[color]);
+        for (uint32_t i = 0; i < kDrawCount; ++i) {
+            pass.Draw(1, 1, i);
+            uint32_t x = offsetX + i % kGridSize;
+            uint32_t y = offsetY + i / kGridSize;
+            expected[y * kRTSize + x] = ExpectedColor(0, color);
+        }
+        pass.End();
+    }
+
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+
+    EXPECT_TEXTURE_EQ(expected.data(), renderPass.color, {0, 0}, {kRTSize, kRTSize});
+}
+
+DAWN_INSTANTIATE_TEST(RenderPassManyDrawsTests,
+                      D3D11Backend(),
+                      D3D12Backend(),
+                      MetalBackend(),
+                      OpenGLBackend(),
+                      OpenGLESBackend(),
+                      VulkanBackend(),
+                      VulkanBackend({"vulkan_record_render_passes_in_parallel"}));
+
+}  // anonymous namespace
+}  // namespace dawn
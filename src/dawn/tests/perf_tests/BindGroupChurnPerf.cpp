@@ -0,0 +1,164 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <vector>
+
+#include "dawn/common/Math.h"
+#include "dawn/tests/perf_tests/DawnPerfTest.h"
+#include "dawn/utils/WGPUHelpers.h"
+
+namespace dawn {
+namespace {
+
+constexpr unsigned int kNumIterations = 20;
+constexpr uint64_t kUniformSize = 16;
+
+enum class BindGroupContents {
+    // Every bind group references a different range of the buffer.
+    Unique,
+    // All the bind groups reference the same range of the buffer.
+    Identical,
+};
+
+struct BindGroupChurnParams : AdapterTestParam {
+    BindGroupChurnParams(const AdapterTestParam& param,
+                         uint32_t bindGroupsPerStepIn,
+                         BindGroupContents contentsIn)
+        : AdapterTestParam(param), bindGroupsPerStep(bindGroupsPerStepIn), contents(contentsIn) {}
+    uint32_t bindGroupsPerStep;
+    BindGroupContents contents;
+};
+
+std::ostream& operator<<(std::ostream& ostream, const BindGroupChurnParams& param) {
+    ostream << static_cast<const AdapterTestParam&>(param);
+    ostream << "_bindGroups_" << param.bindGroupsPerStep;
+    switch (param.contents) {
+        case BindGroupContents::Unique:
+            ostream << "_Unique";
+            break;
+        case BindGroupContents::Identical:
+            ostream << "_Identical";
+            break;
+    }
+    return ostream;
+}
+
+// Test the performance of creating, using and destroying many bind groups every frame, like
+// applications that recreate their bind groups each frame do. The bind groups alternate between
+// two different layouts with the same kinds of bindings so that the backends can share descriptor
+// pools between them.
+class BindGroupChurnPerf : public DawnPerfTestWithParams<BindGroupChurnParams> {
+  public:
+    BindGroupChurnPerf() : DawnPerfTestWithParams(kNumIterations, 1) {}
+    ~BindGroupChurnPerf() override = default;
+
+    void SetUp() override {
+        DawnPerfTestWithParams<BindGroupChurnParams>::SetUp();
+
+        mUniformStride =
+            Align(kUniformSize, GetSupportedLimits().limits.minUniformBufferOffsetAlignment);
+
+        wgpu::BufferDescriptor bufferDesc;
+        bufferDesc.size = mUniformStride * GetParam().bindGroupsPerStep;
+        bufferDesc.usage = wgpu::BufferUsage::Uniform;
+        mBuffer = device.CreateBuffer(&bufferDesc);
+
+        wgpu::ShaderModule module = utils::CreateShaderModule(device, R"(
+            @group(0) @binding(0) var<uniform> a : vec4u;
+            @group(0) @binding(1) var<uniform> b : vec4u;
+            @compute @workgroup_size(1) fn main() {
+                _ = a;
+                _ = b;
+            }
+        )");
+
+        // The layouts differ by their visibility but have the same number of uniform buffers.
+        wgpu::ShaderStage visibilities[] = {
+            wgpu::ShaderStage::Compute,
+            wgpu::ShaderStage::Compute | wgpu::ShaderStage::Fragment,
+        };
+        for (uint32_t i = 0; i < 2; ++i) {
+            mLayouts[i] = utils::MakeBindGroupLayout(
+                device, {{0, visibilities[i], wgpu::BufferBindingType::Uniform},
+                         {1, visibilities[i], wgpu::BufferBindingType::Uniform}});
+
+            wgpu::ComputePipelineDescriptor pipelineDesc;
+            pipelineDesc.layout = utils::MakeBasicPipelineLayout(device, &mLayouts[i]);
+            pipelineDesc.compute.module = module;
+            mPipelines[i] = device.CreateComputePipeline(&pipelineDesc);
+        }
+    }
+
+  private:
+    void Step() override {
+        const BindGroupChurnParams& params = GetParam();
+
+        for (unsigned int iteration = 0; iteration < kNumIterations; ++iteration) {
+            std::vector<wgpu::BindGroup> bindGroups(params.bindGroupsPerStep);
+            for (uint32_t i = 0; i < params.bindGroupsPerStep; ++i) {
+                uint64_t offset = 0;
+                if (params.contents == BindGroupContents::Unique) {
+                    offset = i * mUniformStride;
+                }
+                bindGroups[i] = utils::MakeBindGroup(device, mLayouts[i % 2],
+                                                     {{0, mBuffer, offset, kUniformSize},
+                                                      {1, mBuffer, offset, kUniformSize}});
+            }
+
+            wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+            wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+            for (uint32_t i = 0; i < params.bindGroupsPerStep; ++i) {
+                pass.SetPipeline(mPipelines[i % 2]);
+                pass.SetBindGroup(0, bindGroups[i]);
+                pass.DispatchWorkgroups(1);
+            }
+            pass.End();
+            wgpu::CommandBuffer commands = encoder.Finish();
+            queue.Submit(1, &commands);
+
+            // The bind groups are released at the end of the iteration and recreated in the next
+            // one.
+        }
+    }
+
+    uint64_t mUniformStride = 0;
+    wgpu::Buffer mBuffer;
+    wgpu::BindGroupLayout mLayouts[2];
+    wgpu::ComputePipeline mPipelines[2];
+};
+
+TEST_P(BindGroupChurnPerf, Run) {
+    RunTest();
+}
+
+DAWN_INSTANTIATE_TEST_P(BindGroupChurnPerf,
+                        {D3D12Backend(), MetalBackend(), OpenGLBackend(), VulkanBackend()},
+                        {64, 1024},
+                        {BindGroupContents::Unique, BindGroupContents::Identical});
+
+}  // anonymous namespace
+}  // namespace dawn
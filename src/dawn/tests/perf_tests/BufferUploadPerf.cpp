@@ -25,6 +25,7 @@
 // OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <algorithm>
 #include <vector>
 
 #include "dawn/tests/perf_tests/DawnPerfTest.h"
@@ -38,6 +39,9 @@ constexpr unsigned int kNumIterations = 50;
 enum class UploadMethod {
     WriteBuffer,
     MappedAtCreation,
+    // Alternates full-size and small WriteBuffers to exercise both the ring buffers and the
+    // dedicated staging buffers of the dynamic uploader.
+    WriteBufferMixedSizes,
 };
 
 // Perf delta exists between ranges [0, 1MB] vs [1MB, MAX_SIZE).
@@ -49,8 +53,11 @@ enum class UploadSize {
 
     BufferSize_4MB = 4 * 1024 * 1024,
     BufferSize_16MB = 16 * 1024 * 1024,
+    BufferSize_64MB = 64 * 1024 * 1024,
 };
 
+constexpr size_t kMixedSmallUploadSize = 4 * 1024;
+
 struct BufferUploadParams : AdapterTestParam {
     BufferUploadParams(const AdapterTestParam& param,
                        UploadMethod uploadMethod,
@@ -71,6 +78,9 @@ std::ostream& operator<<(std::ostream& ostream, const BufferUploadParams& param)
         case UploadMethod::MappedAtCreation:
             ostream << "_MappedAtCreation";
             break;
+        case UploadMethod::WriteBufferMixedSizes:
+            ostream << "_WriteBufferMixedSizes";
+            break;
     }
 
     switch (param.uploadSize) {
@@ -89,6 +99,9 @@ std::ostream& operator<<(std::ostream& ostream, const BufferUploadParams& param)
         case UploadSize::BufferSize_16MB:
             ostream << "_BufferSize_16MB";
             break;
+        case UploadSize::BufferSize_64MB:
+            ostream << "_BufferSize_64MB";
+            break;
     }
 
     return ostream;
@@ -132,6 +145,20 @@ void BufferUploadPerf::Step() {
             break;
         }
 
+        case UploadMethod::WriteBufferMixedSizes: {
+            size_t smallUploadSize = std::min(data.size(), kMixedSmallUploadSize);
+            for (unsigned int i = 0; i < kNumIterations; ++i) {
+                queue.WriteBuffer(dst, 0, data.data(), data.size());
+                for (unsigned int j = 0; j < 4; ++j) {
+                    queue.WriteBuffer(dst, j * smallUploadSize % data.size(), data.data(),
+                                      smallUploadSize);
+                }
+            }
+            // Make sure all WriteBuffer's are flushed.
+            queue.Submit(0, nullptr);
+            break;
+        }
+
         case UploadMethod::MappedAtCreation: {
             wgpu::BufferDescriptor desc = {};
             desc.size = data.size();
@@ -158,12 +185,16 @@ TEST_P(BufferUploadPerf, Run) {
     RunTest();
 }
 
+// The Vulkan variant without vulkan_direct_write_buffer_on_uma measures the staging path on UMA
+// devices, where the CPU copy into the destination buffer is used by default.
 DAWN_INSTANTIATE_TEST_P(BufferUploadPerf,
-                        {D3D12Backend(), MetalBackend(), OpenGLBackend(), VulkanBackend()},
-                        {UploadMethod::WriteBuffer, UploadMethod::MappedAtCreation},
+                        {D3D12Backend(), MetalBackend(), OpenGLBackend(), VulkanBackend(),
+                         VulkanBackend({}, {"vulkan_direct_write_buffer_on_uma"})},
+                        {UploadMethod::WriteBuffer, UploadMethod::MappedAtCreation,
+                         UploadMethod::WriteBufferMixedSizes},
                         {UploadSize::BufferSize_1KB, UploadSize::BufferSize_64KB,
                          UploadSize::BufferSize_1MB, UploadSize::BufferSize_4MB,
-                         UploadSize::BufferSize_16MB});
+                         UploadSize::BufferSize_16MB, UploadSize::BufferSize_64MB});
 
 }  // anonymous namespace
 }  // namespace dawn
@@ -25,6 +25,8 @@
 // OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <memory>
+#include <string>
 #include <tuple>
 #include <vector>
 
@@ -33,6 +35,7 @@
 #include "dawn/common/Math.h"
 #include "dawn/tests/perf_tests/DawnPerfTest.h"
 #include "dawn/utils/ComboRenderPipelineDescriptor.h"
+#include "dawn/utils/Timer.h"
 #include "dawn/utils/WGPUHelpers.h"
 
 namespace dawn {
@@ -85,8 +88,12 @@ enum class BindGroup {
     NoReuse,    // Create a new bind group every time.
     Multiple,   // Use multiple static bind groups.
     Dynamic,    // Use bind groups with dynamic offsets.
+    Materials,  // Cycle through a small set of static bind groups, like per-material bindings.
 };
 
+// The number of bind groups cycled through with BindGroup::Materials.
+constexpr uint32_t kNumMaterials = 8;
+
 enum class VertexBuffer {
     NoChange,  // Use one vertex buffer for all draws.
     Multiple,  // Use multiple static vertex buffers.
@@ -188,6 +195,9 @@ std::ostream& operator<<(std::ostream& ostream, const DrawCallParamForTest& test
         case BindGroup::Dynamic:
             ostream << "_DynamicBindGroup";
             break;
+        case BindGroup::Materials:
+            ostream << "_MaterialBindGroups";
+            break;
     }
 
     switch (param.uniformDataType) {
@@ -236,6 +246,9 @@ class DrawCallPerf : public DawnPerfTestWithParams<DrawCallParamForTest> {
     template <typename Encoder>
     void RecordRenderCommands(Encoder encoder);
 
+    // Updates the uniform data and records the frame's commands without submitting them.
+    wgpu::CommandBuffer RecordFrame();
+
   private:
     void Step() override;
 
@@ -327,6 +340,7 @@ void DrawCallPerf::SetUp() {
         case BindGroup::Redundant:
         case BindGroup::NoReuse:
         case BindGroup::Multiple:
+        case BindGroup::Materials:
             mUniformBindGroupLayout = utils::MakeBindGroupLayout(
                 device,
                 {
@@ -438,6 +452,17 @@ void DrawCallPerf::SetUp() {
             }
             break;
 
+        case BindGroup::Materials:
+            for (uint32_t i = 0; i < kNumMaterials; ++i) {
+                mUniformBuffers[i] = utils::CreateBufferFromData(
+                    device, mUniformBufferData.data() + i * mNumUniformFloats, 3 * sizeof(float),
+                    wgpu::BufferUsage::Uniform);
+
+                mUniformBindGroups[i] = utils::MakeBindGroup(
+                    device, mUniformBindGroupLayout, {{0, mUniformBuffers[i], 0, kUniformSize}});
+            }
+            break;
+
         case BindGroup::Dynamic:
             mUniformBuffers[0] = utils::CreateBufferFromData(
                 device, mUniformBufferData.data(), mUniformBufferData.size() * sizeof(float),
@@ -541,6 +566,10 @@ void DrawCallPerf::RecordRenderCommands(Encoder pass) {
                 pass.SetBindGroup(uniformBindGroupIndex, mUniformBindGroups[i]);
                 break;
 
+            case BindGroup::Materials:
+                pass.SetBindGroup(uniformBindGroupIndex, mUniformBindGroups[i % kNumMaterials]);
+                break;
+
             case BindGroup::Dynamic: {
                 uint32_t dynamicOffset = static_cast<uint32_t>(i * mAlignedUniformSize);
                 pass.SetBindGroup(uniformBindGroupIndex, mUniformBindGroups[0], 1, &dynamicOffset);
@@ -555,7 +584,7 @@ void DrawCallPerf::RecordRenderCommands(Encoder pass) {
     }
 }
 
-void DrawCallPerf::Step() {
+wgpu::CommandBuffer DrawCallPerf::RecordFrame() {
     if (GetParam().uniformDataType == UniformData::Dynamic) {
         // Update uniform data if it's dynamic.
         std::fill(mUniformBufferData.begin(), mUniformBufferData.end(),
@@ -575,6 +604,13 @@ void DrawCallPerf::Step() {
                                       3 * sizeof(float));
                 }
                 break;
+            case BindGroup::Materials:
+                for (uint32_t i = 0; i < kNumMaterials; ++i) {
+                    queue.WriteBuffer(mUniformBuffers[i], 0,
+                                      mUniformBufferData.data() + i * mNumUniformFloats,
+                                      3 * sizeof(float));
+                }
+                break;
             case BindGroup::Dynamic:
                 queue.WriteBuffer(mUniformBuffers[0], 0, mUniformBufferData.data(),
                                   mUniformBufferData.size() * sizeof(float));
@@ -599,7 +635,11 @@ void DrawCallPerf::Step() {
     }
 
     pass.End();
-    wgpu::CommandBuffer commandBuffer = commands.Finish();
+    return commands.Finish();
+}
+
+void DrawCallPerf::Step() {
+    wgpu::CommandBuffer commandBuffer = RecordFrame();
     queue.Submit(1, &commandBuffer);
 }
 
@@ -607,10 +647,74 @@ TEST_P(DrawCallPerf, Run) {
     RunTest();
 }
 
+// Reports how many command blocks are still allocated from the system allocator per frame once
+// the device's command block pool has warmed up.
+TEST_P(DrawCallPerf, CommandBlockAllocations) {
+    constexpr unsigned int kWarmupSteps = 4;
+    constexpr unsigned int kMeasuredSteps = 16;
+
+    for (unsigned int i = 0; i < kWarmupSteps; ++i) {
+        Step();
+        WaitForAllOperations();
+    }
+
+    uint64_t allocationsBefore = native::GetCommandBlockAllocationCountForTesting(backendDevice);
+    for (unsigned int i = 0; i < kMeasuredSteps; ++i) {
+        Step();
+        WaitForAllOperations();
+    }
+    uint64_t allocationsAfter = native::GetCommandBlockAllocationCountForTesting(backendDevice);
+
+    PrintResult("command_block_allocations_per_frame",
+                static_cast<double>(allocationsAfter - allocationsBefore) / kMeasuredSteps,
+                "count", false);
+}
+
+// Reports the CPU time spent in Queue::Submit per frame, which is where the backends record the
+// commands in their native command buffers. When render passes are recorded in parallel, the time
+// is reported for several maximum numbers of recording threads to show how it scales, instead of
+// only for the default that depends on the machine's hardware concurrency.
+TEST_P(DrawCallPerf, SubmitTime) {
+    constexpr unsigned int kWarmupSteps = 4;
+    constexpr unsigned int kMeasuredSteps = 16;
+
+    auto MeasureSubmitTime = [&]() {
+        for (unsigned int i = 0; i < kWarmupSteps; ++i) {
+            Step();
+            WaitForAllOperations();
+        }
+
+        std::unique_ptr<utils::Timer> timer(utils::CreateTimer());
+        double submitTime = 0.0;
+        for (unsigned int i = 0; i < kMeasuredSteps; ++i) {
+            wgpu::CommandBuffer commandBuffer = RecordFrame();
+            timer->Start();
+            queue.Submit(1, &commandBuffer);
+            timer->Stop();
+            submitTime += timer->GetElapsedTime();
+            WaitForAllOperations();
+        }
+        return submitTime * 1e6 / kMeasuredSteps;
+    };
+
+    if (!HasToggleEnabled("vulkan_record_render_passes_in_parallel")) {
+        PrintResult("submit_time", MeasureSubmitTime(), "us", true);
+        return;
+    }
+
+    for (uint32_t threadCount : {1u, 2u, 4u, 8u}) {
+        native::SetMaxRenderPassRecordingChunksForTesting(backendDevice, threadCount);
+        PrintResult("submit_time_" + std::to_string(threadCount) + "_threads", MeasureSubmitTime(),
+                    "us", true);
+    }
+}
+
 DAWN_INSTANTIATE_TEST_P(
     DrawCallPerf,
     {D3D12Backend(), MetalBackend(), OpenGLBackend(), VulkanBackend(),
-     VulkanBackend({"skip_validation"})},
+     VulkanBackend({"skip_validation"}),
+     VulkanBackend({"vulkan_record_render_passes_in_parallel"}),
+     VulkanBackend({"bake_render_bundle_commands"})},
     {
         // Baseline
         MakeParam(),
@@ -620,9 +724,10 @@ DAWN_INSTANTIATE_TEST_P(
         MakeParam(VertexBuffer::Dynamic),   // Dynamic vertex buffer
 
         // Change bind group binding
-        MakeParam(BindGroup::Multiple),  // Multiple bind groups
-        MakeParam(BindGroup::Dynamic),   // Dynamic bind groups
-        MakeParam(BindGroup::NoReuse),   // New bind group per-draw
+        MakeParam(BindGroup::Multiple),   // Multiple bind groups
+        MakeParam(BindGroup::Dynamic),    // Dynamic bind groups
+        MakeParam(BindGroup::NoReuse),    // New bind group per-draw
+        MakeParam(BindGroup::Materials),  // Small set of bind groups reused across draws
 
         // Redundantly set pipeline / bind groups
         MakeParam(Pipeline::Redundant, BindGroup::Redundant),
@@ -632,9 +737,13 @@ DAWN_INSTANTIATE_TEST_P(
                   BindGroup::Multiple),  // Multiple bind groups w/ dynamic pipeline
         MakeParam(Pipeline::Dynamic,
                   BindGroup::Dynamic),  // Dynamic bind groups w/ dynamic pipeline
+        MakeParam(Pipeline::Dynamic,
+                  BindGroup::Materials),  // Material bind groups w/ dynamic pipeline
 
         // ----------- Render Bundles -----------
-        // Command validation / state tracking can be futher optimized / precomputed.
+        // Command validation / state tracking can be futher optimized / precomputed. Compare
+        // with the baseline above to measure repeated bundle execution against direct encoding,
+        // and with bake_render_bundle_commands to replay the bundles translated only once.
         // Use render bundles with varying vertex buffer binding
         MakeParam(VertexBuffer::Multiple,
                   RenderBundle::Yes),  // Multiple vertex buffers w/ render bundle
@@ -0,0 +1,132 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <vector>
+
+#include "dawn/tests/perf_tests/DawnPerfTest.h"
+#include "dawn/utils/TestUtils.h"
+#include "dawn/utils/WGPUHelpers.h"
+
+namespace dawn {
+namespace {
+
+constexpr unsigned int kNumIterations = 10;
+constexpr uint32_t kNumPassesPerEncoder = 64;
+constexpr uint32_t kNumDispatchesPerPass = 16;
+
+struct MultithreadEncodingParams : AdapterTestParam {
+    MultithreadEncodingParams(const AdapterTestParam& param, uint32_t numThreadsIn)
+        : AdapterTestParam(param), numThreads(numThreadsIn) {}
+    uint32_t numThreads;
+};
+
+std::ostream& operator<<(std::ostream& ostream, const MultithreadEncodingParams& param) {
+    ostream << static_cast<const AdapterTestParam&>(param);
+    ostream << "_threads_" << param.numThreads;
+    return ostream;
+}
+
+// Test the throughput of encoding command buffers concurrently. Each thread records its own command
+// encoder full of compute passes, so the only contention between threads is on device-level
+// locking. Ideally the time per step stays flat as the thread count grows.
+class MultithreadEncodingPerf : public DawnPerfTestWithParams<MultithreadEncodingParams> {
+  public:
+    MultithreadEncodingPerf() : DawnPerfTestWithParams(kNumIterations, 1) {}
+    ~MultithreadEncodingPerf() override = default;
+
+    std::vector<wgpu::FeatureName> GetRequiredFeatures() override {
+        std::vector<wgpu::FeatureName> features;
+        if (!UsesWire()) {
+            features.push_back(wgpu::FeatureName::ImplicitDeviceSynchronization);
+        }
+        return features;
+    }
+
+    void SetUp() override {
+        DawnPerfTestWithParams<MultithreadEncodingParams>::SetUp();
+        // DawnWire and the OpenGL backends don't support the thread safe API.
+        DAWN_TEST_UNSUPPORTED_IF(UsesWire());
+        DAWN_TEST_UNSUPPORTED_IF(IsOpenGL() || IsOpenGLES());
+
+        wgpu::ComputePipelineDescriptor pipelineDesc;
+        pipelineDesc.compute.module = utils::CreateShaderModule(device, R"(
+            @group(0) @binding(0) var<storage, read_write> data : array<u32>;
+            @compute @workgroup_size(1) fn main(@builtin(global_invocation_id) id : vec3u) {
+                data[id.x] = data[id.x] + 1u;
+            }
+        )");
+        mPipeline = device.CreateComputePipeline(&pipelineDesc);
+
+        const uint32_t numThreads = GetParam().numThreads;
+        mBindGroups.resize(numThreads);
+        mCommandBuffers.resize(numThreads);
+        for (uint32_t i = 0; i < numThreads; ++i) {
+            // Each thread writes to its own buffer so that the encoders don't share resources.
+            wgpu::BufferDescriptor bufferDesc;
+            bufferDesc.size = 256;
+            bufferDesc.usage = wgpu::BufferUsage::Storage;
+            wgpu::Buffer buffer = device.CreateBuffer(&bufferDesc);
+            mBindGroups[i] =
+                utils::MakeBindGroup(device, mPipeline.GetBindGroupLayout(0), {{0, buffer}});
+        }
+    }
+
+  private:
+    void Step() override {
+        for (unsigned int i = 0; i < kNumIterations; ++i) {
+            utils::RunInParallel(GetParam().numThreads, [this](uint32_t index) {
+                wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+                for (uint32_t pass = 0; pass < kNumPassesPerEncoder; ++pass) {
+                    wgpu::ComputePassEncoder computePass = encoder.BeginComputePass();
+                    computePass.SetPipeline(mPipeline);
+                    computePass.SetBindGroup(0, mBindGroups[index]);
+                    for (uint32_t dispatch = 0; dispatch < kNumDispatchesPerPass; ++dispatch) {
+                        computePass.DispatchWorkgroups(1);
+                    }
+                    computePass.End();
+                }
+                mCommandBuffers[index] = encoder.Finish();
+            });
+            queue.Submit(mCommandBuffers.size(), mCommandBuffers.data());
+        }
+    }
+
+    wgpu::ComputePipeline mPipeline;
+    std::vector<wgpu::BindGroup> mBindGroups;
+    std::vector<wgpu::CommandBuffer> mCommandBuffers;
+};
+
+TEST_P(MultithreadEncodingPerf, Run) {
+    RunTest();
+}
+
+DAWN_INSTANTIATE_TEST_P(MultithreadEncodingPerf,
+                        {D3D12Backend(), MetalBackend(), VulkanBackend()},
+                        {1, 2, 4, 8});
+
+}  // anonymous namespace
+}  // namespace dawn
@@ -0,0 +1,140 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <vector>
+
+#include "dawn/tests/perf_tests/DawnPerfTest.h"
+
+namespace dawn {
+namespace {
+
+constexpr unsigned int kNumIterations = 20;
+
+// The formats, load and store operations used by each color attachment. All of them have at most
+// 8 bytes per sample so that kMaxAttachments of them fit in maxColorAttachmentBytesPerSample.
+constexpr wgpu::TextureFormat kFormats[] = {
+    wgpu::TextureFormat::RGBA8Unorm,  wgpu::TextureFormat::BGRA8Unorm,
+    wgpu::TextureFormat::R8Unorm,     wgpu::TextureFormat::RG8Unorm,
+    wgpu::TextureFormat::R32Float,    wgpu::TextureFormat::RG16Float,
+    wgpu::TextureFormat::RGBA16Float, wgpu::TextureFormat::RGB10A2Unorm,
+};
+constexpr wgpu::LoadOp kLoadOps[] = {wgpu::LoadOp::Clear, wgpu::LoadOp::Load};
+constexpr wgpu::StoreOp kStoreOps[] = {wgpu::StoreOp::Store, wgpu::StoreOp::Discard};
+
+constexpr uint32_t kNumFormats = sizeof(kFormats) / sizeof(kFormats[0]);
+constexpr uint32_t kNumAttachmentConfigs = kNumFormats * 2 * 2;
+constexpr uint32_t kMaxAttachments = 3;
+
+struct RenderPassCacheParams : AdapterTestParam {
+    RenderPassCacheParams(const AdapterTestParam& param, uint32_t distinctRenderPassesIn)
+        : AdapterTestParam(param), distinctRenderPasses(distinctRenderPassesIn) {}
+    uint32_t distinctRenderPasses;
+};
+
+std::ostream& operator<<(std::ostream& ostream, const RenderPassCacheParams& param) {
+    ostream << static_cast<const AdapterTestParam&>(param);
+    ostream << "_distinctRenderPasses_" << param.distinctRenderPasses;
+    return ostream;
+}
+
+// Test the performance of beginning render passes whose attachment formats and load/store
+// operations are all different, like applications with many dynamic render targets do. This
+// stresses the backends' render pass caches (and their eviction when they are bounded) with a
+// high query diversity.
+class RenderPassCachePerf : public DawnPerfTestWithParams<RenderPassCacheParams> {
+  public:
+    RenderPassCachePerf() : DawnPerfTestWithParams(kNumIterations, 1) {}
+    ~RenderPassCachePerf() override = default;
+
+    void SetUp() override {
+        DawnPerfTestWithParams<RenderPassCacheParams>::SetUp();
+
+        // Each render pass uses enough attachments for their configurations to all be different.
+        mAttachmentsPerPass = 1;
+        for (uint32_t configs = kNumAttachmentConfigs;
+             configs < GetParam().distinctRenderPasses && mAttachmentsPerPass < kMaxAttachments;
+             configs *= kNumAttachmentConfigs) {
+            mAttachmentsPerPass++;
+        }
+
+        // The same texture can't be used twice in a render pass so create one per attachment
+        // slot and format.
+        for (uint32_t slot = 0; slot < mAttachmentsPerPass; ++slot) {
+            for (uint32_t format = 0; format < kNumFormats; ++format) {
+                wgpu::TextureDescriptor descriptor;
+                descriptor.size = {1, 1};
+                descriptor.format = kFormats[format];
+                descriptor.usage = wgpu::TextureUsage::RenderAttachment;
+                mViews[slot][format] = device.CreateTexture(&descriptor).CreateView();
+            }
+        }
+    }
+
+  private:
+    void Step() override {
+        for (unsigned int iteration = 0; iteration < kNumIterations; ++iteration) {
+            wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+            for (uint32_t i = 0; i < GetParam().distinctRenderPasses; ++i) {
+                std::vector<wgpu::RenderPassColorAttachment> attachments(mAttachmentsPerPass);
+
+                // Decode the attachment configurations from the digits of i in base
+                // kNumAttachmentConfigs.
+                uint32_t configs = i;
+                for (uint32_t slot = 0; slot < mAttachmentsPerPass; ++slot) {
+                    uint32_t config = configs % kNumAttachmentConfigs;
+                    configs /= kNumAttachmentConfigs;
+
+                    attachments[slot].view = mViews[slot][config % kNumFormats];
+                    attachments[slot].loadOp = kLoadOps[(config / kNumFormats) % 2];
+                    attachments[slot].storeOp = kStoreOps[config / (kNumFormats * 2)];
+                }
+
+                wgpu::RenderPassDescriptor renderPass;
+                renderPass.colorAttachmentCount = attachments.size();
+                renderPass.colorAttachments = attachments.data();
+                encoder.BeginRenderPass(&renderPass).End();
+            }
+            wgpu::CommandBuffer commands = encoder.Finish();
+            queue.Submit(1, &commands);
+        }
+    }
+
+    uint32_t mAttachmentsPerPass = 0;
+    wgpu::TextureView mViews[kMaxAttachments][kNumFormats];
+};
+
+TEST_P(RenderPassCachePerf, Run) {
+    RunTest();
+}
+
+DAWN_INSTANTIATE_TEST_P(RenderPassCachePerf,
+                        {D3D12Backend(), MetalBackend(), OpenGLBackend(), VulkanBackend(),
+                         VulkanBackend({"vulkan_bound_render_pass_cache"})},
+                        {16, 1024, 4096});
+
+}  // anonymous namespace
+}  // namespace dawn
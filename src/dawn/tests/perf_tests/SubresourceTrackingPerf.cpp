@@ -53,8 +53,9 @@ std::ostream& operator<<(std::ostream& ostream, const SubresourceTrackingParams&
 
 // Test the performance of Subresource usage and barrier tracking on a case that would generally be
 // difficult. It uses a 2D array texture with mipmaps and updates one of the layers with data from
-// another texture, then generates mipmaps for that layer. It is difficult because it requires
-// tracking the state of individual subresources in the middle of the subresources of that texture.
+// another texture, then generates mipmaps for that layer and samples the whole array. It is
+// difficult because it requires tracking the state of individual subresources in the middle of
+// the subresources of that texture, then iterating over the state of all of them.
 class SubresourceTrackingPerf : public DawnPerfTestWithParams<SubresourceTrackingParams> {
   public:
     static constexpr unsigned int kNumIterations = 50;
@@ -62,9 +63,18 @@ class SubresourceTrackingPerf : public DawnPerfTestWithParams<SubresourceTrackin
     SubresourceTrackingPerf() : DawnPerfTestWithParams(kNumIterations, 1) {}
     ~SubresourceTrackingPerf() override = default;
 
+    wgpu::RequiredLimits GetRequiredLimits(const wgpu::SupportedLimits& supported) override {
+        // Large arrays are above the default limit on the number of array layers.
+        wgpu::RequiredLimits required = {};
+        required.limits.maxTextureArrayLayers = supported.limits.maxTextureArrayLayers;
+        return required;
+    }
+
     void SetUp() override {
         DawnPerfTestWithParams<SubresourceTrackingParams>::SetUp();
         const SubresourceTrackingParams& params = GetParam();
+        DAWN_TEST_UNSUPPORTED_IF(params.arrayLayerCount >
+                                 GetSupportedLimits().limits.maxTextureArrayLayers);
 
         wgpu::TextureDescriptor materialDesc;
         materialDesc.dimension = wgpu::TextureDimension::e2D;
@@ -96,6 +106,22 @@ class SubresourceTrackingPerf : public DawnPerfTestWithParams<SubresourceTrackin
             }
         )");
         mPipeline = device.CreateRenderPipeline(&pipelineDesc);
+
+        pipelineDesc.cFragment.module = utils::CreateShaderModule(device, R"(
+            @group(0) @binding(0) var materials : texture_2d_array<f32>;
+            @fragment fn main() -> @location(0) vec4f {
+                _ = materials;
+                return vec4f(1.0, 0.0, 0.0, 1.0);
+            }
+        )");
+        mArrayPipeline = device.CreateRenderPipeline(&pipelineDesc);
+
+        wgpu::TextureViewDescriptor arrayViewDesc;
+        arrayViewDesc.dimension = wgpu::TextureViewDimension::e2DArray;
+        mArrayBindGroup = utils::MakeBindGroup(device, mArrayPipeline.GetBindGroupLayout(0),
+                                               {{0, mMaterials.CreateView(&arrayViewDesc)}});
+
+        mArrayRenderPass = utils::CreateBasicRenderPass(device, 1, 1);
     }
 
   private:
@@ -146,6 +172,16 @@ class SubresourceTrackingPerf : public DawnPerfTestWithParams<SubresourceTrackin
             pass.End();
         }
 
+        // Sample the whole array like a scene using the materials would.
+        {
+            wgpu::RenderPassEncoder pass =
+                encoder.BeginRenderPass(&mArrayRenderPass.renderPassInfo);
+            pass.SetPipeline(mArrayPipeline);
+            pass.SetBindGroup(0, mArrayBindGroup);
+            pass.Draw(3);
+            pass.End();
+        }
+
         wgpu::CommandBuffer commands = encoder.Finish();
         queue.Submit(1, &commands);
     }
@@ -153,6 +189,9 @@ class SubresourceTrackingPerf : public DawnPerfTestWithParams<SubresourceTrackin
     wgpu::Texture mUploadTexture;
     wgpu::Texture mMaterials;
     wgpu::RenderPipeline mPipeline;
+    wgpu::RenderPipeline mArrayPipeline;
+    wgpu::BindGroup mArrayBindGroup;
+    utils::BasicRenderPass mArrayRenderPass;
 };
 
 TEST_P(SubresourceTrackingPerf, Run) {
@@ -161,7 +200,7 @@ TEST_P(SubresourceTrackingPerf, Run) {
 
 DAWN_INSTANTIATE_TEST_P(SubresourceTrackingPerf,
                         {D3D12Backend(), MetalBackend(), OpenGLBackend(), VulkanBackend()},
-                        {1, 4, 16, 256},
+                        {1, 4, 16, 256, 2048},
                         {2, 3, 8});
 
 }  // anonymous namespace
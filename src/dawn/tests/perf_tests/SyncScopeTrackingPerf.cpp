@@ -0,0 +1,191 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <vector>
+
+#include "dawn/tests/perf_tests/DawnPerfTest.h"
+#include "dawn/utils/ComboRenderPipelineDescriptor.h"
+#include "dawn/utils/WGPUHelpers.h"
+
+namespace dawn {
+namespace {
+
+constexpr unsigned int kNumIterations = 10;
+constexpr uint32_t kBuffersPerBindGroup = 4;
+constexpr uint64_t kUniformSize = 16;
+
+enum class PassType {
+    Render,
+    Compute,
+};
+
+struct SyncScopeTrackingParams : AdapterTestParam {
+    SyncScopeTrackingParams(const AdapterTestParam& param,
+                            PassType passTypeIn,
+                            uint32_t resourcesPerPassIn)
+        : AdapterTestParam(param), passType(passTypeIn), resourcesPerPass(resourcesPerPassIn) {}
+    PassType passType;
+    uint32_t resourcesPerPass;
+};
+
+std::ostream& operator<<(std::ostream& ostream, const SyncScopeTrackingParams& param) {
+    ostream << static_cast<const AdapterTestParam&>(param);
+    switch (param.passType) {
+        case PassType::Render:
+            ostream << "_Render";
+            break;
+        case PassType::Compute:
+            ostream << "_Compute";
+            break;
+    }
+    ostream << "_resources_" << param.resourcesPerPass;
+    return ostream;
+}
+
+// Test the performance of tracking the usage of thousands of distinct resources in a single pass,
+// like scenes that bind a different set of buffers for each of their many draws. In render passes
+// all the resources are tracked in the same synchronization scope, while compute passes build one
+// synchronization scope per dispatch. The bind groups are created up front so that the encoding
+// and the submit of the pass are measured.
+class SyncScopeTrackingPerf : public DawnPerfTestWithParams<SyncScopeTrackingParams> {
+  public:
+    SyncScopeTrackingPerf() : DawnPerfTestWithParams(kNumIterations, 1) {}
+    ~SyncScopeTrackingPerf() override = default;
+
+    void SetUp() override {
+        DawnPerfTestWithParams<SyncScopeTrackingParams>::SetUp();
+        const SyncScopeTrackingParams& params = GetParam();
+
+        wgpu::ShaderStage visibility = params.passType == PassType::Render
+                                           ? wgpu::ShaderStage::Fragment
+                                           : wgpu::ShaderStage::Compute;
+        std::vector<wgpu::BindGroupLayoutEntry> layoutEntries(kBuffersPerBindGroup);
+        for (uint32_t i = 0; i < kBuffersPerBindGroup; ++i) {
+            layoutEntries[i].binding = i;
+            layoutEntries[i].visibility = visibility;
+            layoutEntries[i].buffer.type = wgpu::BufferBindingType::Uniform;
+        }
+        wgpu::BindGroupLayoutDescriptor layoutDesc;
+        layoutDesc.entryCount = layoutEntries.size();
+        layoutDesc.entries = layoutEntries.data();
+        wgpu::BindGroupLayout layout = device.CreateBindGroupLayout(&layoutDesc);
+        wgpu::PipelineLayout pipelineLayout = utils::MakeBasicPipelineLayout(device, &layout);
+
+        // Every buffer is only bound once so that each of them has its own entry in the pass.
+        wgpu::BufferDescriptor bufferDesc;
+        bufferDesc.size = kUniformSize;
+        bufferDesc.usage = wgpu::BufferUsage::Uniform;
+        uint32_t bindGroupCount = params.resourcesPerPass / kBuffersPerBindGroup;
+        for (uint32_t i = 0; i < bindGroupCount; ++i) {
+            std::vector<wgpu::BindGroupEntry> entries(kBuffersPerBindGroup);
+            for (uint32_t j = 0; j < kBuffersPerBindGroup; ++j) {
+                entries[j].binding = j;
+                entries[j].buffer = device.CreateBuffer(&bufferDesc);
+                entries[j].size = kUniformSize;
+            }
+            wgpu::BindGroupDescriptor bindGroupDesc;
+            bindGroupDesc.layout = layout;
+            bindGroupDesc.entryCount = entries.size();
+            bindGroupDesc.entries = entries.data();
+            mBindGroups.push_back(device.CreateBindGroup(&bindGroupDesc));
+        }
+
+        if (params.passType == PassType::Render) {
+            utils::ComboRenderPipelineDescriptor pipelineDesc;
+            pipelineDesc.layout = pipelineLayout;
+            pipelineDesc.vertex.module = utils::CreateShaderModule(device, R"(
+                @vertex fn main() -> @builtin(position) vec4f {
+                    return vec4f(1.0, 0.0, 0.0, 1.0);
+                }
+            )");
+            pipelineDesc.cFragment.module = utils::CreateShaderModule(device, R"(
+                @fragment fn main() -> @location(0) vec4f {
+                    return vec4f(1.0, 0.0, 0.0, 1.0);
+                }
+            )");
+            pipelineDesc.cTargets[0].format = wgpu::TextureFormat::RGBA8Unorm;
+            mRenderPipeline = device.CreateRenderPipeline(&pipelineDesc);
+
+            wgpu::TextureDescriptor textureDesc;
+            textureDesc.size = {1, 1, 1};
+            textureDesc.format = wgpu::TextureFormat::RGBA8Unorm;
+            textureDesc.usage = wgpu::TextureUsage::RenderAttachment;
+            mRenderTarget = device.CreateTexture(&textureDesc).CreateView();
+        } else {
+            wgpu::ComputePipelineDescriptor pipelineDesc;
+            pipelineDesc.layout = pipelineLayout;
+            pipelineDesc.compute.module = utils::CreateShaderModule(device, R"(
+                @compute @workgroup_size(1) fn main() {}
+            )");
+            mComputePipeline = device.CreateComputePipeline(&pipelineDesc);
+        }
+    }
+
+  private:
+    void Step() override {
+        for (unsigned int iteration = 0; iteration < kNumIterations; ++iteration) {
+            wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+            if (GetParam().passType == PassType::Render) {
+                utils::ComboRenderPassDescriptor renderPass({mRenderTarget});
+                wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass);
+                pass.SetPipeline(mRenderPipeline);
+                for (const wgpu::BindGroup& bindGroup : mBindGroups) {
+                    pass.SetBindGroup(0, bindGroup);
+                    pass.Draw(3);
+                }
+                pass.End();
+            } else {
+                wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+                pass.SetPipeline(mComputePipeline);
+                for (const wgpu::BindGroup& bindGroup : mBindGroups) {
+                    pass.SetBindGroup(0, bindGroup);
+                    pass.DispatchWorkgroups(1);
+                }
+                pass.End();
+            }
+            wgpu::CommandBuffer commands = encoder.Finish();
+            queue.Submit(1, &commands);
+        }
+    }
+
+    std::vector<wgpu::BindGroup> mBindGroups;
+    wgpu::TextureView mRenderTarget;
+    wgpu::RenderPipeline mRenderPipeline;
+    wgpu::ComputePipeline mComputePipeline;
+};
+
+TEST_P(SyncScopeTrackingPerf, Run) {
+    RunTest();
+}
+
+DAWN_INSTANTIATE_TEST_P(SyncScopeTrackingPerf,
+                        {D3D12Backend(), MetalBackend(), OpenGLBackend(), VulkanBackend()},
+                        {PassType::Render, PassType::Compute},
+                        {1024, 4096});
+
+}  // anonymous namespace
+}  // namespace dawn
@@ -103,5 +103,31 @@ TEST_F(AsyncTaskTest, Basic) {
     ASSERT_TRUE(idset.empty());
 }
 
+// Post many more tasks than there are worker threads so that the workers get reused.
+TEST_F(AsyncTaskTest, MoreTasksThanWorkers) {
+    platform::Platform platform;
+    std::unique_ptr<platform::WorkerTaskPool> pool = platform.CreateWorkerTaskPool();
+
+    native::AsyncTaskManager taskManager(pool.get());
+    ConcurrentTaskResultQueue taskResultQueue;
+
+    constexpr size_t kTaskCount = 1024u;
+    std::set<uint32_t> idset;
+    for (uint32_t i = 0; i < kTaskCount; ++i) {
+        native::AsyncTask asyncTask([&taskResultQueue, i] { DoTask(&taskResultQueue, i); });
+        taskManager.PostTask(std::move(asyncTask));
+        idset.insert(i);
+    }
+
+    taskManager.WaitAllPendingTasks();
+
+    std::vector<std::unique_ptr<SimpleTaskResult>> results = taskResultQueue.GetAllResults();
+    ASSERT_EQ(kTaskCount, results.size());
+    for (std::unique_ptr<SimpleTaskResult>& result : results) {
+        idset.erase(result->id);
+    }
+    ASSERT_TRUE(idset.empty());
+}
+
 }  // anonymous namespace
 }  // namespace dawn
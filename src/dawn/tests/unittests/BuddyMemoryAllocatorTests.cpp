@@ -67,6 +67,9 @@ class PlaceholderBuddyResourceAllocator {
         return mAllocator.ComputeTotalNumOfHeapsForTesting();
     }
 
+    uint64_t GetHeapCount() const { return mAllocator.GetHeapCount(); }
+    uint64_t GetAllocatedSize() const { return mAllocator.GetAllocatedSize(); }
+
   private:
     PlaceholderResourceHeapAllocator mHeapAllocator;
     BuddyMemoryAllocator mAllocator;
@@ -468,4 +471,37 @@ TEST(BuddyMemoryAllocatorTests, DestroyHeaps) {
     ASSERT_EQ(poolAllocator.GetPoolSizeForTesting(), 0u);
 }
 
+// Verify the fragmentation statistics track the committed heaps and the rounded allocated size.
+TEST(BuddyMemoryAllocatorTests, FragmentationStats) {
+    constexpr uint64_t kHeapSize = 128;
+    constexpr uint64_t kMaxBlockSize = 512;
+    PlaceholderBuddyResourceAllocator allocator(kMaxBlockSize, kHeapSize);
+
+    EXPECT_EQ(allocator.GetHeapCount(), 0u);
+    EXPECT_EQ(allocator.GetAllocatedSize(), 0u);
+
+    // Allocations are rounded up to a power-of-two.
+    ResourceMemoryAllocation allocation1 = allocator.Allocate(48);
+    ASSERT_EQ(allocation1.GetInfo().mMethod, AllocationMethod::kSubAllocated);
+    EXPECT_EQ(allocator.GetHeapCount(), 1u);
+    EXPECT_EQ(allocator.GetAllocatedSize(), 64u);
+
+    // Fill the rest of the first heap and spill in a second one.
+    ResourceMemoryAllocation allocation2 = allocator.Allocate(64);
+    ResourceMemoryAllocation allocation3 = allocator.Allocate(128);
+    ASSERT_EQ(allocation3.GetInfo().mMethod, AllocationMethod::kSubAllocated);
+    EXPECT_EQ(allocator.GetHeapCount(), 2u);
+    EXPECT_EQ(allocator.GetAllocatedSize(), 256u);
+
+    // Freeing a heap's last allocation releases it.
+    allocator.Deallocate(allocation3);
+    EXPECT_EQ(allocator.GetHeapCount(), 1u);
+    EXPECT_EQ(allocator.GetAllocatedSize(), 128u);
+
+    allocator.Deallocate(allocation1);
+    allocator.Deallocate(allocation2);
+    EXPECT_EQ(allocator.GetHeapCount(), 0u);
+    EXPECT_EQ(allocator.GetAllocatedSize(), 0u);
+}
+
 }  // namespace dawn::native
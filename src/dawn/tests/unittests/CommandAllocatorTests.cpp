@@ -513,4 +513,65 @@ TEST(CommandAllocator, AcquireCommandBlocks) {
     iterator.MakeEmptyAsDataWasDestroyed();
 }
 
+// Test that blocks returned to a CommandBlockPool are reused by later allocators.
+TEST(CommandAllocator, PooledBlocksAreReused) {
+    CommandBlockPool pool;
+    constexpr size_t kNumCommands = 10000;
+
+    auto EncodeAndFree = [&] {
+        CommandAllocator allocator(&pool);
+        for (size_t i = 0; i < kNumCommands; ++i) {
+            CommandDraw* draw = allocator.Allocate<CommandDraw>(CommandType::Draw);
+            draw->first = i;
+        }
+
+        CommandIterator iterator(std::move(allocator));
+        CommandType type;
+        size_t count = 0;
+        while (iterator.NextCommandId(&type)) {
+            ASSERT_EQ(type, CommandType::Draw);
+            ASSERT_EQ(iterator.NextCommand<CommandDraw>()->first, count);
+            count++;
+        }
+        ASSERT_EQ(count, kNumCommands);
+        iterator.MakeEmptyAsDataWasDestroyed();
+    };
+
+    EncodeAndFree();
+    uint64_t allocationCount = pool.GetSystemAllocationCountForTesting();
+    ASSERT_GT(allocationCount, 0u);
+
+    // Encoding the same amount of commands again doesn't need new blocks.
+    EncodeAndFree();
+    ASSERT_EQ(pool.GetSystemAllocationCountForTesting(), allocationCount);
+
+    // Trimming keeps the blocks needed for the peak usage since the last trim.
+    pool.Trim();
+    EncodeAndFree();
+    ASSERT_EQ(pool.GetSystemAllocationCountForTesting(), allocationCount);
+
+    // Nothing was in use since the last trim, so all the blocks are freed.
+    pool.Trim();
+    pool.Trim();
+    EncodeAndFree();
+    ASSERT_EQ(pool.GetSystemAllocationCountForTesting(), 2 * allocationCount);
+}
+
+// Test that blocks too large to be pooled are still freed correctly.
+TEST(CommandAllocator, PooledLargeCommands) {
+    CommandBlockPool pool;
+
+    for (int i = 0; i < 2; ++i) {
+        CommandAllocator allocator(&pool);
+        allocator.Allocate<CommandBig>(CommandType::Big);
+        allocator.Allocate<CommandSmall>(CommandType::Small);
+
+        CommandIterator iterator(std::move(allocator));
+        iterator.MakeEmptyAsDataWasDestroyed();
+    }
+
+    // The big command gets its own block each time and isn't recycled.
+    ASSERT_EQ(pool.GetSystemAllocationCountForTesting(), 3u);
+}
+
 }  // namespace dawn::native
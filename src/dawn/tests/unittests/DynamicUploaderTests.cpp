@@ -0,0 +1,64 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <algorithm>
+
+#include "dawn/native/DynamicUploader.h"
+#include "gtest/gtest.h"
+
+namespace dawn::native {
+namespace {
+
+// Test that staging buffer size classes are 4-byte aligned.
+TEST(DynamicUploaderTests, SizeClassIsAligned) {
+    EXPECT_EQ(DynamicUploader::GetStagingBufferSizeClass(1), 4u);
+    EXPECT_EQ(DynamicUploader::GetStagingBufferSizeClass(4), 4u);
+    EXPECT_EQ(DynamicUploader::GetStagingBufferSizeClass(5), 8u);
+    EXPECT_EQ(DynamicUploader::GetStagingBufferSizeClass(17), 20u);
+}
+
+// Test that size classes are spaced 8 per power of two.
+TEST(DynamicUploaderTests, SizeClassSpacing) {
+    constexpr uint64_t kMiB = 1024 * 1024;
+    EXPECT_EQ(DynamicUploader::GetStagingBufferSizeClass(16 * kMiB), 16 * kMiB);
+    EXPECT_EQ(DynamicUploader::GetStagingBufferSizeClass(16 * kMiB + 4), 18 * kMiB);
+    EXPECT_EQ(DynamicUploader::GetStagingBufferSizeClass(18 * kMiB), 18 * kMiB);
+    EXPECT_EQ(DynamicUploader::GetStagingBufferSizeClass(63 * kMiB), 64 * kMiB);
+}
+
+// Test that size classes waste at most 1/8th of the requested size.
+TEST(DynamicUploaderTests, SizeClassWaste) {
+    for (uint64_t size = 4; size < (uint64_t(1) << 32); size = size * 3 / 2 + 4) {
+        uint64_t sizeClass = DynamicUploader::GetStagingBufferSizeClass(size);
+        EXPECT_GE(sizeClass, size);
+        EXPECT_LE(sizeClass - size, std::max(size / 8, uint64_t(4)));
+        EXPECT_EQ(sizeClass, DynamicUploader::GetStagingBufferSizeClass(sizeClass));
+    }
+}
+
+}  // anonymous namespace
+}  // namespace dawn::native
@@ -0,0 +1,186 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dawn/platform/FileCachingInterface.h"
+
+namespace dawn::platform {
+namespace {
+
+class FileCachingInterfaceTests : public testing::Test {
+  protected:
+    void SetUp() override {
+        mPath = testing::TempDir() + "dawn_" +
+                testing::UnitTest::GetInstance()->current_test_info()->name() + ".cache";
+        std::remove(mPath.c_str());
+    }
+
+    void TearDown() override { std::remove(mPath.c_str()); }
+
+    std::unique_ptr<FileCachingInterface> Open(uint64_t maxSize = 1 << 20) {
+        return FileCachingInterface::Create(mPath.c_str(), maxSize);
+    }
+
+    static void Store(FileCachingInterface* cache,
+                      const std::string& key,
+                      const std::string& value) {
+        cache->StoreData(key.data(), key.size(), value.data(), value.size());
+    }
+
+    static std::string Load(FileCachingInterface* cache, const std::string& key) {
+        size_t size = cache->LoadData(key.data(), key.size(), nullptr, 0);
+        std::string value(size, '\0');
+        if (size > 0) {
+            EXPECT_EQ(size, cache->LoadData(key.data(), key.size(), value.data(), size));
+        }
+        return value;
+    }
+
+    std::string mPath;
+};
+
+// Test that stored values can be loaded back, and that missing keys aren't found.
+TEST_F(FileCachingInterfaceTests, StoreAndLoad) {
+    auto cache = Open();
+    if (cache == nullptr) {
+        GTEST_SKIP() << "File caching is not supported on this platform.";
+    }
+
+    Store(cache.get(), "key0", "value0");
+    Store(cache.get(), "key1", "a longer value1");
+    EXPECT_EQ(Load(cache.get(), "key0"), "value0");
+    EXPECT_EQ(Load(cache.get(), "key1"), "a longer value1");
+    EXPECT_EQ(Load(cache.get(), "key2"), "");
+
+    // Storing a key again replaces its value.
+    Store(cache.get(), "key0", "new value0");
+    EXPECT_EQ(Load(cache.get(), "key0"), "new value0");
+    EXPECT_EQ(cache->GetEntryCountForTesting(), 2u);
+
+    // Loading into a buffer that is too small fails.
+    char small[2];
+    EXPECT_EQ(cache->LoadData("key0", 4, small, sizeof(small)), 0u);
+}
+
+// Test that the entries are persisted when the file is reopened.
+TEST_F(FileCachingInterfaceTests, PersistsAcrossReopen) {
+    auto cache = Open();
+    if (cache == nullptr) {
+        GTEST_SKIP() << "File caching is not supported on this platform.";
+    }
+    Store(cache.get(), "key0", "value0");
+    Store(cache.get(), "key1", "value1");
+    Store(cache.get(), "key0", "new value0");
+    cache = nullptr;
+
+    cache = Open();
+    ASSERT_NE(cache, nullptr);
+    EXPECT_EQ(cache->GetEntryCountForTesting(), 2u);
+    EXPECT_EQ(Load(cache.get(), "key0"), "new value0");
+    EXPECT_EQ(Load(cache.get(), "key1"), "value1");
+}
+
+// Test that the file is only opened by one cache at a time.
+TEST_F(FileCachingInterfaceTests, ExclusiveAccess) {
+    auto cache = Open();
+    if (cache == nullptr) {
+        GTEST_SKIP() << "File caching is not supported on this platform.";
+    }
+    EXPECT_EQ(Open(), nullptr);
+    cache = nullptr;
+    EXPECT_NE(Open(), nullptr);
+}
+
+// Test that the least recently used entries are evicted to keep the file within its budget.
+TEST_F(FileCachingInterfaceTests, EvictsLeastRecentlyUsed) {
+    constexpr uint64_t kMaxSize = 1024;
+    auto cache = Open(kMaxSize);
+    if (cache == nullptr) {
+        GTEST_SKIP() << "File caching is not supported on this platform.";
+    }
+
+    const std::string value(100, 'x');
+    Store(cache.get(), "key0", value);
+    Store(cache.get(), "key1", value);
+    for (int i = 2; i < 20; ++i) {
+        // Keep key0 the most recently used entry.
+        EXPECT_EQ(Load(cache.get(), "key0"), value);
+        Store(cache.get(), "key" + std::to_string(i), value);
+        EXPECT_LE(cache->GetFileSizeForTesting(), kMaxSize);
+    }
+
+    EXPECT_EQ(Load(cache.get(), "key0"), value);
+    EXPECT_EQ(Load(cache.get(), "key1"), "");
+    EXPECT_EQ(Load(cache.get(), "key19"), value);
+    EXPECT_LT(cache->GetEntryCountForTesting(), 20u);
+
+    // Values too large for the budget are not stored.
+    Store(cache.get(), "big", std::string(kMaxSize, 'y'));
+    EXPECT_EQ(Load(cache.get(), "big"), "");
+
+    // The compacted file can be reopened.
+    size_t entryCount = cache->GetEntryCountForTesting();
+    cache = nullptr;
+    cache = Open(kMaxSize);
+    ASSERT_NE(cache, nullptr);
+    EXPECT_EQ(cache->GetEntryCountForTesting(), entryCount);
+    EXPECT_EQ(Load(cache.get(), "key0"), value);
+}
+
+// Test that a torn record at the end of the file is discarded when it is reopened.
+TEST_F(FileCachingInterfaceTests, TruncatesTornRecord) {
+    auto cache = Open();
+    if (cache == nullptr) {
+        GTEST_SKIP() << "File caching is not supported on this platform.";
+    }
+    Store(cache.get(), "key0", "value0");
+    uint64_t fileSize = cache->GetFileSizeForTesting();
+    cache = nullptr;
+
+    FILE* file = fopen(mPath.c_str(), "ab");
+    ASSERT_NE(file, nullptr);
+    const std::vector<uint8_t> garbage = {0x44, 0x4e, 0x57, 0x52, 0xff, 0xff};
+    fwrite(garbage.data(), 1, garbage.size(), file);
+    fclose(file);
+
+    cache = Open();
+    ASSERT_NE(cache, nullptr);
+    EXPECT_EQ(cache->GetFileSizeForTesting(), fileSize);
+    EXPECT_EQ(Load(cache.get(), "key0"), "value0");
+
+    Store(cache.get(), "key1", "value1");
+    EXPECT_EQ(Load(cache.get(), "key1"), "value1");
+}
+
+}  // anonymous namespace
+}  // namespace dawn::platform
@@ -0,0 +1,304 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "dawn/common/Platform.h"
+#include "dawn/utils/SharedMemory.h"
+#include "dawn/utils/SharedMemoryCommandBuffer.h"
+#include "gtest/gtest.h"
+
+#if DAWN_PLATFORM_IS(POSIX)
+#include <unistd.h>
+#endif
+
+namespace dawn::utils {
+namespace {
+
+// Shared memory is only implemented on POSIX platforms.
+#if DAWN_PLATFORM_IS(POSIX)
+
+// Commands used by these tests start with their size and a sequence number, followed by bytes
+// derived from the sequence number.
+struct TestCommandHeader {
+    uint32_t size;
+    uint32_t sequence;
+};
+
+void WriteTestCommand(void* dst, uint32_t size, uint32_t sequence) {
+    TestCommandHeader header = {size, sequence};
+    memcpy(dst, &header, sizeof(header));
+    for (uint32_t i = sizeof(header); i < size; ++i) {
+        static_cast<uint8_t*>(dst)[i] = static_cast<uint8_t>(sequence + i);
+    }
+}
+
+class TestCommandHandler : public dawn::wire::CommandHandler {
+  public:
+    const volatile char* HandleCommands(const volatile char* commands, size_t size) override {
+        if (mFail) {
+            return nullptr;
+        }
+        while (size >= sizeof(TestCommandHeader)) {
+            TestCommandHeader header;
+            for (size_t i = 0; i < sizeof(header); ++i) {
+                reinterpret_cast<char*>(&header)[i] = commands[i];
+            }
+            if (header.size < sizeof(header) || header.size > size) {
+                return nullptr;
+            }
+            for (uint32_t i = sizeof(header); i < header.size; ++i) {
+                uint8_t expected = static_cast<uint8_t>(header.sequence + i);
+                if (static_cast<uint8_t>(commands[i]) != expected) {
+                    return nullptr;
+                }
+            }
+            mSequences.push_back(header.sequence);
+            commands += header.size;
+            size -= header.size;
+        }
+        return size == 0 ? commands : nullptr;
+    }
+
+    void SetFail() { mFail = true; }
+    const std::vector<uint32_t>& GetSequences() const { return mSequences; }
+
+  private:
+    bool mFail = false;
+    std::vector<uint32_t> mSequences;
+};
+
+class SharedMemoryCommandBufferTests : public testing::Test {
+  protected:
+    void CreateRing(size_t capacity) {
+        std::unique_ptr<SharedMemory> memory = SharedMemory::Create(
+            SharedMemoryCommandSerializer::GetRequiredSharedMemorySize(capacity));
+        ASSERT_NE(memory, nullptr);
+        std::unique_ptr<SharedMemory> consumerMemory =
+            SharedMemory::Map(dup(memory->GetFD()), memory->GetSize());
+        ASSERT_NE(consumerMemory, nullptr);
+
+        mSerializer = SharedMemoryCommandSerializer::Create(std::move(memory));
+        ASSERT_NE(mSerializer, nullptr);
+        mReceiver = SharedMemoryCommandReceiver::Create(std::move(consumerMemory));
+        ASSERT_NE(mReceiver, nullptr);
+    }
+
+    bool SerializeTestCommand(uint32_t size, uint32_t sequence) {
+        void* dst = mSerializer->GetCmdSpace(size);
+        if (dst == nullptr) {
+            return false;
+        }
+        WriteTestCommand(dst, size, sequence);
+        return true;
+    }
+
+    std::unique_ptr<SharedMemoryCommandSerializer> mSerializer;
+    std::unique_ptr<SharedMemoryCommandReceiver> mReceiver;
+    TestCommandHandler mHandler;
+};
+
+// Test that flushed commands are received in order and unflushed ones aren't visible.
+TEST_F(SharedMemoryCommandBufferTests, Basic) {
+    CreateRing(4096);
+    ASSERT_FALSE(HasFatalFailure());
+
+    ASSERT_TRUE(SerializeTestCommand(16, 0));
+    ASSERT_TRUE(SerializeTestCommand(64, 1));
+    EXPECT_FALSE(mReceiver->HasCommands());
+
+    EXPECT_TRUE(mSerializer->Flush());
+    EXPECT_TRUE(mReceiver->HasCommands());
+    EXPECT_TRUE(mReceiver->HandleCommands(&mHandler));
+    EXPECT_FALSE(mReceiver->HasCommands());
+    EXPECT_EQ(mHandler.GetSequences(), (std::vector<uint32_t>{0, 1}));
+
+    // Flushing without commands doesn't publish anything.
+    EXPECT_TRUE(mSerializer->Flush());
+    EXPECT_FALSE(mReceiver->HasCommands());
+}
+
+// Test that allocations larger than the maximum allocation size fail.
+TEST_F(SharedMemoryCommandBufferTests, MaximumAllocationSize) {
+    CreateRing(4096);
+    ASSERT_FALSE(HasFatalFailure());
+
+    size_t maxSize = mSerializer->GetMaximumAllocationSize();
+    EXPECT_GE(maxSize, 1024u);
+    EXPECT_LT(maxSize, 4096u);
+    EXPECT_EQ(mSerializer->GetCmdSpace(maxSize + 1), nullptr);
+
+    ASSERT_TRUE(SerializeTestCommand(maxSize, 0));
+    EXPECT_TRUE(mSerializer->Flush());
+    EXPECT_TRUE(mReceiver->HandleCommands(&mHandler));
+    EXPECT_EQ(mHandler.GetSequences(), (std::vector<uint32_t>{0}));
+}
+
+// Test that commands keep their order when the ring wraps around many times.
+TEST_F(SharedMemoryCommandBufferTests, WrapAround) {
+    // Big enough that the three commands serialized between two flushes always fit.
+    CreateRing(1024);
+    ASSERT_FALSE(HasFatalFailure());
+
+    std::vector<uint32_t> expected;
+    for (uint32_t i = 0; i < 200; ++i) {
+        ASSERT_TRUE(SerializeTestCommand(8 + (i * 12) % 96, i));
+        expected.push_back(i);
+        if (i % 3 == 2) {
+            EXPECT_TRUE(mSerializer->Flush());
+            EXPECT_TRUE(mReceiver->HandleCommands(&mHandler));
+        }
+    }
+    EXPECT_TRUE(mSerializer->Flush());
+    EXPECT_TRUE(mReceiver->HandleCommands(&mHandler));
+    EXPECT_EQ(mHandler.GetSequences(), expected);
+}
+
+// Test that a chunk ending exactly at the end of the ring isn't extended past it.
+TEST_F(SharedMemoryCommandBufferTests, ChunkEndingAtEndOfRing) {
+    CreateRing(256);
+    ASSERT_FALSE(HasFatalFailure());
+
+    // Move the cursor to the middle of the ring.
+    ASSERT_TRUE(SerializeTestCommand(120, 0));
+    EXPECT_TRUE(mSerializer->Flush());
+    EXPECT_TRUE(mReceiver->HandleCommands(&mHandler));
+
+    // Fill the second half of the ring with a single chunk, then add more commands.
+    std::vector<uint32_t> expected = {0};
+    for (uint32_t i = 1; i < 20; ++i) {
+        ASSERT_TRUE(SerializeTestCommand(8, i));
+        expected.push_back(i);
+    }
+    EXPECT_TRUE(mSerializer->Flush());
+    EXPECT_TRUE(mReceiver->HandleCommands(&mHandler));
+    EXPECT_EQ(mHandler.GetSequences(), expected);
+}
+
+// Test that the producer waits for the consumer when the ring is full.
+TEST_F(SharedMemoryCommandBufferTests, ProducerWaitsForConsumer) {
+    CreateRing(1024);
+    ASSERT_FALSE(HasFatalFailure());
+
+    constexpr uint32_t kCommandCount = 10000;
+    std::thread consumer([&] {
+        while (!mReceiver->IsDone()) {
+            ASSERT_TRUE(mReceiver->HandleCommands(&mHandler));
+            std::this_thread::yield();
+        }
+    });
+
+    for (uint32_t i = 0; i < kCommandCount; ++i) {
+        ASSERT_TRUE(SerializeTestCommand(8 + (i % 7) * 40, i));
+        if (i % 16 == 0) {
+            ASSERT_TRUE(mSerializer->Flush());
+        }
+    }
+    mSerializer->Close();
+    consumer.join();
+
+    ASSERT_EQ(mHandler.GetSequences().size(), kCommandCount);
+    for (uint32_t i = 0; i < kCommandCount; ++i) {
+        EXPECT_EQ(mHandler.GetSequences()[i], i);
+    }
+}
+
+// Test that a handler error closes the ring and makes the producer fail.
+TEST_F(SharedMemoryCommandBufferTests, HandlerErrorClosesRing) {
+    CreateRing(256);
+    ASSERT_FALSE(HasFatalFailure());
+
+    ASSERT_TRUE(SerializeTestCommand(16, 0));
+    EXPECT_TRUE(mSerializer->Flush());
+    mHandler.SetFail();
+    EXPECT_FALSE(mReceiver->HandleCommands(&mHandler));
+
+    ASSERT_TRUE(SerializeTestCommand(16, 1));
+    EXPECT_FALSE(mSerializer->Flush());
+
+    // Filling the ring doesn't block forever since the consumer is gone.
+    for (uint32_t i = 0; i < 64; ++i) {
+        SerializeTestCommand(64, i);
+    }
+    EXPECT_EQ(mSerializer->GetCmdSpace(64), nullptr);
+}
+
+// Test that the receiver rejects memory that doesn't contain a ring.
+TEST_F(SharedMemoryCommandBufferTests, ReceiverRejectsInvalidMemory) {
+    std::unique_ptr<SharedMemory> memory = SharedMemory::Create(
+        SharedMemoryCommandSerializer::GetRequiredSharedMemorySize(256));
+    ASSERT_NE(memory, nullptr);
+    EXPECT_EQ(SharedMemoryCommandReceiver::Create(std::move(memory)), nullptr);
+}
+
+// Mirrors the start of the ring header so that tests can act as a compromised producer.
+struct RingHeaderForTesting {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+    alignas(64) std::atomic<uint64_t> writeOffset;
+};
+
+// Test that the receiver rejects write offsets that can't contain a chunk header or that are more
+// than the capacity of the ring past the read offset.
+TEST_F(SharedMemoryCommandBufferTests, ReceiverRejectsInvalidWriteOffset) {
+    for (uint64_t writeOffset : {uint64_t(4), uint64_t(2 * 256)}) {
+        std::unique_ptr<SharedMemory> memory = SharedMemory::Create(
+            SharedMemoryCommandSerializer::GetRequiredSharedMemorySize(256));
+        ASSERT_NE(memory, nullptr);
+        std::unique_ptr<SharedMemory> consumerMemory =
+            SharedMemory::Map(dup(memory->GetFD()), memory->GetSize());
+        ASSERT_NE(consumerMemory, nullptr);
+        std::unique_ptr<SharedMemory> hostileMemory =
+            SharedMemory::Map(dup(memory->GetFD()), memory->GetSize());
+        ASSERT_NE(hostileMemory, nullptr);
+
+        mSerializer = SharedMemoryCommandSerializer::Create(std::move(memory));
+        ASSERT_NE(mSerializer, nullptr);
+        mReceiver = SharedMemoryCommandReceiver::Create(std::move(consumerMemory));
+        ASSERT_NE(mReceiver, nullptr);
+
+        // Publish a valid chunk, then overwrite the write offset with a bogus one.
+        ASSERT_TRUE(SerializeTestCommand(16, 0));
+        EXPECT_TRUE(mSerializer->Flush());
+        static_cast<RingHeaderForTesting*>(hostileMemory->GetPointer())
+            ->writeOffset.store(writeOffset);
+
+        EXPECT_FALSE(mReceiver->HandleCommands(&mHandler));
+        EXPECT_TRUE(mHandler.GetSequences().empty());
+    }
+}
+
+#endif  // DAWN_PLATFORM_IS(POSIX)
+
+}  // anonymous namespace
+}  // namespace dawn::utils
@@ -0,0 +1,356 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "dawn/common/Platform.h"
+#include "dawn/utils/SharedMemory.h"
+#include "dawn/utils/SharedMemoryTransferService.h"
+#include "gtest/gtest.h"
+
+#if DAWN_PLATFORM_IS(POSIX)
+#include <unistd.h>
+#endif
+
+namespace dawn::utils {
+namespace {
+
+// Shared memory is only implemented on POSIX platforms.
+#if DAWN_PLATFORM_IS(POSIX)
+
+using ClientReadHandle = dawn::wire::client::MemoryTransferService::ReadHandle;
+using ClientWriteHandle = dawn::wire::client::MemoryTransferService::WriteHandle;
+using ServerReadHandle = dawn::wire::server::MemoryTransferService::ReadHandle;
+using ServerWriteHandle = dawn::wire::server::MemoryTransferService::WriteHandle;
+
+class SharedMemoryTransferServiceTests : public testing::Test {
+  protected:
+    void CreateServices(size_t arenaSize) {
+        std::unique_ptr<SharedMemory> clientArena = SharedMemory::Create(arenaSize);
+        ASSERT_NE(clientArena, nullptr);
+        std::unique_ptr<SharedMemory> serverArena =
+            SharedMemory::Map(dup(clientArena->GetFD()), arenaSize);
+        ASSERT_NE(serverArena, nullptr);
+
+        mClientService = CreateClientSharedMemoryTransferService(std::move(clientArena));
+        mServerService = CreateServerSharedMemoryTransferService(std::move(serverArena));
+    }
+
+    // Creates the server companion of |clientHandle| like the wire does with its create info.
+    template <typename ClientHandle>
+    std::vector<char> SerializeCreate(ClientHandle* clientHandle) {
+        std::vector<char> createInfo(clientHandle->SerializeCreateSize());
+        clientHandle->SerializeCreate(createInfo.data());
+        return createInfo;
+    }
+
+    std::unique_ptr<ServerReadHandle> CreateServerReadHandle(ClientReadHandle* clientHandle) {
+        std::vector<char> createInfo = SerializeCreate(clientHandle);
+        ServerReadHandle* serverHandle = nullptr;
+        if (!mServerService->DeserializeReadHandle(createInfo.data(), createInfo.size(),
+                                                   &serverHandle)) {
+            return nullptr;
+        }
+        return std::unique_ptr<ServerReadHandle>(serverHandle);
+    }
+
+    std::unique_ptr<ServerWriteHandle> CreateServerWriteHandle(ClientWriteHandle* clientHandle) {
+        std::vector<char> createInfo = SerializeCreate(clientHandle);
+        ServerWriteHandle* serverHandle = nullptr;
+        if (!mServerService->DeserializeWriteHandle(createInfo.data(), createInfo.size(),
+                                                    &serverHandle)) {
+            return nullptr;
+        }
+        return std::unique_ptr<ServerWriteHandle>(serverHandle);
+    }
+
+    // Simulates a successful MapAsync(Read) of |serverData| and returns whether the client
+    // accepted the data update.
+    bool TransferRead(ServerReadHandle* serverHandle,
+                      ClientReadHandle* clientHandle,
+                      const std::vector<uint8_t>& serverData,
+                      size_t offset,
+                      size_t size) {
+        std::vector<char> update(serverHandle->SizeOfSerializeDataUpdate(offset, size));
+        serverHandle->SerializeDataUpdate(serverData.data() + offset, offset, size, update.data());
+        return clientHandle->DeserializeDataUpdate(update.empty() ? nullptr : update.data(),
+                                                   update.size(), offset, size);
+    }
+
+    // Simulates an Unmap after a write mapping and returns whether the server accepted the data
+    // update.
+    bool TransferWrite(ClientWriteHandle* clientHandle,
+                       ServerWriteHandle* serverHandle,
+                       size_t offset,
+                       size_t size) {
+        std::vector<char> update(clientHandle->SizeOfSerializeDataUpdate(offset, size));
+        clientHandle->SerializeDataUpdate(update.data(), offset, size);
+        return serverHandle->DeserializeDataUpdate(update.empty() ? nullptr : update.data(),
+                                                   update.size(), offset, size);
+    }
+
+    std::unique_ptr<ClientSharedMemoryTransferService> mClientService;
+    std::unique_ptr<dawn::wire::server::MemoryTransferService> mServerService;
+};
+
+// Test that read data is written by the server in the shared memory seen by the client, without
+// being serialized.
+TEST_F(SharedMemoryTransferServiceTests, Read) {
+    CreateServices(64 * 1024);
+    ASSERT_FALSE(HasFatalFailure());
+
+    constexpr size_t kSize = 1024;
+    std::unique_ptr<ClientReadHandle> clientHandle(mClientService->CreateReadHandle(kSize));
+    ASSERT_NE(clientHandle, nullptr);
+    std::unique_ptr<ServerReadHandle> serverHandle = CreateServerReadHandle(clientHandle.get());
+    ASSERT_NE(serverHandle, nullptr);
+
+    std::vector<uint8_t> serverData(kSize);
+    std::iota(serverData.begin(), serverData.end(), uint8_t(0));
+    EXPECT_EQ(serverHandle->SizeOfSerializeDataUpdate(256, 512), 0u);
+    ASSERT_TRUE(TransferRead(serverHandle.get(), clientHandle.get(), serverData, 256, 512));
+
+    const uint8_t* clientData = static_cast<const uint8_t*>(clientHandle->GetData());
+    EXPECT_EQ(memcmp(clientData + 256, serverData.data() + 256, 512), 0);
+
+    // Out of bounds updates are rejected.
+    EXPECT_FALSE(clientHandle->DeserializeDataUpdate(nullptr, 0, 512, kSize));
+}
+
+// Test that written data is copied by the server directly from the shared memory.
+TEST_F(SharedMemoryTransferServiceTests, Write) {
+    CreateServices(64 * 1024);
+    ASSERT_FALSE(HasFatalFailure());
+
+    constexpr size_t kSize = 1024;
+    std::unique_ptr<ClientWriteHandle> clientHandle(mClientService->CreateWriteHandle(kSize));
+    ASSERT_NE(clientHandle, nullptr);
+    std::unique_ptr<ServerWriteHandle> serverHandle = CreateServerWriteHandle(clientHandle.get());
+    ASSERT_NE(serverHandle, nullptr);
+
+    // The client data starts zeroed.
+    uint8_t* clientData = static_cast<uint8_t*>(clientHandle->GetData());
+    std::vector<uint8_t> zeroes(kSize, 0);
+    EXPECT_EQ(memcmp(clientData, zeroes.data(), kSize), 0);
+
+    std::vector<uint8_t> serverData(kSize, 0xFF);
+    serverHandle->SetTarget(serverData.data());
+    serverHandle->SetDataLength(kSize);
+
+    std::iota(clientData, clientData + kSize, uint8_t(0));
+    EXPECT_EQ(clientHandle->SizeOfSerializeDataUpdate(0, kSize), 0u);
+    ASSERT_TRUE(TransferWrite(clientHandle.get(), serverHandle.get(), 128, 256));
+
+    EXPECT_EQ(memcmp(serverData.data() + 128, clientData + 128, 256), 0);
+    EXPECT_EQ(serverData[127], 0xFF);
+    EXPECT_EQ(serverData[384], 0xFF);
+
+    // Out of bounds updates are rejected.
+    EXPECT_FALSE(serverHandle->DeserializeDataUpdate(nullptr, 0, 512, kSize));
+}
+
+// Test that regions are only reused once both the client and the server handles are destroyed.
+TEST_F(SharedMemoryTransferServiceTests, RegionsReusedAfterBothSidesRelease) {
+    CreateServices(4096);
+    ASSERT_FALSE(HasFatalFailure());
+
+    // Use the whole arena with a shared handle.
+    constexpr size_t kSize = 2048;
+    std::unique_ptr<ClientWriteHandle> clientHandle(mClientService->CreateWriteHandle(kSize));
+    ASSERT_NE(clientHandle, nullptr);
+    void* sharedData = clientHandle->GetData();
+    EXPECT_EQ(clientHandle->SizeOfSerializeDataUpdate(0, kSize), 0u);
+    std::unique_ptr<ServerWriteHandle> serverHandle = CreateServerWriteHandle(clientHandle.get());
+    ASSERT_NE(serverHandle, nullptr);
+
+    // The region can't be reused while the server handle is alive, so the next handle is inline.
+    clientHandle = nullptr;
+    clientHandle.reset(mClientService->CreateWriteHandle(kSize));
+    ASSERT_NE(clientHandle, nullptr);
+    EXPECT_EQ(clientHandle->SizeOfSerializeDataUpdate(0, kSize), kSize);
+    clientHandle = nullptr;
+
+    // Once the server handle is destroyed, the region is reused.
+    serverHandle = nullptr;
+    clientHandle.reset(mClientService->CreateWriteHandle(kSize));
+    ASSERT_NE(clientHandle, nullptr);
+    EXPECT_EQ(clientHandle->SizeOfSerializeDataUpdate(0, kSize), 0u);
+    EXPECT_EQ(clientHandle->GetData(), sharedData);
+}
+
+// Test that the region of a handle that was never serialized is reused as soon as the handle is
+// destroyed.
+TEST_F(SharedMemoryTransferServiceTests, RegionReusedWhenHandleNeverSerialized) {
+    CreateServices(4096);
+    ASSERT_FALSE(HasFatalFailure());
+
+    constexpr size_t kSize = 2048;
+    std::unique_ptr<ClientWriteHandle> clientHandle(mClientService->CreateWriteHandle(kSize));
+    ASSERT_NE(clientHandle, nullptr);
+    void* sharedData = clientHandle->GetData();
+    clientHandle = nullptr;
+
+    clientHandle.reset(mClientService->CreateWriteHandle(kSize));
+    ASSERT_NE(clientHandle, nullptr);
+    EXPECT_EQ(clientHandle->SizeOfSerializeDataUpdate(0, kSize), 0u);
+    EXPECT_EQ(clientHandle->GetData(), sharedData);
+}
+
+// Test that the region of a handle whose command was dropped is reused once the server
+// deserialized a later handle.
+TEST_F(SharedMemoryTransferServiceTests, RegionReusedWhenHandleDropped) {
+    CreateServices(4096);
+    ASSERT_FALSE(HasFatalFailure());
+
+    // The handle is serialized but the server never sees it.
+    constexpr size_t kSize = 2048;
+    std::unique_ptr<ClientWriteHandle> clientHandle(mClientService->CreateWriteHandle(kSize));
+    ASSERT_NE(clientHandle, nullptr);
+    void* sharedData = clientHandle->GetData();
+    SerializeCreate(clientHandle.get());
+    clientHandle = nullptr;
+
+    // The server might still deserialize the handle, so its region isn't reused yet.
+    clientHandle.reset(mClientService->CreateWriteHandle(kSize));
+    ASSERT_NE(clientHandle, nullptr);
+    EXPECT_EQ(clientHandle->SizeOfSerializeDataUpdate(0, kSize), kSize);
+
+    // Once the server deserialized the next handle, the dropped region is reused.
+    std::unique_ptr<ServerWriteHandle> serverHandle = CreateServerWriteHandle(clientHandle.get());
+    ASSERT_NE(serverHandle, nullptr);
+    clientHandle.reset(mClientService->CreateWriteHandle(kSize));
+    ASSERT_NE(clientHandle, nullptr);
+    EXPECT_EQ(clientHandle->SizeOfSerializeDataUpdate(0, kSize), 0u);
+    EXPECT_EQ(clientHandle->GetData(), sharedData);
+}
+
+// Test that the regions the server didn't release are reused once the server is disconnected.
+TEST_F(SharedMemoryTransferServiceTests, RegionsReusedAfterServerDisconnected) {
+    CreateServices(8192);
+    ASSERT_FALSE(HasFatalFailure());
+
+    // Only two regions fit in the arena.
+    constexpr size_t kSize = 3072;
+    std::unique_ptr<ClientWriteHandle> releasedHandle(mClientService->CreateWriteHandle(kSize));
+    ASSERT_NE(releasedHandle, nullptr);
+    std::unique_ptr<ClientWriteHandle> liveHandle(mClientService->CreateWriteHandle(kSize));
+    ASSERT_NE(liveHandle, nullptr);
+    std::unique_ptr<ServerWriteHandle> releasedServerHandle =
+        CreateServerWriteHandle(releasedHandle.get());
+    ASSERT_NE(releasedServerHandle, nullptr);
+    std::unique_ptr<ServerWriteHandle> liveServerHandle = CreateServerWriteHandle(liveHandle.get());
+    ASSERT_NE(liveServerHandle, nullptr);
+    void* releasedData = releasedHandle->GetData();
+    void* liveData = liveHandle->GetData();
+    releasedHandle = nullptr;
+
+    // The server handles are never destroyed, like when the server is lost. The client reuses
+    // the region of the destroyed handle, then the one of the handle destroyed afterwards.
+    mClientService->OnServerDisconnected();
+    std::unique_ptr<ClientWriteHandle> clientHandle(mClientService->CreateWriteHandle(kSize));
+    ASSERT_NE(clientHandle, nullptr);
+    EXPECT_EQ(clientHandle->GetData(), releasedData);
+
+    liveHandle = nullptr;
+    std::unique_ptr<ClientWriteHandle> otherHandle(mClientService->CreateWriteHandle(kSize));
+    ASSERT_NE(otherHandle, nullptr);
+    EXPECT_EQ(otherHandle->GetData(), liveData);
+}
+
+// Test that handles fall back to inline transfers when the arena is full.
+TEST_F(SharedMemoryTransferServiceTests, InlineFallback) {
+    CreateServices(4096);
+    ASSERT_FALSE(HasFatalFailure());
+
+    constexpr size_t kSize = 8192;
+    std::unique_ptr<ClientReadHandle> clientReadHandle(mClientService->CreateReadHandle(kSize));
+    ASSERT_NE(clientReadHandle, nullptr);
+    std::unique_ptr<ServerReadHandle> serverReadHandle =
+        CreateServerReadHandle(clientReadHandle.get());
+    ASSERT_NE(serverReadHandle, nullptr);
+    EXPECT_EQ(serverReadHandle->SizeOfSerializeDataUpdate(0, kSize), kSize);
+
+    std::vector<uint8_t> serverData(kSize);
+    std::iota(serverData.begin(), serverData.end(), uint8_t(3));
+    ASSERT_TRUE(TransferRead(serverReadHandle.get(), clientReadHandle.get(), serverData, 0, kSize));
+    EXPECT_EQ(memcmp(clientReadHandle->GetData(), serverData.data(), kSize), 0);
+
+    std::unique_ptr<ClientWriteHandle> clientWriteHandle(mClientService->CreateWriteHandle(kSize));
+    ASSERT_NE(clientWriteHandle, nullptr);
+    std::unique_ptr<ServerWriteHandle> serverWriteHandle =
+        CreateServerWriteHandle(clientWriteHandle.get());
+    ASSERT_NE(serverWriteHandle, nullptr);
+
+    std::vector<uint8_t> target(kSize);
+    serverWriteHandle->SetTarget(target.data());
+    serverWriteHandle->SetDataLength(kSize);
+    memset(clientWriteHandle->GetData(), 0x42, kSize);
+    ASSERT_TRUE(TransferWrite(clientWriteHandle.get(), serverWriteHandle.get(), 0, kSize));
+    EXPECT_EQ(target, std::vector<uint8_t>(kSize, 0x42));
+}
+
+// Test that the server rejects create info pointing outside of the arena.
+TEST_F(SharedMemoryTransferServiceTests, ServerRejectsInvalidCreateInfo) {
+    CreateServices(4096);
+    ASSERT_FALSE(HasFatalFailure());
+
+    std::unique_ptr<ClientReadHandle> clientHandle(mClientService->CreateReadHandle(1024));
+    ASSERT_NE(clientHandle, nullptr);
+    std::vector<char> createInfo = SerializeCreate(clientHandle.get());
+
+    // The create info is {kind, padding, regionOffset, size, sequence}.
+    auto TryDeserialize = [&](uint64_t regionOffset, uint64_t size) {
+        std::vector<char> info = createInfo;
+        memcpy(info.data() + 8, &regionOffset, sizeof(regionOffset));
+        memcpy(info.data() + 16, &size, sizeof(size));
+        ServerReadHandle* serverHandle = nullptr;
+        bool success =
+            mServerService->DeserializeReadHandle(info.data(), info.size(), &serverHandle);
+        delete serverHandle;
+        return success;
+    };
+
+    EXPECT_TRUE(TryDeserialize(64, 1024));
+    EXPECT_FALSE(TryDeserialize(0, 1024));
+    EXPECT_FALSE(TryDeserialize(4096, 0));
+    EXPECT_FALSE(TryDeserialize(64, 4096));
+    EXPECT_FALSE(TryDeserialize(96, 1024));
+    EXPECT_FALSE(TryDeserialize(128, ~uint64_t(0) - 32));
+
+    ServerReadHandle* serverHandle = nullptr;
+    EXPECT_FALSE(mServerService->DeserializeReadHandle(createInfo.data(), createInfo.size() - 1,
+                                                       &serverHandle));
+}
+
+#endif  // DAWN_PLATFORM_IS(POSIX)
+
+}  // anonymous namespace
+}  // namespace dawn::utils
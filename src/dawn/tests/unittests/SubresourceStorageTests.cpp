@@ -210,10 +210,12 @@ void CheckLayerCompressed(const SubresourceStorage<T>& s,
 
     uint32_t levelCount = s.GetMipLevelCountForTesting();
 
+    // Compressed layers can be part of a run of layers so look for a range containing it.
     bool seen = false;
     s.Iterate([&](const SubresourceRange& range, const T&) {
-        if (range.aspects == aspect && range.layerCount == 1 && range.levelCount == levelCount &&
-            range.baseArrayLayer == layer && range.baseMipLevel == 0) {
+        if (range.aspects == aspect && range.baseArrayLayer <= layer &&
+            layer < range.baseArrayLayer + range.layerCount && range.levelCount == levelCount &&
+            range.baseMipLevel == 0) {
             seen = true;
         }
     });
@@ -710,6 +712,87 @@ TEST(SubresourceStorageTest, AspectDecompressionUpdatesLayer0) {
     EXPECT_EQ(3, s.Get(Aspect::Color, 0, 1));
 }
 
+// Test that partial updates of an array with many layers only split the runs of layers around
+// the updated layers and that the runs are merged back when the data matches again.
+TEST(SubresourceStorageTest, UpdateLargeArrayKeepsLayerRuns) {
+    const uint32_t kLayers = 2048;
+    const uint32_t kLevels = 3;
+    SubresourceStorage<int> s(Aspect::Color, kLayers, kLevels);
+    FakeStorage<int> f(Aspect::Color, kLayers, kLevels);
+
+    auto CountIterateCalls = [&]() {
+        uint32_t count = 0;
+        s.Iterate([&](const SubresourceRange&, const int&) { count++; });
+        return count;
+    };
+
+    // Update a single subresource, only its layer is decompressed.
+    {
+        SubresourceRange range = SubresourceRange::MakeSingle(Aspect::Color, 1000, 1);
+        CallUpdateOnBoth(&s, &f, range, [](const SubresourceRange&, int* data) { *data += 1; });
+    }
+
+    CheckAspectCompressed(s, Aspect::Color, false);
+    CheckLayerCompressed(s, Aspect::Color, 999, true);
+    CheckLayerCompressed(s, Aspect::Color, 1000, false);
+    CheckLayerCompressed(s, Aspect::Color, 1001, true);
+    EXPECT_EQ(CountIterateCalls(), 2 + kLevels);
+
+    // Update a band of full layers containing the decompressed layer. It is recompressed and
+    // merged with the rest of the band.
+    {
+        SubresourceRange range(Aspect::Color, {500, 1000}, {0, kLevels});
+        CallUpdateOnBoth(&s, &f, range, [](const SubresourceRange&, int* data) { *data = 7; });
+    }
+
+    CheckLayerCompressed(s, Aspect::Color, 1000, true);
+    EXPECT_EQ(CountIterateCalls(), 3u);
+
+    // Set the band back to the value of the other layers. All the runs are merged and the aspect
+    // is recompressed.
+    {
+        SubresourceRange range(Aspect::Color, {500, 1000}, {0, kLevels});
+        CallUpdateOnBoth(&s, &f, range, [](const SubresourceRange&, int* data) { *data = 0; });
+    }
+
+    CheckAspectCompressed(s, Aspect::Color, true);
+}
+
+// Test merging two arrays with many layers whose runs of layers alternate, which cuts the layers
+// at every layer boundary. The layers in [0, kLayers / 2) of `s` become equal and are merged back
+// in a single run while the layers after them keep alternating.
+TEST(SubresourceStorageTest, MergeLargeArraysWithAlternatingLayers) {
+    const uint32_t kLayers = 2048;
+    const uint32_t kLevels = 3;
+    SubresourceStorage<int> s(Aspect::Color, kLayers, kLevels);
+    FakeStorage<int> f(Aspect::Color, kLayers, kLevels);
+    SubresourceStorage<int> other(Aspect::Color, kLayers, kLevels);
+
+    // Even layers of the first half of `s` and odd layers of `other` are set to 1. The second
+    // half of `s` is a single run that is split by the runs of `other`.
+    for (uint32_t layer = 0; layer < kLayers; layer++) {
+        SubresourceRange range(Aspect::Color, {layer, 1}, {0, kLevels});
+        if (layer % 2 == 0 && layer < kLayers / 2) {
+            s.Update(range, [](const SubresourceRange&, int* data) { *data = 1; });
+            f.Update(range, [](const SubresourceRange&, int* data) { *data = 1; });
+        }
+        if (layer % 2 == 1) {
+            other.Update(range, [](const SubresourceRange&, int* data) { *data = 1; });
+        }
+    }
+
+    CallMergeOnBoth(&s, &f, other,
+                    [](const SubresourceRange&, int* data, int other) { *data += other; });
+
+    CheckAspectCompressed(s, Aspect::Color, false);
+    CheckLayerCompressed(s, Aspect::Color, 0, true);
+    CheckLayerCompressed(s, Aspect::Color, kLayers - 1, true);
+
+    uint32_t iterateCount = 0;
+    s.Iterate([&](const SubresourceRange&, const int&) { iterateCount++; });
+    EXPECT_EQ(iterateCount, 1 + kLayers / 2);
+}
+
 // Bugs found while testing:
 //  - mLayersCompressed not initialized to true.
 //  - DecompressLayer setting Compressed to true instead of false.
@@ -0,0 +1,202 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "dawn/native/PassResourceUsageTracker.h"
+#include "mocks/BufferMock.h"
+#include "mocks/DawnMockTest.h"
+#include "mocks/TextureMock.h"
+
+namespace dawn::native {
+namespace {
+
+using ::testing::NiceMock;
+
+class PassResourceUsageTrackerTests : public DawnMockTest {
+  protected:
+    Ref<BufferMock> CreateBuffer() {
+        BufferDescriptor desc = {};
+        desc.size = 16;
+        desc.usage = wgpu::BufferUsage::Vertex | wgpu::BufferUsage::Index |
+                     wgpu::BufferUsage::Uniform | wgpu::BufferUsage::Storage;
+        return AcquireRef(new NiceMock<BufferMock>(mDeviceMock, &desc));
+    }
+
+    Ref<TextureMock> CreateTexture() {
+        TextureDescriptor desc = {};
+        desc.usage = wgpu::TextureUsage::TextureBinding | wgpu::TextureUsage::RenderAttachment;
+        desc.size = {4, 4};
+        desc.mipLevelCount = 2;
+        desc.format = wgpu::TextureFormat::RGBA8Unorm;
+        return AcquireRef(new NiceMock<TextureMock>(mDeviceMock, &desc));
+    }
+};
+
+// Test that a resource used by two encoders in an interleaved way, which overwrites its stamp and
+// makes a tracker append it twice, comes out once with the merged usages of each tracker.
+TEST_F(PassResourceUsageTrackerTests, InterleavedTrackersMergeDuplicates) {
+    Ref<BufferMock> buffer0 = CreateBuffer();
+    Ref<BufferMock> buffer1 = CreateBuffer();
+    Ref<TextureMock> texture = CreateTexture();
+    const SubresourceRange mip0 = SubresourceRange::MakeSingle(Aspect::Color, 0, 0);
+    const SubresourceRange mip1 = SubresourceRange::MakeSingle(Aspect::Color, 0, 1);
+
+    SyncScopeUsageTracker trackerA;
+    SyncScopeUsageTracker trackerB;
+
+    trackerA.BufferUsedAs(buffer0.Get(), wgpu::BufferUsage::Vertex);
+    trackerA.TextureRangeUsedAs(texture.Get(), mip0, wgpu::TextureUsage::RenderAttachment);
+    trackerB.BufferUsedAs(buffer0.Get(), wgpu::BufferUsage::Storage, wgpu::ShaderStage::Compute);
+    trackerB.TextureRangeUsedAs(texture.Get(), mip1, wgpu::TextureUsage::TextureBinding,
+                                wgpu::ShaderStage::Compute);
+    trackerA.BufferUsedAs(buffer0.Get(), wgpu::BufferUsage::Index);
+    trackerA.BufferUsedAs(buffer1.Get(), wgpu::BufferUsage::Uniform, wgpu::ShaderStage::Fragment);
+    trackerA.TextureRangeUsedAs(texture.Get(), mip1, wgpu::TextureUsage::TextureBinding,
+                                wgpu::ShaderStage::Fragment);
+    trackerB.BufferUsedAs(buffer1.Get(), wgpu::BufferUsage::Uniform, wgpu::ShaderStage::Compute);
+
+    SyncScopeResourceUsage usageA = trackerA.AcquireSyncScopeUsage();
+    ASSERT_EQ(usageA.buffers.size(), 2u);
+    EXPECT_EQ(usageA.buffers[0], buffer0.Get());
+    EXPECT_EQ(usageA.bufferSyncInfos[0].usage,
+              wgpu::BufferUsage::Vertex | wgpu::BufferUsage::Index);
+    EXPECT_EQ(usageA.bufferSyncInfos[0].shaderStages, wgpu::ShaderStage::None);
+    EXPECT_EQ(usageA.buffers[1], buffer1.Get());
+    EXPECT_EQ(usageA.bufferSyncInfos[1].usage, wgpu::BufferUsage::Uniform);
+    EXPECT_EQ(usageA.bufferSyncInfos[1].shaderStages, wgpu::ShaderStage::Fragment);
+    ASSERT_EQ(usageA.textures.size(), 1u);
+    EXPECT_EQ(usageA.textures[0], texture.Get());
+    EXPECT_EQ(usageA.textureSyncInfos[0].Get(Aspect::Color, 0, 0),
+              (TextureSyncInfo{wgpu::TextureUsage::RenderAttachment, wgpu::ShaderStage::None}));
+    EXPECT_EQ(usageA.textureSyncInfos[0].Get(Aspect::Color, 0, 1),
+              (TextureSyncInfo{wgpu::TextureUsage::TextureBinding, wgpu::ShaderStage::Fragment}));
+
+    SyncScopeResourceUsage usageB = trackerB.AcquireSyncScopeUsage();
+    ASSERT_EQ(usageB.buffers.size(), 2u);
+    EXPECT_EQ(usageB.buffers[0], buffer0.Get());
+    EXPECT_EQ(usageB.bufferSyncInfos[0].usage, wgpu::BufferUsage::Storage);
+    EXPECT_EQ(usageB.bufferSyncInfos[0].shaderStages, wgpu::ShaderStage::Compute);
+    EXPECT_EQ(usageB.buffers[1], buffer1.Get());
+    EXPECT_EQ(usageB.bufferSyncInfos[1].usage, wgpu::BufferUsage::Uniform);
+    EXPECT_EQ(usageB.bufferSyncInfos[1].shaderStages, wgpu::ShaderStage::Compute);
+    ASSERT_EQ(usageB.textures.size(), 1u);
+    EXPECT_EQ(usageB.textures[0], texture.Get());
+    EXPECT_EQ(usageB.textureSyncInfos[0].Get(Aspect::Color, 0, 0),
+              (TextureSyncInfo{wgpu::TextureUsage::None, wgpu::ShaderStage::None}));
+    EXPECT_EQ(usageB.textureSyncInfos[0].Get(Aspect::Color, 0, 1),
+              (TextureSyncInfo{wgpu::TextureUsage::TextureBinding, wgpu::ShaderStage::Compute}));
+}
+
+// Test that a tracker whose usage was acquired starts over even though the resources still carry
+// stamps with the indices of its previous entries.
+TEST_F(PassResourceUsageTrackerTests, AcquireResetsTracker) {
+    Ref<BufferMock> buffer0 = CreateBuffer();
+    Ref<BufferMock> buffer1 = CreateBuffer();
+
+    SyncScopeUsageTracker tracker;
+    tracker.BufferUsedAs(buffer0.Get(), wgpu::BufferUsage::Vertex);
+    tracker.BufferUsedAs(buffer1.Get(), wgpu::BufferUsage::Index);
+    SyncScopeResourceUsage first = tracker.AcquireSyncScopeUsage();
+    ASSERT_EQ(first.buffers.size(), 2u);
+
+    tracker.BufferUsedAs(buffer1.Get(), wgpu::BufferUsage::Uniform);
+    SyncScopeResourceUsage second = tracker.AcquireSyncScopeUsage();
+    ASSERT_EQ(second.buffers.size(), 1u);
+    EXPECT_EQ(second.buffers[0], buffer1.Get());
+    EXPECT_EQ(second.bufferSyncInfos[0].usage, wgpu::BufferUsage::Uniform);
+}
+
+// Test trackers on different threads using the same buffers and textures. Whatever the
+// interleaving, each tracker must produce one entry per resource with only its own usages.
+TEST_F(PassResourceUsageTrackerTests, ConcurrentTrackers) {
+    constexpr uint32_t kResourceCount = 32;
+    constexpr uint32_t kRepeatCount = 64;
+    std::vector<Ref<BufferMock>> buffers;
+    std::vector<Ref<TextureMock>> textures;
+    for (uint32_t i = 0; i < kResourceCount; ++i) {
+        buffers.push_back(CreateBuffer());
+        textures.push_back(CreateTexture());
+    }
+
+    struct ThreadUsage {
+        wgpu::BufferUsage firstBufferUsage;
+        wgpu::BufferUsage otherBufferUsage;
+        wgpu::ShaderStage stage;
+        SyncScopeResourceUsage result;
+    };
+    std::array<ThreadUsage, 2> threadUsages = {{
+        {wgpu::BufferUsage::Vertex, wgpu::BufferUsage::Index, wgpu::ShaderStage::Vertex, {}},
+        {wgpu::BufferUsage::Uniform, wgpu::BufferUsage::Storage, wgpu::ShaderStage::Fragment, {}},
+    }};
+
+    std::vector<std::thread> threads;
+    for (ThreadUsage& threadUsage : threadUsages) {
+        threads.emplace_back([&] {
+            SyncScopeUsageTracker tracker;
+            for (uint32_t repeat = 0; repeat < kRepeatCount; ++repeat) {
+                wgpu::BufferUsage usage =
+                    repeat == 0 ? threadUsage.firstBufferUsage : threadUsage.otherBufferUsage;
+                for (uint32_t i = 0; i < kResourceCount; ++i) {
+                    tracker.BufferUsedAs(buffers[i].Get(), usage, threadUsage.stage);
+                    tracker.TextureRangeUsedAs(
+                        textures[i].Get(), SubresourceRange::MakeSingle(Aspect::Color, 0, 1),
+                        wgpu::TextureUsage::TextureBinding, threadUsage.stage);
+                }
+            }
+            threadUsage.result = tracker.AcquireSyncScopeUsage();
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (const ThreadUsage& threadUsage : threadUsages) {
+        const SyncScopeResourceUsage& result = threadUsage.result;
+        ASSERT_EQ(result.buffers.size(), kResourceCount);
+        ASSERT_EQ(result.textures.size(), kResourceCount);
+        for (uint32_t i = 0; i < kResourceCount; ++i) {
+            EXPECT_EQ(result.buffers[i], buffers[i].Get());
+            EXPECT_EQ(result.bufferSyncInfos[i].usage,
+                      threadUsage.firstBufferUsage | threadUsage.otherBufferUsage);
+            EXPECT_EQ(result.bufferSyncInfos[i].shaderStages, threadUsage.stage);
+            EXPECT_EQ(result.textures[i], textures[i].Get());
+            EXPECT_EQ(result.textureSyncInfos[i].Get(Aspect::Color, 0, 0),
+                      (TextureSyncInfo{wgpu::TextureUsage::None, wgpu::ShaderStage::None}));
+            EXPECT_EQ(result.textureSyncInfos[i].Get(Aspect::Color, 0, 1),
+                      (TextureSyncInfo{wgpu::TextureUsage::TextureBinding, threadUsage.stage}));
+        }
+    }
+}
+
+}  // anonymous namespace
+}  // namespace dawn::native
@@ -335,6 +335,52 @@ class MinBufferSizeTestsBase : public ValidationTest {
             commandEncoder.Finish();
         }
     }
+
+    // Runs a dispatch with each of the given pipelines in a single pass while the same bind groups
+    // stay set (to test that the validation of earlier dispatches isn't reused for later ones)
+    void TestDispatches(const std::vector<wgpu::ComputePipeline>& computePipelines,
+                        const std::vector<wgpu::BindGroup>& bindGroups,
+                        bool expectation) {
+        wgpu::CommandEncoder commandEncoder = device.CreateCommandEncoder();
+        wgpu::ComputePassEncoder computePassEncoder = commandEncoder.BeginComputePass();
+        for (size_t i = 0; i < bindGroups.size(); ++i) {
+            computePassEncoder.SetBindGroup(i, bindGroups[i]);
+        }
+        for (const wgpu::ComputePipeline& computePipeline : computePipelines) {
+            computePassEncoder.SetPipeline(computePipeline);
+            computePassEncoder.DispatchWorkgroups(1);
+        }
+        computePassEncoder.End();
+        if (!expectation) {
+            ASSERT_DEVICE_ERROR(commandEncoder.Finish());
+        } else {
+            commandEncoder.Finish();
+        }
+    }
+
+    // Runs a draw with each of the given pipelines in a single pass while the same bind groups
+    // stay set (to test that the validation of earlier draws isn't reused for later ones)
+    void TestDraws(const std::vector<wgpu::RenderPipeline>& renderPipelines,
+                   const std::vector<wgpu::BindGroup>& bindGroups,
+                   bool expectation) {
+        PlaceholderRenderPass renderPass(device);
+
+        wgpu::CommandEncoder commandEncoder = device.CreateCommandEncoder();
+        wgpu::RenderPassEncoder renderPassEncoder = commandEncoder.BeginRenderPass(&renderPass);
+        for (size_t i = 0; i < bindGroups.size(); ++i) {
+            renderPassEncoder.SetBindGroup(i, bindGroups[i]);
+        }
+        for (const wgpu::RenderPipeline& renderPipeline : renderPipelines) {
+            renderPassEncoder.SetPipeline(renderPipeline);
+            renderPassEncoder.Draw(3);
+        }
+        renderPassEncoder.End();
+        if (!expectation) {
+            ASSERT_DEVICE_ERROR(commandEncoder.Finish());
+        } else {
+            commandEncoder.Finish();
+        }
+    }
 };
 
 // The check between BGL and pipeline at pipeline creation time
@@ -497,6 +543,71 @@ TEST_F(MinBufferSizeDrawTimeValidationTests, MultipleGroups) {
     });
 }
 
+// Draw time validation is redone when the pipeline changes to one requiring larger bindings while
+// the same bind group stays set
+TEST_F(MinBufferSizeDrawTimeValidationTests, PipelineChangeToLargerMinimumSize) {
+    std::vector<BindingDescriptor> smallBindings = {{0, 0, "a : f32, b : f32", "f32", "a", 8}};
+    std::vector<BindingDescriptor> largeBindings = {
+        {0, 0, "a : f32, b : f32, c : f32, d : f32", "f32", "a", 16}};
+    std::string vertexShader = CreateVertexShaderWithBindings({});
+
+    wgpu::BindGroupLayout layout = CreateBindGroupLayout(smallBindings, {0});
+
+    wgpu::ComputePipeline smallComputePipeline =
+        CreateComputePipeline({layout}, CreateComputeShaderWithBindings(smallBindings));
+    wgpu::ComputePipeline largeComputePipeline =
+        CreateComputePipeline({layout}, CreateComputeShaderWithBindings(largeBindings));
+    wgpu::RenderPipeline smallRenderPipeline = CreateRenderPipeline(
+        {layout}, vertexShader, CreateFragmentShaderWithBindings(smallBindings));
+    wgpu::RenderPipeline largeRenderPipeline = CreateRenderPipeline(
+        {layout}, vertexShader, CreateFragmentShaderWithBindings(largeBindings));
+
+    // The binding is large enough for the small pipelines only.
+    wgpu::BindGroup bindGroup = CreateBindGroup(layout, smallBindings, {8});
+
+    TestDispatches({smallComputePipeline, smallComputePipeline}, {bindGroup}, true);
+    TestDispatches({smallComputePipeline, largeComputePipeline}, {bindGroup}, false);
+    TestDispatches({smallComputePipeline, largeComputePipeline, smallComputePipeline},
+                   {bindGroup}, false);
+
+    TestDraws({smallRenderPipeline, smallRenderPipeline}, {bindGroup}, true);
+    TestDraws({smallRenderPipeline, largeRenderPipeline}, {bindGroup}, false);
+    TestDraws({smallRenderPipeline, largeRenderPipeline, smallRenderPipeline}, {bindGroup},
+              false);
+}
+
+// Draw time validation is redone when the pipeline changes to one with a layout incompatible with
+// the bind group while the same bind group stays set
+TEST_F(MinBufferSizeDrawTimeValidationTests, PipelineChangeToIncompatibleLayout) {
+    std::vector<BindingDescriptor> bindings = {{0, 0, "a : f32, b : f32", "f32", "a", 8}};
+    std::vector<BindingDescriptor> readOnlyBindings = {{0, 0, "a : f32, b : f32", "f32", "a", 8,
+                                                        wgpu::BufferBindingType::ReadOnlyStorage}};
+    std::string vertexShader = CreateVertexShaderWithBindings({});
+
+    wgpu::BindGroupLayout layout = CreateBindGroupLayout(bindings, {0});
+    wgpu::BindGroupLayout readOnlyLayout = CreateBindGroupLayout(readOnlyBindings, {0});
+
+    wgpu::ComputePipeline computePipeline =
+        CreateComputePipeline({layout}, CreateComputeShaderWithBindings(bindings));
+    wgpu::ComputePipeline readOnlyComputePipeline = CreateComputePipeline(
+        {readOnlyLayout}, CreateComputeShaderWithBindings(readOnlyBindings));
+    wgpu::RenderPipeline renderPipeline =
+        CreateRenderPipeline({layout}, vertexShader, CreateFragmentShaderWithBindings(bindings));
+    wgpu::RenderPipeline readOnlyRenderPipeline = CreateRenderPipeline(
+        {readOnlyLayout}, vertexShader, CreateFragmentShaderWithBindings(readOnlyBindings));
+
+    wgpu::BindGroup bindGroup = CreateBindGroup(layout, bindings, {8});
+
+    TestDispatches({computePipeline, computePipeline}, {bindGroup}, true);
+    TestDispatches({computePipeline, readOnlyComputePipeline}, {bindGroup}, false);
+    TestDispatches({computePipeline, readOnlyComputePipeline, computePipeline}, {bindGroup},
+                   false);
+
+    TestDraws({renderPipeline, renderPipeline}, {bindGroup}, true);
+    TestDraws({renderPipeline, readOnlyRenderPipeline}, {bindGroup}, false);
+    TestDraws({renderPipeline, readOnlyRenderPipeline, renderPipeline}, {bindGroup}, false);
+}
+
 // The correctness of minimum buffer size for the defaulted layout for a pipeline
 class MinBufferSizeDefaultLayoutTests : public MinBufferSizeTestsBase {
   public:
@@ -25,8 +25,10 @@
 // OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <cstring>
 #include <limits>
 #include <memory>
+#include <vector>
 
 #include "dawn/common/Assert.h"
 #include "dawn/tests/unittests/wire/WireFutureTest.h"
@@ -538,6 +540,47 @@ TEST_F(WireBufferMappedAtCreationTests, ReleaseBeforeUnmap) {
     FlushClient();
 }
 
+// Test that only the ranges returned by GetMappedRange are sent to the server on Unmap.
+TEST_F(WireBufferMappedAtCreationTests, UnmapOnlyFlushesMappedRanges) {
+    constexpr size_t kSize = 16384;
+    constexpr size_t kWriteSize = 16;
+    constexpr size_t kSecondWriteOffset = 12288;
+
+    WGPUBufferDescriptor descriptor = {};
+    descriptor.size = kSize;
+    descriptor.mappedAtCreation = true;
+
+    WGPUBuffer apiBuffer = api.GetNewBuffer();
+    std::vector<uint8_t> apiBufferData(kSize, 0xAB);
+
+    WGPUBuffer buffer = wgpuDeviceCreateBuffer(device, &descriptor);
+
+    EXPECT_CALL(api, DeviceCreateBuffer(apiDevice, _)).WillOnce(Return(apiBuffer));
+    EXPECT_CALL(api, BufferGetMappedRange(apiBuffer, 0, kSize))
+        .WillOnce(Return(apiBufferData.data()));
+
+    FlushClient();
+
+    memset(wgpuBufferGetMappedRange(buffer, 0, kWriteSize), 1, kWriteSize);
+    memset(wgpuBufferGetMappedRange(buffer, kSecondWriteOffset, kWriteSize), 2, kWriteSize);
+
+    wgpuBufferUnmap(buffer);
+    EXPECT_CALL(api, BufferUnmap(apiBuffer)).Times(1);
+
+    FlushClient();
+
+    // The bytes outside of the written ranges were not sent so they keep their server-side value.
+    for (size_t i = 0; i < kSize; ++i) {
+        uint8_t expected = 0xAB;
+        if (i < kWriteSize) {
+            expected = 1;
+        } else if (i >= kSecondWriteOffset && i < kSecondWriteOffset + kWriteSize) {
+            expected = 2;
+        }
+        ASSERT_EQ(expected, apiBufferData[i]) << "at byte " << i;
+    }
+}
+
 // Test that it is valid to map a buffer after it is mapped at creation and unmapped.
 TEST_P(WireBufferMappedAtCreationTests, MapSuccess) {
     WGPUBufferDescriptor descriptor = {};
@@ -0,0 +1,120 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <vector>
+
+#include "dawn/wire/client/DirtyRangeTracker.h"
+#include "gtest/gtest.h"
+
+namespace dawn::wire::client {
+namespace {
+
+using Range = DirtyRangeTracker::Range;
+constexpr size_t kGranularity = DirtyRangeTracker::kCoalesceGranularity;
+
+void ExpectRanges(const DirtyRangeTracker& tracker, const std::vector<Range>& expected) {
+    const std::vector<Range>& ranges = tracker.GetRanges();
+    ASSERT_EQ(ranges.size(), expected.size());
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        EXPECT_EQ(ranges[i].offset, expected[i].offset) << "range " << i;
+        EXPECT_EQ(ranges[i].size, expected[i].size) << "range " << i;
+    }
+}
+
+// Test that empty ranges are ignored and that Reset clears the tracker.
+TEST(WireDirtyRangeTrackerTests, EmptyAndReset) {
+    DirtyRangeTracker tracker;
+    EXPECT_TRUE(tracker.IsEmpty());
+
+    tracker.Add(16, 0);
+    EXPECT_TRUE(tracker.IsEmpty());
+
+    tracker.Add(16, 8);
+    ExpectRanges(tracker, {{16, 8}});
+
+    tracker.Reset();
+    EXPECT_TRUE(tracker.IsEmpty());
+}
+
+// Test that distant ranges are kept separate and sorted.
+TEST(WireDirtyRangeTrackerTests, DistantRangesAreSeparate) {
+    DirtyRangeTracker tracker;
+    tracker.Add(4 * kGranularity, 8);
+    tracker.Add(0, 8);
+    tracker.Add(2 * kGranularity, 8);
+    ExpectRanges(tracker, {{0, 8}, {2 * kGranularity, 8}, {4 * kGranularity, 8}});
+}
+
+// Test that overlapping, adjacent and close ranges are merged.
+TEST(WireDirtyRangeTrackerTests, CloseRangesAreMerged) {
+    DirtyRangeTracker tracker;
+    tracker.Add(0, 16);
+    // Overlapping.
+    tracker.Add(8, 16);
+    ExpectRanges(tracker, {{0, 24}});
+    // Adjacent.
+    tracker.Add(24, 8);
+    ExpectRanges(tracker, {{0, 32}});
+    // Within the coalescing granularity.
+    tracker.Add(32 + kGranularity - 8, 8);
+    ExpectRanges(tracker, {{0, 32 + kGranularity}});
+    // Exactly one granularity away is not merged.
+    tracker.Add(2 * kGranularity + 32, 8);
+    ExpectRanges(tracker, {{0, 32 + kGranularity}, {2 * kGranularity + 32, 8}});
+}
+
+// Test that adding a range that bridges several tracked ranges merges all of them.
+TEST(WireDirtyRangeTrackerTests, BridgingRangeMergesAll) {
+    DirtyRangeTracker tracker;
+    tracker.Add(0, 8);
+    tracker.Add(2 * kGranularity, 8);
+    tracker.Add(4 * kGranularity, 8);
+    tracker.Add(6 * kGranularity, 8);
+
+    tracker.Add(kGranularity, 3 * kGranularity + 16);
+    ExpectRanges(tracker, {{0, 4 * kGranularity + 16}, {6 * kGranularity, 8}});
+}
+
+// Test that the number of tracked ranges is bounded by merging the closest ranges.
+TEST(WireDirtyRangeTrackerTests, RangeCountIsBounded) {
+    DirtyRangeTracker tracker;
+    for (size_t i = 0; i < DirtyRangeTracker::kMaxRanges; ++i) {
+        tracker.Add(i * 4 * kGranularity, 8);
+    }
+    EXPECT_EQ(tracker.GetRanges().size(), DirtyRangeTracker::kMaxRanges);
+
+    // This range is closer to the second range than any other pair so it gets merged with it.
+    size_t offset = 5 * kGranularity + 8;
+    tracker.Add(offset, 8);
+    const std::vector<Range>& ranges = tracker.GetRanges();
+    ASSERT_EQ(ranges.size(), DirtyRangeTracker::kMaxRanges);
+    EXPECT_EQ(ranges[1].offset, 4 * kGranularity);
+    EXPECT_EQ(ranges[1].size, offset + 8 - 4 * kGranularity);
+}
+
+}  // anonymous namespace
+}  // namespace dawn::wire::client
@@ -0,0 +1,152 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <vector>
+
+#include "dawn/native/VulkanBackend.h"
+#include "dawn/native/vulkan/CommandRecordingContext.h"
+#include "dawn/native/vulkan/DeviceVk.h"
+#include "dawn/native/vulkan/QueueVk.h"
+#include "dawn/tests/DawnTest.h"
+#include "dawn/utils/ComboRenderPipelineDescriptor.h"
+#include "dawn/utils/SystemUtils.h"
+#include "dawn/utils/WGPUHelpers.h"
+#include "partition_alloc/pointers/raw_ptr.h"
+
+namespace dawn::native::vulkan {
+namespace {
+
+// More command pools than can be kept for reuse, so that some of them are destroyed.
+constexpr uint32_t kBurstSize = Queue::kMaxUnusedCommandPools + 8;
+
+class VulkanCommandPoolTests : public DawnTest {
+  protected:
+    void SetUp() override {
+        DawnTest::SetUp();
+        DAWN_TEST_UNSUPPORTED_IF(UsesWire());
+
+        mDeviceVk = ToBackend(FromAPI(device.Get()));
+        mQueueVk = ToBackend(mDeviceVk->GetQueue());
+    }
+
+    // Ticks the device until all the submits complete, which recycles their command pools.
+    void TickUntilIdle() {
+        while (mQueueVk->HasScheduledCommands()) {
+            device.Tick();
+            utils::USleep(100);
+        }
+    }
+
+    raw_ptr<Device> mDeviceVk;
+    raw_ptr<Queue> mQueueVk;
+};
+
+// Test that the pools of primary command buffers completing at once are reset for reuse up to
+// kMaxUnusedCommandPools, and that the next recording context reuses one of them.
+TEST_P(VulkanCommandPoolTests, PrimaryCommandPoolsAreRecycled) {
+    // Submit without ticking in between, so that all the pools are in flight at once.
+    for (uint32_t i = 0; i < kBurstSize; ++i) {
+        mQueueVk->GetPendingRecordingContext();
+        mQueueVk->SubmitPendingCommands().AcquireSuccess();
+    }
+
+    TickUntilIdle();
+    std::vector<VkCommandPool> unusedPools =
+        mQueueVk->GetUnusedCommandPoolsForTesting(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    EXPECT_EQ(unusedPools.size(), Queue::kMaxUnusedCommandPools);
+
+    // The recording context following the next submit uses an already reset pool instead of
+    // creating one.
+    mQueueVk->GetPendingRecordingContext();
+    mQueueVk->SubmitPendingCommands().AcquireSuccess();
+    CommandRecordingContext* recordingContext =
+        mQueueVk->GetPendingRecordingContext(Queue::SubmitMode::Passive);
+    EXPECT_EQ(recordingContext->commandPool, unusedPools.back());
+
+    unusedPools.pop_back();
+    EXPECT_EQ(mQueueVk->GetUnusedCommandPoolsForTesting(VK_COMMAND_BUFFER_LEVEL_PRIMARY),
+              unusedPools);
+}
+
+// Test that the pools of the secondary command buffers used to record render passes in parallel
+// are reset for reuse up to kMaxUnusedCommandPools, and that the next secondary command buffer
+// reuses one of them.
+TEST_P(VulkanCommandPoolTests, SecondaryCommandPoolsAreRecycled) {
+    DAWN_TEST_UNSUPPORTED_IF(!HasToggleEnabled("vulkan_record_render_passes_in_parallel"));
+
+    // Passes with 512 draws are split in two chunks, each recorded in a secondary command buffer.
+    constexpr uint32_t kDrawCount = 512;
+    mDeviceVk->SetMaxRenderPassRecordingChunksForTesting(2);
+
+    utils::ComboRenderPipelineDescriptor descriptor;
+    descriptor.vertex.module = utils::CreateShaderModule(device, R"(
+        @vertex fn main() -> @builtin(position) vec4f {
+            return vec4f(0.0, 0.0, 0.0, 1.0);
+        })");
+    descriptor.cFragment.module = utils::CreateShaderModule(device, R"(
+        @fragment fn main() -> @location(0) vec4f {
+            return vec4f(0.0, 1.0, 0.0, 1.0);
+        })");
+    descriptor.primitive.topology = wgpu::PrimitiveTopology::PointList;
+    descriptor.cTargets[0].format = utils::BasicRenderPass::kDefaultColorFormat;
+    wgpu::RenderPipeline pipeline = device.CreateRenderPipeline(&descriptor);
+
+    // Record all the passes in a single submit so that their pools are in flight at once.
+    utils::BasicRenderPass renderPass = utils::CreateBasicRenderPass(device, 1, 1);
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    for (uint32_t i = 0; i < kBurstSize / 2; ++i) {
+        wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass.renderPassInfo);
+        pass.SetPipeline(pipeline);
+        for (uint32_t j = 0; j < kDrawCount; ++j) {
+            pass.Draw(1);
+        }
+        pass.End();
+    }
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+
+    TickUntilIdle();
+    std::vector<VkCommandPool> unusedPools =
+        mQueueVk->GetUnusedCommandPoolsForTesting(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+    EXPECT_EQ(unusedPools.size(), Queue::kMaxUnusedCommandPools);
+
+    // The next secondary command buffer uses an already reset pool instead of creating one.
+    CommandRecordingContext* recordingContext = mQueueVk->GetPendingRecordingContext();
+    mQueueVk->GetSecondaryCommandBuffer(recordingContext).AcquireSuccess();
+    EXPECT_EQ(recordingContext->secondaryCommands.back().pool, unusedPools.back());
+
+    unusedPools.pop_back();
+    EXPECT_EQ(mQueueVk->GetUnusedCommandPoolsForTesting(VK_COMMAND_BUFFER_LEVEL_SECONDARY),
+              unusedPools);
+}
+
+DAWN_INSTANTIATE_TEST(VulkanCommandPoolTests,
+                      VulkanBackend(),
+                      VulkanBackend({"vulkan_record_render_passes_in_parallel"}));
+
+}  // anonymous namespace
+}  // namespace dawn::native::vulkan
@@ -0,0 +1,161 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <vector>
+
+#include "dawn/native/BindGroup.h"
+#include "dawn/native/BindGroupLayout.h"
+#include "dawn/native/VulkanBackend.h"
+#include "dawn/native/vulkan/BindGroupLayoutVk.h"
+#include "dawn/native/vulkan/BindGroupVk.h"
+#include "dawn/native/vulkan/DescriptorSetAllocator.h"
+#include "dawn/tests/DawnTest.h"
+#include "dawn/utils/WGPUHelpers.h"
+
+namespace dawn::native::vulkan {
+namespace {
+
+// The layouts of the tests have 4 descriptors, so the first pool of their allocator fits
+// 512 / 4 sets.
+constexpr uint32_t kFirstPoolMaxSets = 128;
+
+class VulkanDescriptorSetAllocatorTests : public DawnTest {
+  protected:
+    void SetUp() override {
+        DawnTest::SetUp();
+        DAWN_TEST_UNSUPPORTED_IF(UsesWire());
+    }
+
+    wgpu::BindGroupLayout MakeLayout(wgpu::ShaderStage visibility,
+                                     wgpu::BufferBindingType bindingType) {
+        return dawn::utils::MakeBindGroupLayout(device, {{0, visibility, bindingType},
+                                                         {1, visibility, bindingType},
+                                                         {2, visibility, bindingType},
+                                                         {3, visibility, bindingType}});
+    }
+
+    DescriptorSetAllocator* GetAllocator(const wgpu::BindGroupLayout& layout) {
+        return ToBackend(FromAPI(layout.Get())->GetInternalBindGroupLayout())
+            ->GetDescriptorSetAllocatorForTesting();
+    }
+
+    VkDescriptorSet GetDescriptorSet(const wgpu::BindGroup& bindGroup) {
+        return ToBackend(FromAPI(bindGroup.Get()))->GetHandle();
+    }
+};
+
+// Test that bind groups with the same contents share one descriptor set, and that bind groups with
+// different contents don't.
+TEST_P(VulkanDescriptorSetAllocatorTests, IdenticalBindGroupsShareDescriptorSet) {
+    wgpu::BindGroupLayout layout =
+        MakeLayout(wgpu::ShaderStage::Vertex, wgpu::BufferBindingType::Uniform);
+
+    wgpu::BufferDescriptor bufferDesc;
+    bufferDesc.size = 512;
+    bufferDesc.usage = wgpu::BufferUsage::Uniform;
+    wgpu::Buffer buffer = device.CreateBuffer(&bufferDesc);
+
+    auto MakeBindGroup = [&](uint64_t offset) {
+        return dawn::utils::MakeBindGroup(
+            device, layout,
+            {{0, buffer, offset, 16}, {1, buffer, offset, 16}, {2, buffer, offset, 16},
+             {3, buffer, offset, 16}});
+    };
+    wgpu::BindGroup bindGroup = MakeBindGroup(0);
+    wgpu::BindGroup identicalBindGroup = MakeBindGroup(0);
+    wgpu::BindGroup otherBindGroup = MakeBindGroup(256);
+
+    ASSERT_NE(bindGroup.Get(), identicalBindGroup.Get());
+    EXPECT_NE(GetDescriptorSet(bindGroup), VK_NULL_HANDLE);
+    EXPECT_EQ(GetDescriptorSet(bindGroup), GetDescriptorSet(identicalBindGroup));
+    EXPECT_NE(GetDescriptorSet(bindGroup), GetDescriptorSet(otherBindGroup));
+
+    // Relabeling one of the bind groups renames the shared set and keeps it shared.
+    identicalBindGroup.SetLabel("identical");
+    EXPECT_EQ(GetDescriptorSet(bindGroup), GetDescriptorSet(identicalBindGroup));
+
+    // The shared set stays alive as long as one of the bind groups using it does.
+    VkDescriptorSet sharedSet = GetDescriptorSet(bindGroup);
+    bindGroup = nullptr;
+    EXPECT_EQ(GetDescriptorSet(identicalBindGroup), sharedSet);
+}
+
+// Test that layouts with the same number of descriptors of each type share their allocator.
+TEST_P(VulkanDescriptorSetAllocatorTests, SameDescriptorCountsShareAllocator) {
+    wgpu::BindGroupLayout vertexLayout =
+        MakeLayout(wgpu::ShaderStage::Vertex, wgpu::BufferBindingType::Uniform);
+    wgpu::BindGroupLayout fragmentLayout =
+        MakeLayout(wgpu::ShaderStage::Fragment, wgpu::BufferBindingType::Uniform);
+    wgpu::BindGroupLayout storageLayout =
+        MakeLayout(wgpu::ShaderStage::Fragment, wgpu::BufferBindingType::ReadOnlyStorage);
+
+    // The layouts are different, but the first two have the same descriptors.
+    ASSERT_NE(FromAPI(vertexLayout.Get())->GetInternalBindGroupLayout(),
+              FromAPI(fragmentLayout.Get())->GetInternalBindGroupLayout());
+    EXPECT_EQ(GetAllocator(vertexLayout), GetAllocator(fragmentLayout));
+    EXPECT_NE(GetAllocator(vertexLayout), GetAllocator(storageLayout));
+}
+
+// Test that each new pool has twice the sets of the previous one.
+TEST_P(VulkanDescriptorSetAllocatorTests, PoolsGrowGeometrically) {
+    wgpu::BindGroupLayout layout =
+        MakeLayout(wgpu::ShaderStage::Vertex, wgpu::BufferBindingType::Uniform);
+    DescriptorSetAllocator* allocator = GetAllocator(layout);
+    EXPECT_TRUE(allocator->GetPoolMaxSetsForTesting().empty());
+
+    // Bind groups with identical contents share their descriptor set, so each one binds a
+    // different range of the buffer.
+    constexpr uint32_t kBindGroupCount = kFirstPoolMaxSets + 2 * kFirstPoolMaxSets + 1;
+    constexpr uint64_t kBindingStride = 256;
+    wgpu::BufferDescriptor bufferDesc;
+    bufferDesc.size = kBindGroupCount * kBindingStride;
+    bufferDesc.usage = wgpu::BufferUsage::Uniform;
+    wgpu::Buffer buffer = device.CreateBuffer(&bufferDesc);
+
+    std::vector<wgpu::BindGroup> bindGroups;
+    for (uint32_t i = 0; i < kBindGroupCount; ++i) {
+        uint64_t offset = i * kBindingStride;
+        bindGroups.push_back(dawn::utils::MakeBindGroup(
+            device, layout,
+            {{0, buffer, offset, 16}, {1, buffer, offset, 16}, {2, buffer, offset, 16},
+             {3, buffer, offset, 16}}));
+
+        if (i + 1 == kFirstPoolMaxSets) {
+            EXPECT_EQ(allocator->GetPoolMaxSetsForTesting(),
+                      std::vector<uint32_t>({kFirstPoolMaxSets}));
+        }
+    }
+
+    EXPECT_EQ(allocator->GetPoolMaxSetsForTesting(),
+              std::vector<uint32_t>({kFirstPoolMaxSets, 2 * kFirstPoolMaxSets,
+                                     4 * kFirstPoolMaxSets}));
+}
+
+DAWN_INSTANTIATE_TEST(VulkanDescriptorSetAllocatorTests, VulkanBackend());
+
+}  // anonymous namespace
+}  // namespace dawn::native::vulkan
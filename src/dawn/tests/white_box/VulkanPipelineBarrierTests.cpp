@@ -0,0 +1,157 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <array>
+
+#include "dawn/native/VulkanBackend.h"
+#include "dawn/native/vulkan/DeviceVk.h"
+#include "dawn/native/vulkan/QueueVk.h"
+#include "dawn/tests/DawnTest.h"
+#include "dawn/utils/WGPUHelpers.h"
+#include "partition_alloc/pointers/raw_ptr.h"
+
+namespace dawn::native::vulkan {
+namespace {
+
+constexpr uint32_t kBufferCount = 3;
+
+class VulkanPipelineBarrierTests : public DawnTest {
+  protected:
+    void SetUp() override {
+        DawnTest::SetUp();
+        DAWN_TEST_UNSUPPORTED_IF(UsesWire());
+
+        mQueueVk = ToBackend(ToBackend(FromAPI(device.Get()))->GetQueue());
+
+        // Each dispatch writes all the buffers and the storage texture.
+        wgpu::ComputePipelineDescriptor descriptor;
+        descriptor.compute.module = utils::CreateShaderModule(device, R"(
+            @group(0) @binding(0) var<storage, read_write> a : array<u32>;
+            @group(0) @binding(1) var<storage, read_write> b : array<u32>;
+            @group(0) @binding(2) var<storage, read_write> c : array<u32>;
+            @group(0) @binding(3) var t : texture_storage_2d<rgba8unorm, write>;
+
+            @compute @workgroup_size(1) fn main() {
+                a[0] += 1u;
+                b[0] += 1u;
+                c[0] += 1u;
+                textureStore(t, vec2i(0), vec4f(1.0));
+            })");
+        mPipeline = device.CreateComputePipeline(&descriptor);
+
+        wgpu::BufferDescriptor bufferDesc;
+        bufferDesc.size = 16;
+        bufferDesc.usage =
+            wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+        for (wgpu::Buffer& buffer : mBuffers) {
+            buffer = device.CreateBuffer(&bufferDesc);
+        }
+
+        wgpu::TextureDescriptor textureDesc;
+        textureDesc.size = {1, 1};
+        textureDesc.format = wgpu::TextureFormat::RGBA8Unorm;
+        textureDesc.usage = wgpu::TextureUsage::StorageBinding;
+        wgpu::Texture texture = device.CreateTexture(&textureDesc);
+
+        mBindGroup = utils::MakeBindGroup(device, mPipeline.GetBindGroupLayout(0),
+                                          {{0, mBuffers[0]},
+                                           {1, mBuffers[1]},
+                                           {2, mBuffers[2]},
+                                           {3, texture.CreateView()}});
+
+        // Write all the resources once so that they are initialized and every following use
+        // needs a write -> write barrier.
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        EncodeDispatches(encoder, 1);
+        Submit(encoder);
+    }
+
+    void EncodeDispatches(const wgpu::CommandEncoder& encoder, uint32_t dispatchCount) {
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        pass.SetPipeline(mPipeline);
+        pass.SetBindGroup(0, mBindGroup);
+        for (uint32_t i = 0; i < dispatchCount; ++i) {
+            pass.DispatchWorkgroups(1);
+        }
+        pass.End();
+    }
+
+    void Submit(const wgpu::CommandEncoder& encoder) {
+        wgpu::CommandBuffer commands = encoder.Finish();
+        queue.Submit(1, &commands);
+    }
+
+    raw_ptr<Queue> mQueueVk;
+    wgpu::ComputePipeline mPipeline;
+    std::array<wgpu::Buffer, kBufferCount> mBuffers;
+    wgpu::BindGroup mBindGroup;
+};
+
+// Test that the barriers of all the resources used by a dispatch are recorded in a single
+// vkCmdPipelineBarrier.
+TEST_P(VulkanPipelineBarrierTests, OnePipelineBarrierPerDispatch) {
+    constexpr uint32_t kDispatchCount = 8;
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    EncodeDispatches(encoder, kDispatchCount);
+    Submit(encoder);
+
+    EXPECT_EQ(mQueueVk->GetLastSubmitPipelineBarrierCountForTesting(), kDispatchCount);
+    EXPECT_EQ(mQueueVk->GetLastSubmitMemoryBarrierCountForTesting(),
+              kDispatchCount * (kBufferCount + 1));
+}
+
+// Test that the barriers stay coalesced over a sequence of passes and copies on the same
+// resources, and that the source and destination of a copy share a vkCmdPipelineBarrier.
+TEST_P(VulkanPipelineBarrierTests, SequenceOfPassesAndCopies) {
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    EncodeDispatches(encoder, 2);
+    encoder.CopyBufferToBuffer(mBuffers[0], 0, mBuffers[1], 0, 4);
+    EncodeDispatches(encoder, 3);
+    Submit(encoder);
+
+    // One barrier per dispatch for all the resources, and one for the source and destination of
+    // the copy.
+    EXPECT_EQ(mQueueVk->GetLastSubmitPipelineBarrierCountForTesting(), 2u + 1u + 3u);
+    EXPECT_EQ(mQueueVk->GetLastSubmitMemoryBarrierCountForTesting(),
+              (2u + 3u) * (kBufferCount + 1) + 2u);
+}
+
+// Test that the statistics only cover the last submit.
+TEST_P(VulkanPipelineBarrierTests, CountsArePerSubmit) {
+    for (uint32_t dispatchCount : {4u, 1u}) {
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        EncodeDispatches(encoder, dispatchCount);
+        Submit(encoder);
+
+        EXPECT_EQ(mQueueVk->GetLastSubmitPipelineBarrierCountForTesting(), dispatchCount);
+    }
+}
+
+DAWN_INSTANTIATE_TEST(VulkanPipelineBarrierTests, VulkanBackend());
+
+}  // anonymous namespace
+}  // namespace dawn::native::vulkan
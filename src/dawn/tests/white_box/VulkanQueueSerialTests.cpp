@@ -0,0 +1,181 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <limits>
+#include <vector>
+
+#include "dawn/native/VulkanBackend.h"
+#include "dawn/native/vulkan/DeviceVk.h"
+#include "dawn/native/vulkan/PhysicalDeviceVk.h"
+#include "dawn/native/vulkan/QueueVk.h"
+#include "dawn/tests/DawnTest.h"
+#include "dawn/utils/WGPUHelpers.h"
+#include "partition_alloc/pointers/raw_ptr.h"
+
+namespace dawn::native::vulkan {
+namespace {
+
+constexpr Nanoseconds kNoTimeout = Nanoseconds(std::numeric_limits<uint64_t>::max());
+
+class VulkanQueueSerialTests : public DawnTest {
+  protected:
+    void SetUp() override {
+        DawnTest::SetUp();
+        DAWN_TEST_UNSUPPORTED_IF(UsesWire());
+
+        mDeviceVk = ToBackend(FromAPI(device.Get()));
+        mQueueVk = ToBackend(mDeviceVk->GetQueue());
+    }
+
+    // Submits an empty command buffer and returns the serial of its submit.
+    ExecutionSerial SubmitEmpty() {
+        wgpu::CommandBuffer commands = device.CreateCommandEncoder().Finish();
+        queue.Submit(1, &commands);
+        return mQueueVk->GetLastSubmittedCommandSerial();
+    }
+
+    // Submits a compute dispatch that keeps the GPU busy for a while and returns the serial of
+    // its submit.
+    ExecutionSerial SubmitBusyWork() {
+        wgpu::ComputePipelineDescriptor descriptor;
+        descriptor.compute.module = utils::CreateShaderModule(device, R"(
+            @group(0) @binding(0) var<storage, read_write> data : array<u32>;
+
+            @compute @workgroup_size(64) fn main(@builtin(global_invocation_id) id : vec3u) {
+                var value = id.x;
+                for (var i = 0u; i < 100000u; i++) {
+                    value = value * 1664525u + 1013904223u;
+                }
+                data[id.x] = value;
+            })");
+        wgpu::ComputePipeline pipeline = device.CreateComputePipeline(&descriptor);
+
+        constexpr uint32_t kWorkgroupCount = 64;
+        wgpu::BufferDescriptor bufferDesc;
+        bufferDesc.size = kWorkgroupCount * 64 * sizeof(uint32_t);
+        bufferDesc.usage = wgpu::BufferUsage::Storage;
+        wgpu::Buffer buffer = device.CreateBuffer(&bufferDesc);
+        wgpu::BindGroup bindGroup =
+            utils::MakeBindGroup(device, pipeline.GetBindGroupLayout(0), {{0, buffer}});
+
+        wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        pass.SetPipeline(pipeline);
+        pass.SetBindGroup(0, bindGroup);
+        pass.DispatchWorkgroups(kWorkgroupCount);
+        pass.End();
+        wgpu::CommandBuffer commands = encoder.Finish();
+        queue.Submit(1, &commands);
+        return mQueueVk->GetLastSubmittedCommandSerial();
+    }
+
+    // Updates the completed serial of the queue and returns it.
+    ExecutionSerial CheckCompletedSerial() {
+        mQueueVk->CheckPassedSerials().AcquireSuccess();
+        return mQueueVk->GetCompletedCommandSerial();
+    }
+
+    raw_ptr<Device> mDeviceVk;
+    raw_ptr<Queue> mQueueVk;
+};
+
+// Test that the queue tracks its submits with a timeline semaphore only when the toggle is enabled
+// and the device supports them.
+TEST_P(VulkanQueueSerialTests, UsesTimelineSemaphoreFollowsToggle) {
+    const VulkanDeviceInfo& info = ToBackend(mDeviceVk->GetPhysicalDevice())->GetDeviceInfo();
+    bool supported = info.HasExt(DeviceExt::TimelineSemaphore) &&
+                     info.timelineSemaphoreFeatures.timelineSemaphore == VK_TRUE;
+
+    EXPECT_EQ(mQueueVk->UsesTimelineSemaphore(),
+              HasToggleEnabled("vulkan_use_timeline_semaphore") && supported);
+}
+
+// Test that waiting on the serial of the last of several submits completes all of them.
+TEST_P(VulkanQueueSerialTests, WaitForLastOfSeveralSubmits) {
+    std::vector<ExecutionSerial> serials;
+    for (uint32_t i = 0; i < 4; ++i) {
+        serials.push_back(SubmitEmpty());
+    }
+    for (uint32_t i = 1; i < serials.size(); ++i) {
+        EXPECT_EQ(serials[i], serials[i - 1] + ExecutionSerial(1));
+    }
+
+    EXPECT_TRUE(mQueueVk->WaitForQueueSerial(serials.back(), kNoTimeout).AcquireSuccess());
+    EXPECT_EQ(CheckCompletedSerial(), serials.back());
+
+    // Waiting again on any of the completed serials returns immediately.
+    for (ExecutionSerial serial : serials) {
+        EXPECT_TRUE(mQueueVk->WaitForQueueSerial(serial, Nanoseconds(0)).AcquireSuccess());
+    }
+    EXPECT_EQ(CheckCompletedSerial(), serials.back());
+}
+
+// Test that waiting on the serials of several submits in order makes the completed serial advance
+// up to each of them.
+TEST_P(VulkanQueueSerialTests, WaitForEachOfSeveralSubmits) {
+    std::vector<ExecutionSerial> serials;
+    for (uint32_t i = 0; i < 4; ++i) {
+        serials.push_back(SubmitEmpty());
+    }
+
+    for (ExecutionSerial serial : serials) {
+        EXPECT_TRUE(mQueueVk->WaitForQueueSerial(serial, kNoTimeout).AcquireSuccess());
+        ExecutionSerial completedSerial = CheckCompletedSerial();
+        EXPECT_GE(completedSerial, serial);
+        EXPECT_LE(completedSerial, serials.back());
+    }
+    EXPECT_EQ(CheckCompletedSerial(), serials.back());
+}
+
+// Test that a wait with a zero timeout on a pending serial doesn't update the completed serial,
+// and that the serial is reported as completed once waited on.
+TEST_P(VulkanQueueSerialTests, ZeroTimeoutWaitOnPendingSerial) {
+    ExecutionSerial completedBefore = CheckCompletedSerial();
+    ExecutionSerial busySerial = SubmitBusyWork();
+    ExecutionSerial lastSerial = SubmitEmpty();
+    EXPECT_GT(busySerial, completedBefore);
+
+    // The busy work is most likely still running. A wait with a zero timeout returns right away,
+    // and doesn't report the serial as completed unless it passed.
+    bool passed = mQueueVk->WaitForQueueSerial(lastSerial, Nanoseconds(0)).AcquireSuccess();
+    if (!passed) {
+        EXPECT_LT(mQueueVk->GetCompletedCommandSerial(), lastSerial);
+    }
+
+    EXPECT_TRUE(mQueueVk->WaitForQueueSerial(busySerial, kNoTimeout).AcquireSuccess());
+    EXPECT_GE(CheckCompletedSerial(), busySerial);
+
+    EXPECT_TRUE(mQueueVk->WaitForQueueSerial(lastSerial, kNoTimeout).AcquireSuccess());
+    EXPECT_EQ(CheckCompletedSerial(), lastSerial);
+}
+
+DAWN_INSTANTIATE_TEST(VulkanQueueSerialTests,
+                      VulkanBackend(),
+                      VulkanBackend({}, {"vulkan_use_timeline_semaphore"}));
+
+}  // anonymous namespace
+}  // namespace dawn::native::vulkan
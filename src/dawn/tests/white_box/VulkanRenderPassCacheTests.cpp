@@ -0,0 +1,160 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "dawn/native/VulkanBackend.h"
+#include "dawn/native/vulkan/DeviceVk.h"
+#include "dawn/native/vulkan/RenderPassCache.h"
+#include "dawn/tests/DawnTest.h"
+#include "dawn/utils/ComboRenderPipelineDescriptor.h"
+#include "dawn/utils/WGPUHelpers.h"
+#include "partition_alloc/pointers/raw_ptr.h"
+
+namespace dawn::native::vulkan {
+namespace {
+
+class VulkanRenderPassCacheTests : public DawnTest {
+  protected:
+    void SetUp() override {
+        DawnTest::SetUp();
+        DAWN_TEST_UNSUPPORTED_IF(UsesWire());
+
+        mDeviceVk = ToBackend(FromAPI(device.Get()));
+    }
+
+    RenderPassCacheQuery MakeQuery(wgpu::TextureFormat format) {
+        RenderPassCacheQuery query;
+        query.SetColor(ColorAttachmentIndex(static_cast<uint8_t>(0)), format, wgpu::LoadOp::Clear,
+                       wgpu::StoreOp::Store, false);
+        query.SetSampleCount(1);
+        return query;
+    }
+
+    void ExpectStats(RenderPassCache* cache,
+                     uint64_t hits,
+                     uint64_t misses,
+                     uint64_t evictions,
+                     size_t size) {
+        RenderPassCache::Stats stats = cache->GetStats();
+        EXPECT_EQ(stats.hits, hits);
+        EXPECT_EQ(stats.misses, misses);
+        EXPECT_EQ(stats.evictions, evictions);
+        EXPECT_EQ(stats.size, size);
+    }
+
+    raw_ptr<Device> mDeviceVk;
+};
+
+// Test that a bounded cache evicts the least recently used render pass and counts its hits and
+// misses.
+TEST_P(VulkanRenderPassCacheTests, LRUEviction) {
+    RenderPassCache cache(mDeviceVk, 2);
+    RenderPassCacheQuery queryA = MakeQuery(wgpu::TextureFormat::RGBA8Unorm);
+    RenderPassCacheQuery queryB = MakeQuery(wgpu::TextureFormat::BGRA8Unorm);
+    RenderPassCacheQuery queryC = MakeQuery(wgpu::TextureFormat::R8Unorm);
+
+    VkRenderPass renderPassA = cache.GetRenderPass(queryA).AcquireSuccess();
+    VkRenderPass renderPassB = cache.GetRenderPass(queryB).AcquireSuccess();
+    EXPECT_NE(renderPassA, renderPassB);
+    ExpectStats(&cache, 0, 2, 0, 2);
+
+    // Using A makes B the least recently used render pass.
+    EXPECT_EQ(cache.GetRenderPass(queryA).AcquireSuccess(), renderPassA);
+    ExpectStats(&cache, 1, 2, 0, 2);
+
+    // Adding C evicts B.
+    cache.GetRenderPass(queryC).AcquireSuccess();
+    ExpectStats(&cache, 1, 3, 1, 2);
+
+    // A is still cached but B is created again, which evicts C since A was used more recently.
+    EXPECT_EQ(cache.GetRenderPass(queryA).AcquireSuccess(), renderPassA);
+    ExpectStats(&cache, 2, 3, 1, 2);
+    cache.GetRenderPass(queryB).AcquireSuccess();
+    ExpectStats(&cache, 2, 4, 2, 2);
+    EXPECT_EQ(cache.GetRenderPass(queryA).AcquireSuccess(), renderPassA);
+    ExpectStats(&cache, 3, 4, 2, 2);
+    cache.GetRenderPass(queryC).AcquireSuccess();
+    ExpectStats(&cache, 3, 5, 3, 2);
+}
+
+// Test that an unbounded cache never evicts render passes.
+TEST_P(VulkanRenderPassCacheTests, Unbounded) {
+    RenderPassCache cache(mDeviceVk);
+    wgpu::TextureFormat formats[] = {wgpu::TextureFormat::RGBA8Unorm,
+                                     wgpu::TextureFormat::BGRA8Unorm,
+                                     wgpu::TextureFormat::R8Unorm};
+    for (wgpu::TextureFormat format : formats) {
+        cache.GetRenderPass(MakeQuery(format)).AcquireSuccess();
+    }
+    for (wgpu::TextureFormat format : formats) {
+        cache.GetRenderPass(MakeQuery(format)).AcquireSuccess();
+    }
+    ExpectStats(&cache, 3, 3, 0, 3);
+}
+
+// Test that render pipelines don't use VkRenderPasses from the device's cache when it is bounded,
+// since they can be created on worker threads while another thread evicts them.
+TEST_P(VulkanRenderPassCacheTests, PipelinesDontUseBoundedCache) {
+    RenderPassCache* cache = mDeviceVk->GetRenderPassCache();
+    DAWN_TEST_UNSUPPORTED_IF(!cache->IsBounded());
+
+    utils::ComboRenderPipelineDescriptor descriptor;
+    descriptor.vertex.module = utils::CreateShaderModule(device, R"(
+        @vertex fn main() -> @builtin(position) vec4f {
+            return vec4f(0.0, 0.0, 0.0, 1.0);
+        })");
+    descriptor.cFragment.module = utils::CreateShaderModule(device, R"(
+        @fragment fn main() -> @location(0) vec4f {
+            return vec4f(0.0, 1.0, 0.0, 1.0);
+        })");
+    descriptor.primitive.topology = wgpu::PrimitiveTopology::PointList;
+    descriptor.cTargets[0].format = wgpu::TextureFormat::RGBA8Unorm;
+
+    RenderPassCache::Stats before = cache->GetStats();
+    wgpu::RenderPipeline pipeline = device.CreateRenderPipeline(&descriptor);
+    RenderPassCache::Stats after = cache->GetStats();
+    EXPECT_EQ(after.hits, before.hits);
+    EXPECT_EQ(after.misses, before.misses);
+
+    // The pipeline is still compatible with the render passes of the cache.
+    utils::BasicRenderPass renderPass = utils::CreateBasicRenderPass(device, 1, 1);
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderPass.renderPassInfo);
+    pass.SetPipeline(pipeline);
+    pass.Draw(1);
+    pass.End();
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+
+    EXPECT_PIXEL_RGBA8_EQ(utils::RGBA8::kGreen, renderPass.color, 0, 0);
+}
+
+DAWN_INSTANTIATE_TEST(VulkanRenderPassCacheTests,
+                      VulkanBackend(),
+                      VulkanBackend({"vulkan_bound_render_pass_cache"}));
+
+}  // anonymous namespace
+}  // namespace dawn::native::vulkan
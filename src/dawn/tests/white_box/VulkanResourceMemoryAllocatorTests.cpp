@@ -0,0 +1,120 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "dawn/native/ResourceMemoryAllocation.h"
+#include "dawn/native/VulkanBackend.h"
+#include "dawn/native/vulkan/DeviceVk.h"
+#include "dawn/native/vulkan/ResourceHeapVk.h"
+#include "dawn/native/vulkan/ResourceMemoryAllocatorVk.h"
+#include "dawn/tests/DawnTest.h"
+#include "partition_alloc/pointers/raw_ptr.h"
+
+namespace dawn::native::vulkan {
+namespace {
+
+constexpr uint64_t kKiB = 1024;
+constexpr uint64_t kMiB = 1024 * kKiB;
+
+class VulkanResourceMemoryAllocatorTests : public DawnTest {
+  protected:
+    void SetUp() override {
+        DawnTest::SetUp();
+        DAWN_TEST_UNSUPPORTED_IF(UsesWire());
+        DAWN_TEST_UNSUPPORTED_IF(HasToggleEnabled("disable_resource_suballocation"));
+
+        mDeviceVk = ToBackend(FromAPI(device.Get()));
+    }
+
+    VkMemoryRequirements MakeRequirements(uint64_t size) {
+        VkMemoryRequirements requirements = {};
+        requirements.size = size;
+        requirements.alignment = 256;
+        requirements.memoryTypeBits = (1u << mDeviceVk->GetDeviceInfo().memoryTypes.size()) - 1;
+        return requirements;
+    }
+
+    // The size of the memory heap that allocations of |kind| come from.
+    uint64_t GetMemoryHeapSize(MemoryKind kind) {
+        int memoryType =
+            mDeviceVk->GetResourceMemoryAllocator()->FindBestTypeIndex(MakeRequirements(1), kind);
+        const VulkanDeviceInfo& info = mDeviceVk->GetDeviceInfo();
+        return info.memoryHeaps[info.memoryTypes[memoryType].heapIndex].size;
+    }
+
+    // Allocates |size| bytes of |kind| memory and returns the size of the VkDeviceMemory it is
+    // sub-allocated in, or 0 if it got a dedicated VkDeviceMemory.
+    uint64_t GetHeapSizeOfAllocation(uint64_t size, MemoryKind kind) {
+        ResourceMemoryAllocation allocation =
+            mDeviceVk->GetResourceMemoryAllocator()
+                ->Allocate(MakeRequirements(size), kind)
+                .AcquireSuccess();
+        uint64_t heapSize = 0;
+        if (allocation.GetInfo().mMethod == AllocationMethod::kSubAllocated) {
+            heapSize = ToBackend(allocation.GetResourceHeap())->GetSize();
+        } else {
+            EXPECT_EQ(allocation.GetInfo().mMethod, AllocationMethod::kDirect);
+        }
+        mDeviceVk->GetResourceMemoryAllocator()->Deallocate(&allocation);
+        return heapSize;
+    }
+
+    raw_ptr<Device> mDeviceVk;
+};
+
+// Test that resources are sub-allocated in the heaps of the first size class they fit in.
+TEST_P(VulkanResourceMemoryAllocatorTests, SizeClasses) {
+    uint64_t memoryHeapSize = GetMemoryHeapSize(MemoryKind::Opaque);
+    // Small memory heaps only have the medium size class.
+    DAWN_TEST_UNSUPPORTED_IF(memoryHeapSize < 64 * kMiB ||
+                             GetMemoryHeapSize(MemoryKind::Linear) != memoryHeapSize);
+
+    // Tiny buffers go in the linear-only buddy tier of 64KiB blocks, but tiny textures can't.
+    EXPECT_EQ(GetHeapSizeOfAllocation(16 * kKiB, MemoryKind::Linear), 2 * kMiB);
+    EXPECT_EQ(GetHeapSizeOfAllocation(64 * kKiB, MemoryKind::Linear), 2 * kMiB);
+    EXPECT_EQ(GetHeapSizeOfAllocation(16 * kKiB, MemoryKind::Opaque), 4 * kMiB);
+
+    // Small resources.
+    EXPECT_EQ(GetHeapSizeOfAllocation(64 * kKiB + 1, MemoryKind::Linear), 4 * kMiB);
+    EXPECT_EQ(GetHeapSizeOfAllocation(256 * kKiB, MemoryKind::Opaque), 4 * kMiB);
+
+    // Medium resources.
+    EXPECT_EQ(GetHeapSizeOfAllocation(256 * kKiB + 1, MemoryKind::Opaque), 8 * kMiB);
+    EXPECT_EQ(GetHeapSizeOfAllocation(4 * kMiB, MemoryKind::Linear), 8 * kMiB);
+
+    // Large resources are only sub-allocated on large memory heaps.
+    uint64_t largeHeapSize = memoryHeapSize >= 1024 * kMiB ? 64 * kMiB : 0;
+    EXPECT_EQ(GetHeapSizeOfAllocation(4 * kMiB + 1, MemoryKind::Opaque), largeHeapSize);
+    EXPECT_EQ(GetHeapSizeOfAllocation(32 * kMiB, MemoryKind::Opaque), largeHeapSize);
+
+    // Resources larger than all the size classes get dedicated memory.
+    EXPECT_EQ(GetHeapSizeOfAllocation(32 * kMiB + 1, MemoryKind::Opaque), 0u);
+}
+
+DAWN_INSTANTIATE_TEST(VulkanResourceMemoryAllocatorTests, VulkanBackend());
+
+}  // anonymous namespace
+}  // namespace dawn::native::vulkan
@@ -0,0 +1,128 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "dawn/utils/SharedMemory.h"
+
+#include "dawn/common/Assert.h"
+#include "dawn/common/Platform.h"
+
+#if DAWN_PLATFORM_IS(POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdio>
+#endif
+
+namespace dawn::utils {
+
+#if DAWN_PLATFORM_IS(POSIX)
+
+namespace {
+
+int CreateAnonymousFile() {
+#if DAWN_PLATFORM_IS(LINUX)
+    int memfd = memfd_create("dawn_shared_memory", MFD_CLOEXEC);
+    if (memfd >= 0) {
+        return memfd;
+    }
+#endif
+    // Fall back to POSIX shared memory that is unlinked right away so that only the descriptor
+    // refers to it.
+    char name[64];
+    snprintf(name, sizeof(name), "/dawn_shared_memory_%d_%p", static_cast<int>(getpid()),
+             static_cast<void*>(name));
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) {
+        shm_unlink(name);
+    }
+    return fd;
+}
+
+}  // anonymous namespace
+
+// static
+std::unique_ptr<SharedMemory> SharedMemory::Create(size_t size) {
+    int fd = CreateAnonymousFile();
+    if (fd < 0) {
+        return nullptr;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        close(fd);
+        return nullptr;
+    }
+    return Map(fd, size);
+}
+
+// static
+std::unique_ptr<SharedMemory> SharedMemory::Map(int fd, size_t size) {
+    DAWN_ASSERT(size > 0);
+    void* pointer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (pointer == MAP_FAILED) {
+        close(fd);
+        return nullptr;
+    }
+    return std::unique_ptr<SharedMemory>(new SharedMemory(fd, pointer, size));
+}
+
+SharedMemory::~SharedMemory() {
+    munmap(mPointer, mSize);
+    close(mFD);
+}
+
+#else  // DAWN_PLATFORM_IS(POSIX)
+
+// static
+std::unique_ptr<SharedMemory> SharedMemory::Create(size_t) {
+    return nullptr;
+}
+
+// static
+std::unique_ptr<SharedMemory> SharedMemory::Map(int, size_t) {
+    return nullptr;
+}
+
+SharedMemory::~SharedMemory() = default;
+
+#endif  // DAWN_PLATFORM_IS(POSIX)
+
+SharedMemory::SharedMemory(int fd, void* pointer, size_t size)
+    : mFD(fd), mPointer(pointer), mSize(size) {}
+
+void* SharedMemory::GetPointer() const {
+    return mPointer;
+}
+
+size_t SharedMemory::GetSize() const {
+    return mSize;
+}
+
+int SharedMemory::GetFD() const {
+    return mFD;
+}
+
+}  // namespace dawn::utils
@@ -0,0 +1,66 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef SRC_DAWN_UTILS_SHAREDMEMORY_H_
+#define SRC_DAWN_UTILS_SHAREDMEMORY_H_
+
+#include <cstddef>
+#include <memory>
+
+#include "partition_alloc/pointers/raw_ptr.h"
+
+namespace dawn::utils {
+
+// A memory mapping that can be shared between processes. It is backed by an anonymous file whose
+// descriptor can be inherited by a child process or sent over a socket, then mapped again with
+// SharedMemory::Map. Only supported on POSIX platforms, Create and Map return nullptr elsewhere.
+class SharedMemory {
+  public:
+    static std::unique_ptr<SharedMemory> Create(size_t size);
+    // Maps |size| bytes of the shared memory file |fd|. The returned object takes ownership of the
+    // file descriptor.
+    static std::unique_ptr<SharedMemory> Map(int fd, size_t size);
+    ~SharedMemory();
+
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    void* GetPointer() const;
+    size_t GetSize() const;
+    int GetFD() const;
+
+  private:
+    SharedMemory(int fd, void* pointer, size_t size);
+
+    int mFD;
+    raw_ptr<void> mPointer;
+    size_t mSize;
+};
+
+}  // namespace dawn::utils
+
+#endif  // SRC_DAWN_UTILS_SHAREDMEMORY_H_
@@ -0,0 +1,278 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "dawn/utils/SharedMemoryCommandBuffer.h"
+
+#include <atomic>
+#include <new>
+#include <thread>
+#include <utility>
+
+#include "dawn/common/Assert.h"
+#include "dawn/common/Math.h"
+
+namespace dawn::utils {
+
+namespace {
+
+constexpr uint32_t kRingMagic = 0x474e4952;  // "RING"
+constexpr uint32_t kRingVersion = 1;
+
+// Each chunk of commands is preceded by its size. Chunks start at 8-byte aligned offsets.
+constexpr uint64_t kChunkHeaderSize = sizeof(uint64_t);
+constexpr uint64_t kChunkAlignment = 8;
+// Chunk size telling the consumer that the rest of the ring is unused and the next chunk starts at
+// the beginning of the ring.
+constexpr uint64_t kWrapMarker = ~uint64_t(0);
+
+constexpr uint32_t kProducerClosed = 1;
+constexpr uint32_t kConsumerClosed = 2;
+
+}  // anonymous namespace
+
+// Lives at the start of the shared memory, followed by the ring data. The offsets are on separate
+// cache lines so that the producer and the consumer don't false-share.
+struct SharedMemoryRingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+    alignas(64) std::atomic<uint64_t> writeOffset;
+    alignas(64) std::atomic<uint64_t> readOffset;
+    alignas(64) std::atomic<uint32_t> closedFlags;
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+static_assert(sizeof(SharedMemoryRingHeader) % kChunkAlignment == 0);
+
+// SharedMemoryCommandSerializer
+
+// static
+size_t SharedMemoryCommandSerializer::GetRequiredSharedMemorySize(size_t capacity) {
+    DAWN_ASSERT(IsPowerOfTwo(capacity));
+    return sizeof(SharedMemoryRingHeader) + capacity;
+}
+
+// static
+std::unique_ptr<SharedMemoryCommandSerializer> SharedMemoryCommandSerializer::Create(
+    std::unique_ptr<SharedMemory> memory) {
+    if (memory == nullptr || memory->GetSize() <= sizeof(SharedMemoryRingHeader)) {
+        return nullptr;
+    }
+    uint64_t capacity = memory->GetSize() - sizeof(SharedMemoryRingHeader);
+    if (!IsPowerOfTwo(capacity) || capacity < 2 * kChunkHeaderSize) {
+        return nullptr;
+    }
+
+    auto* header = new (memory->GetPointer()) SharedMemoryRingHeader();
+    header->magic = kRingMagic;
+    header->version = kRingVersion;
+    header->capacity = capacity;
+    header->writeOffset.store(0, std::memory_order_relaxed);
+    header->readOffset.store(0, std::memory_order_relaxed);
+    header->closedFlags.store(0, std::memory_order_release);
+
+    return std::unique_ptr<SharedMemoryCommandSerializer>(
+        new SharedMemoryCommandSerializer(std::move(memory)));
+}
+
+SharedMemoryCommandSerializer::SharedMemoryCommandSerializer(std::unique_ptr<SharedMemory> memory)
+    : mMemory(std::move(memory)),
+      mHeader(static_cast<SharedMemoryRingHeader*>(mMemory->GetPointer())),
+      mData(static_cast<char*>(mMemory->GetPointer()) + sizeof(SharedMemoryRingHeader)),
+      mCapacity(mHeader->capacity) {}
+
+SharedMemoryCommandSerializer::~SharedMemoryCommandSerializer() {
+    Close();
+}
+
+size_t SharedMemoryCommandSerializer::GetMaximumAllocationSize() const {
+    // Allow a chunk with a single allocation to always fit after wrapping around the ring.
+    return (mCapacity / 2 - kChunkHeaderSize) & ~(kChunkAlignment - 1);
+}
+
+void* SharedMemoryCommandSerializer::GetCmdSpace(size_t size) {
+    // Note: This returns non-null even if size is zero.
+    if (size > GetMaximumAllocationSize()) {
+        return nullptr;
+    }
+    // Reserve space for the padding added when the chunk gets published.
+    uint64_t alignedSize = Align(size, kChunkAlignment);
+
+    // Never wait for space while a chunk is open because the consumer can't free space for a
+    // chunk that isn't published yet.
+    if (mChunkOpen) {
+        // Chunks are contiguous so they can't extend past the end of the ring.
+        uint64_t ringEnd = (mChunkStart & ~(mCapacity - 1)) + mCapacity;
+        uint64_t readOffset = mHeader->readOffset.load(std::memory_order_acquire);
+        if (mCursor + alignedSize > ringEnd || mCursor + alignedSize - readOffset > mCapacity) {
+            PublishChunk();
+        }
+    }
+
+    if (!mChunkOpen) {
+        uint64_t neededSize = kChunkHeaderSize + alignedSize;
+        uint64_t tailSize = mCapacity - (mCursor & (mCapacity - 1));
+        if (tailSize < neededSize) {
+            if (!WaitForSpace(tailSize)) {
+                return nullptr;
+            }
+            *reinterpret_cast<uint64_t*>(mData + (mCursor & (mCapacity - 1))) = kWrapMarker;
+            mCursor += tailSize;
+            mHeader->writeOffset.store(mCursor, std::memory_order_release);
+        }
+        if (!WaitForSpace(neededSize)) {
+            return nullptr;
+        }
+        mChunkStart = mCursor;
+        mCursor += kChunkHeaderSize;
+        mChunkOpen = true;
+    }
+
+    char* result = mData + (mCursor & (mCapacity - 1));
+    mCursor += size;
+    return result;
+}
+
+bool SharedMemoryCommandSerializer::Flush() {
+    if (mChunkOpen) {
+        PublishChunk();
+    }
+    return (mHeader->closedFlags.load(std::memory_order_acquire) & kConsumerClosed) == 0;
+}
+
+void SharedMemoryCommandSerializer::Close() {
+    if (mChunkOpen) {
+        PublishChunk();
+    }
+    mHeader->closedFlags.fetch_or(kProducerClosed, std::memory_order_release);
+}
+
+void SharedMemoryCommandSerializer::PublishChunk() {
+    DAWN_ASSERT(mChunkOpen);
+    *reinterpret_cast<uint64_t*>(mData + (mChunkStart & (mCapacity - 1))) =
+        mCursor - mChunkStart - kChunkHeaderSize;
+    mCursor = Align(mCursor, kChunkAlignment);
+    mHeader->writeOffset.store(mCursor, std::memory_order_release);
+    mChunkOpen = false;
+}
+
+bool SharedMemoryCommandSerializer::WaitForSpace(uint64_t size) {
+    DAWN_ASSERT(!mChunkOpen);
+    DAWN_ASSERT(size <= mCapacity);
+    while (mCursor + size - mHeader->readOffset.load(std::memory_order_acquire) > mCapacity) {
+        if (mHeader->closedFlags.load(std::memory_order_acquire) & kConsumerClosed) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+// SharedMemoryCommandReceiver
+
+// static
+std::unique_ptr<SharedMemoryCommandReceiver> SharedMemoryCommandReceiver::Create(
+    std::unique_ptr<SharedMemory> memory) {
+    if (memory == nullptr || memory->GetSize() <= sizeof(SharedMemoryRingHeader)) {
+        return nullptr;
+    }
+    const auto* header = static_cast<const SharedMemoryRingHeader*>(memory->GetPointer());
+    if (header->magic != kRingMagic || header->version != kRingVersion ||
+        header->capacity != memory->GetSize() - sizeof(SharedMemoryRingHeader) ||
+        !IsPowerOfTwo(header->capacity)) {
+        return nullptr;
+    }
+    return std::unique_ptr<SharedMemoryCommandReceiver>(
+        new SharedMemoryCommandReceiver(std::move(memory)));
+}
+
+SharedMemoryCommandReceiver::SharedMemoryCommandReceiver(std::unique_ptr<SharedMemory> memory)
+    : mMemory(std::move(memory)),
+      mHeader(static_cast<SharedMemoryRingHeader*>(mMemory->GetPointer())),
+      mData(static_cast<char*>(mMemory->GetPointer()) + sizeof(SharedMemoryRingHeader)),
+      mCapacity(mHeader->capacity),
+      mReadOffset(mHeader->readOffset.load(std::memory_order_acquire)) {}
+
+SharedMemoryCommandReceiver::~SharedMemoryCommandReceiver() {
+    Close();
+}
+
+bool SharedMemoryCommandReceiver::HandleCommands(dawn::wire::CommandHandler* handler) {
+    uint64_t writeOffset = mHeader->writeOffset.load(std::memory_order_acquire);
+    while (mReadOffset < writeOffset) {
+        // The producer could be compromised. The published size must fit a chunk header and can't
+        // be more than the whole ring, otherwise the chunk size checks below would underflow.
+        uint64_t publishedSize = writeOffset - mReadOffset;
+        if (publishedSize < kChunkHeaderSize || publishedSize > mCapacity) {
+            Close();
+            return false;
+        }
+
+        // Read the chunk size only once and validate it before using it.
+        uint64_t position = mReadOffset & (mCapacity - 1);
+        const volatile char* chunk = mData + position;
+        uint64_t chunkSize = *reinterpret_cast<const volatile uint64_t*>(chunk);
+
+        if (chunkSize == kWrapMarker) {
+            mReadOffset += mCapacity - position;
+            continue;
+        }
+        if (chunkSize > mCapacity - position - kChunkHeaderSize ||
+            chunkSize > publishedSize - kChunkHeaderSize) {
+            Close();
+            return false;
+        }
+
+        // Commands are handled in place, the handler deserializes them from volatile memory.
+        if (chunkSize > 0 &&
+            handler->HandleCommands(chunk + kChunkHeaderSize, chunkSize) == nullptr) {
+            Close();
+            return false;
+        }
+
+        mReadOffset += Align(kChunkHeaderSize + chunkSize, kChunkAlignment);
+        mHeader->readOffset.store(mReadOffset, std::memory_order_release);
+    }
+    return true;
+}
+
+bool SharedMemoryCommandReceiver::HasCommands() const {
+    return mHeader->writeOffset.load(std::memory_order_acquire) != mReadOffset;
+}
+
+bool SharedMemoryCommandReceiver::IsDone() const {
+    // The producer publishes its last chunk before setting the flag.
+    bool producerClosed =
+        mHeader->closedFlags.load(std::memory_order_acquire) & kProducerClosed;
+    return producerClosed && !HasCommands();
+}
+
+void SharedMemoryCommandReceiver::Close() {
+    mHeader->closedFlags.fetch_or(kConsumerClosed, std::memory_order_release);
+}
+
+}  // namespace dawn::utils
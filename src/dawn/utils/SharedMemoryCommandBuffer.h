@@ -0,0 +1,116 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef SRC_DAWN_UTILS_SHAREDMEMORYCOMMANDBUFFER_H_
+#define SRC_DAWN_UTILS_SHAREDMEMORYCOMMANDBUFFER_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "dawn/utils/SharedMemory.h"
+#include "dawn/wire/Wire.h"
+#include "partition_alloc/pointers/raw_ptr.h"
+
+namespace dawn::utils {
+
+struct SharedMemoryRingHeader;
+
+// A wire transport where the client serializes commands directly into a single-producer
+// single-consumer ring buffer in shared memory and the server handles them in place, without any
+// copy. The producer and the consumer only synchronize through atomic read and write offsets
+// stored in the shared memory, so they can live in different processes.
+//
+// Commands are published in chunks: each Flush() (or running out of contiguous space at the end of
+// the ring) makes the commands serialized since the previous one visible to the consumer. When the
+// ring is full, GetCmdSpace waits for the consumer to free space.
+class SharedMemoryCommandSerializer : public dawn::wire::CommandSerializer {
+  public:
+    // Returns the size of shared memory needed for a ring with |capacity| bytes of commands.
+    // |capacity| must be a power of two.
+    static size_t GetRequiredSharedMemorySize(size_t capacity);
+
+    // Initializes a ring buffer that uses all of |memory|.
+    static std::unique_ptr<SharedMemoryCommandSerializer> Create(
+        std::unique_ptr<SharedMemory> memory);
+    ~SharedMemoryCommandSerializer() override;
+
+    size_t GetMaximumAllocationSize() const override;
+    void* GetCmdSpace(size_t size) override;
+    bool Flush() override;
+
+    // Tells the consumer that no more commands will be sent. Called on destruction.
+    void Close();
+
+  private:
+    explicit SharedMemoryCommandSerializer(std::unique_ptr<SharedMemory> memory);
+
+    void PublishChunk();
+    bool WaitForSpace(uint64_t size);
+
+    std::unique_ptr<SharedMemory> mMemory;
+    raw_ptr<SharedMemoryRingHeader> mHeader;
+    raw_ptr<char, AllowPtrArithmetic> mData;
+    uint64_t mCapacity;
+
+    // Monotonic offsets into the ring. The position in the ring is the offset modulo capacity.
+    uint64_t mCursor = 0;
+    uint64_t mChunkStart = 0;
+    bool mChunkOpen = false;
+};
+
+// The consumer side of SharedMemoryCommandSerializer.
+class SharedMemoryCommandReceiver {
+  public:
+    // Attaches to a ring buffer initialized by SharedMemoryCommandSerializer::Create, possibly in
+    // another process. Returns nullptr if |memory| doesn't contain a valid ring.
+    static std::unique_ptr<SharedMemoryCommandReceiver> Create(
+        std::unique_ptr<SharedMemory> memory);
+    ~SharedMemoryCommandReceiver();
+
+    // Passes all the published commands to |handler|, in place. Returns false if the handler fails
+    // or the ring is corrupted, in which case the ring is closed.
+    bool HandleCommands(dawn::wire::CommandHandler* handler);
+
+    // Returns true if there are published commands not handled yet.
+    bool HasCommands() const;
+    // Returns true if the producer is closed and all its commands have been handled.
+    bool IsDone() const;
+    void Close();
+
+  private:
+    explicit SharedMemoryCommandReceiver(std::unique_ptr<SharedMemory> memory);
+
+    std::unique_ptr<SharedMemory> mMemory;
+    raw_ptr<SharedMemoryRingHeader> mHeader;
+    raw_ptr<char, AllowPtrArithmetic> mData;
+    uint64_t mCapacity;
+    uint64_t mReadOffset = 0;
+};
+
+}  // namespace dawn::utils
+
+#endif  // SRC_DAWN_UTILS_SHAREDMEMORYCOMMANDBUFFER_H_
@@ -0,0 +1,577 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "dawn/utils/SharedMemoryTransferService.h"
+
+#include <atomic>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <new>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "dawn/common/Alloc.h"
+#include "dawn/common/Assert.h"
+#include "dawn/common/Math.h"
+#include "partition_alloc/pointers/raw_ptr.h"
+
+namespace dawn::utils {
+
+namespace {
+
+enum class HandleKind : uint32_t {
+    // The data is transferred inline in the command stream, like with the inline memory transfer
+    // services.
+    Inline = 0,
+    // The data is in a region of the shared memory arena.
+    Shared = 1,
+};
+
+// Serialized by the client handles for the server to create their companion handle.
+struct HandleCreateInfo {
+    HandleKind kind;
+    uint32_t padding;
+    // The offset of the region's RegionHeader in the arena. The data follows the header.
+    uint64_t regionOffset;
+    uint64_t size;
+    // Increases with each handle the client serializes, in the order of the command stream.
+    uint64_t sequence;
+};
+
+// At the start of the arena.
+struct ArenaHeader {
+    // The sequence of the last handle deserialized by the server. Since the server deserializes
+    // handles in the order of the command stream, the handles with a smaller sequence that it
+    // didn't deserialize were dropped with their command and will never be.
+    std::atomic<uint64_t> lastDeserializedSequence;
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+enum RegionState : uint32_t {
+    kRegionUnclaimed = 0,
+    // Set by the server when it deserializes a handle for the region.
+    kRegionServerAcquired = 1,
+    // Set by the server when its handle for the region is destroyed, after its last access to the
+    // region's data.
+    kRegionServerReleased = 2,
+};
+
+// At the start of each region of the arena.
+struct RegionHeader {
+    std::atomic<uint32_t> state;
+};
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+constexpr uint64_t kRegionAlignment = 64;
+constexpr uint64_t kArenaHeaderSize = kRegionAlignment;
+constexpr uint64_t kRegionHeaderSize = kRegionAlignment;
+static_assert(sizeof(ArenaHeader) <= kArenaHeaderSize);
+static_assert(sizeof(RegionHeader) <= kRegionHeaderSize);
+
+// Client side
+
+// First-fit allocator of the ranges of the arena, coalescing adjacent free ranges.
+class ArenaAllocator {
+  public:
+    static constexpr uint64_t kInvalidOffset = std::numeric_limits<uint64_t>::max();
+
+    ArenaAllocator(uint64_t offset, uint64_t size) {
+        if (size > 0) {
+            mFreeRanges[offset] = size;
+        }
+    }
+
+    uint64_t Allocate(uint64_t size) {
+        for (auto it = mFreeRanges.begin(); it != mFreeRanges.end(); ++it) {
+            auto [offset, rangeSize] = *it;
+            if (rangeSize < size) {
+                continue;
+            }
+            mFreeRanges.erase(it);
+            if (rangeSize > size) {
+                mFreeRanges[offset + size] = rangeSize - size;
+            }
+            return offset;
+        }
+        return kInvalidOffset;
+    }
+
+    void Deallocate(uint64_t offset, uint64_t size) {
+        auto next = mFreeRanges.lower_bound(offset);
+        DAWN_ASSERT(next == mFreeRanges.end() || offset + size <= next->first);
+        if (next != mFreeRanges.end() && offset + size == next->first) {
+            size += next->second;
+            next = mFreeRanges.erase(next);
+        }
+        if (next != mFreeRanges.begin()) {
+            auto prev = std::prev(next);
+            DAWN_ASSERT(prev->first + prev->second <= offset);
+            if (prev->first + prev->second == offset) {
+                prev->second += size;
+                return;
+            }
+        }
+        mFreeRanges[offset] = size;
+    }
+
+  private:
+    std::map<uint64_t, uint64_t> mFreeRanges;
+};
+
+class ClientSharedMemoryTransferServiceImpl : public ClientSharedMemoryTransferService {
+  public:
+    explicit ClientSharedMemoryTransferServiceImpl(std::unique_ptr<SharedMemory> arena)
+        : mArena(std::move(arena)),
+          mAllocator(kArenaHeaderSize, GetAllocatableSize(mArena->GetSize())) {
+        if (mArena->GetSize() >= kArenaHeaderSize) {
+            new (mArena->GetPointer()) ArenaHeader{0};
+        }
+    }
+    // The regions the server didn't release yet are dropped with the arena. The wire client, and
+    // so all the handles, must be destroyed before.
+    ~ClientSharedMemoryTransferServiceImpl() override = default;
+
+    ReadHandle* CreateReadHandle(size_t size) override {
+        HandleStorage storage(this, size);
+        if (!storage.Initialize()) {
+            return nullptr;
+        }
+        return new ReadHandleImpl(std::move(storage));
+    }
+
+    WriteHandle* CreateWriteHandle(size_t size) override {
+        HandleStorage storage(this, size);
+        if (!storage.Initialize()) {
+            return nullptr;
+        }
+        memset(storage.GetData(), 0, size);
+        return new WriteHandleImpl(std::move(storage));
+    }
+
+    void OnServerDisconnected() override {
+        mServerDisconnected = true;
+        for (auto [regionOffset, allocationSize, sequence] : mReleasedRegions) {
+            mAllocator.Deallocate(regionOffset, allocationSize);
+        }
+        mReleasedRegions.clear();
+    }
+
+  private:
+    // The data of a client handle, either in a region of the arena or in a heap allocation if the
+    // arena is full.
+    class HandleStorage {
+      public:
+        HandleStorage(ClientSharedMemoryTransferServiceImpl* service, size_t size)
+            : mService(service), mSize(size) {}
+        HandleStorage(HandleStorage&& other)
+            : mService(other.mService),
+              mSize(other.mSize),
+              mRegionOffset(std::exchange(other.mRegionOffset, ArenaAllocator::kInvalidOffset)),
+              mSequence(other.mSequence),
+              mInlineData(std::move(other.mInlineData)) {}
+        HandleStorage& operator=(HandleStorage&&) = delete;
+
+        ~HandleStorage() {
+            if (IsShared()) {
+                mService->ReleaseRegion(mRegionOffset, mSize, mSequence);
+            }
+        }
+
+        bool Initialize() {
+            mRegionOffset = mService->AllocateRegion(mSize);
+            if (IsShared()) {
+                return true;
+            }
+            mInlineData.reset(AllocNoThrow<uint8_t>(mSize));
+            return mInlineData != nullptr;
+        }
+
+        bool IsShared() const { return mRegionOffset != ArenaAllocator::kInvalidOffset; }
+        size_t GetSize() const { return mSize; }
+
+        uint8_t* GetData() {
+            if (IsShared()) {
+                return mService->GetRegionData(mRegionOffset);
+            }
+            return mInlineData.get();
+        }
+
+        void SerializeCreate(void* serializePointer) {
+            if (mSequence == kNotSerialized) {
+                mSequence = mService->mNextSequence++;
+            }
+            HandleCreateInfo info = {};
+            info.kind = IsShared() ? HandleKind::Shared : HandleKind::Inline;
+            info.regionOffset = IsShared() ? mRegionOffset : 0;
+            info.size = mSize;
+            info.sequence = mSequence;
+            memcpy(serializePointer, &info, sizeof(info));
+        }
+
+      private:
+        raw_ptr<ClientSharedMemoryTransferServiceImpl> mService;
+        size_t mSize;
+        uint64_t mRegionOffset = ArenaAllocator::kInvalidOffset;
+        uint64_t mSequence = kNotSerialized;
+        std::unique_ptr<uint8_t[]> mInlineData;
+    };
+
+    class ReadHandleImpl : public ReadHandle {
+      public:
+        explicit ReadHandleImpl(HandleStorage storage) : mStorage(std::move(storage)) {}
+        ~ReadHandleImpl() override = default;
+
+        size_t SerializeCreateSize() override { return sizeof(HandleCreateInfo); }
+        void SerializeCreate(void* serializePointer) override {
+            mStorage.SerializeCreate(serializePointer);
+        }
+
+        const void* GetData() override { return mStorage.GetData(); }
+
+        bool DeserializeDataUpdate(const void* deserializePointer,
+                                   size_t deserializeSize,
+                                   size_t offset,
+                                   size_t size) override {
+            if (offset > mStorage.GetSize() || size > mStorage.GetSize() - offset) {
+                return false;
+            }
+            // The server already wrote the data in the shared region.
+            if (mStorage.IsShared()) {
+                return deserializeSize == 0;
+            }
+            if (deserializeSize != size || deserializePointer == nullptr) {
+                return false;
+            }
+            memcpy(mStorage.GetData() + offset, deserializePointer, size);
+            return true;
+        }
+
+      private:
+        HandleStorage mStorage;
+    };
+
+    class WriteHandleImpl : public WriteHandle {
+      public:
+        explicit WriteHandleImpl(HandleStorage storage) : mStorage(std::move(storage)) {}
+        ~WriteHandleImpl() override = default;
+
+        size_t SerializeCreateSize() override { return sizeof(HandleCreateInfo); }
+        void SerializeCreate(void* serializePointer) override {
+            mStorage.SerializeCreate(serializePointer);
+        }
+
+        void* GetData() override { return mStorage.GetData(); }
+
+        size_t SizeOfSerializeDataUpdate(size_t offset, size_t size) override {
+            DAWN_ASSERT(offset <= mStorage.GetSize());
+            DAWN_ASSERT(size <= mStorage.GetSize() - offset);
+            // The server reads the data from the shared region directly.
+            return mStorage.IsShared() ? 0 : size;
+        }
+
+        void SerializeDataUpdate(void* serializePointer, size_t offset, size_t size) override {
+            if (mStorage.IsShared()) {
+                return;
+            }
+            DAWN_ASSERT(serializePointer != nullptr);
+            DAWN_ASSERT(offset <= mStorage.GetSize());
+            DAWN_ASSERT(size <= mStorage.GetSize() - offset);
+            memcpy(serializePointer, mStorage.GetData() + offset, size);
+        }
+
+      private:
+        HandleStorage mStorage;
+    };
+
+    static constexpr uint64_t kNotSerialized = 0;
+
+    static uint64_t GetAllocatableSize(uint64_t arenaSize) {
+        uint64_t alignedSize = arenaSize & ~(kRegionAlignment - 1);
+        return alignedSize > kArenaHeaderSize ? alignedSize - kArenaHeaderSize : 0;
+    }
+
+    static uint64_t GetRegionAllocationSize(size_t dataSize) {
+        return kRegionHeaderSize + Align(uint64_t(dataSize), kRegionAlignment);
+    }
+
+    ArenaHeader* GetArenaHeader() { return static_cast<ArenaHeader*>(mArena->GetPointer()); }
+
+    RegionHeader* GetRegionHeader(uint64_t regionOffset) {
+        return reinterpret_cast<RegionHeader*>(static_cast<uint8_t*>(mArena->GetPointer()) +
+                                               regionOffset);
+    }
+
+    uint8_t* GetRegionData(uint64_t regionOffset) {
+        return static_cast<uint8_t*>(mArena->GetPointer()) + regionOffset + kRegionHeaderSize;
+    }
+
+    uint64_t AllocateRegion(size_t dataSize) {
+        if (dataSize > mArena->GetSize()) {
+            return ArenaAllocator::kInvalidOffset;
+        }
+        uint64_t allocationSize = GetRegionAllocationSize(dataSize);
+        uint64_t regionOffset = mAllocator.Allocate(allocationSize);
+        if (regionOffset == ArenaAllocator::kInvalidOffset && ReclaimRegions()) {
+            regionOffset = mAllocator.Allocate(allocationSize);
+        }
+        if (regionOffset != ArenaAllocator::kInvalidOffset) {
+            new (GetRegionHeader(regionOffset)) RegionHeader{kRegionUnclaimed};
+        }
+        return regionOffset;
+    }
+
+    void ReleaseRegion(uint64_t regionOffset, size_t dataSize, uint64_t sequence) {
+        uint64_t allocationSize = GetRegionAllocationSize(dataSize);
+        // The server never heard of the region if the handle wasn't serialized, and it won't
+        // release it anymore once disconnected.
+        if (sequence == kNotSerialized || mServerDisconnected) {
+            mAllocator.Deallocate(regionOffset, allocationSize);
+            return;
+        }
+        // The server might still use the region, it is reclaimed once it releases it too.
+        mReleasedRegions.push_back({regionOffset, allocationSize, sequence});
+    }
+
+    // Returns true if any region was reclaimed.
+    bool ReclaimRegions() {
+        // Loaded before the states of the regions so that the server acquiring them is visible.
+        uint64_t lastDeserializedSequence =
+            GetArenaHeader()->lastDeserializedSequence.load(std::memory_order_acquire);
+        bool reclaimed = false;
+        for (size_t i = 0; i < mReleasedRegions.size();) {
+            auto [regionOffset, allocationSize, sequence] = mReleasedRegions[i];
+            uint32_t state = GetRegionHeader(regionOffset)->state.load(std::memory_order_acquire);
+            // Regions that the server skipped past were dropped with their command.
+            bool dropped = state == kRegionUnclaimed && sequence <= lastDeserializedSequence;
+            if (state != kRegionServerReleased && !dropped) {
+                ++i;
+                continue;
+            }
+            mAllocator.Deallocate(regionOffset, allocationSize);
+            mReleasedRegions[i] = mReleasedRegions.back();
+            mReleasedRegions.pop_back();
+            reclaimed = true;
+        }
+        return reclaimed;
+    }
+
+    std::unique_ptr<SharedMemory> mArena;
+    ArenaAllocator mAllocator;
+    uint64_t mNextSequence = kNotSerialized + 1;
+    bool mServerDisconnected = false;
+    // Regions whose client handle is destroyed, with their allocation size and the sequence of
+    // their handle.
+    std::vector<std::tuple<uint64_t, uint64_t, uint64_t>> mReleasedRegions;
+};
+
+// Server side
+
+class ServerSharedMemoryTransferService : public dawn::wire::server::MemoryTransferService {
+  public:
+    explicit ServerSharedMemoryTransferService(std::unique_ptr<SharedMemory> arena)
+        : mArena(std::move(arena)) {}
+    ~ServerSharedMemoryTransferService() override = default;
+
+    bool DeserializeReadHandle(const void* deserializePointer,
+                               size_t deserializeSize,
+                               ReadHandle** readHandle) override {
+        DAWN_ASSERT(readHandle != nullptr);
+        HandleRegion region;
+        if (!DeserializeRegion(deserializePointer, deserializeSize, &region)) {
+            return false;
+        }
+        *readHandle = new ReadHandleImpl(region);
+        return true;
+    }
+
+    bool DeserializeWriteHandle(const void* deserializePointer,
+                                size_t deserializeSize,
+                                WriteHandle** writeHandle) override {
+        DAWN_ASSERT(writeHandle != nullptr);
+        HandleRegion region;
+        if (!DeserializeRegion(deserializePointer, deserializeSize, &region)) {
+            return false;
+        }
+        *writeHandle = new WriteHandleImpl(region);
+        return true;
+    }
+
+  private:
+    // The region of the arena used by a handle. |data| is null for handles transferring their data
+    // inline.
+    struct HandleRegion {
+        raw_ptr<RegionHeader> header = nullptr;
+        raw_ptr<uint8_t, AllowPtrArithmetic> data = nullptr;
+        size_t size = 0;
+
+        bool IsShared() const { return data != nullptr; }
+
+        void Release() {
+            if (header != nullptr) {
+                header->state.store(kRegionServerReleased, std::memory_order_release);
+            }
+        }
+    };
+
+    class ReadHandleImpl : public ReadHandle {
+      public:
+        explicit ReadHandleImpl(const HandleRegion& region) : mRegion(region) {}
+        ~ReadHandleImpl() override { mRegion.Release(); }
+
+        size_t SizeOfSerializeDataUpdate(size_t offset, size_t size) override {
+            return mRegion.IsShared() ? 0 : size;
+        }
+
+        void SerializeDataUpdate(const void* data,
+                                 size_t offset,
+                                 size_t size,
+                                 void* serializePointer) override {
+            if (size == 0) {
+                return;
+            }
+            DAWN_ASSERT(data != nullptr);
+            if (!mRegion.IsShared()) {
+                DAWN_ASSERT(serializePointer != nullptr);
+                memcpy(serializePointer, data, size);
+                return;
+            }
+            // The region size comes from the client so it could be smaller than the mapping.
+            if (offset > mRegion.size || size > mRegion.size - offset) {
+                return;
+            }
+            memcpy(mRegion.data + offset, data, size);
+        }
+
+      private:
+        HandleRegion mRegion;
+    };
+
+    class WriteHandleImpl : public WriteHandle {
+      public:
+        explicit WriteHandleImpl(const HandleRegion& region) : mRegion(region) {}
+        ~WriteHandleImpl() override { mRegion.Release(); }
+
+        bool DeserializeDataUpdate(const void* deserializePointer,
+                                   size_t deserializeSize,
+                                   size_t offset,
+                                   size_t size) override {
+            if (mTargetData == nullptr) {
+                return false;
+            }
+            if (offset > mDataLength || size > mDataLength - offset) {
+                return false;
+            }
+            const void* source = deserializePointer;
+            if (mRegion.IsShared()) {
+                if (deserializeSize != 0 || offset > mRegion.size ||
+                    size > mRegion.size - offset) {
+                    return false;
+                }
+                source = mRegion.data + offset;
+            } else if (deserializeSize != size || deserializePointer == nullptr) {
+                return false;
+            }
+            memcpy(static_cast<uint8_t*>(mTargetData) + offset, source, size);
+            return true;
+        }
+
+      private:
+        HandleRegion mRegion;
+    };
+
+    bool DeserializeRegion(const void* deserializePointer,
+                           size_t deserializeSize,
+                           HandleRegion* region) {
+        if (deserializeSize != sizeof(HandleCreateInfo) || deserializePointer == nullptr) {
+            return false;
+        }
+        HandleCreateInfo info;
+        memcpy(&info, deserializePointer, sizeof(info));
+
+        switch (info.kind) {
+            case HandleKind::Inline:
+                *region = {};
+                break;
+            case HandleKind::Shared: {
+                // Validate the region is in the arena, after its header, without overflows.
+                uint64_t arenaSize = mArena->GetSize();
+                if (info.regionOffset % kRegionAlignment != 0 ||
+                    info.regionOffset < kArenaHeaderSize || arenaSize < kRegionHeaderSize ||
+                    info.regionOffset > arenaSize - kRegionHeaderSize ||
+                    info.size > arenaSize - kRegionHeaderSize - info.regionOffset) {
+                    return false;
+                }
+
+                uint8_t* regionStart =
+                    static_cast<uint8_t*>(mArena->GetPointer()) + info.regionOffset;
+                region->header = reinterpret_cast<RegionHeader*>(regionStart);
+                region->data = regionStart + kRegionHeaderSize;
+                region->size = static_cast<size_t>(info.size);
+                region->header->state.store(kRegionServerAcquired, std::memory_order_relaxed);
+                break;
+            }
+            default:
+                return false;
+        }
+
+        // Published after acquiring the region so that the client doesn't reclaim it as dropped.
+        if (info.sequence > mLastDeserializedSequence && mArena->GetSize() >= kArenaHeaderSize) {
+            mLastDeserializedSequence = info.sequence;
+            GetArenaHeader()->lastDeserializedSequence.store(info.sequence,
+                                                             std::memory_order_release);
+        }
+        return true;
+    }
+
+    ArenaHeader* GetArenaHeader() { return static_cast<ArenaHeader*>(mArena->GetPointer()); }
+
+    std::unique_ptr<SharedMemory> mArena;
+    uint64_t mLastDeserializedSequence = 0;
+};
+
+}  // anonymous namespace
+
+std::unique_ptr<ClientSharedMemoryTransferService> CreateClientSharedMemoryTransferService(
+    std::unique_ptr<SharedMemory> arena) {
+    if (arena == nullptr) {
+        return nullptr;
+    }
+    return std::make_unique<ClientSharedMemoryTransferServiceImpl>(std::move(arena));
+}
+
+std::unique_ptr<dawn::wire::server::MemoryTransferService>
+CreateServerSharedMemoryTransferService(std::unique_ptr<SharedMemory> arena) {
+    if (arena == nullptr) {
+        return nullptr;
+    }
+    return std::make_unique<ServerSharedMemoryTransferService>(std::move(arena));
+}
+
+}  // namespace dawn::utils
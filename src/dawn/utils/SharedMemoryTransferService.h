@@ -0,0 +1,66 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef SRC_DAWN_UTILS_SHAREDMEMORYTRANSFERSERVICE_H_
+#define SRC_DAWN_UTILS_SHAREDMEMORYTRANSFERSERVICE_H_
+
+#include <memory>
+
+#include "dawn/utils/SharedMemory.h"
+#include "dawn/wire/WireClient.h"
+#include "dawn/wire/WireServer.h"
+
+namespace dawn::utils {
+
+// Wire memory transfer services where the data of mapped buffers lives in an arena of shared
+// memory mapped by both the client and the server, instead of being copied inline in the command
+// stream. Reads are written by the server directly in the memory returned by the client's
+// GetMappedRange, and writes are copied by the server directly from it, which saves a copy and
+// keeps buffer contents out of the command stream.
+//
+// Handles reference a region of the arena that the client sub-allocates. The client only reuses a
+// region once both its handle and the server's companion handle are destroyed, which the server
+// signals through the region's header. Regions of handles that the server never deserialized are
+// reused as soon as the client handle is destroyed. When the arena is exhausted, handles fall back
+// to transferring their data inline in the command stream.
+//
+// The client and server must be created with mappings of the same shared memory.
+class ClientSharedMemoryTransferService : public dawn::wire::client::MemoryTransferService {
+  public:
+    // Reuses all the regions waiting for the server to release them, and the regions of the
+    // handles destroyed afterwards. To call when the connection to the server is lost.
+    virtual void OnServerDisconnected() = 0;
+};
+
+std::unique_ptr<ClientSharedMemoryTransferService> CreateClientSharedMemoryTransferService(
+    std::unique_ptr<SharedMemory> arena);
+std::unique_ptr<dawn::wire::server::MemoryTransferService>
+CreateServerSharedMemoryTransferService(std::unique_ptr<SharedMemory> arena);
+
+}  // namespace dawn::utils
+
+#endif  // SRC_DAWN_UTILS_SHAREDMEMORYTRANSFERSERVICE_H_
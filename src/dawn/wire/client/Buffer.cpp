@@ -399,6 +399,7 @@ void* Buffer::GetMappedRange(size_t offset, size_t size) {
     if (!IsMappedForWriting() || !CheckGetMappedRangeOffsetSize(offset, size)) {
         return nullptr;
     }
+    mDirtyRanges.Add(offset, size == WGPU_WHOLE_MAP_SIZE ? mSize - offset : size);
     return static_cast<uint8_t*>(mMappedData) + offset;
 }
 
@@ -425,24 +426,17 @@ void Buffer::Unmap() {
         // Writes need to be flushed before Unmap is sent. Unmap calls all associated
         // in-flight callbacks which may read the updated data.
 
-        // Get the serialization size of data update writes.
-        size_t writeDataUpdateInfoLength =
-            mWriteHandle->SizeOfSerializeDataUpdate(mMappedOffset, mMappedSize);
-
-        BufferUpdateMappedDataCmd cmd;
-        cmd.bufferId = GetWireId();
-        cmd.writeDataUpdateInfoLength = writeDataUpdateInfoLength;
-        cmd.writeDataUpdateInfo = nullptr;
-        cmd.offset = mMappedOffset;
-        cmd.size = mMappedSize;
-
-        client->SerializeCommand(
-            cmd, CommandExtension{writeDataUpdateInfoLength, [&](char* writeHandleBuffer) {
-                                      // Serialize flush metadata into the space after the command.
-                                      // This closes the handle for writing.
-                                      mWriteHandle->SerializeDataUpdate(writeHandleBuffer,
-                                                                        cmd.offset, cmd.size);
-                                  }});
+        // Only the ranges returned by GetMappedRange can have been written to. If none were
+        // requested the data might still have been written through the write handle directly, so
+        // conservatively flush the whole mapped range.
+        if (mDirtyRanges.IsEmpty()) {
+            SerializeWriteDataUpdate(mMappedOffset, mMappedSize);
+        } else {
+            for (const DirtyRangeTracker::Range& range : mDirtyRanges.GetRanges()) {
+                SerializeWriteDataUpdate(range.offset, range.size);
+            }
+        }
+        mDirtyRanges.Reset();
 
         // If mDestructWriteHandleOnUnmap is true, that means the write handle is merely
         // for mappedAtCreation usage. It is destroyed on unmap after flush to server
@@ -530,6 +524,27 @@ bool Buffer::CheckGetMappedRangeOffsetSize(size_t offset, size_t size) const {
     return offsetInMappedRange <= mMappedSize - rangeSize;
 }
 
+void Buffer::SerializeWriteDataUpdate(size_t offset, size_t size) {
+    DAWN_ASSERT(mWriteHandle != nullptr);
+
+    // Get the serialization size of data update writes.
+    size_t writeDataUpdateInfoLength = mWriteHandle->SizeOfSerializeDataUpdate(offset, size);
+
+    BufferUpdateMappedDataCmd cmd;
+    cmd.bufferId = GetWireId();
+    cmd.writeDataUpdateInfoLength = writeDataUpdateInfoLength;
+    cmd.writeDataUpdateInfo = nullptr;
+    cmd.offset = offset;
+    cmd.size = size;
+
+    GetClient()->SerializeCommand(
+        cmd, CommandExtension{writeDataUpdateInfoLength, [&](char* writeHandleBuffer) {
+                                  // Serialize flush metadata into the space after the command.
+                                  mWriteHandle->SerializeDataUpdate(writeHandleBuffer, cmd.offset,
+                                                                    cmd.size);
+                              }});
+}
+
 void Buffer::FreeMappedData() {
 #if defined(DAWN_ENABLE_ASSERTS)
     // When in "debug" mode, 0xCA-out the mapped data when we free it so that in we can detect
@@ -546,6 +561,7 @@ void Buffer::FreeMappedData() {
     mWriteHandle = nullptr;
     mMappedData = nullptr;
     mMappedState = MapState::Unmapped;
+    mDirtyRanges.Reset();
 }
 
 }  // namespace dawn::wire::client
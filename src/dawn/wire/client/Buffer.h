@@ -36,6 +36,7 @@
 #include "dawn/common/RefCounted.h"
 #include "dawn/webgpu.h"
 #include "dawn/wire/WireClient.h"
+#include "dawn/wire/client/DirtyRangeTracker.h"
 #include "dawn/wire/client/ObjectBase.h"
 #include "partition_alloc/pointers/raw_ptr.h"
 
@@ -83,6 +84,8 @@ class Buffer final : public ObjectWithEventsBase {
     bool IsMappedForReading() const;
     bool IsMappedForWriting() const;
     bool CheckGetMappedRangeOffsetSize(size_t offset, size_t size) const;
+    // Sends the contents of [offset, offset + size) of the write handle to the server.
+    void SerializeWriteDataUpdate(size_t offset, size_t size);
 
     void FreeMappedData();
 
@@ -114,6 +117,9 @@ class Buffer final : public ObjectWithEventsBase {
     raw_ptr<void, DanglingUntriaged> mMappedData = nullptr;
     size_t mMappedOffset = 0;
     size_t mMappedSize = 0;
+    // Ranges returned by GetMappedRange while mapped for writing. They are the only parts of the
+    // mapping the application can have written to, so only they are flushed on Unmap.
+    DirtyRangeTracker mDirtyRanges;
 
     // Only one mapped pointer can be active at a time
     // TODO(enga): Use a tagged pointer to save space.
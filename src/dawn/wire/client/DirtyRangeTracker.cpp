@@ -0,0 +1,106 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "dawn/wire/client/DirtyRangeTracker.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "dawn/common/Assert.h"
+
+namespace dawn::wire::client {
+
+namespace {
+
+size_t GetEnd(const DirtyRangeTracker::Range& range) {
+    return range.offset + range.size;
+}
+
+// Returns true if a range ending at `end` and a range starting at `begin` are close enough to be
+// sent as a single data update.
+bool ShouldCoalesce(size_t end, size_t begin) {
+    return begin <= end || begin - end < DirtyRangeTracker::kCoalesceGranularity;
+}
+
+}  // anonymous namespace
+
+void DirtyRangeTracker::Add(size_t offset, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    DAWN_ASSERT(size <= std::numeric_limits<size_t>::max() - offset);
+
+    size_t begin = offset;
+    size_t end = offset + size;
+
+    // Skip the ranges that end well before the new one, then absorb all the ranges that overlap
+    // or are close to it.
+    auto first = mRanges.begin();
+    while (first != mRanges.end() && !ShouldCoalesce(GetEnd(*first), begin)) {
+        ++first;
+    }
+    auto last = first;
+    while (last != mRanges.end() && ShouldCoalesce(end, last->offset)) {
+        begin = std::min(begin, last->offset);
+        end = std::max(end, GetEnd(*last));
+        ++last;
+    }
+    first = mRanges.erase(first, last);
+    mRanges.insert(first, {begin, end - begin});
+
+    if (mRanges.size() <= kMaxRanges) {
+        return;
+    }
+
+    // Too many ranges are tracked, merge the two closest ones. A single merge is enough since at
+    // most one range is added per call.
+    size_t closest = 0;
+    size_t closestGap = std::numeric_limits<size_t>::max();
+    for (size_t i = 0; i + 1 < mRanges.size(); ++i) {
+        size_t gap = mRanges[i + 1].offset - GetEnd(mRanges[i]);
+        if (gap < closestGap) {
+            closest = i;
+            closestGap = gap;
+        }
+    }
+    mRanges[closest].size = GetEnd(mRanges[closest + 1]) - mRanges[closest].offset;
+    mRanges.erase(mRanges.begin() + closest + 1);
+}
+
+void DirtyRangeTracker::Reset() {
+    mRanges.clear();
+}
+
+bool DirtyRangeTracker::IsEmpty() const {
+    return mRanges.empty();
+}
+
+const std::vector<DirtyRangeTracker::Range>& DirtyRangeTracker::GetRanges() const {
+    return mRanges;
+}
+
+}  // namespace dawn::wire::client
@@ -0,0 +1,63 @@
+// Copyright 2024 The Dawn & Tint Authors
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef SRC_DAWN_WIRE_CLIENT_DIRTYRANGETRACKER_H_
+#define SRC_DAWN_WIRE_CLIENT_DIRTYRANGETRACKER_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace dawn::wire::client {
+
+// Records the byte ranges of a mapped buffer that the application may have written to so that
+// only those spans are sent to the server on Unmap. Ranges closer than kCoalesceGranularity are
+// merged so that many small neighbouring writes turn into a single data update, and the number
+// of tracked ranges is bounded by kMaxRanges by merging the closest neighbours.
+class DirtyRangeTracker {
+  public:
+    struct Range {
+        size_t offset;
+        size_t size;
+    };
+
+    static constexpr size_t kCoalesceGranularity = 4096;
+    static constexpr size_t kMaxRanges = 16;
+
+    void Add(size_t offset, size_t size);
+    void Reset();
+
+    bool IsEmpty() const;
+    // Returns disjoint ranges sorted by offset.
+    const std::vector<Range>& GetRanges() const;
+
+  private:
+    std::vector<Range> mRanges;
+};
+
+}  // namespace dawn::wire::client
+
+#endif  // SRC_DAWN_WIRE_CLIENT_DIRTYRANGETRACKER_H_